@@ -24,6 +24,7 @@
 
 #include "libavutil/channel_layout.h"
 #include "libavutil/common.h"
+#include "libavutil/intreadwrite.h"
 #include "parser.h"
 #include "aac_ac3_parser.h"
 #include "ac3_parser_internal.h"
@@ -55,7 +56,15 @@ get_next:
             }else{ //we need a header first
                 len=0;
                 for(i=s->remaining_size; i<buf_size; i++){
-                    s->state = (s->state<<8) + buf[i];
+                    /* once the state only holds bytes of buf, skip ahead
+                     * to the next possible header start */
+                    if (i >= s->remaining_size + 8) {
+                        int start = i - s->header_size + 1;
+                        int skip  = s->find_sync(buf + start, buf_size - start);
+                        i = FFMIN(i + skip, buf_size - 1);
+                        s->state = AV_RB64(buf + i - 7);
+                    } else
+                        s->state = (s->state<<8) + buf[i];
                     if((len=s->sync(s->state, &s->need_next_header, &new_frame_start)))
                         break;
                 }
@@ -32,6 +32,11 @@ typedef struct AACAC3ParseContext {
     ParseContext pc;
     int header_size;
     int (*sync)(uint64_t state, int *need_next_header, int *new_frame_start);
+    /**
+     * Return the offset of the first byte of buf that may start a header,
+     * or size. sync() is not called for the headers skipped this way.
+     */
+    int (*find_sync)(const uint8_t *buf, int size);
 
     const AVCRC *crc_ctx;
     int remaining_size;
@@ -26,6 +26,7 @@
 #include "adts_parser.h"
 #include "parser_internal.h"
 #include "libavutil/intreadwrite.h"
+#include "libavutil/syncscan.h"
 
 static int aac_sync(uint64_t state, int *need_next_header, int *new_frame_start)
 {
@@ -43,11 +44,17 @@ static int aac_sync(uint64_t state, int *need_next_header, int *new_frame_start)
     return size;
 }
 
+static int aac_find_sync(const uint8_t *buf, int size)
+{
+    return avpriv_find_sync_word(buf, size, 0xFFF0, 0xFFF0);
+}
+
 static av_cold int aac_parse_init(AVCodecParserContext *s1)
 {
     AACAC3ParseContext *s = s1->priv_data;
     s->header_size = AV_AAC_ADTS_HEADER_SIZE;
     s->sync = aac_sync;
+    s->find_sync = aac_find_sync;
     return 0;
 }
 
@@ -115,16 +115,12 @@ static av_always_inline float quantize_and_encode_band_cost_template(
     } else {
         off = aac_cb_maxval[cb];
     }
+    s->aacdsp.cb_index(s->cbidx, s->qcoefs, size, dim, aac_cb_range[cb], off);
     for (int i = 0; i < size; i += dim) {
         const float *vec;
-        int *quants = s->qcoefs + i;
-        int curidx = 0;
+        int curidx = s->cbidx[i / dim];
         int curbits;
         float quantized, rd = 0.0f;
-        for (int j = 0; j < dim; j++) {
-            curidx *= aac_cb_range[cb];
-            curidx += quants[j] + off;
-        }
         curbits =  ff_aac_spectral_bits[cb-1][curidx];
         vec     = &ff_aac_codebook_vectors[cb-1][curidx*dim];
         if (BT_UNSIGNED) {
@@ -132,6 +132,7 @@ typedef struct ChannelElement {
     uint8_t ms_mask[128];     ///< Set if mid/side stereo is used for each scalefactor window band
     uint8_t is_mask[128];     ///< Set if intensity stereo is used
     // shared
+    int random_state;         ///< PNS noise generator state, kept per element so that elements can be searched in any order
     SingleChannelElement ch[2];
 } ChannelElement;
 
@@ -210,6 +211,7 @@ typedef struct AACEncContext {
 
     AudioFrameQueue afq;
     DECLARE_ALIGNED(32, int,   qcoefs)[96];      ///< quantized coefficients
+    DECLARE_ALIGNED(32, int,   cbidx)[48];       ///< codebook indices of qcoefs
     DECLARE_ALIGNED(32, float, scoefs)[1024];    ///< scaled coefficients
 
     uint16_t quantize_band_cost_cache_generation;
@@ -220,6 +222,8 @@ typedef struct AACEncContext {
     struct {
         float *samples;
     } buffer;
+
+    struct AACEncContext **thread_ctx;           ///< per-thread copies for the quantizer search, NULL without slice threads
 } AACEncContext;
 
 void ff_quantize_band_cost_cache_init(struct AACEncContext *s);
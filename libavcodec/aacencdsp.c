@@ -45,10 +45,22 @@ static void quantize_bands(int *out, const float *in, const float *scaled,
     }
 }
 
+static void cb_index_c(int *idx, const int *quants, int size, int dim,
+                       int range, int off)
+{
+    for (int i = 0; i < size; i += dim) {
+        int curidx = 0;
+        for (int j = 0; j < dim; j++)
+            curidx = curidx * range + quants[i + j] + off;
+        *idx++ = curidx;
+    }
+}
+
 void ff_aacenc_dsp_init(AACEncDSPContext *s)
 {
     s->abs_pow34   = abs_pow34_v;
     s->quant_bands = quantize_bands;
+    s->cb_index    = cb_index_c;
 
 #if ARCH_RISCV
     ff_aacenc_dsp_init_riscv(s);
@@ -24,6 +24,12 @@ typedef struct AACEncDSPContext {
     void (*quant_bands)(int *out, const float *in, const float *scaled,
                         int size, int is_signed, int maxval, const float Q34,
                         const float rounding);
+    /**
+     * Compute the codebook index of each group of dim quantized values,
+     * size must be a multiple of 4.
+     */
+    void (*cb_index)(int *idx, const int *quants, int size, int dim,
+                     int range, int off);
 } AACEncDSPContext;
 
 void ff_aacenc_dsp_init(AACEncDSPContext *s);
@@ -27,6 +27,8 @@
 void ff_abs_pow34_neon(float *out, const float *in, const int size);
 void ff_aac_quant_bands_neon(int *, const float *, const float *, int, int,
                              int, const float, const float);
+void ff_aac_cb_index_neon(int *idx, const int *quants, int size, int dim,
+                          int range, int off);
 
 av_cold void ff_aacenc_dsp_init_aarch64(AACEncDSPContext *s)
 {
@@ -35,4 +37,5 @@ av_cold void ff_aacenc_dsp_init_aarch64(AACEncDSPContext *s)
 
     s->abs_pow34 = ff_abs_pow34_neon;
     s->quant_bands = ff_aac_quant_bands_neon;
+    s->cb_index    = ff_aac_cb_index_neon;
 }
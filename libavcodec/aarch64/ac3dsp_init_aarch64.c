@@ -36,6 +36,9 @@ void ff_ac3_sum_square_butterfly_float_neon(float sum[4],
                                             const float *coef0,
                                             const float *coef1,
                                             int len);
+void ff_ac3_bit_alloc_calc_bap_neon(int16_t *mask, int16_t *psd, int start, int end,
+                                    int snr_offset, int floor,
+                                    const uint8_t *bap_tab, uint8_t *bap);
 
 av_cold void ff_ac3dsp_init_aarch64(AC3DSPContext *c)
 {
@@ -47,4 +50,5 @@ av_cold void ff_ac3dsp_init_aarch64(AC3DSPContext *c)
     c->float_to_fixed24 = ff_float_to_fixed24_neon;
     c->sum_square_butterfly_int32 = ff_ac3_sum_square_butterfly_int32_neon;
     c->sum_square_butterfly_float = ff_ac3_sum_square_butterfly_float_neon;
+    c->bit_alloc_calc_bap = ff_ac3_bit_alloc_calc_bap_neon;
 }
@@ -0,0 +1,36 @@
+/*
+ * This file is part of Librempeg
+ *
+ * Librempeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Librempeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Librempeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <stdint.h>
+
+#include "libavutil/aarch64/cpu.h"
+#include "libavutil/attributes.h"
+#include "libavcodec/adpcmdsp.h"
+
+void ff_adpcm_unpack_nibbles_lo_neon(uint8_t *dst, const uint8_t *src, int len);
+void ff_adpcm_unpack_nibbles_hi_neon(uint8_t *dst, const uint8_t *src, int len);
+
+av_cold void ff_adpcmdsp_init_aarch64(ADPCMDSPContext *c)
+{
+    int cpu_flags = av_get_cpu_flags();
+
+    if (have_neon(cpu_flags)) {
+        c->unpack_nibbles_lo = ff_adpcm_unpack_nibbles_lo_neon;
+        c->unpack_nibbles_hi = ff_adpcm_unpack_nibbles_hi_neon;
+    }
+}
@@ -24,6 +24,7 @@
 
 #include "libavutil/channel_layout.h"
 #include "libavutil/mem.h"
+#include "libavutil/syncscan.h"
 #include "parser.h"
 #include "ac3defs.h"
 #include "ac3tab.h"
@@ -468,12 +469,21 @@ static int ac3_sync(uint64_t state, int *need_next_header, int *new_frame_start)
     return hdr.frame_size;
 }
 
+/* headers start with the sync word in either byte order */
+static int ac3_find_sync(const uint8_t *buf, int size)
+{
+    int pos = avpriv_find_sync_word(buf, size, 0x0B77, 0xFFFF);
+    int le  = avpriv_find_sync_word(buf, FFMIN(pos + 1, size), 0x770B, 0xFFFF);
+    return FFMIN(pos, le);
+}
+
 static av_cold int ac3_parse_init(AVCodecParserContext *s1)
 {
     AACAC3ParseContext *s = s1->priv_data;
     s->header_size = AC3_HEADER_SIZE;
     s->crc_ctx = av_crc_get_table(AV_CRC_16_ANSI);
     s->sync = ac3_sync;
+    s->find_sync = ac3_find_sync;
     return 0;
 }
 
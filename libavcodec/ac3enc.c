@@ -791,53 +791,63 @@ static void encode_exponents_blk_ch(uint8_t *exp, int nb_exps, int exp_strategy,
 
 
 /*
- * Encode exponents from original extracted form to what the decoder will see.
+ * Encode exponents of one channel from original extracted form to what the
+ * decoder will see.
  * This copies and groups exponents based on exponent strategy and reduces
  * deltas between adjacent exponent groups so that they can be differentially
  * encoded.
  */
-static void encode_exponents(AC3EncodeContext *s)
+static int encode_exponents_ch(AVCodecContext *avctx, void *arg, int jobnr, int threadnr)
 {
-    int blk, blk1, ch, cpl;
-    uint8_t *exp, *exp_strategy;
+    AC3EncodeContext *s = avctx->priv_data;
+    int ch = jobnr + !s->cpl_on;
+    uint8_t *exp          = s->blocks[0].exp[ch] + s->start_freq[ch];
+    uint8_t *exp_strategy = s->exp_strategy[ch];
+    int cpl = (ch == CPL_CH);
+    int blk = 0, blk1;
     int nb_coefs, num_reuse_blocks;
 
-    for (ch = !s->cpl_on; ch <= s->channels; ch++) {
-        exp          = s->blocks[0].exp[ch] + s->start_freq[ch];
-        exp_strategy = s->exp_strategy[ch];
-
-        cpl = (ch == CPL_CH);
-        blk = 0;
-        while (blk < s->num_blocks) {
-            AC3Block *block = &s->blocks[blk];
-            if (cpl && !block->cpl_in_use) {
-                exp += AC3_MAX_COEFS;
-                blk++;
-                continue;
-            }
-            nb_coefs = block->end_freq[ch] - s->start_freq[ch];
-            blk1 = blk + 1;
+    while (blk < s->num_blocks) {
+        AC3Block *block = &s->blocks[blk];
+        if (cpl && !block->cpl_in_use) {
+            exp += AC3_MAX_COEFS;
+            blk++;
+            continue;
+        }
+        nb_coefs = block->end_freq[ch] - s->start_freq[ch];
+        blk1 = blk + 1;
 
-            /* count the number of EXP_REUSE blocks after the current block
-               and set exponent reference block numbers */
-            s->exp_ref_block[ch][blk] = blk;
-            while (blk1 < s->num_blocks && exp_strategy[blk1] == EXP_REUSE) {
-                s->exp_ref_block[ch][blk1] = blk;
-                blk1++;
-            }
-            num_reuse_blocks = blk1 - blk - 1;
+        /* count the number of EXP_REUSE blocks after the current block
+           and set exponent reference block numbers */
+        s->exp_ref_block[ch][blk] = blk;
+        while (blk1 < s->num_blocks && exp_strategy[blk1] == EXP_REUSE) {
+            s->exp_ref_block[ch][blk1] = blk;
+            blk1++;
+        }
+        num_reuse_blocks = blk1 - blk - 1;
 
-            /* for the EXP_REUSE case we select the min of the exponents */
-            s->ac3dsp.ac3_exponent_min(exp-s->start_freq[ch], num_reuse_blocks,
-                                       AC3_MAX_COEFS);
+        /* for the EXP_REUSE case we select the min of the exponents */
+        s->ac3dsp.ac3_exponent_min(exp-s->start_freq[ch], num_reuse_blocks,
+                                   AC3_MAX_COEFS);
 
-            encode_exponents_blk_ch(exp, nb_coefs, exp_strategy[blk], cpl);
+        encode_exponents_blk_ch(exp, nb_coefs, exp_strategy[blk], cpl);
 
-            exp += AC3_MAX_COEFS * (num_reuse_blocks + 1);
-            blk = blk1;
-        }
+        exp += AC3_MAX_COEFS * (num_reuse_blocks + 1);
+        blk = blk1;
     }
 
+    return 0;
+}
+
+
+/*
+ * Encode exponents of all channels, in parallel with slice threads.
+ */
+static void encode_exponents(AC3EncodeContext *s)
+{
+    s->avctx->execute2(s->avctx, encode_exponents_ch, NULL, NULL,
+                       s->channels + s->cpl_on);
+
     /* reference block numbers have been changed, so reset ref_bap_set */
     s->ref_bap_set = 0;
 }
@@ -1235,32 +1245,45 @@ static void count_frame_bits(AC3EncodeContext *s)
 
 
 /*
- * Calculate masking curve based on the final exponents.
+ * Calculate masking curve of one channel based on the final exponents.
  * Also calculate the power spectral densities to use in future calculations.
  */
-static void bit_alloc_masking(AC3EncodeContext *s)
+static int bit_alloc_masking_ch(AVCodecContext *avctx, void *arg, int jobnr, int threadnr)
 {
-    int blk, ch;
+    AC3EncodeContext *s = avctx->priv_data;
+    int ch = jobnr + !s->cpl_on;
 
-    for (blk = 0; blk < s->num_blocks; blk++) {
+    for (int blk = 0; blk < s->num_blocks; blk++) {
         AC3Block *block = &s->blocks[blk];
-        for (ch = !block->cpl_in_use; ch <= s->channels; ch++) {
-            /* We only need psd and mask for calculating bap.
-               Since we currently do not calculate bap when exponent
-               strategy is EXP_REUSE we do not need to calculate psd or mask. */
-            if (s->exp_strategy[ch][blk] != EXP_REUSE) {
-                ff_ac3_bit_alloc_calc_psd(block->exp[ch], s->start_freq[ch],
-                                          block->end_freq[ch], block->psd[ch],
-                                          block->band_psd[ch]);
-                ff_ac3_bit_alloc_calc_mask(&s->bit_alloc, block->band_psd[ch],
-                                           s->start_freq[ch], block->end_freq[ch],
-                                           ff_ac3_fast_gain_tab[s->fast_gain_code[ch]],
-                                           ch == s->lfe_channel,
-                                           DBA_NONE, 0, NULL, NULL, NULL,
-                                           block->mask[ch]);
-            }
+        if (ch == CPL_CH && !block->cpl_in_use)
+            continue;
+        /* We only need psd and mask for calculating bap.
+           Since we currently do not calculate bap when exponent
+           strategy is EXP_REUSE we do not need to calculate psd or mask. */
+        if (s->exp_strategy[ch][blk] != EXP_REUSE) {
+            ff_ac3_bit_alloc_calc_psd(block->exp[ch], s->start_freq[ch],
+                                      block->end_freq[ch], block->psd[ch],
+                                      block->band_psd[ch]);
+            ff_ac3_bit_alloc_calc_mask(&s->bit_alloc, block->band_psd[ch],
+                                       s->start_freq[ch], block->end_freq[ch],
+                                       ff_ac3_fast_gain_tab[s->fast_gain_code[ch]],
+                                       ch == s->lfe_channel,
+                                       DBA_NONE, 0, NULL, NULL, NULL,
+                                       block->mask[ch]);
         }
     }
+
+    return 0;
+}
+
+
+/*
+ * Calculate masking curves of all channels, in parallel with slice threads.
+ */
+static void bit_alloc_masking(AC3EncodeContext *s)
+{
+    s->avctx->execute2(s->avctx, bit_alloc_masking_ch, NULL, NULL,
+                       s->channels + s->cpl_on);
 }
 
 
@@ -1306,55 +1329,48 @@ static void count_mantissa_bits_init(uint16_t mant_cnt[AC3_MAX_BLOCKS][16])
 
 
 /**
- * Update mantissa bit counts for all blocks in 1 channel in a given bandwidth
- * range.
- *
- * @param s                 AC-3 encoder private context
- * @param ch                channel index
- * @param[in,out] mant_cnt  running counts for each bap value for each block
- * @param start             starting coefficient bin
- * @param end               ending coefficient bin
+ * Run the bit allocation of one channel with a given SNR offset and count
+ * its bap values for each block, up to the highest end frequency a
+ * channel can have.
  */
-static void count_mantissa_bits_update_ch(AC3EncodeContext *s, int ch,
-                                          uint16_t mant_cnt[AC3_MAX_BLOCKS][16],
-                                          int start, int end)
+static int bit_alloc_ch(AVCodecContext *avctx, void *arg, int jobnr, int threadnr)
 {
-    int blk;
+    AC3EncodeContext *s = avctx->priv_data;
+    const int snr_offset = *(const int *)arg;
+    int ch = jobnr + !s->cpl_enabled;
+    int start = s->start_freq[ch];
+    int max_end_freq = s->bandwidth_code * 3 + 73;
 
-    for (blk = 0; blk < s->num_blocks; blk++) {
+    for (int blk = 0; blk < s->num_blocks; blk++) {
         AC3Block *block = &s->blocks[blk];
+
+        memset(s->mant_cnt[ch][blk], 0, sizeof(s->mant_cnt[ch][blk]));
         if (ch == CPL_CH && !block->cpl_in_use)
             continue;
-        s->ac3dsp.update_bap_counts(mant_cnt[blk],
+        /* Currently the only bit allocation parameters which vary across
+           blocks within a frame are the exponent values.  We can take
+           advantage of that by reusing the bit allocation pointers
+           whenever we reuse exponents. */
+        if (s->exp_strategy[ch][blk] != EXP_REUSE) {
+            s->ac3dsp.bit_alloc_calc_bap(block->mask[ch], block->psd[ch],
+                                         start, block->end_freq[ch],
+                                         snr_offset, s->bit_alloc.floor,
+                                         ff_ac3_bap_tab, s->ref_bap[ch][blk]);
+        }
+        s->ac3dsp.update_bap_counts(s->mant_cnt[ch][blk],
                                     s->ref_bap[ch][blk] + start,
-                                    FFMIN(end, block->end_freq[ch]) - start);
+                                    FFMIN(max_end_freq, block->end_freq[ch]) - start);
     }
-}
-
 
-/*
- * Count the number of mantissa bits in the frame based on the bap values.
- */
-static int count_mantissa_bits(AC3EncodeContext *s)
-{
-    int ch, max_end_freq;
-    LOCAL_ALIGNED_16(uint16_t, mant_cnt, [AC3_MAX_BLOCKS], [16]);
-
-    count_mantissa_bits_init(mant_cnt);
-
-    max_end_freq = s->bandwidth_code * 3 + 73;
-    for (ch = !s->cpl_enabled; ch <= s->channels; ch++)
-        count_mantissa_bits_update_ch(s, ch, mant_cnt, s->start_freq[ch],
-                                      max_end_freq);
-
-    return s->ac3dsp.compute_mantissa_size(mant_cnt);
+    return 0;
 }
 
 
 /**
  * Run the bit allocation with a given SNR offset.
  * This calculates the bit allocation pointers that will be used to determine
- * the quantization of each mantissa.
+ * the quantization of each mantissa. Channels are allocated in parallel with
+ * slice threads.
  *
  * @param s           AC-3 encoder private context
  * @param snr_offset  SNR offset, 0 to 1023
@@ -1363,28 +1379,21 @@ static int count_mantissa_bits(AC3EncodeContext *s)
  */
 static int bit_alloc(AC3EncodeContext *s, int snr_offset)
 {
-    int blk, ch;
+    LOCAL_ALIGNED_16(uint16_t, mant_cnt, [AC3_MAX_BLOCKS], [16]);
 
     snr_offset = (snr_offset - 240) * 4;
 
     reset_block_bap(s);
-    for (blk = 0; blk < s->num_blocks; blk++) {
-        AC3Block *block = &s->blocks[blk];
+    s->avctx->execute2(s->avctx, bit_alloc_ch, &snr_offset, NULL,
+                       s->channels + s->cpl_enabled);
 
-        for (ch = !block->cpl_in_use; ch <= s->channels; ch++) {
-            /* Currently the only bit allocation parameters which vary across
-               blocks within a frame are the exponent values.  We can take
-               advantage of that by reusing the bit allocation pointers
-               whenever we reuse exponents. */
-            if (s->exp_strategy[ch][blk] != EXP_REUSE) {
-                s->ac3dsp.bit_alloc_calc_bap(block->mask[ch], block->psd[ch],
-                                             s->start_freq[ch], block->end_freq[ch],
-                                             snr_offset, s->bit_alloc.floor,
-                                             ff_ac3_bap_tab, s->ref_bap[ch][blk]);
-            }
-        }
-    }
-    return count_mantissa_bits(s);
+    count_mantissa_bits_init(mant_cnt);
+    for (int ch = !s->cpl_enabled; ch <= s->channels; ch++)
+        for (int blk = 0; blk < s->num_blocks; blk++)
+            for (int i = 0; i < 16; i++)
+                mant_cnt[blk][i] += s->mant_cnt[ch][blk][i];
+
+    return s->ac3dsp.compute_mantissa_size(mant_cnt);
 }
 
 
@@ -1594,33 +1603,44 @@ static void quantize_mantissas_blk_ch(AC3Mant *s, int32_t *fixed_coef,
 
 
 /**
- * Quantize mantissas using coefficients, exponents, and bit allocation pointers.
- *
- * @param s  AC-3 encoder private context
+ * Quantize the mantissas of one block using coefficients, exponents, and bit
+ * allocation pointers. Mantissa groups never span blocks.
  */
-static void ac3_quantize_mantissas(AC3EncodeContext *s)
+static int quantize_mantissas_blk(AVCodecContext *avctx, void *arg, int blk, int threadnr)
 {
-    int blk, ch, ch0=0, got_cpl;
+    AC3EncodeContext *s = avctx->priv_data;
+    AC3Block *block = &s->blocks[blk];
+    AC3Mant m = { 0 };
+    int ch, ch0 = 0, got_cpl;
 
-    for (blk = 0; blk < s->num_blocks; blk++) {
-        AC3Block *block = &s->blocks[blk];
-        AC3Mant m = { 0 };
-
-        got_cpl = !block->cpl_in_use;
-        for (ch = 1; ch <= s->channels; ch++) {
-            if (!got_cpl && ch > 1 && block->channel_in_cpl[ch-1]) {
-                ch0     = ch - 1;
-                ch      = CPL_CH;
-                got_cpl = 1;
-            }
-            quantize_mantissas_blk_ch(&m, block->fixed_coef[ch],
-                                      s->blocks[s->exp_ref_block[ch][blk]].exp[ch],
-                                      s->ref_bap[ch][blk], block->qmant[ch],
-                                      s->start_freq[ch], block->end_freq[ch]);
-            if (ch == CPL_CH)
-                ch = ch0;
+    got_cpl = !block->cpl_in_use;
+    for (ch = 1; ch <= s->channels; ch++) {
+        if (!got_cpl && ch > 1 && block->channel_in_cpl[ch-1]) {
+            ch0     = ch - 1;
+            ch      = CPL_CH;
+            got_cpl = 1;
         }
+        quantize_mantissas_blk_ch(&m, block->fixed_coef[ch],
+                                  s->blocks[s->exp_ref_block[ch][blk]].exp[ch],
+                                  s->ref_bap[ch][blk], block->qmant[ch],
+                                  s->start_freq[ch], block->end_freq[ch]);
+        if (ch == CPL_CH)
+            ch = ch0;
     }
+
+    return 0;
+}
+
+
+/**
+ * Quantize mantissas of all blocks, in parallel with slice threads.
+ *
+ * @param s  AC-3 encoder private context
+ */
+static void ac3_quantize_mantissas(AC3EncodeContext *s)
+{
+    s->avctx->execute2(s->avctx, quantize_mantissas_blk, NULL, NULL,
+                       s->num_blocks);
 }
 
 
@@ -2167,6 +2187,7 @@ av_cold int ff_ac3_encode_close(AVCodecContext *avctx)
     av_freep(&s->mask_buffer);
     av_freep(&s->qmant_buffer);
     av_freep(&s->cpl_coord_buffer);
+    av_freep(&s->windowed_samples);
     av_freep(&s->fdsp);
 
     av_tx_uninit(&s->tx);
@@ -2412,6 +2433,8 @@ static av_cold int allocate_buffers(AC3EncodeContext *s)
     int total_coefs    = AC3_MAX_COEFS * channel_blocks;
     uint8_t *cpl_coord_mant_buffer;
     const unsigned sampletype_size = SAMPLETYPE_SIZE(s);
+    int nb_threads = s->avctx->active_thread_type & FF_THREAD_SLICE ?
+                     s->avctx->thread_count : 1;
 
     for (int ch = 0; ch < s->channels; ch++) {
         s->planar_samples[ch] = av_mallocz(AC3_BLOCK_SIZE * sampletype_size);
@@ -2430,6 +2453,11 @@ static av_cold int allocate_buffers(AC3EncodeContext *s)
         !FF_ALLOC_TYPED_ARRAY(s->qmant_buffer,       total_coefs))
         return AVERROR(ENOMEM);
 
+    s->windowed_samples = av_malloc_array(nb_threads,
+                                          AC3_WINDOW_SIZE * sampletype_size);
+    if (!s->windowed_samples)
+        return AVERROR(ENOMEM);
+
     if (!s->fixed_point) {
         if (!FF_ALLOCZ_TYPED_ARRAY(s->fixed_coef_buffer, total_coefs))
             return AVERROR(ENOMEM);
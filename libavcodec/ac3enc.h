@@ -251,6 +251,7 @@ typedef struct AC3EncodeContext {
     uint8_t exp_ref_block[AC3_MAX_CHANNELS][AC3_MAX_BLOCKS]; ///< reference blocks for EXP_REUSE
     uint8_t *ref_bap     [AC3_MAX_CHANNELS][AC3_MAX_BLOCKS]; ///< bit allocation pointers (bap)
     int ref_bap_set;                                         ///< indicates if ref_bap pointers have been set
+    uint16_t mant_cnt[AC3_MAX_CHANNELS][AC3_MAX_BLOCKS][16]; ///< bap counts of each channel
 
     /** fixed vs. float function pointers */
     void (*encode_frame)(struct AC3EncodeContext *s, uint8_t * const *samples);
@@ -262,10 +263,7 @@ typedef struct AC3EncodeContext {
         DECLARE_ALIGNED(32, float,   mdct_window_float)[AC3_BLOCK_SIZE];
         DECLARE_ALIGNED(32, int32_t, mdct_window_fixed)[AC3_BLOCK_SIZE];
     };
-    union {
-        DECLARE_ALIGNED(32, float,   windowed_samples_float)[AC3_WINDOW_SIZE];
-        DECLARE_ALIGNED(32, int32_t, windowed_samples_fixed)[AC3_WINDOW_SIZE];
-    };
+    uint8_t *windowed_samples;              ///< MDCT input, one window per slice thread
 } AC3EncodeContext;
 
 extern const AVChannelLayout ff_ac3_ch_layouts[19];
@@ -45,40 +45,53 @@
 #endif
 
 /*
- * Apply the MDCT to input samples to generate frequency coefficients.
- * This applies the KBD window and normalizes the input to reduce precision
- * loss due to fixed-point calculations.
+ * Apply the MDCT to the input samples of one channel to generate frequency
+ * coefficients. This applies the KBD window and normalizes the input to
+ * reduce precision loss due to fixed-point calculations.
+ */
+static int mdct_channel(AVCodecContext *avctx, void *arg, int ch, int threadnr)
+{
+    AC3EncodeContext *s = avctx->priv_data;
+    uint8_t * const *samples = arg;
+    SampleType *windowed_samples = (SampleType *)s->windowed_samples +
+                                   threadnr * AC3_WINDOW_SIZE;
+    const SampleType *input_samples0 = (const SampleType*)s->planar_samples[ch];
+    /* Reorder channels from native order to AC-3 order. */
+    const SampleType *input_samples1 = (const SampleType*)samples[s->channel_map[ch]];
+    int blk = 0;
+
+    do {
+        AC3Block *block = &s->blocks[blk];
+
+        s->fdsp->vector_fmul(windowed_samples, input_samples0,
+                             s->RENAME(mdct_window), AC3_BLOCK_SIZE);
+        s->fdsp->vector_fmul_reverse(windowed_samples + AC3_BLOCK_SIZE,
+                                     input_samples1,
+                                     s->RENAME(mdct_window), AC3_BLOCK_SIZE);
+
+        s->tx_fn(s->tx, block->mdct_coef[ch+1],
+                 windowed_samples, sizeof(*windowed_samples));
+        input_samples0  = input_samples1;
+        input_samples1 += AC3_BLOCK_SIZE;
+    } while (++blk < s->num_blocks);
+
+    /* Store last 256 samples of current frame */
+    memcpy(s->planar_samples[ch], input_samples0,
+           AC3_BLOCK_SIZE * sizeof(*input_samples0));
+
+    return 0;
+}
+
+
+/*
+ * Apply the MDCT to all channels, in parallel with slice threads.
  */
 static void apply_mdct(AC3EncodeContext *s, uint8_t * const *samples)
 {
     av_assert1(s->num_blocks > 0);
 
-    for (int ch = 0; ch < s->channels; ch++) {
-        const SampleType *input_samples0 = (const SampleType*)s->planar_samples[ch];
-        /* Reorder channels from native order to AC-3 order. */
-        const SampleType *input_samples1 = (const SampleType*)samples[s->channel_map[ch]];
-        int blk = 0;
-
-        do {
-            AC3Block *block = &s->blocks[blk];
-            SampleType *windowed_samples = s->RENAME(windowed_samples);
-
-            s->fdsp->vector_fmul(windowed_samples, input_samples0,
-                                 s->RENAME(mdct_window), AC3_BLOCK_SIZE);
-            s->fdsp->vector_fmul_reverse(windowed_samples + AC3_BLOCK_SIZE,
-                                         input_samples1,
-                                         s->RENAME(mdct_window), AC3_BLOCK_SIZE);
-
-            s->tx_fn(s->tx, block->mdct_coef[ch+1],
-                     windowed_samples, sizeof(*windowed_samples));
-            input_samples0  = input_samples1;
-            input_samples1 += AC3_BLOCK_SIZE;
-        } while (++blk < s->num_blocks);
-
-        /* Store last 256 samples of current frame */
-        memcpy(s->planar_samples[ch], input_samples0,
-               AC3_BLOCK_SIZE * sizeof(*input_samples0));
-    }
+    s->avctx->execute2(s->avctx, mdct_channel, (void *)samples, NULL,
+                       s->channels);
 }
 
 
@@ -43,10 +43,13 @@
 #include "bytestream.h"
 #include "adpcm.h"
 #include "adpcm_data.h"
+#include "adpcmdsp.h"
 #include "codec_internal.h"
 #include "decode.h"
 
 #include "libavutil/attributes.h"
+#include "libavutil/mem_internal.h"
+#include "libavutil/opt.h"
 
 /**
  * @file
@@ -390,12 +393,15 @@ static const float hevag_coefs[128][4] = {
 /* end of tables */
 
 typedef struct ADPCMDecodeContext {
+    const AVClass *class;
     ADPCMChannelStatus status[14];
     int table[14][16];
     int start_skip;
     int vqa_version;                /**< VQA version. Used for ADPCM_IMA_WS */
     int has_status;                 /**< Status flag. Reset to 0 after a flush. */
     int block_size;                 /**< Block size for THP codecs */
+    int blocks_per_frame;           /**< Maximum number of blocks decoded into one frame */
+    ADPCMDSPContext adsp;
 } ADPCMDecodeContext;
 
 static void adpcm_flush(AVCodecContext *avctx);
@@ -450,6 +456,7 @@ static av_cold int adpcm_decode_init(AVCodecContext * avctx)
         if (avctx->ch_layout.nb_channels <= 0)
             return AVERROR_INVALIDDATA;
         break;
+    case AV_CODEC_ID_ADPCM_IMA_WAV:
     case AV_CODEC_ID_ADPCM_IMA_WAV_MONO:
     case AV_CODEC_ID_ADPCM_IMA_DAT4:
     case AV_CODEC_ID_ADPCM_THP:
@@ -581,6 +588,9 @@ static av_cold int adpcm_decode_init(AVCodecContext * avctx)
         break;
     }
 
+    if (CONFIG_ADPCMDSP)
+        ff_adpcmdsp_init(&c->adsp);
+
     return 0;
 }
 
@@ -1810,32 +1820,181 @@ static int brr_predict(const int filter, const int p1, const int p2)
     }
 }
 
-static int adpcm_decode_frame(AVCodecContext *avctx, AVFrame *frame,
-                              int *got_frame_ptr, AVPacket *avpkt)
+#if CONFIG_ADPCMDSP
+/* bytes of channel data unpacked at once */
+#define ADPCM_CHUNK 256
+
+typedef struct ADPCMChannelJob {
+    const uint8_t *src;     ///< channel data, or the packet for NDSP
+    int16_t *samples;       ///< output plane of the channel
+    int size;               ///< size of the data pointed to by src
+    int stride;             ///< distance between the 4-byte groups of IMA WAV
+    int skip;               ///< start skip of the first NDSP block
+    int ch;
+} ADPCMChannelJob;
+
+static int decode_channels(AVCodecContext *avctx,
+                           int (*func)(AVCodecContext *avctx, void *arg),
+                           ADPCMChannelJob *jobs)
+{
+    int ret[14];
+
+    avctx->execute(avctx, func, jobs, ret, avctx->ch_layout.nb_channels,
+                   sizeof(*jobs));
+    for (int ch = 0; ch < avctx->ch_layout.nb_channels; ch++)
+        if (ret[ch] < 0)
+            return ret[ch];
+    return 0;
+}
+#endif
+
+#if CONFIG_ADPCM_IMA_WAV_DECODER || CONFIG_ADPCM_IMA_WAV_MONO_DECODER
+static int decode_ima_channel(AVCodecContext *avctx, void *arg)
+{
+    ADPCMDecodeContext *c = avctx->priv_data;
+    const ADPCMChannelJob *job = arg;
+    ADPCMChannelStatus *cs = &c->status[job->ch];
+    int16_t *samples = job->samples;
+    DECLARE_ALIGNED(16, uint8_t, buf)[ADPCM_CHUNK];
+    DECLARE_ALIGNED(16, uint8_t, nibbles)[2 * ADPCM_CHUNK];
+
+    for (int pos = 0; pos < job->size; pos += ADPCM_CHUNK) {
+        const int len = FFMIN(job->size - pos, ADPCM_CHUNK);
+        const uint8_t *src = job->src + pos;
+
+        if (job->stride != 4) {
+            for (int i = 0; i < len; i += 4)
+                memcpy(buf + i, job->src + (pos + i) / 4 * job->stride, 4);
+            src = buf;
+        }
+        c->adsp.unpack_nibbles_lo(nibbles, src, len);
+        for (int i = 0; i < 2 * len; i++)
+            *samples++ = ff_adpcm_ima_qt_expand_nibble(cs, nibbles[i]);
+    }
+
+    return 0;
+}
+#endif
+
+#if CONFIG_ADPCM_MS_DECODER
+static int decode_ms_channel(AVCodecContext *avctx, void *arg)
+{
+    ADPCMDecodeContext *c = avctx->priv_data;
+    const ADPCMChannelJob *job = arg;
+    ADPCMChannelStatus *cs = &c->status[job->ch];
+    int16_t *samples = job->samples;
+    DECLARE_ALIGNED(16, uint8_t, nibbles)[2 * ADPCM_CHUNK];
+
+    for (int pos = 0; pos < job->size; pos += ADPCM_CHUNK) {
+        const int len = FFMIN(job->size - pos, ADPCM_CHUNK);
+
+        c->adsp.unpack_nibbles_hi(nibbles, job->src + pos, len);
+        for (int i = 0; i < 2 * len; i++)
+            *samples++ = adpcm_ms_expand_nibble(cs, nibbles[i]);
+    }
+
+    return 0;
+}
+#endif
+
+#if CONFIG_ADPCM_NDSP_DECODER || CONFIG_ADPCM_NDSP_LE_DECODER
+static int decode_ndsp_channel(AVCodecContext *avctx, void *arg)
+{
+    ADPCMDecodeContext *c = avctx->priv_data;
+    const ADPCMChannelJob *job = arg;
+    const int channels = avctx->ch_layout.nb_channels;
+    const int block_align = avctx->block_align > 0 ? avctx->block_align : job->size;
+    const int *table = c->table[job->ch];
+    int sample1 = c->status[job->ch].sample1;
+    int sample2 = c->status[job->ch].sample2;
+    const uint8_t *block = job->src;
+    int16_t *samples = job->samples;
+
+    for (int left = job->size; left > 0; left -= block_align) {
+        const int block_size = FFMIN(left, block_align);
+        const int skip = left == job->size ? job->skip : 0;
+        const int nb_frames = FFMAX((block_size - skip * channels) / channels / 8, 0);
+        const uint8_t *src = block + job->ch * (skip + nb_frames * 8) + skip;
+
+        /* 8-byte frames of 14 samples, the first byte holds the
+         * coefficient index and the scale; the nibbles are read in place,
+         * the prediction is the bottleneck and not their extraction */
+        for (int pos = 0; pos < nb_frames * 8; pos += ADPCM_CHUNK) {
+            const int len = FFMIN(nb_frames * 8 - pos, ADPCM_CHUNK);
+
+            for (int i = 0; i < 2 * len; i += 16) {
+                const int index = (src[pos + i / 2] >> 4) & 0x7;
+                const int scale = 1 << (src[pos + i / 2] & 0xF);
+                const int factor1 = table[index * 2];
+                const int factor2 = table[index * 2 + 1];
+
+                for (int n = 2; n < 16; n++) {
+                    const int byte = src[pos + (i + n) / 2];
+                    int32_t sampledat = (sign_extend(n & 1 ? byte : byte >> 4, 4) * scale) << 11;
+
+                    sampledat = (sample1 * factor1 + sample2 * factor2 + 1024 + sampledat) >> 11;
+                    *samples = av_clip_int16(sampledat);
+                    sample2 = sample1;
+                    sample1 = *samples++;
+                }
+            }
+        }
+
+        block += channels * (skip + nb_frames * 8);
+    }
+
+    c->status[job->ch].sample1 = sample1;
+    c->status[job->ch].sample2 = sample2;
+
+    return 0;
+}
+#endif
+
+/**
+ * Decode a packet, or with offset >= 0 one block of a packet into the
+ * already allocated frame, starting at that sample.
+ *
+ * @return number of bytes consumed
+ */
+static int adpcm_decode_block(AVCodecContext *avctx, AVFrame *frame, int offset,
+                              const uint8_t *buf, int buf_size, int64_t pts)
 {
-    const uint8_t *buf = avpkt->data;
-    int buf_size = avpkt->size;
     ADPCMDecodeContext *c = avctx->priv_data;
     int channels = avctx->ch_layout.nb_channels;
     int16_t *samples;
     int16_t **samples_p;
+    int16_t *planes[14];
     int st; /* stereo */
     int nb_samples, coded_samples, approx_nb_samples, ret;
     GetByteContext gb;
 
     bytestream2_init(&gb, buf, buf_size);
-    nb_samples = get_nb_samples(avctx, &gb, buf_size, &coded_samples, &approx_nb_samples, avpkt->pts);
+    nb_samples = get_nb_samples(avctx, &gb, buf_size, &coded_samples, &approx_nb_samples, pts);
     if (nb_samples <= 0) {
         av_log(avctx, AV_LOG_ERROR, "invalid number of samples in packet\n");
         return AVERROR_INVALIDDATA;
     }
 
     /* get output buffer */
-    frame->nb_samples = nb_samples;
-    if ((ret = ff_get_buffer(avctx, frame, 0)) < 0)
-        return ret;
+    if (offset < 0) {
+        frame->nb_samples = nb_samples;
+        if ((ret = ff_get_buffer(avctx, frame, 0)) < 0)
+            return ret;
+        offset = 0;
+    } else if (nb_samples > frame->nb_samples - offset) {
+        return AVERROR_BUG;
+    }
     samples = (int16_t *)frame->data[0];
     samples_p = (int16_t **)frame->extended_data;
+    if (offset) {
+        if (av_sample_fmt_is_planar(frame->format)) {
+            for (int ch = 0; ch < channels; ch++)
+                planes[ch] = samples_p[ch] + offset;
+            samples_p = planes;
+        } else {
+            samples += offset * channels;
+        }
+    }
 
     /* use coded_samples when applicable */
     /* it is always <= nb_samples, so the output buffer will be large enough */
@@ -1890,6 +2049,9 @@ static int adpcm_decode_frame(AVCodecContext *avctx, AVFrame *frame,
         }
         ) /* End of CASE */
     CASE(ADPCM_IMA_WAV_MONO,
+        ADPCMChannelJob jobs[14];
+        const int size = (nb_samples - 1) / 8 * 4;
+
         for (int i = 0; i < channels; i++) {
             ADPCMChannelStatus *cs = &c->status[i];
 
@@ -1897,15 +2059,12 @@ static int adpcm_decode_frame(AVCodecContext *avctx, AVFrame *frame,
             cs->step_index = av_clip(bytestream2_get_byteu(&gb), 0, 88);
             bytestream2_skipu(&gb, 1);
 
-            for (int n = 0; n < (nb_samples - 1) / 8; n++) {
-                samples = &samples_p[i][1 + n * 8];
-                for (int m = 0; m < 8; m += 2) {
-                    int v = bytestream2_get_byteu(&gb);
-                    samples[m    ] = ff_adpcm_ima_qt_expand_nibble(cs, v & 0x0F);
-                    samples[m + 1] = ff_adpcm_ima_qt_expand_nibble(cs, v >> 4);
-                }
-            }
+            jobs[i] = (ADPCMChannelJob){ .src = buf + bytestream2_tell(&gb), .size = size,
+                                         .stride = 4, .samples = samples_p[i] + 1, .ch = i };
+            bytestream2_skipu(&gb, size);
         }
+        if ((ret = decode_channels(avctx, decode_ima_channel, jobs)) < 0)
+            return ret;
         ) /* End of CASE */
     CASE(ADPCM_IMA_WAV,
         for (int i = 0; i < channels; i++) {
@@ -1946,22 +2105,22 @@ static int adpcm_decode_frame(AVCodecContext *avctx, AVFrame *frame,
             }
             bytestream2_skip(&gb, avctx->block_align - channels * 4);
         } else {
-            for (int n = 0; n < (nb_samples - 1) / 8; n++) {
-                for (int i = 0; i < channels; i++) {
-                    ADPCMChannelStatus *cs = &c->status[i];
-                    samples = &samples_p[i][1 + n * 8];
-                    for (int m = 0; m < 8; m += 2) {
-                        int v = bytestream2_get_byteu(&gb);
-                        samples[m    ] = ff_adpcm_ima_qt_expand_nibble(cs, v & 0x0F);
-                        samples[m + 1] = ff_adpcm_ima_qt_expand_nibble(cs, v >> 4);
-                    }
-                }
-            }
+            /* the channels are interleaved in groups of 4 bytes */
+            ADPCMChannelJob jobs[14];
+            const int size = (nb_samples - 1) / 8 * 4;
+
+            for (int i = 0; i < channels; i++)
+                jobs[i] = (ADPCMChannelJob){ .src = buf + 4 * channels + 4 * i, .size = size,
+                                             .stride = 4 * channels, .samples = samples_p[i] + 1,
+                                             .ch = i };
+            if ((ret = decode_channels(avctx, decode_ima_channel, jobs)) < 0)
+                return ret;
+            bytestream2_skipu(&gb, size * channels);
         }
         ) /* End of CASE */
     CASE(ADPCM_IMA_FSB,
         {
-            int left = avpkt->size;
+            int left = buf_size;
             int block_align = (avctx->block_align > 0) ? avctx->block_align : left;
             int samples_offset = 0;
 
@@ -2011,7 +2170,7 @@ static int adpcm_decode_frame(AVCodecContext *avctx, AVFrame *frame,
         ) /* End of CASE */
     CASE(ADPCM_IMA_XBOX,
         {
-            int left = avpkt->size;
+            int left = buf_size;
             int block_align = (avctx->block_align > 0) ? avctx->block_align : left;
             int samples_offset = 0;
 
@@ -2058,7 +2217,7 @@ static int adpcm_decode_frame(AVCodecContext *avctx, AVFrame *frame,
         ) /* End of CASE */
     CASE(ADPCM_IMA_XBOX_MONO,
         {
-            int left = avpkt->size;
+            int left = buf_size;
             int block_align = (avctx->block_align > 0) ? avctx->block_align : left;
             int samples_offset = 0;
 
@@ -2135,6 +2294,9 @@ static int adpcm_decode_frame(AVCodecContext *avctx, AVFrame *frame,
         int block_predictor;
 
         if (avctx->ch_layout.nb_channels > 2) {
+            ADPCMChannelJob jobs[6];
+            const int size = FFMAX((nb_samples - 2) >> 1, 0);
+
             for (int channel = 0; channel < avctx->ch_layout.nb_channels; channel++) {
                 ADPCMChannelStatus *cs = &c->status[channel];
                 samples = samples_p[channel];
@@ -2151,12 +2313,13 @@ static int adpcm_decode_frame(AVCodecContext *avctx, AVFrame *frame,
                 cs->sample2 = sign_extend(bytestream2_get_le16u(&gb), 16);
                 *samples++ = cs->sample2;
                 *samples++ = cs->sample1;
-                for (int n = (nb_samples - 2) >> 1; n > 0; n--) {
-                    int byte = bytestream2_get_byteu(&gb);
-                    *samples++ = adpcm_ms_expand_nibble(cs, byte >> 4  );
-                    *samples++ = adpcm_ms_expand_nibble(cs, byte & 0x0F);
-                }
+
+                jobs[channel] = (ADPCMChannelJob){ .src = buf + bytestream2_tell(&gb), .size = size,
+                                                   .samples = samples, .ch = channel };
+                bytestream2_skipu(&gb, size);
             }
+            if ((ret = decode_channels(avctx, decode_ms_channel, jobs)) < 0)
+                return ret;
         } else {
             block_predictor = bytestream2_get_byteu(&gb);
             if (block_predictor > 6) {
@@ -2198,10 +2361,10 @@ static int adpcm_decode_frame(AVCodecContext *avctx, AVFrame *frame,
         }
         ) /* End of CASE */
     CASE(ADPCM_MTAF,
-        const int block_size = (avctx->block_align > 0) ? FFMIN(avctx->block_align, avpkt->size) : avpkt->size;
+        const int block_size = (avctx->block_align > 0) ? FFMIN(avctx->block_align, buf_size) : buf_size;
         const int nb_samples_per_block = block_size - 16 * (channels / 2) * 2 / channels;
 
-        for (int block = 0; block < avpkt->size / block_size; block++) {
+        for (int block = 0; block < buf_size / block_size; block++) {
             int offset = block * nb_samples_per_block;
 
             for (int channel = 0; channel < channels; channel += 2) {
@@ -2428,10 +2591,10 @@ static int adpcm_decode_frame(AVCodecContext *avctx, AVFrame *frame,
         }
         ) /* End of CASE */
     CASE(ADPCM_IMA_DAT4,
-        const int block_size = (avctx->block_align > 0) ? FFMIN(avctx->block_align, avpkt->size) : avpkt->size;
+        const int block_size = (avctx->block_align > 0) ? FFMIN(avctx->block_align, buf_size) : buf_size;
         int nb_samples_per_block = (block_size/channels - 4) * 2;
 
-        for (int block = 0; block < avpkt->size / block_size; block++) {
+        for (int block = 0; block < buf_size / block_size; block++) {
             for (int channel = 0; channel < channels; channel++) {
                 ADPCMChannelStatus *cs = &c->status[channel];
 
@@ -2559,7 +2722,7 @@ static int adpcm_decode_frame(AVCodecContext *avctx, AVFrame *frame,
         if (c->vqa_version == 3) {
             const int block_samples = avctx->block_align / channels * 2;
 
-            for (int block = 0; block < avpkt->size / avctx->block_align; block++) {
+            for (int block = 0; block < buf_size / avctx->block_align; block++) {
                 for (int channel = 0; channel < channels; channel++) {
                     int16_t *smp = samples_p[channel] + block * block_samples;
 
@@ -2593,7 +2756,7 @@ static int adpcm_decode_frame(AVCodecContext *avctx, AVFrame *frame,
         bytestream2_seek(&gb, 0, SEEK_END);
         ) /* End of CASE */
     CASE(ADPCM_IMA_DVI,
-        for (int block = 0; block < avpkt->size / FFMAX(avctx->block_align, 1); block++) {
+        for (int block = 0; block < buf_size / FFMAX(avctx->block_align, 1); block++) {
             const int nb_samples_per_block = 2 * FFMAX(avctx->block_align, 1) / channels;
 
             for (int channel = 0; channel < channels; channel++) {
@@ -2609,7 +2772,7 @@ static int adpcm_decode_frame(AVCodecContext *avctx, AVFrame *frame,
         }
         ) /* End of CASE */
     CASE(ADPCM_IMA_HWAS,
-        for (int block = 0; block < avpkt->size / FFMAX(avctx->block_align, 1); block++) {
+        for (int block = 0; block < buf_size / FFMAX(avctx->block_align, 1); block++) {
             const int nb_samples_per_block = 2 * FFMAX(avctx->block_align, 1) / channels;
 
             for (int channel = 0; channel < channels; channel++) {
@@ -2799,7 +2962,7 @@ static int adpcm_decode_frame(AVCodecContext *avctx, AVFrame *frame,
         bytestream2_skip(&gb, channels == 2 ? 2 : 3); // Skip terminating NULs
         ) /* End of CASE */
     CASE(ADPCM_EA_MAXIS_XA,
-        const int blocks = (avctx->block_align > 0) ? avpkt->size / avctx->block_align : 1;
+        const int blocks = (avctx->block_align > 0) ? buf_size / avctx->block_align : 1;
         const int block_samples = (avctx->block_align > 0) ? nb_samples / blocks : nb_samples;
 
         for (int b = 0; b < blocks; b++) {
@@ -3027,7 +3190,7 @@ static int adpcm_decode_frame(AVCodecContext *avctx, AVFrame *frame,
         ) /* End of CASE */
     CASE(ADPCM_IMA_AWC,
         const int nb_samples_per_block = (0x800 - 4) * 2;
-        const int nb_blocks = avpkt->size / channels / 0x800;
+        const int nb_blocks = buf_size / channels / 0x800;
 
         for (int i = 0; i < channels; i++) {
             int samples_offset = 0;
@@ -3216,58 +3379,14 @@ static int adpcm_decode_frame(AVCodecContext *avctx, AVFrame *frame,
     case AV_CODEC_ID_ADPCM_NDSP:
     case AV_CODEC_ID_ADPCM_NDSP_LE:
         {
-            int left = avpkt->size;
-            int block_align = (avctx->block_align > 0) ? avctx->block_align : left;
-            int samples_offset = 0;
-
-            while (left > 0) {
-                const int block_size = FFMIN(left, block_align);
-                const int start_skip = (left == avpkt->size && avpkt->pts == 0) ? c->start_skip * channels : 0;
-                const int nb_samples_per_block = 14 * ((block_size - start_skip) / channels / 8);
-
-                for (int ch = 0; ch < channels; ch++) {
-                    samples = samples_p[ch] + samples_offset;
-
-                    if (avpkt->pts == 0 && c->start_skip > 0 && left == avpkt->size)
-                        bytestream2_skip(&gb, c->start_skip);
-
-                    /* Read in every sample for this channel.  */
-                    for (int i = 0; i < nb_samples_per_block / 14; i++) {
-                        int byte = bytestream2_get_byteu(&gb);
-                        const int index = (byte >> 4) & 0x7;
-                        const int scale = 1 << (byte & 0xF);
-                        int factor1 = c->table[ch][index * 2];
-                        int factor2 = c->table[ch][index * 2 + 1];
-                        int sample1 = c->status[ch].sample1;
-                        int sample2 = c->status[ch].sample2;
-
-                        /* Decode 14 samples.  */
-                        for (int n = 0; n < 14; n++) {
-                            int32_t sampledat;
-
-                            if (n & 1) {
-                                sampledat = sign_extend(byte, 4);
-                            } else {
-                                byte = bytestream2_get_byteu(&gb);
-                                sampledat = sign_extend(byte >> 4, 4);
-                            }
+            ADPCMChannelJob jobs[14];
 
-                            sampledat = (sampledat * scale) << 11;
-                            sampledat = ((sample1 * factor1 +
-                                          sample2 * factor2 + 1024 + sampledat) >> 11);
-                            *samples = av_clip_int16(sampledat);
-                            sample2 = sample1;
-                            sample1 = *samples++;
-                        }
-
-                        c->status[ch].sample1 = sample1;
-                        c->status[ch].sample2 = sample2;
-                    }
-                }
-
-                samples_offset += nb_samples_per_block;
-                left -= block_size;
-            }
+            for (int ch = 0; ch < channels; ch++)
+                jobs[ch] = (ADPCMChannelJob){ .src = buf, .size = buf_size,
+                                              .skip = pts == 0 ? c->start_skip : 0,
+                                              .samples = samples_p[ch], .ch = ch };
+            if ((ret = decode_channels(avctx, decode_ndsp_channel, jobs)) < 0)
+                return ret;
         }
         bytestream2_seek(&gb, 0, SEEK_END);
         break;
@@ -3297,7 +3416,7 @@ static int adpcm_decode_frame(AVCodecContext *avctx, AVFrame *frame,
             samples = samples_p[ch];
 
             bytestream2_seek(&gb, pos + c->block_size * ch, SEEK_SET);
-            if (avpkt->pts == 0 && c->start_skip > 0)
+            if (pts == 0 && c->start_skip > 0)
                 bytestream2_skip(&gb, c->start_skip);
 
             /* Read in every sample for this channel.  */
@@ -3338,7 +3457,7 @@ static int adpcm_decode_frame(AVCodecContext *avctx, AVFrame *frame,
 #endif /* CONFIG_ADPCM_THP(_LE)_DECODER */
     CASE(ADPCM_NDSP_SI,
         for (int ch = 0; ch < channels; ch++) {
-            uint8_t *src = avpkt->data;
+            const uint8_t *src = buf;
             samples = samples_p[ch];
 
             /* Read in every sample for this channel.  */
@@ -3384,7 +3503,7 @@ static int adpcm_decode_frame(AVCodecContext *avctx, AVFrame *frame,
         bytestream2_seek(&gb, 0, SEEK_END);
         ) /* End of CASE */
     CASE(ADPCM_NDSP_SI1,
-        for (int block = 0; block < avpkt->size / FFMAX(avctx->block_align, 8 * channels); block++) {
+        for (int block = 0; block < buf_size / FFMAX(avctx->block_align, 8 * channels); block++) {
             for (int n = 0; n < 8; n++) {
                 for (int ch = 0; ch < channels; ch++) {
                     int byte, scale, coeff1, coeff2, sample1, sample2;
@@ -3500,7 +3619,7 @@ static int adpcm_decode_frame(AVCodecContext *avctx, AVFrame *frame,
                 coefs[n] = sign_extend(bytestream2_get_be16(&cb), 16);
         }
 
-        for (int block = 0; block < avpkt->size / 9; block++) {
+        for (int block = 0; block < buf_size / 9; block++) {
             int scale, index, codes[16];
             int16_t hist[8] = { 0 };
             const int order = 2;
@@ -3565,7 +3684,7 @@ static int adpcm_decode_frame(AVCodecContext *avctx, AVFrame *frame,
         bytestream2_seek(&gb, 0, SEEK_END);
         ) /* End of CASE */
     CASE(ADPCM_PROCYON,
-        for (int block = 0; block < avpkt->size / FFMAX(avctx->block_align, 16 * channels); block++) {
+        for (int block = 0; block < buf_size / FFMAX(avctx->block_align, 16 * channels); block++) {
             const int nb_samples_per_block = 30 * FFMAX(avctx->block_align, 16 * channels) / (16 * channels);
 
             for (int channel = 0; channel < channels; channel++) {
@@ -3614,9 +3733,9 @@ static int adpcm_decode_frame(AVCodecContext *avctx, AVFrame *frame,
         }
         ) /* End of CASE */
     CASE(ADPCM_PSX,
-        const int block_size = (avctx->block_align > 0) ? FFMIN(avctx->block_align, avpkt->size) : avpkt->size;
+        const int block_size = (avctx->block_align > 0) ? FFMIN(avctx->block_align, buf_size) : buf_size;
 
-        for (int block = 0; block < avpkt->size / block_size; block++) {
+        for (int block = 0; block < buf_size / block_size; block++) {
             int nb_samples_per_block = block_size / (16 * channels) * 28;
             for (int channel = 0; channel < channels; channel++) {
                 samples = samples_p[channel] + block * nb_samples_per_block;
@@ -3667,7 +3786,7 @@ static int adpcm_decode_frame(AVCodecContext *avctx, AVFrame *frame,
         }
         ) /* End of CASE */
     CASE(ADPCM_PSXC,
-        for (int block = 0; block < avpkt->size / avctx->block_align; block++) {
+        for (int block = 0; block < buf_size / avctx->block_align; block++) {
             int nb_samples_per_block = ((avctx->block_align - 1) / channels) * 2;
             for (int channel = 0; channel < channels; channel++) {
                 int coef1, coef2, hist1, hist2;
@@ -3711,7 +3830,7 @@ static int adpcm_decode_frame(AVCodecContext *avctx, AVFrame *frame,
         }
         ) /* End of CASE */
     CASE(ADPCM_HEVAG,
-        for (int block = 0; block < avpkt->size / FFMAX(avctx->block_align, 16 * channels); block++) {
+        for (int block = 0; block < buf_size / FFMAX(avctx->block_align, 16 * channels); block++) {
             int nb_samples_per_block = 28 * FFMAX(avctx->block_align, 16 * channels) / (16 * channels);
             for (int channel = 0; channel < channels; channel++) {
                 samples = samples_p[channel] + block * nb_samples_per_block;
@@ -3777,7 +3896,7 @@ static int adpcm_decode_frame(AVCodecContext *avctx, AVFrame *frame,
         }
         ) /* End of CASE */
     CASE(ADPCM_DSA,
-        for (int block = 0; block < avpkt->size / avctx->block_align; block++) {
+        for (int block = 0; block < buf_size / avctx->block_align; block++) {
             int nb_samples_per_block = (avctx->block_align / channels - 1) * 2;
             for (int channel = 0; channel < channels; channel++) {
                 int index, shift, byte, hist1;
@@ -3813,7 +3932,7 @@ static int adpcm_decode_frame(AVCodecContext *avctx, AVFrame *frame,
         }
         ) /* End of CASE */
     CASE(ADPCM_BRR,
-        for (int i = 0; i < avpkt->size / 9; i++) {
+        for (int i = 0; i < buf_size / 9; i++) {
             uint8_t control = bytestream2_get_byteu(&gb);
             int filter, factor, shift, hist1, hist2;
 
@@ -3857,7 +3976,7 @@ static int adpcm_decode_frame(AVCodecContext *avctx, AVFrame *frame,
         }
         ) /* End of CASE */
     CASE(ADPCM_FMOD,
-        for (int block = 0; block < avpkt->size / avctx->block_align; block++) {
+        for (int block = 0; block < buf_size / avctx->block_align; block++) {
             int nb_samples_per_block = (avctx->block_align / channels - 0xc) * 2;
             for (int channel = 0; channel < channels; channel++) {
                 uint32_t coefs, shifts;
@@ -3946,7 +4065,7 @@ static int adpcm_decode_frame(AVCodecContext *avctx, AVFrame *frame,
          * Each block relies on the previous two samples of each channel.
          * They should be 0 initially.
          */
-        for (int block = 0; block < avpkt->size / avctx->block_align; block++) {
+        for (int block = 0; block < buf_size / avctx->block_align; block++) {
             for (int channel = 0; channel < avctx->ch_layout.nb_channels; channel++) {
                 ADPCMChannelStatus *cs = c->status + channel;
                 int control, shift;
@@ -4007,21 +4126,81 @@ static int adpcm_decode_frame(AVCodecContext *avctx, AVFrame *frame,
         av_unreachable("There are cases for all codec ids using adpcm_decode_frame");
     }
 
-    if (avpkt->size && bytestream2_tell(&gb) == 0) {
+    if (buf_size && bytestream2_tell(&gb) == 0) {
         av_log(avctx, AV_LOG_ERROR, "Nothing consumed\n");
         return AVERROR_INVALIDDATA;
     }
 
-    *got_frame_ptr = 1;
-
-    if (avpkt->size < bytestream2_tell(&gb)) {
-        av_log(avctx, AV_LOG_ERROR, "Overread of %d < %d\n", avpkt->size, bytestream2_tell(&gb));
-        return avpkt->size;
+    if (buf_size < bytestream2_tell(&gb)) {
+        av_log(avctx, AV_LOG_ERROR, "Overread of %d < %d\n", buf_size, bytestream2_tell(&gb));
+        return buf_size;
     }
 
     return bytestream2_tell(&gb);
 }
 
+/* Decoders of one block per call, which may batch the blocks of a packet. */
+#define ADPCM_BATCHED(id_) ((id_) == AV_CODEC_ID_ADPCM_IMA_DK3      || \
+                            (id_) == AV_CODEC_ID_ADPCM_IMA_DK4      || \
+                            (id_) == AV_CODEC_ID_ADPCM_IMA_PDA      || \
+                            (id_) == AV_CODEC_ID_ADPCM_IMA_RAD      || \
+                            (id_) == AV_CODEC_ID_ADPCM_IMA_WAV      || \
+                            (id_) == AV_CODEC_ID_ADPCM_IMA_WAV_MONO || \
+                            (id_) == AV_CODEC_ID_ADPCM_MS)
+
+static int adpcm_decode_frame(AVCodecContext *avctx, AVFrame *frame,
+                              int *got_frame_ptr, AVPacket *avpkt)
+{
+    ADPCMDecodeContext *c = avctx->priv_data;
+    const int block_align = avctx->block_align;
+    int nb_blocks = 0, block_samples = 0, consumed = 0, ret;
+
+    if (c->blocks_per_frame > 1 && ADPCM_BATCHED(avctx->codec_id) && block_align > 0)
+        nb_blocks = FFMIN(avpkt->size / block_align, c->blocks_per_frame);
+
+    if (nb_blocks > 1) {
+        int coded_samples, approx_nb_samples;
+        GetByteContext gb;
+
+        bytestream2_init(&gb, avpkt->data, block_align);
+        block_samples = get_nb_samples(avctx, &gb, block_align, &coded_samples,
+                                       &approx_nb_samples, avpkt->pts);
+        if (coded_samples)
+            block_samples = 0;
+    }
+
+    if (block_samples <= 0) {
+        ret = adpcm_decode_block(avctx, frame, -1, avpkt->data, avpkt->size, avpkt->pts);
+        if (ret >= 0)
+            *got_frame_ptr = 1;
+        return ret;
+    }
+
+    /* Decode many small blocks into one frame, this saves the per frame
+     * overhead of the callers for bulk conversions. The blocks are consumed
+     * the same way as over several calls, so the samples do not change. */
+    frame->nb_samples = nb_blocks * block_samples;
+    if ((ret = ff_get_buffer(avctx, frame, 0)) < 0)
+        return ret;
+
+    for (int i = 0; i < nb_blocks; i++) {
+        if (avpkt->size - consumed < block_align) {
+            frame->nb_samples = i * block_samples;
+            break;
+        }
+        ret = adpcm_decode_block(avctx, frame, i * block_samples,
+                                 avpkt->data + consumed, avpkt->size - consumed,
+                                 i ? AV_NOPTS_VALUE : avpkt->pts);
+        if (ret < 0)
+            return ret;
+        consumed += ret;
+    }
+
+    *got_frame_ptr = 1;
+
+    return consumed;
+}
+
 static av_cold void adpcm_flush(AVCodecContext *avctx)
 {
     ADPCMDecodeContext *c = avctx->priv_data;
@@ -4071,6 +4250,28 @@ static const enum AVSampleFormat sample_fmts_both[] = { AV_SAMPLE_FMT_S16,
                                                         AV_SAMPLE_FMT_S16P,
                                                         AV_SAMPLE_FMT_NONE };
 
+#define OFFSET(x) offsetof(ADPCMDecodeContext, x)
+#define AD AV_OPT_FLAG_AUDIO_PARAM | AV_OPT_FLAG_DECODING_PARAM
+static const AVOption options[] = {
+    { "blocks_per_frame", "maximum number of blocks of a packet decoded into one frame",
+      OFFSET(blocks_per_frame), AV_OPT_TYPE_INT, { .i64 = 1 }, 1, INT_MAX, AD },
+    { NULL }
+};
+
+static const AVClass adpcm_batched_class = {
+    .class_name = "ADPCM decoder",
+    .item_name  = av_default_item_name,
+    .option     = options,
+    .version    = LIBAVUTIL_VERSION_INT,
+};
+
+/* Decoders which decode each channel in a separate job. */
+#define ADPCM_THREADS(id_) ((id_) == AV_CODEC_ID_ADPCM_IMA_WAV      || \
+                            (id_) == AV_CODEC_ID_ADPCM_IMA_WAV_MONO || \
+                            (id_) == AV_CODEC_ID_ADPCM_MS           || \
+                            (id_) == AV_CODEC_ID_ADPCM_NDSP         || \
+                            (id_) == AV_CODEC_ID_ADPCM_NDSP_LE ? AV_CODEC_CAP_SLICE_THREADS : 0)
+
 #define ADPCM_DECODER_0(id_, sample_fmts_, name_, long_name_)
 #define ADPCM_DECODER_1(id_, sample_fmts_, name_, long_name_) \
 const FFCodec ff_ ## name_ ## _decoder = {                  \
@@ -4078,8 +4279,9 @@ const FFCodec ff_ ## name_ ## _decoder = {                  \
     CODEC_LONG_NAME(long_name_),                            \
     .p.type         = AVMEDIA_TYPE_AUDIO,                   \
     .p.id           = id_,                                  \
-    .p.capabilities = AV_CODEC_CAP_DR1,                     \
+    .p.capabilities = AV_CODEC_CAP_DR1 | ADPCM_THREADS(id_), \
     CODEC_SAMPLEFMTS_ARRAY(sample_fmts_),                   \
+    .p.priv_class   = ADPCM_BATCHED(id_) ? &adpcm_batched_class : NULL, \
     .priv_data_size = sizeof(ADPCMDecodeContext),           \
     .init           = adpcm_decode_init,                    \
     FF_CODEC_DECODE_CB(adpcm_decode_frame),                 \
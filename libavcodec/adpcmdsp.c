@@ -0,0 +1,49 @@
+/*
+ * This file is part of Librempeg
+ *
+ * Librempeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Librempeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Librempeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "config.h"
+#include "libavutil/attributes.h"
+#include "adpcmdsp.h"
+
+static void unpack_nibbles_lo_c(uint8_t *dst, const uint8_t *src, int len)
+{
+    for (int i = 0; i < len; i++) {
+        dst[2 * i    ] = src[i] & 0x0F;
+        dst[2 * i + 1] = src[i] >> 4;
+    }
+}
+
+static void unpack_nibbles_hi_c(uint8_t *dst, const uint8_t *src, int len)
+{
+    for (int i = 0; i < len; i++) {
+        dst[2 * i    ] = src[i] >> 4;
+        dst[2 * i + 1] = src[i] & 0x0F;
+    }
+}
+
+av_cold void ff_adpcmdsp_init(ADPCMDSPContext *c)
+{
+    c->unpack_nibbles_lo = unpack_nibbles_lo_c;
+    c->unpack_nibbles_hi = unpack_nibbles_hi_c;
+
+#if ARCH_AARCH64
+    ff_adpcmdsp_init_aarch64(c);
+#elif ARCH_X86
+    ff_adpcmdsp_init_x86(c);
+#endif
+}
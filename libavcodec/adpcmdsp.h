@@ -0,0 +1,41 @@
+/*
+ * This file is part of Librempeg
+ *
+ * Librempeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Librempeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Librempeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef AVCODEC_ADPCMDSP_H
+#define AVCODEC_ADPCMDSP_H
+
+#include <stdint.h>
+
+typedef struct ADPCMDSPContext {
+    /**
+     * Split len bytes into 2 * len nibbles, the low nibble of each byte
+     * first. len is rounded up to a multiple of 16, src must be readable
+     * and dst writable up to that size.
+     */
+    void (*unpack_nibbles_lo)(uint8_t *dst, const uint8_t *src, int len);
+    /**
+     * Same as unpack_nibbles_lo, with the high nibble of each byte first.
+     */
+    void (*unpack_nibbles_hi)(uint8_t *dst, const uint8_t *src, int len);
+} ADPCMDSPContext;
+
+void ff_adpcmdsp_init(ADPCMDSPContext *c);
+void ff_adpcmdsp_init_aarch64(ADPCMDSPContext *c);
+void ff_adpcmdsp_init_x86(ADPCMDSPContext *c);
+
+#endif /* AVCODEC_ADPCMDSP_H */
@@ -150,9 +150,6 @@ typedef struct Atrac3pChanUnitCtx {
     Atrac3pWaveSynthParams wave_synth_hist[2];     ///< waves synth history for two frames
     Atrac3pWaveSynthParams *waves_info;
     Atrac3pWaveSynthParams *waves_info_prev;
-
-    Atrac3pIPQFChannelCtx ipqf_ctx[2];
-    DECLARE_ALIGNED(32, float, prev_buf)[2][ATRAC3P_FRAME_SAMPLES]; ///< overlapping buffer
 } Atrac3pChanUnitCtx;
 
 /**
@@ -177,6 +174,17 @@ int ff_atrac3p_decode_channel_unit(GetBitContext *gb, Atrac3pChanUnitCtx *ctx,
  */
 void ff_atrac3p_init_dsp_static(void);
 
+/**
+ * Reconstruct the full envelope of the sine waves of a particular subband
+ * from the truncated bitstream data. It has to be done before the tones
+ * of the subband are synthesized and is needed by the next frame.
+ *
+ * @param[in,out] ch_unit   pointer to the channel unit context
+ * @param[in]     ch_num    which channel to process
+ * @param[in]     sb        which subband to process
+ */
+void ff_atrac3p_reconstruct_envelope(Atrac3pChanUnitCtx *ch_unit, int ch_num, int sb);
+
 /**
  * Synthesize sine waves for a particular subband.
  *
@@ -186,7 +194,7 @@ void ff_atrac3p_init_dsp_static(void);
  * @param[in]   sb        which subband to process
  * @param[out]  out       receives processed data
  */
-void ff_atrac3p_generate_tones(Atrac3pChanUnitCtx *ch_unit, AVFloatDSPContext *fdsp,
+void ff_atrac3p_generate_tones(const Atrac3pChanUnitCtx *ch_unit, AVFloatDSPContext *fdsp,
                                int ch_num, int sb, float *out);
 
 /**
@@ -37,15 +37,19 @@
 #include <stdint.h>
 #include <string.h>
 
+#include "libavutil/avassert.h"
 #include "libavutil/channel_layout.h"
 #include "libavutil/float_dsp.h"
 #include "libavutil/mem.h"
 #include "libavutil/mem_internal.h"
+#include "libavutil/refstruct.h"
 #include "libavutil/thread.h"
+#include "libavutil/threadprogress.h"
 #include "avcodec.h"
 #include "codec_internal.h"
 #include "decode.h"
 #include "get_bits.h"
+#include "thread.h"
 #include "atrac.h"
 #include "atrac3plus.h"
 
@@ -60,14 +64,22 @@ static const uint8_t channel_map[8][8] = {
     { 0, 1, 2, 4, 5, 6, 7, 3, },
 };
 
+/** Synthesis history of a channel unit */
+typedef struct ATRAC3PUnitHistory {
+    Atrac3pIPQFChannelCtx ipqf_ctx[2];
+    DECLARE_ALIGNED(32, float, prev_buf)[2][ATRAC3P_FRAME_SAMPLES]; ///< overlapping buffer
+} ATRAC3PUnitHistory;
+
 typedef struct ATRAC3PContext {
     GetBitContext gb;
     AVFloatDSPContext *fdsp;
 
-    DECLARE_ALIGNED(32, float, samples)[2][ATRAC3P_FRAME_SAMPLES];  ///< quantized MDCT spectrum
-    DECLARE_ALIGNED(32, float, mdct_buf)[2][ATRAC3P_FRAME_SAMPLES]; ///< output of the IMDCT
+    /* per output channel, for all the channel units of a frame */
+    DECLARE_ALIGNED(32, float, samples)[8][ATRAC3P_FRAME_SAMPLES];  ///< quantized MDCT spectrum
+    DECLARE_ALIGNED(32, float, mdct_buf)[8][ATRAC3P_SUBBANDS][2 * ATRAC3P_SUBBAND_SAMPLES]; ///< output of the IMDCT
+    DECLARE_ALIGNED(32, float, tones_buf)[8][ATRAC3P_FRAME_SAMPLES]; ///< resynthesized tonal signal
+
     DECLARE_ALIGNED(32, float, time_buf)[2][ATRAC3P_FRAME_SAMPLES]; ///< output of the gain compensation
-    DECLARE_ALIGNED(32, float, outp_buf)[2][ATRAC3P_FRAME_SAMPLES];
 
     AtracGCContext gainc_ctx;   ///< gain compensation context
     AVTXContext *mdct_ctx;
@@ -76,10 +88,14 @@ typedef struct ATRAC3PContext {
     av_tx_fn ipqf_dct_fn;
 
     Atrac3pChanUnitCtx *ch_units;   ///< global channel units
+    ATRAC3PUnitHistory *hist;       ///< RefStruct reference, shared by all frame threads
 
     int num_channel_blocks;     ///< number of channel blocks
     uint8_t channel_blocks[5];  ///< channel configuration descriptor
     const uint8_t *channel_map; ///< channel layout map
+
+    ThreadProgress *curr_progress, *prev_progress; ///< RefStruct references
+    AVRefStructPool *progress_pool; ///< RefStruct reference
 } ATRAC3PContext;
 
 static av_cold int atrac3p_decode_close(AVCodecContext *avctx)
@@ -89,6 +105,11 @@ static av_cold int atrac3p_decode_close(AVCodecContext *avctx)
     av_freep(&ctx->ch_units);
     av_freep(&ctx->fdsp);
 
+    av_refstruct_unref(&ctx->curr_progress);
+    av_refstruct_unref(&ctx->prev_progress);
+    av_refstruct_pool_uninit(&ctx->progress_pool);
+    av_refstruct_unref(&ctx->hist);
+
     av_tx_uninit(&ctx->mdct_ctx);
     av_tx_uninit(&ctx->ipqf_dct_ctx);
 
@@ -169,6 +190,63 @@ static av_cold void atrac3p_init_static(void)
     ff_atrac3p_init_dsp_static();
 }
 
+#if HAVE_THREADS
+static void copy_channel_unit(Atrac3pChanUnitCtx *dst, const Atrac3pChanUnitCtx *src)
+{
+    memcpy(dst, src, sizeof(*dst));
+
+    for (int ch = 0; ch < 2; ch++) {
+        const Atrac3pChanParams *sch = &src->channels[ch];
+        Atrac3pChanParams *dch = &dst->channels[ch];
+        int cur;
+
+        cur = sch->wnd_shape != sch->wnd_shape_hist[0];
+        dch->wnd_shape       = dch->wnd_shape_hist[cur];
+        dch->wnd_shape_prev  = dch->wnd_shape_hist[!cur];
+        cur = sch->gain_data != sch->gain_data_hist[0];
+        dch->gain_data       = dch->gain_data_hist[cur];
+        dch->gain_data_prev  = dch->gain_data_hist[!cur];
+        cur = sch->tones_info != sch->tones_info_hist[0];
+        dch->tones_info      = dch->tones_info_hist[cur];
+        dch->tones_info_prev = dch->tones_info_hist[!cur];
+    }
+
+    dst->waves_info      = &dst->wave_synth_hist[src->waves_info != &src->wave_synth_hist[0]];
+    dst->waves_info_prev = &dst->wave_synth_hist[src->waves_info == &src->wave_synth_hist[0]];
+}
+
+static int update_thread_context(AVCodecContext *dst, const AVCodecContext *src)
+{
+    ATRAC3PContext *fsrc = src->priv_data;
+    ATRAC3PContext *fdst = dst->priv_data;
+
+    av_refstruct_replace(&fdst->curr_progress, fsrc->curr_progress);
+
+    for (int i = 0; i < fsrc->num_channel_blocks; i++)
+        copy_channel_unit(&fdst->ch_units[i], &fsrc->ch_units[i]);
+
+    return 0;
+}
+
+static av_cold int progress_pool_init_cb(AVRefStructOpaque opaque, void *obj)
+{
+    ThreadProgress *progress = obj;
+    return ff_thread_progress_init(progress, 1);
+}
+
+static void progress_pool_reset_cb(AVRefStructOpaque opaque, void *obj)
+{
+    ThreadProgress *progress = obj;
+    ff_thread_progress_reset(progress);
+}
+
+static av_cold void progress_pool_free_entry_cb(AVRefStructOpaque opaque, void *obj)
+{
+    ThreadProgress *progress = obj;
+    ff_thread_progress_destroy(progress);
+}
+#endif
+
 static av_cold int atrac3p_decode_init(AVCodecContext *avctx)
 {
     static AVOnce init_static_once = AV_ONCE_INIT;
@@ -221,6 +299,24 @@ static av_cold int atrac3p_decode_init(AVCodecContext *avctx)
         ctx->ch_units[i].waves_info_prev = &ctx->ch_units[i].wave_synth_hist[1];
     }
 
+    if (ff_thread_sync_ref(avctx, offsetof(ATRAC3PContext, hist)) != FF_THREAD_IS_COPY) {
+        ctx->hist = av_refstruct_allocz(ctx->num_channel_blocks * sizeof(*ctx->hist));
+        if (!ctx->hist)
+            return AVERROR(ENOMEM);
+    }
+
+#if HAVE_THREADS
+    if (ff_thread_sync_ref(avctx, offsetof(ATRAC3PContext, progress_pool)) == FF_THREAD_IS_FIRST_THREAD) {
+        ctx->progress_pool = av_refstruct_pool_alloc_ext(sizeof(*ctx->curr_progress),
+                                                         AV_REFSTRUCT_POOL_FLAG_FREE_ON_INIT_ERROR, NULL,
+                                                         progress_pool_init_cb,
+                                                         progress_pool_reset_cb,
+                                                         progress_pool_free_entry_cb, NULL);
+        if (!ctx->progress_pool)
+            return AVERROR(ENOMEM);
+    }
+#endif
+
     avctx->sample_fmt = AV_SAMPLE_FMT_FLTP;
 
     ff_thread_once(&init_static_once, atrac3p_init_static);
@@ -292,24 +388,70 @@ static void decode_residual_spectrum(ATRAC3PContext *ctx, Atrac3pChanUnitCtx *ch
     }
 }
 
+static int has_tones(const Atrac3pChanUnitCtx *ch_unit, int ch, int sb)
+{
+    return (ch_unit->waves_info->tones_present ||
+            ch_unit->waves_info_prev->tones_present) &&
+           (ch_unit->channels[ch].tones_info[sb].num_wavs ||
+            ch_unit->channels[ch].tones_info_prev[sb].num_wavs);
+}
+
+static void swap_history(Atrac3pChanUnitCtx *ch_unit, int num_channels)
+{
+    int ch;
+
+    /* swap window shape, gain control and tones buffers. */
+    for (ch = 0; ch < num_channels; ch++) {
+        FFSWAP(uint8_t *, ch_unit->channels[ch].wnd_shape,
+               ch_unit->channels[ch].wnd_shape_prev);
+        FFSWAP(AtracGainInfo *, ch_unit->channels[ch].gain_data,
+               ch_unit->channels[ch].gain_data_prev);
+        FFSWAP(Atrac3pWavesData *, ch_unit->channels[ch].tones_info,
+               ch_unit->channels[ch].tones_info_prev);
+    }
+
+    FFSWAP(Atrac3pWaveSynthParams *, ch_unit->waves_info, ch_unit->waves_info_prev);
+}
+
 static void reconstruct_frame(ATRAC3PContext *ctx, Atrac3pChanUnitCtx *ch_unit,
-                              int num_channels, AVCodecContext *avctx)
+                              int num_channels, int out_ch)
 {
     int ch, sb;
 
     for (ch = 0; ch < num_channels; ch++) {
-        for (sb = 0; sb < ch_unit->num_subbands; sb++) {
-            /* inverse transform and windowing */
+        float *samples  = ctx->samples[out_ch + ch];
+        float *tone_buf = ctx->tones_buf[out_ch + ch];
+
+        /* inverse transform and windowing */
+        for (sb = 0; sb < ch_unit->num_subbands; sb++)
             ff_atrac3p_imdct(ctx->fdsp, ctx->mdct_ctx, ctx->mdct_fn,
-                             &ctx->samples[ch][sb * ATRAC3P_SUBBAND_SAMPLES],
-                             &ctx->mdct_buf[ch][sb * ATRAC3P_SUBBAND_SAMPLES],
+                             &samples[sb * ATRAC3P_SUBBAND_SAMPLES],
+                             ctx->mdct_buf[out_ch + ch][sb],
                              (ch_unit->channels[ch].wnd_shape_prev[sb] << 1) +
                              ch_unit->channels[ch].wnd_shape[sb], sb);
 
+        /* resynthesize tonal signal */
+        for (sb = 0; sb < ch_unit->num_subbands; sb++)
+            if (has_tones(ch_unit, ch, sb)) {
+                memset(&tone_buf[sb * 128], 0, 128 * sizeof(*tone_buf));
+                ff_atrac3p_generate_tones(ch_unit, ctx->fdsp, ch, sb,
+                                          &tone_buf[sb * 128]);
+            }
+    }
+}
+
+static void overlap_frame(ATRAC3PContext *ctx, Atrac3pChanUnitCtx *ch_unit,
+                          ATRAC3PUnitHistory *hist, int num_channels,
+                          int out_ch, float **samples_p)
+{
+    int ch, sb;
+
+    for (ch = 0; ch < num_channels; ch++) {
+        for (sb = 0; sb < ch_unit->num_subbands; sb++) {
             /* gain compensation and overlapping */
             ff_atrac_gain_compensation(&ctx->gainc_ctx,
-                                       &ctx->mdct_buf[ch][sb * ATRAC3P_SUBBAND_SAMPLES],
-                                       &ch_unit->prev_buf[ch][sb * ATRAC3P_SUBBAND_SAMPLES],
+                                       ctx->mdct_buf[out_ch + ch][sb],
+                                       &hist->prev_buf[ch][sb * ATRAC3P_SUBBAND_SAMPLES],
                                        &ch_unit->channels[ch].gain_data_prev[sb],
                                        &ch_unit->channels[ch].gain_data[sb],
                                        ATRAC3P_SUBBAND_SAMPLES,
@@ -317,56 +459,40 @@ static void reconstruct_frame(ATRAC3PContext *ctx, Atrac3pChanUnitCtx *ch_unit,
         }
 
         /* zero unused subbands in both output and overlapping buffers */
-        memset(&ch_unit->prev_buf[ch][ch_unit->num_subbands * ATRAC3P_SUBBAND_SAMPLES],
+        memset(&hist->prev_buf[ch][ch_unit->num_subbands * ATRAC3P_SUBBAND_SAMPLES],
                0,
                (ATRAC3P_SUBBANDS - ch_unit->num_subbands) *
                ATRAC3P_SUBBAND_SAMPLES *
-               sizeof(ch_unit->prev_buf[ch][ch_unit->num_subbands * ATRAC3P_SUBBAND_SAMPLES]));
+               sizeof(hist->prev_buf[ch][ch_unit->num_subbands * ATRAC3P_SUBBAND_SAMPLES]));
         memset(&ctx->time_buf[ch][ch_unit->num_subbands * ATRAC3P_SUBBAND_SAMPLES],
                0,
                (ATRAC3P_SUBBANDS - ch_unit->num_subbands) *
                ATRAC3P_SUBBAND_SAMPLES *
                sizeof(ctx->time_buf[ch][ch_unit->num_subbands * ATRAC3P_SUBBAND_SAMPLES]));
 
-        /* resynthesize and add tonal signal */
-        if (ch_unit->waves_info->tones_present ||
-            ch_unit->waves_info_prev->tones_present) {
-            for (sb = 0; sb < ch_unit->num_subbands; sb++)
-                if (ch_unit->channels[ch].tones_info[sb].num_wavs ||
-                    ch_unit->channels[ch].tones_info_prev[sb].num_wavs) {
-                    ff_atrac3p_generate_tones(ch_unit, ctx->fdsp, ch, sb,
-                                              &ctx->time_buf[ch][sb * 128]);
-                }
-        }
+        /* add tonal signal */
+        for (sb = 0; sb < ch_unit->num_subbands; sb++)
+            if (has_tones(ch_unit, ch, sb))
+                ctx->fdsp->vector_fmac_scalar(&ctx->time_buf[ch][sb * 128],
+                                              &ctx->tones_buf[out_ch + ch][sb * 128],
+                                              1.0f, 128);
 
         /* subband synthesis and acoustic signal output */
         ff_atrac3p_ipqf(ctx->ipqf_dct_ctx, ctx->ipqf_dct_fn,
-                        &ch_unit->ipqf_ctx[ch], &ctx->time_buf[ch][0],
-                        &ctx->outp_buf[ch][0]);
+                        &hist->ipqf_ctx[ch], &ctx->time_buf[ch][0],
+                        samples_p[ctx->channel_map[out_ch + ch]]);
     }
-
-    /* swap window shape and gain control buffers. */
-    for (ch = 0; ch < num_channels; ch++) {
-        FFSWAP(uint8_t *, ch_unit->channels[ch].wnd_shape,
-               ch_unit->channels[ch].wnd_shape_prev);
-        FFSWAP(AtracGainInfo *, ch_unit->channels[ch].gain_data,
-               ch_unit->channels[ch].gain_data_prev);
-        FFSWAP(Atrac3pWavesData *, ch_unit->channels[ch].tones_info,
-               ch_unit->channels[ch].tones_info_prev);
-    }
-
-    FFSWAP(Atrac3pWaveSynthParams *, ch_unit->waves_info, ch_unit->waves_info_prev);
 }
 
 static int atrac3p_decode_frame(AVCodecContext *avctx, AVFrame *frame,
                                 int *got_frame_ptr, AVPacket *avpkt)
 {
     ATRAC3PContext *ctx = avctx->priv_data;
-    int i, ret, ch_unit_id, ch_block = 0, out_ch_index = 0, channels_to_process;
+    int i, ret, ch_unit_id, ch_block = 0, out_ch_index, channels_to_process;
     float **samples_p = (float **)frame->extended_data;
 
     frame->nb_samples = ATRAC3P_FRAME_SAMPLES;
-    if ((ret = ff_get_buffer(avctx, frame, 0)) < 0)
+    if ((ret = ff_thread_get_buffer(avctx, frame, 0)) < 0)
         return ret;
 
     if ((ret = init_get_bits8(&ctx->gb, avpkt->data, avpkt->size)) < 0)
@@ -377,41 +503,86 @@ static int atrac3p_decode_frame(AVCodecContext *avctx, AVFrame *frame,
         return AVERROR_INVALIDDATA;
     }
 
+    /* the channel units are parsed upfront, they depend on the parameters
+     * of the previous frame */
     while (get_bits_left(&ctx->gb) >= 2 &&
            (ch_unit_id = get_bits(&ctx->gb, 2)) != CH_UNIT_TERMINATOR) {
+        Atrac3pChanUnitCtx *ch_unit = &ctx->ch_units[ch_block];
+
         if (ch_unit_id == CH_UNIT_EXTENSION) {
             avpriv_report_missing_feature(avctx, "Channel unit extension");
-            return AVERROR_PATCHWELCOME;
+            ret = AVERROR_PATCHWELCOME;
+            break;
         }
         if (ch_block >= ctx->num_channel_blocks ||
             ctx->channel_blocks[ch_block] != ch_unit_id) {
             av_log(avctx, AV_LOG_ERROR,
                    "Frame data doesn't match channel configuration!\n");
-            return AVERROR_INVALIDDATA;
+            ret = AVERROR_INVALIDDATA;
+            break;
         }
 
-        ctx->ch_units[ch_block].unit_type = ch_unit_id;
-        channels_to_process               = ch_unit_id + 1;
+        ch_unit->unit_type  = ch_unit_id;
+        channels_to_process = ch_unit_id + 1;
 
-        if ((ret = ff_atrac3p_decode_channel_unit(&ctx->gb,
-                                                  &ctx->ch_units[ch_block],
+        swap_history(ch_unit, channels_to_process);
+        if ((ret = ff_atrac3p_decode_channel_unit(&ctx->gb, ch_unit,
                                                   channels_to_process,
-                                                  avctx)) < 0)
-            return ret;
-
-        decode_residual_spectrum(ctx, &ctx->ch_units[ch_block], ctx->samples,
-                                 channels_to_process, avctx);
-        reconstruct_frame(ctx, &ctx->ch_units[ch_block],
-                          channels_to_process, avctx);
+                                                  avctx)) < 0) {
+            /* a unit that failed to decode doesn't become the history */
+            swap_history(ch_unit, channels_to_process);
+            break;
+        }
 
         for (i = 0; i < channels_to_process; i++)
-            memcpy(samples_p[ctx->channel_map[out_ch_index + i]], ctx->outp_buf[i],
-                   ATRAC3P_FRAME_SAMPLES * sizeof(**samples_p));
+            for (int sb = 0; sb < ch_unit->num_subbands; sb++)
+                if (has_tones(ch_unit, i, sb))
+                    ff_atrac3p_reconstruct_envelope(ch_unit, i, sb);
 
         ch_block++;
+    }
+
+    if (ret < 0 && !ch_block)
+        return ret;
+
+    /* the units decoded before an error still update the synthesis history */
+    av_assert1(!!ctx->progress_pool == !!(avctx->active_thread_type & FF_THREAD_FRAME));
+    if (ctx->progress_pool) {
+        av_refstruct_unref(&ctx->prev_progress);
+        ctx->prev_progress = av_refstruct_pool_get(ctx->progress_pool);
+        if (!ctx->prev_progress)
+            return AVERROR(ENOMEM);
+        FFSWAP(ThreadProgress*, ctx->prev_progress, ctx->curr_progress);
+        ff_thread_finish_setup(avctx);
+    }
+
+    for (i = 0, out_ch_index = 0; i < ch_block; i++) {
+        channels_to_process = ctx->ch_units[i].unit_type + 1;
+
+        decode_residual_spectrum(ctx, &ctx->ch_units[i], &ctx->samples[out_ch_index],
+                                 channels_to_process, avctx);
+        reconstruct_frame(ctx, &ctx->ch_units[i], channels_to_process,
+                          out_ch_index);
+
         out_ch_index += channels_to_process;
     }
 
+    if (ctx->prev_progress)
+        ff_thread_progress_await(ctx->prev_progress, INT_MAX);
+    for (i = 0, out_ch_index = 0; i < ch_block; i++) {
+        channels_to_process = ctx->ch_units[i].unit_type + 1;
+
+        overlap_frame(ctx, &ctx->ch_units[i], &ctx->hist[i],
+                      channels_to_process, out_ch_index, samples_p);
+
+        out_ch_index += channels_to_process;
+    }
+    if (ctx->curr_progress)
+        ff_thread_progress_report(ctx->curr_progress, INT_MAX);
+
+    if (ret < 0)
+        return ret;
+
     *got_frame_ptr = 1;
 
     return avctx->codec_id == AV_CODEC_ID_ATRAC3P ? FFMIN(avctx->block_align, avpkt->size) : avpkt->size;
@@ -422,12 +593,13 @@ const FFCodec ff_atrac3p_decoder = {
     CODEC_LONG_NAME("ATRAC3+ (Adaptive TRansform Acoustic Coding 3+)"),
     .p.type         = AVMEDIA_TYPE_AUDIO,
     .p.id           = AV_CODEC_ID_ATRAC3P,
-    .p.capabilities = AV_CODEC_CAP_DR1,
+    .p.capabilities = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_FRAME_THREADS,
     .caps_internal  = FF_CODEC_CAP_INIT_CLEANUP,
     .priv_data_size = sizeof(ATRAC3PContext),
     .init           = atrac3p_decode_init,
     .close          = atrac3p_decode_close,
     FF_CODEC_DECODE_CB(atrac3p_decode_frame),
+    UPDATE_THREAD_CONTEXT(update_thread_context),
     .bsfs           = "atrac3plus_skip",
 };
 
@@ -436,10 +608,11 @@ const FFCodec ff_atrac3pal_decoder = {
     CODEC_LONG_NAME("ATRAC3+ AL (Adaptive TRansform Acoustic Coding 3+ Advanced Lossless)"),
     .p.type         = AVMEDIA_TYPE_AUDIO,
     .p.id           = AV_CODEC_ID_ATRAC3PAL,
-    .p.capabilities = AV_CODEC_CAP_DR1,
+    .p.capabilities = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_FRAME_THREADS,
     .caps_internal  = FF_CODEC_CAP_INIT_CLEANUP,
     .priv_data_size = sizeof(ATRAC3PContext),
     .init           = atrac3p_decode_init,
     .close          = atrac3p_decode_close,
     FF_CODEC_DECODE_CB(atrac3p_decode_frame),
+    UPDATE_THREAD_CONTEXT(update_thread_context),
 };
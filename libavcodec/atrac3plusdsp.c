@@ -116,15 +116,15 @@ av_cold void ff_atrac3p_init_dsp_static(void)
  *  @param[in]    reg_offset    region offset for trimming envelope data
  *  @param[out]   out           receives synthesized data
  */
-static void waves_synth(Atrac3pWaveSynthParams *synth_param,
-                        Atrac3pWavesData *waves_info,
-                        Atrac3pWaveEnvelope *envelope,
+static void waves_synth(const Atrac3pWaveSynthParams *synth_param,
+                        const Atrac3pWavesData *waves_info,
+                        const Atrac3pWaveEnvelope *envelope,
                         AVFloatDSPContext *fdsp,
                         int invert_phase, int reg_offset, float *out)
 {
     int i, wn, inc, pos;
     double amp;
-    Atrac3pWaveParam *wave_param = &synth_param->waves[waves_info->start_index];
+    const Atrac3pWaveParam *wave_param = &synth_param->waves[waves_info->start_index];
 
     for (wn = 0; wn < waves_info->num_wavs; wn++, wave_param++) {
         /* amplitude dequantization */
@@ -175,14 +175,10 @@ static void waves_synth(Atrac3pWaveSynthParams *synth_param,
     }
 }
 
-void ff_atrac3p_generate_tones(Atrac3pChanUnitCtx *ch_unit, AVFloatDSPContext *fdsp,
-                               int ch_num, int sb, float *out)
+void ff_atrac3p_reconstruct_envelope(Atrac3pChanUnitCtx *ch_unit, int ch_num, int sb)
 {
-    DECLARE_ALIGNED(32, float, wavreg1)[128] = { 0 };
-    DECLARE_ALIGNED(32, float, wavreg2)[128] = { 0 };
-    int i, reg1_env_nonzero, reg2_env_nonzero;
-    Atrac3pWavesData *tones_now  = &ch_unit->channels[ch_num].tones_info_prev[sb];
-    Atrac3pWavesData *tones_next = &ch_unit->channels[ch_num].tones_info[sb];
+    const Atrac3pWavesData *tones_now = &ch_unit->channels[ch_num].tones_info_prev[sb];
+    Atrac3pWavesData *tones_next      = &ch_unit->channels[ch_num].tones_info[sb];
 
     /* reconstruct full envelopes for both overlapping regions
      * from truncated bitstream data */
@@ -209,6 +205,16 @@ void ff_atrac3p_generate_tones(Atrac3pChanUnitCtx *ch_unit, AVFloatDSPContext *f
         tones_next->curr_env.has_stop_point = 0;
         tones_next->curr_env.stop_pos       = 64;
     }
+}
+
+void ff_atrac3p_generate_tones(const Atrac3pChanUnitCtx *ch_unit, AVFloatDSPContext *fdsp,
+                               int ch_num, int sb, float *out)
+{
+    DECLARE_ALIGNED(32, float, wavreg1)[128] = { 0 };
+    DECLARE_ALIGNED(32, float, wavreg2)[128] = { 0 };
+    int i, reg1_env_nonzero, reg2_env_nonzero;
+    const Atrac3pWavesData *tones_now  = &ch_unit->channels[ch_num].tones_info_prev[sb];
+    const Atrac3pWavesData *tones_next = &ch_unit->channels[ch_num].tones_info[sb];
 
     /* is the visible part of the envelope non-zero? */
     reg1_env_nonzero = (tones_now->curr_env.stop_pos    < 32) ? 0 : 1;
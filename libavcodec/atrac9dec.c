@@ -19,13 +19,17 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include "libavutil/avassert.h"
 #include "libavutil/channel_layout.h"
 #include "libavutil/mem.h"
+#include "libavutil/refstruct.h"
 #include "libavutil/thread.h"
+#include "libavutil/threadprogress.h"
 
 #include "codec_internal.h"
 #include "decode.h"
 #include "get_bits.h"
+#include "thread.h"
 #include "atrac9tab.h"
 #include "libavutil/tx.h"
 #include "libavutil/lfg.h"
@@ -52,7 +56,6 @@ typedef struct ATRAC9ChannelData {
     int32_t q_coeffs_fine[256];
 
     DECLARE_ALIGNED(32, float, coeffs  )[256];
-    DECLARE_ALIGNED(32, float, prev_win)[128];
 } ATRAC9ChannelData;
 
 typedef struct ATRAC9BlockData {
@@ -103,7 +106,15 @@ typedef struct ATRAC9Context {
     uint8_t alloc_curve[48][48];
     DECLARE_ALIGNED(32, float, imdct_win)[256];
 
-    DECLARE_ALIGNED(32, float, temp)[2048];
+    /* Spectrum and iMDCT of every frame of the packet, per output channel */
+    DECLARE_ALIGNED(32, float, spectrum)[8][4][256];
+    DECLARE_ALIGNED(32, float, imdct_out)[8][4][256];
+
+    /* Overlap, per output channel */
+    float (*prev_win)[128]; ///< RefStruct reference, shared by all frame threads
+
+    ThreadProgress *curr_progress, *prev_progress; ///< RefStruct references
+    AVRefStructPool *progress_pool; ///< RefStruct reference
 } ATRAC9Context;
 
 static const VLCElem *sf_vlc[2][8];       /* Signed/unsigned, length */
@@ -645,8 +656,7 @@ static inline void apply_band_extension(ATRAC9Context *s, ATRAC9BlockData *b,
 }
 
 static int atrac9_decode_block(ATRAC9Context *s, GetBitContext *gb,
-                               ATRAC9BlockData *b, AVFrame *frame,
-                               int frame_idx, int block_idx)
+                               ATRAC9BlockData *b, int frame_idx, int block_idx)
 {
     const int first_in_pkt = !get_bits1(gb);
     const int reuse_params =  get_bits1(gb);
@@ -774,31 +784,64 @@ static int atrac9_decode_block(ATRAC9Context *s, GetBitContext *gb,
 
 imdct:
     for (int i = 0; i <= stereo; i++) {
-        ATRAC9ChannelData *c = &b->channel[i];
         const int dst_idx = s->block_config->plane_map[block_idx][i];
-        const int wsize = 1 << s->frame_log2;
-        const ptrdiff_t offset = wsize*frame_idx*sizeof(float);
-        float *dst = (float *)(frame->extended_data[dst_idx] + offset);
 
-        s->tx_fn(s->tx, s->temp, c->coeffs, sizeof(float));
-        s->fdsp->vector_fmul_window(dst, c->prev_win, s->temp,
-                                    s->imdct_win, wsize >> 1);
-        memcpy(c->prev_win, s->temp + (wsize >> 1), sizeof(float)*wsize >> 1);
+        memcpy(s->spectrum[dst_idx][frame_idx], b->channel[i].coeffs,
+               sizeof(b->channel[i].coeffs));
     }
 
     return 0;
 }
 
+typedef struct ThreadData {
+    AVFrame *frame;
+    int nb_frames;
+} ThreadData;
+
+static int atrac9_synth_channel(AVCodecContext *avctx, void *tdata, int ch,
+                                int threadnr)
+{
+    ATRAC9Context *s = avctx->priv_data;
+    const ThreadData *td = tdata;
+    const int wsize = 1 << s->frame_log2;
+    float *dst = (float *)td->frame->extended_data[ch];
+
+    for (int i = 0; i < td->nb_frames; i++)
+        s->tx_fn(s->tx, s->imdct_out[ch][i], s->spectrum[ch][i], sizeof(float));
+
+    /* only the first frame overlaps with the previous packet */
+    for (int i = 1; i < td->nb_frames; i++)
+        s->fdsp->vector_fmul_window(dst + wsize * i, s->imdct_out[ch][i - 1] + (wsize >> 1),
+                                    s->imdct_out[ch][i], s->imdct_win, wsize >> 1);
+
+    return 0;
+}
+
+static void atrac9_overlap_channel(ATRAC9Context *s, float *dst, int ch,
+                                   int nb_frames)
+{
+    const int wsize = 1 << s->frame_log2;
+
+    if (!nb_frames)
+        return;
+
+    s->fdsp->vector_fmul_window(dst, s->prev_win[ch], s->imdct_out[ch][0],
+                                s->imdct_win, wsize >> 1);
+    memcpy(s->prev_win[ch], s->imdct_out[ch][nb_frames - 1] + (wsize >> 1),
+           sizeof(float)*wsize >> 1);
+}
+
 static int atrac9_decode_frame(AVCodecContext *avctx, AVFrame *frame,
                                int *got_frame_ptr, AVPacket *avpkt)
 {
     int ret;
     GetBitContext gb;
+    ThreadData td;
     ATRAC9Context *s = avctx->priv_data;
     const int frames = FFMIN(avpkt->size / s->avg_frame_size, s->frame_count);
 
     frame->nb_samples = (1 << s->frame_log2) * frames;
-    ret = ff_get_buffer(avctx, frame, 0);
+    ret = ff_thread_get_buffer(avctx, frame, 0);
     if (ret < 0)
         return ret;
 
@@ -808,13 +851,38 @@ static int atrac9_decode_frame(AVCodecContext *avctx, AVFrame *frame,
 
     for (int i = 0; i < frames; i++) {
         for (int j = 0; j < s->block_config->count; j++) {
-            ret = atrac9_decode_block(s, &gb, &s->block[j], frame, i, j);
+            ret = atrac9_decode_block(s, &gb, &s->block[j], i, j);
             if (ret)
                 return ret;
             align_get_bits(&gb);
         }
     }
 
+    /* the block parameters and the noise generator carry over to the next
+     * packet, so the whole packet is parsed before the next one can start */
+    av_assert1(!!s->progress_pool == !!(avctx->active_thread_type & FF_THREAD_FRAME));
+    if (s->progress_pool) {
+        av_refstruct_unref(&s->prev_progress);
+        s->prev_progress = av_refstruct_pool_get(s->progress_pool);
+        if (!s->prev_progress)
+            return AVERROR(ENOMEM);
+        FFSWAP(ThreadProgress*, s->prev_progress, s->curr_progress);
+        ff_thread_finish_setup(avctx);
+    }
+
+    /* only the synthesis is independent between the channels */
+    td.frame     = frame;
+    td.nb_frames = frames;
+    avctx->execute2(avctx, atrac9_synth_channel, &td, NULL,
+                    avctx->ch_layout.nb_channels);
+
+    if (s->prev_progress)
+        ff_thread_progress_await(s->prev_progress, INT_MAX);
+    for (int ch = 0; ch < avctx->ch_layout.nb_channels; ch++)
+        atrac9_overlap_channel(s, (float *)frame->extended_data[ch], ch, frames);
+    if (s->curr_progress)
+        ff_thread_progress_report(s->curr_progress, INT_MAX);
+
     *got_frame_ptr = 1;
 
     return frames < s->frame_count ? (get_bits_count(&gb) >> 3) : avctx->block_align;
@@ -824,14 +892,7 @@ static av_cold void atrac9_decode_flush(AVCodecContext *avctx)
 {
     ATRAC9Context *s = avctx->priv_data;
 
-    for (int j = 0; j < s->block_config->count; j++) {
-        ATRAC9BlockData *b = &s->block[j];
-        const int stereo = s->block_config->type[j] == ATRAC9_BLOCK_TYPE_CPE;
-        for (int i = 0; i <= stereo; i++) {
-            ATRAC9ChannelData *c = &b->channel[i];
-            memset(c->prev_win, 0, sizeof(c->prev_win));
-        }
-    }
+    memset(s->prev_win, 0, 8 * sizeof(*s->prev_win));
 }
 
 static av_cold int atrac9_decode_close(AVCodecContext *avctx)
@@ -841,9 +902,48 @@ static av_cold int atrac9_decode_close(AVCodecContext *avctx)
     av_tx_uninit(&s->tx);
     av_freep(&s->fdsp);
 
+    av_refstruct_unref(&s->curr_progress);
+    av_refstruct_unref(&s->prev_progress);
+    av_refstruct_pool_uninit(&s->progress_pool);
+    av_refstruct_unref(&s->prev_win);
+
+    return 0;
+}
+
+#if HAVE_THREADS
+static int atrac9_update_thread_context(AVCodecContext *dst, const AVCodecContext *src)
+{
+    ATRAC9Context *fsrc = src->priv_data;
+    ATRAC9Context *fdst = dst->priv_data;
+
+    av_refstruct_replace(&fdst->curr_progress, fsrc->curr_progress);
+
+    memcpy(fdst->block, fsrc->block,
+           fsrc->block_config->count * sizeof(*fdst->block));
+    fdst->lfg = fsrc->lfg;
+
     return 0;
 }
 
+static av_cold int progress_pool_init_cb(AVRefStructOpaque opaque, void *obj)
+{
+    ThreadProgress *progress = obj;
+    return ff_thread_progress_init(progress, 1);
+}
+
+static void progress_pool_reset_cb(AVRefStructOpaque opaque, void *obj)
+{
+    ThreadProgress *progress = obj;
+    ff_thread_progress_reset(progress);
+}
+
+static av_cold void progress_pool_free_entry_cb(AVRefStructOpaque opaque, void *obj)
+{
+    ThreadProgress *progress = obj;
+    ff_thread_progress_destroy(progress);
+}
+#endif
+
 static av_cold const VLCElem *atrac9_init_vlc(VLCInitState *state,
                                               int nb_bits, int nb_codes,
                                               const uint8_t (**tab)[2], int offset)
@@ -990,6 +1090,24 @@ static av_cold int atrac9_decode_init(AVCodecContext *avctx)
         for (int j = 0; j < i; j++)
             s->alloc_curve[i - 1][j] = at9_tab_b_dist[(j * alloc_c_len) / i];
 
+    if (ff_thread_sync_ref(avctx, offsetof(ATRAC9Context, prev_win)) != FF_THREAD_IS_COPY) {
+        s->prev_win = av_refstruct_allocz(8 * sizeof(*s->prev_win));
+        if (!s->prev_win)
+            return AVERROR(ENOMEM);
+    }
+
+#if HAVE_THREADS
+    if (ff_thread_sync_ref(avctx, offsetof(ATRAC9Context, progress_pool)) == FF_THREAD_IS_FIRST_THREAD) {
+        s->progress_pool = av_refstruct_pool_alloc_ext(sizeof(*s->curr_progress),
+                                                       AV_REFSTRUCT_POOL_FLAG_FREE_ON_INIT_ERROR, NULL,
+                                                       progress_pool_init_cb,
+                                                       progress_pool_reset_cb,
+                                                       progress_pool_free_entry_cb, NULL);
+        if (!s->progress_pool)
+            return AVERROR(ENOMEM);
+    }
+#endif
+
     ff_thread_once(&static_table_init, atrac9_init_static);
 
     return 0;
@@ -1005,6 +1123,8 @@ const FFCodec ff_atrac9_decoder = {
     .close          = atrac9_decode_close,
     FF_CODEC_DECODE_CB(atrac9_decode_frame),
     .flush          = atrac9_decode_flush,
+    UPDATE_THREAD_CONTEXT(atrac9_update_thread_context),
     .caps_internal  = FF_CODEC_CAP_INIT_CLEANUP,
-    .p.capabilities = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_CHANNEL_CONF,
+    .p.capabilities = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_CHANNEL_CONF |
+                      AV_CODEC_CAP_FRAME_THREADS | AV_CODEC_CAP_SLICE_THREADS,
 };
@@ -0,0 +1,166 @@
+/*
+ * Encoding independent packets on the shared executor
+ *
+ * This file is part of Librempeg
+ *
+ * Librempeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Librempeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Librempeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "libavutil/attributes.h"
+#include "libavutil/common.h"
+#include "libavutil/cpu.h"
+#include "libavutil/mem.h"
+
+#include "encode.h"
+#include "encode_slots.h"
+
+#define MAX_SLOTS 16
+
+av_cold int ff_encode_slots_init(FFEncodeSlots *es, AVCodecContext *avctx,
+                                 size_t slot_size, FFEncodeSlotEncodeFunc encode,
+                                 FFEncodeSlotOutputFunc output)
+{
+    int nb_threads = avctx->thread_count ? avctx->thread_count : av_cpu_count();
+
+    es->nb_slots  = av_clip(nb_threads, 1, MAX_SLOTS);
+    es->slot_size = slot_size;
+    es->encode    = encode;
+    es->output    = output;
+
+    es->slots    = av_calloc(es->nb_slots, slot_size);
+    es->jobs     = av_calloc(es->nb_slots, sizeof(*es->jobs));
+    es->in_frame = av_frame_alloc();
+    if (!es->slots || !es->jobs || !es->in_frame)
+        return AVERROR(ENOMEM);
+
+    if (es->nb_slots > 1) {
+        es->executor = av_executor_shared_acquire();
+        if (!es->executor)
+            return AVERROR(ENOMEM);
+    }
+
+    return 0;
+}
+
+av_cold void ff_encode_slots_uninit(FFEncodeSlots *es, void (*free_slot)(void *slot))
+{
+    for (int i = 0; es->jobs && i < es->nb_slots; i++) {
+        if (es->jobs[i]) {
+            av_executor_job_wait(es->jobs[i]);
+            av_executor_job_free(&es->jobs[i]);
+        }
+    }
+    for (int i = 0; free_slot && es->slots && i < es->nb_slots; i++)
+        free_slot(ff_encode_slots_get(es, i));
+
+    av_freep(&es->slots);
+    av_freep(&es->jobs);
+    av_frame_free(&es->in_frame);
+    av_executor_shared_release(&es->executor);
+    es->nb_slots   = 0;
+    es->nb_pending = 0;
+}
+
+void *ff_encode_slots_next(const FFEncodeSlots *es)
+{
+    if (es->nb_pending >= es->nb_slots)
+        return NULL;
+    return ff_encode_slots_get(es, (es->first_slot + es->nb_pending) % es->nb_slots);
+}
+
+int ff_encode_slots_submit(FFEncodeSlots *es)
+{
+    int idx = (es->first_slot + es->nb_pending) % es->nb_slots;
+    AVExecutorJob **job = &es->jobs[idx];
+
+    es->nb_pending++;
+
+    if (!es->executor)
+        return 0;
+
+    *job = av_executor_job_alloc(es->executor, es->encode,
+                                 ff_encode_slots_get(es, idx), 0);
+    if (!*job)
+        return AVERROR(ENOMEM);
+    av_executor_job_submit(*job);
+
+    return 0;
+}
+
+int ff_encode_slots_output(FFEncodeSlots *es, AVCodecContext *avctx,
+                           AVPacket *avpkt)
+{
+    void *slot = ff_encode_slots_get(es, es->first_slot);
+    AVExecutorJob **job = &es->jobs[es->first_slot];
+    int ret;
+
+    if (*job) {
+        ret = av_executor_job_wait(*job);
+        av_executor_job_free(job);
+    } else {
+        ret = es->encode(slot);
+    }
+
+    es->first_slot = (es->first_slot + 1) % es->nb_slots;
+    es->nb_pending--;
+
+    return es->output(avctx, slot, ret, avpkt);
+}
+
+int ff_encode_slots_receive_packet(FFEncodeSlots *es, AVCodecContext *avctx,
+                                   AVPacket *avpkt, FFEncodeSlotFillFunc fill)
+{
+    void *slot;
+    int ret;
+
+    while ((slot = ff_encode_slots_next(es))) {
+        ret = ff_encode_get_frame(avctx, es->in_frame);
+        if (ret == AVERROR_EOF)
+            break;
+        if (ret < 0)
+            return ret;
+
+        ret = fill(avctx, slot, es->in_frame);
+        av_frame_unref(es->in_frame);
+        if (ret < 0 || (ret = ff_encode_slots_submit(es)) < 0)
+            return ret;
+    }
+
+    if (!es->nb_pending)
+        return AVERROR_EOF;
+
+    return ff_encode_slots_output(es, avctx, avpkt);
+}
+
+int ff_encode_slots_frame_props(AVCodecContext *avctx, AVPacket *avpkt,
+                                const AVFrame *frame)
+{
+    const AVFrameSideData *sd;
+
+    avpkt->pts      = frame->pts;
+    avpkt->dts      = frame->pts;
+    avpkt->duration = frame->duration ? frame->duration :
+                      ff_samples_to_time_base(avctx, frame->nb_samples);
+
+    sd = av_frame_get_side_data(frame, AV_FRAME_DATA_SKIP_SAMPLES);
+    if (sd && sd->size >= 10) {
+        uint8_t *skip_samples = av_packet_new_side_data(avpkt, AV_PKT_DATA_SKIP_SAMPLES, 10);
+        if (!skip_samples)
+            return AVERROR(ENOMEM);
+        memcpy(skip_samples, sd->data, 10);
+    }
+
+    return ff_encode_reordered_opaque(avctx, avpkt, frame);
+}
@@ -0,0 +1,127 @@
+/*
+ * Encoding independent packets on the shared executor
+ *
+ * This file is part of Librempeg
+ *
+ * Librempeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Librempeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Librempeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef AVCODEC_ENCODE_SLOTS_H
+#define AVCODEC_ENCODE_SLOTS_H
+
+#include <stddef.h>
+
+#include "libavutil/executor.h"
+#include "libavutil/frame.h"
+
+#include "avcodec.h"
+#include "packet.h"
+
+/**
+ * Encode the input queued in a slot.
+ * Only the slot itself may be used, this may run on a worker thread.
+ *
+ * @return size of the encoded packet or a negative error code
+ */
+typedef int (*FFEncodeSlotEncodeFunc)(void *slot);
+
+/**
+ * Return the oldest slot as a packet, in input order.
+ *
+ * @param ret return value of the encode callback for this slot
+ */
+typedef int (*FFEncodeSlotOutputFunc)(AVCodecContext *avctx, void *slot,
+                                      int ret, AVPacket *avpkt);
+
+/**
+ * Move an input frame into a free slot, called in input order.
+ */
+typedef int (*FFEncodeSlotFillFunc)(AVCodecContext *avctx, void *slot,
+                                    AVFrame *frame);
+
+/**
+ * Ring of codec specific slots, one per thread. Encoders whose packets are
+ * independent of each other queue up to nb_slots of them on the shared
+ * executor and return them in input order. Without threads there is a
+ * single slot which is encoded synchronously when it is output.
+ */
+typedef struct FFEncodeSlots {
+    uint8_t *slots;
+    size_t slot_size;
+    AVExecutorJob **jobs;
+    int nb_slots;
+    int first_slot;
+    int nb_pending;
+
+    AVExecutor *executor;
+    AVFrame *in_frame;
+
+    FFEncodeSlotEncodeFunc encode;
+    FFEncodeSlotOutputFunc output;
+} FFEncodeSlots;
+
+/**
+ * Allocate nb_slots zeroed slots of slot_size bytes, nb_slots depends on
+ * avctx->thread_count. The codec initializes the slot contents afterwards.
+ */
+int ff_encode_slots_init(FFEncodeSlots *es, AVCodecContext *avctx,
+                         size_t slot_size, FFEncodeSlotEncodeFunc encode,
+                         FFEncodeSlotOutputFunc output);
+
+/**
+ * Wait for all pending slots and free the ring. free_slot, if not NULL,
+ * is called on every slot to free its contents.
+ */
+void ff_encode_slots_uninit(FFEncodeSlots *es, void (*free_slot)(void *slot));
+
+static inline void *ff_encode_slots_get(const FFEncodeSlots *es, int idx)
+{
+    return es->slots + idx * es->slot_size;
+}
+
+/**
+ * @return the next free slot, to be filled by the codec and passed to
+ *         ff_encode_slots_submit(), or NULL if all slots are pending
+ */
+void *ff_encode_slots_next(const FFEncodeSlots *es);
+
+/**
+ * Queue the slot returned by ff_encode_slots_next() for encoding.
+ */
+int ff_encode_slots_submit(FFEncodeSlots *es);
+
+/**
+ * Wait for the oldest pending slot and pass it to the output callback.
+ */
+int ff_encode_slots_output(FFEncodeSlots *es, AVCodecContext *avctx,
+                           AVPacket *avpkt);
+
+/**
+ * receive_packet helper: fill all free slots from ff_encode_get_frame(),
+ * then output the oldest one.
+ *
+ * @return AVERROR_EOF once the input is drained and no slot is pending
+ */
+int ff_encode_slots_receive_packet(FFEncodeSlots *es, AVCodecContext *avctx,
+                                   AVPacket *avpkt, FFEncodeSlotFillFunc fill);
+
+/**
+ * Set the timestamps, duration, skip samples and reordered opaque of a
+ * packet from the frame it was encoded from.
+ */
+int ff_encode_slots_frame_props(AVCodecContext *avctx, AVPacket *avpkt,
+                                const AVFrame *frame);
+
+#endif /* AVCODEC_ENCODE_SLOTS_H */
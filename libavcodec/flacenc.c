@@ -31,6 +31,7 @@
 #include "bswapdsp.h"
 #include "codec_internal.h"
 #include "encode.h"
+#include "encode_slots.h"
 #include "put_bits.h"
 #include "lpc.h"
 #include "flac.h"
@@ -103,6 +104,16 @@ typedef struct FlacFrame {
     int verbatim_only;
 } FlacFrame;
 
+/**
+ * A frame being encoded, possibly on a worker thread.
+ */
+typedef struct FlacEncodeSlot {
+    struct FlacEncodeContext *s;    ///< frame state used by the job
+    AVFrame *frame;
+    uint8_t *buf;
+    unsigned int buf_size;
+} FlacEncodeSlot;
+
 typedef struct FlacEncodeContext {
     AVClass *class;
     PutBitContext pb;
@@ -129,6 +140,9 @@ typedef struct FlacEncodeContext {
 
     int flushed;
     int64_t next_pts;
+    int last_blocksize;
+
+    FFEncodeSlots slots;
 } FlacEncodeContext;
 
 
@@ -267,6 +281,57 @@ static av_cold void dprint_compression_options(FlacEncodeContext *s)
 }
 
 
+static int encode_slot(void *opaque);
+static int output_slot(AVCodecContext *avctx, void *opaque, int out_bytes,
+                       AVPacket *avpkt);
+
+/**
+ * Set up one slot per thread. Frames are independent of each other, so
+ * several of them can be encoded at once. Without threads the only slot
+ * uses the main context, otherwise each slot gets a copy of it with its
+ * own frame and LPC state.
+ */
+static av_cold int init_slots(AVCodecContext *avctx)
+{
+    FlacEncodeContext *s = avctx->priv_data;
+    int ret;
+
+    ret = ff_encode_slots_init(&s->slots, avctx, sizeof(FlacEncodeSlot),
+                               encode_slot, output_slot);
+    if (ret < 0)
+        return ret;
+
+    for (int i = 0; i < s->slots.nb_slots; i++) {
+        FlacEncodeSlot *slot = ff_encode_slots_get(&s->slots, i);
+        FlacEncodeContext *t;
+
+        slot->frame = av_frame_alloc();
+        if (!slot->frame)
+            return AVERROR(ENOMEM);
+
+        if (s->slots.nb_slots == 1) {
+            slot->s = s;
+            continue;
+        }
+
+        t = slot->s = av_memdup(s, sizeof(*s));
+        if (!t)
+            return AVERROR(ENOMEM);
+        t->md5ctx      = NULL;
+        t->md5_buffer  = NULL;
+        memset(&t->slots,   0, sizeof(t->slots));
+        memset(&t->lpc_ctx, 0, sizeof(t->lpc_ctx));
+
+        ret = ff_lpc_init(&t->lpc_ctx, avctx->frame_size,
+                          s->options.max_prediction_order, FF_LPC_TYPE_LEVINSON);
+        if (ret < 0)
+            return ret;
+    }
+
+    return 0;
+}
+
+
 static av_cold int flac_encode_init(AVCodecContext *avctx)
 {
     int freq = avctx->sample_rate;
@@ -466,13 +531,15 @@ static av_cold int flac_encode_init(AVCodecContext *avctx)
 
     ret = ff_lpc_init(&s->lpc_ctx, avctx->frame_size,
                       s->options.max_prediction_order, FF_LPC_TYPE_LEVINSON);
+    if (ret < 0)
+        return ret;
 
     ff_bswapdsp_init(&s->bdsp);
     ff_flacencdsp_init(&s->flac_dsp);
 
     dprint_compression_options(s);
 
-    return ret;
+    return init_slots(avctx);
 }
 
 
@@ -1561,9 +1628,9 @@ static void write_frame_footer(FlacEncodeContext *s)
 }
 
 
-static int write_frame(FlacEncodeContext *s, AVPacket *avpkt)
+static int write_frame(FlacEncodeContext *s, uint8_t *buf, int buf_size)
 {
-    init_put_bits(&s->pb, avpkt->data, avpkt->size);
+    init_put_bits(&s->pb, buf, buf_size);
     write_frame_header(s);
     write_subframes(s);
     write_frame_footer(s);
@@ -1571,10 +1638,11 @@ static int write_frame(FlacEncodeContext *s, AVPacket *avpkt)
 }
 
 
-static int update_md5_sum(FlacEncodeContext *s, const void *samples)
+static int update_md5_sum(FlacEncodeContext *s, const void *samples,
+                          int nb_samples)
 {
     const uint8_t *buf;
-    int buf_size = s->frame.blocksize * s->channels *
+    int buf_size = nb_samples * s->channels *
                    ((s->avctx->bits_per_raw_sample + 7) / 8);
 
     if (s->avctx->bits_per_raw_sample > 16 || HAVE_BIGENDIAN) {
@@ -1595,7 +1663,7 @@ static int update_md5_sum(FlacEncodeContext *s, const void *samples)
         const int32_t *samples0 = samples;
         uint8_t *tmp            = s->md5_buffer;
 
-        for (i = 0; i < s->frame.blocksize * s->channels; i++) {
+        for (i = 0; i < nb_samples * s->channels; i++) {
             int32_t v = samples0[i] >> 8;
             AV_WL24(tmp + 3*i, v);
         }
@@ -1606,7 +1674,7 @@ static int update_md5_sum(FlacEncodeContext *s, const void *samples)
         const int32_t *samples0 = samples;
         uint8_t *tmp            = s->md5_buffer;
 
-        for (i = 0; i < s->frame.blocksize * s->channels; i++)
+        for (i = 0; i < nb_samples * s->channels; i++)
             AV_WL32(tmp + 4*i, samples0[i]);
         buf = s->md5_buffer;
     }
@@ -1616,42 +1684,17 @@ static int update_md5_sum(FlacEncodeContext *s, const void *samples)
 }
 
 
-static int flac_encode_frame(AVCodecContext *avctx, AVPacket *avpkt,
-                             const AVFrame *frame, int *got_packet_ptr)
+/**
+ * Encode the frame of a slot into its buffer.
+ * Only the slot's own context is used, this may run on a worker thread.
+ * @return size of the encoded frame or a negative error code
+ */
+static int encode_slot(void *opaque)
 {
-    FlacEncodeContext *s;
-    int frame_bytes, out_bytes, ret;
-
-    s = avctx->priv_data;
-
-    /* when the last block is reached, update the header in extradata */
-    if (!frame) {
-        s->max_framesize = s->max_encoded_framesize;
-        av_md5_final(s->md5ctx, s->md5sum);
-        write_streaminfo(s, avctx->extradata);
-
-        if (!s->flushed) {
-            uint8_t *side_data = av_packet_new_side_data(avpkt, AV_PKT_DATA_NEW_EXTRADATA,
-                                                         avctx->extradata_size);
-            if (!side_data)
-                return AVERROR(ENOMEM);
-            memcpy(side_data, avctx->extradata, avctx->extradata_size);
-
-            avpkt->pts = s->next_pts;
-
-            *got_packet_ptr = 1;
-            s->flushed = 1;
-        }
-
-        return 0;
-    }
-
-    /* change max_framesize for small final frame */
-    if (frame->nb_samples < s->frame.blocksize) {
-        s->max_framesize = flac_get_max_frame_size(frame->nb_samples,
-                                                   s->channels,
-                                                   avctx->bits_per_raw_sample);
-    }
+    FlacEncodeSlot *slot = opaque;
+    FlacEncodeContext *s = slot->s;
+    const AVFrame *frame = slot->frame;
+    int frame_bytes;
 
     init_frame(s, frame->nb_samples);
 
@@ -1669,40 +1712,138 @@ static int flac_encode_frame(AVCodecContext *avctx, AVPacket *avpkt,
         s->frame.verbatim_only = 1;
         frame_bytes = encode_frame(s);
         if (frame_bytes < 0) {
-            av_log(avctx, AV_LOG_ERROR, "Bad frame count\n");
+            av_log(s->avctx, AV_LOG_ERROR, "Bad frame count\n");
             return frame_bytes;
         }
     }
 
-    if ((ret = ff_get_encode_buffer(avctx, avpkt, frame_bytes, 0)) < 0)
-        return ret;
+    av_fast_malloc(&slot->buf, &slot->buf_size, frame_bytes);
+    if (!slot->buf)
+        return AVERROR(ENOMEM);
 
-    out_bytes = write_frame(s, avpkt);
+    return write_frame(s, slot->buf, frame_bytes);
+}
+
+
+/**
+ * Queue a frame for encoding. The frame number and the verbatim size
+ * limit depend on the frames before it, they are set here in input order.
+ */
+static int fill_slot(AVCodecContext *avctx, void *opaque, AVFrame *frame)
+{
+    FlacEncodeContext *s = avctx->priv_data;
+    FlacEncodeSlot *slot = opaque;
+
+    /* change max_framesize for small final frame */
+    if (frame->nb_samples < s->last_blocksize) {
+        s->max_framesize = flac_get_max_frame_size(frame->nb_samples,
+                                                   s->channels,
+                                                   s->avctx->bits_per_raw_sample);
+    }
+    s->last_blocksize = frame->nb_samples;
+
+    slot->s->frame_count   = s->frame_count + s->slots.nb_pending;
+    slot->s->max_framesize = s->max_framesize;
+    av_frame_move_ref(slot->frame, frame);
+
+    return 0;
+}
+
+
+/**
+ * Return the oldest queued frame as a packet.
+ */
+static int output_slot(AVCodecContext *avctx, void *opaque, int out_bytes,
+                       AVPacket *avpkt)
+{
+    FlacEncodeContext *s = avctx->priv_data;
+    FlacEncodeSlot *slot = opaque;
+    AVFrame *frame = slot->frame;
+    int ret;
+
+    if (out_bytes < 0) {
+        ret = out_bytes;
+        goto end;
+    }
+
+    if ((ret = ff_get_encode_buffer(avctx, avpkt, out_bytes, 0)) < 0)
+        goto end;
+    memcpy(avpkt->data, slot->buf, out_bytes);
 
     s->frame_count++;
     s->sample_count += frame->nb_samples;
-    if ((ret = update_md5_sum(s, frame->data[0])) < 0) {
+    if ((ret = update_md5_sum(s, frame->data[0], frame->nb_samples)) < 0) {
         av_log(avctx, AV_LOG_ERROR, "Error updating MD5 checksum\n");
-        return ret;
+        goto end;
     }
     if (out_bytes > s->max_encoded_framesize)
         s->max_encoded_framesize = out_bytes;
     if (out_bytes < s->min_framesize)
         s->min_framesize = out_bytes;
 
+    if ((ret = ff_encode_slots_frame_props(avctx, avpkt, frame)) < 0)
+        goto end;
+
     s->next_pts = frame->pts + ff_samples_to_time_base(avctx, frame->nb_samples);
 
-    av_shrink_packet(avpkt, out_bytes);
+end:
+    av_frame_unref(frame);
+    return ret;
+}
+
+
+static int flac_receive_packet(AVCodecContext *avctx, AVPacket *avpkt)
+{
+    FlacEncodeContext *s = avctx->priv_data;
+    uint8_t *side_data;
+    int ret;
+
+    ret = ff_encode_slots_receive_packet(&s->slots, avctx, avpkt, fill_slot);
+    if (ret != AVERROR_EOF)
+        return ret;
+
+    if (s->flushed)
+        return AVERROR_EOF;
+
+    /* when the last block is reached, update the header in extradata */
+    s->max_framesize = s->max_encoded_framesize;
+    av_md5_final(s->md5ctx, s->md5sum);
+    write_streaminfo(s, avctx->extradata);
+
+    side_data = av_packet_new_side_data(avpkt, AV_PKT_DATA_NEW_EXTRADATA,
+                                        avctx->extradata_size);
+    if (!side_data)
+        return AVERROR(ENOMEM);
+    memcpy(side_data, avctx->extradata, avctx->extradata_size);
+
+    avpkt->pts = avpkt->dts = s->next_pts;
+    s->flushed = 1;
 
-    *got_packet_ptr = 1;
     return 0;
 }
 
 
+static void free_slot(void *opaque)
+{
+    FlacEncodeSlot *slot = opaque;
+    FlacEncodeContext *s = slot->s;
+
+    av_frame_free(&slot->frame);
+    av_freep(&slot->buf);
+    /* the copies have no slots of their own, the main context does */
+    if (s && !s->slots.nb_slots) {
+        ff_lpc_end(&s->lpc_ctx);
+        av_freep(&slot->s);
+    }
+}
+
+
 static av_cold int flac_encode_close(AVCodecContext *avctx)
 {
     FlacEncodeContext *s = avctx->priv_data;
 
+    ff_encode_slots_uninit(&s->slots, free_slot);
+
     av_freep(&s->md5ctx);
     av_freep(&s->md5_buffer);
     ff_lpc_end(&s->lpc_ctx);
@@ -1754,12 +1895,13 @@ const FFCodec ff_flac_encoder = {
     .p.id           = AV_CODEC_ID_FLAC,
     .p.capabilities = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_DELAY |
                       AV_CODEC_CAP_SMALL_LAST_FRAME |
-                      AV_CODEC_CAP_ENCODER_REORDERED_OPAQUE,
+                      AV_CODEC_CAP_ENCODER_REORDERED_OPAQUE |
+                      AV_CODEC_CAP_OTHER_THREADS,
     .priv_data_size = sizeof(FlacEncodeContext),
     .init           = flac_encode_init,
-    FF_CODEC_ENCODE_CB(flac_encode_frame),
+    FF_CODEC_RECEIVE_PACKET_CB(flac_receive_packet),
     .close          = flac_encode_close,
     CODEC_SAMPLEFMTS(AV_SAMPLE_FMT_S16, AV_SAMPLE_FMT_S32),
     .p.priv_class   = &flac_encoder_class,
-    .caps_internal  = FF_CODEC_CAP_INIT_CLEANUP | FF_CODEC_CAP_EOF_FLUSH,
+    .caps_internal  = FF_CODEC_CAP_INIT_CLEANUP | FF_CODEC_CAP_AUTO_THREADS,
 };
@@ -26,6 +26,7 @@
 #include "libavutil/intmath.h"
 #include "libavutil/intreadwrite.h"
 #include "libavutil/mem.h"
+#include "libavutil/syncscan.h"
 
 #include "bytestream.h"
 #include "h264.h"
@@ -464,17 +465,15 @@ static int h264_parse_nal_header(H2645NAL *nal, void *logctx)
 
 static int find_next_start_code(const uint8_t *buf, const uint8_t *next_avc)
 {
-    int i = 0;
+    int size = next_avc - buf;
+    int i;
 
-    if (buf + 3 >= next_avc)
-        return next_avc - buf;
+    if (size <= 3)
+        return size;
 
-    while (buf + i + 3 < next_avc) {
-        if (buf[i] == 0 && buf[i + 1] == 0 && buf[i + 2] == 1)
-            break;
-        i++;
-    }
-    return i + 3;
+    /* the start code must be followed by at least one byte */
+    i = avpriv_find_start_code_prefix(buf, size - 1);
+    return i < size - 1 ? i + 3 : size;
 }
 
 static void alloc_rbsp_buffer(H2645RBSP *rbsp, unsigned int size, int use_ref)
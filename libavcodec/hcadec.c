@@ -16,10 +16,13 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include "libavutil/avassert.h"
 #include "libavutil/crc.h"
 #include "libavutil/float_dsp.h"
 #include "libavutil/mem.h"
 #include "libavutil/mem_internal.h"
+#include "libavutil/refstruct.h"
+#include "libavutil/threadprogress.h"
 #include "libavutil/tx.h"
 
 #include "avcodec.h"
@@ -28,16 +31,15 @@
 #include "decode.h"
 #include "get_bits.h"
 #include "hca_data.h"
+#include "thread.h"
 
 #define HCA_MASK 0x7f7f7f7f
 #define MAX_CHANNELS 16
+/* the M/S stereo of subframe n reads and writes up to band 127 + n */
+#define IMDCT_IN_STRIDE (128 + 8)
 
 typedef struct ChannelContext {
     DECLARE_ALIGNED(32, float, base)[128];
-    DECLARE_ALIGNED(32, float, factors)[128];
-    DECLARE_ALIGNED(32, float, imdct_in)[128];
-    DECLARE_ALIGNED(32, float, imdct_out)[128];
-    DECLARE_ALIGNED(32, float, imdct_prev)[128];
     int8_t   scale_factors[128];
     uint8_t  scale[128];
     uint8_t  noises[128];
@@ -47,13 +49,16 @@ typedef struct ChannelContext {
     int      chan_type;
     int      noise_count;
     int      valid_count;
+
+    // Per-frame scratch, not carried over to the next frame
+    DECLARE_ALIGNED(32, float, factors)[128];
+    DECLARE_ALIGNED(32, float, imdct_in)[8][IMDCT_IN_STRIDE];
+    DECLARE_ALIGNED(32, float, imdct_out)[8][128];
 } ChannelContext;
 
 typedef struct HCAContext {
     const AVCRC *crc_table;
 
-    ChannelContext ch[MAX_CHANNELS];
-
     uint8_t ath[128];
     uint8_t cipher[256];
     uint64_t key;
@@ -72,11 +77,19 @@ typedef struct HCAContext {
     uint8_t base_band_count;
     uint8_t stereo_band_count;
     uint8_t bands_per_hfr_group;
+    int     reset_overlap;
+
+    ChannelContext ch[MAX_CHANNELS];
 
     // Set during init() and freed on close(). Untouched on init_flush()
     av_tx_fn           tx_fn;
     AVTXContext       *tx_ctx;
     AVFloatDSPContext *fdsp;
+
+    float (*overlap)[64]; ///< RefStruct reference, shared by all frame threads
+
+    ThreadProgress *curr_progress, *prev_progress; ///< RefStruct references
+    AVRefStructPool *progress_pool; ///< RefStruct reference
 } HCAContext;
 
 static void cipher_init56_create_table(uint8_t *r, uint8_t key)
@@ -269,7 +282,7 @@ static int init_hca(AVCodecContext *avctx, const uint8_t *extradata,
     } else
         return AVERROR_INVALIDDATA;
 
-    if (c->total_band_count > FF_ARRAY_ELEMS(c->ch->imdct_in))
+    if (c->total_band_count > FF_ARRAY_ELEMS(c->ch->base))
         return AVERROR_INVALIDDATA;
 
     while (bytestream2_get_bytes_left(gb) >= 4) {
@@ -368,6 +381,48 @@ static int init_hca(AVCodecContext *avctx, const uint8_t *extradata,
     return 0;
 }
 
+#if HAVE_THREADS
+static int update_thread_context(AVCodecContext *dst, const AVCodecContext *src)
+{
+    HCAContext *fsrc = src->priv_data;
+    HCAContext *fdst = dst->priv_data;
+
+    av_refstruct_replace(&fdst->curr_progress, fsrc->curr_progress);
+
+    /* the header and the parts of the channel state that a frame may
+     * inherit from the previous one */
+    memcpy(fdst, fsrc, offsetof(HCAContext, ch));
+    for (int i = 0; i < src->ch_layout.nb_channels; i++) {
+        const ChannelContext *sch = &fsrc->ch[i];
+        ChannelContext *dch = &fdst->ch[i];
+
+        memcpy(dch, sch, offsetof(ChannelContext, factors));
+        if (sch->hfr_scale)
+            dch->hfr_scale = dch->scale_factors + (sch->hfr_scale - sch->scale_factors);
+    }
+
+    return 0;
+}
+
+static av_cold int progress_pool_init_cb(AVRefStructOpaque opaque, void *obj)
+{
+    ThreadProgress *progress = obj;
+    return ff_thread_progress_init(progress, 1);
+}
+
+static void progress_pool_reset_cb(AVRefStructOpaque opaque, void *obj)
+{
+    ThreadProgress *progress = obj;
+    ff_thread_progress_reset(progress);
+}
+
+static av_cold void progress_pool_free_entry_cb(AVRefStructOpaque opaque, void *obj)
+{
+    ThreadProgress *progress = obj;
+    ff_thread_progress_destroy(progress);
+}
+#endif
+
 static av_cold int decode_init(AVCodecContext *avctx)
 {
     HCAContext *c = avctx->priv_data;
@@ -390,6 +445,24 @@ static av_cold int decode_init(AVCodecContext *avctx)
     if (ret < 0)
         return ret;
 
+    if (ff_thread_sync_ref(avctx, offsetof(HCAContext, overlap)) != FF_THREAD_IS_COPY) {
+        c->overlap = av_refstruct_allocz(MAX_CHANNELS * sizeof(*c->overlap));
+        if (!c->overlap)
+            return AVERROR(ENOMEM);
+    }
+
+#if HAVE_THREADS
+    if (ff_thread_sync_ref(avctx, offsetof(HCAContext, progress_pool)) == FF_THREAD_IS_FIRST_THREAD) {
+        c->progress_pool = av_refstruct_pool_alloc_ext(sizeof(*c->curr_progress),
+                                                       AV_REFSTRUCT_POOL_FLAG_FREE_ON_INIT_ERROR, NULL,
+                                                       progress_pool_init_cb,
+                                                       progress_pool_reset_cb,
+                                                       progress_pool_free_entry_cb, NULL);
+        if (!c->progress_pool)
+            return AVERROR(ENOMEM);
+    }
+#endif
+
     if (avctx->extradata_size != 0 && avctx->extradata_size < 36)
         return AVERROR_INVALIDDATA;
 
@@ -399,14 +472,28 @@ static av_cold int decode_init(AVCodecContext *avctx)
     return init_hca(avctx, avctx->extradata, avctx->extradata_size);
 }
 
-static void run_imdct(HCAContext *c, ChannelContext *ch, int index, float *out)
+static int imdct_channel(AVCodecContext *avctx, void *arg, int ch, int threadnr)
 {
-    c->tx_fn(c->tx_ctx, ch->imdct_out, ch->imdct_in, sizeof(float));
+    HCAContext *c = avctx->priv_data;
+    ChannelContext *chc = &c->ch[ch];
+    float **samples = arg;
+
+    for (int i = 0; i < 8; i++)
+        c->tx_fn(c->tx_ctx, chc->imdct_out[i], chc->imdct_in[i], sizeof(float));
+
+    /* only the first subframe overlaps with the previous frame */
+    for (int i = 1; i < 8; i++)
+        c->fdsp->vector_fmul_window(samples[ch] + i * 128, chc->imdct_out[i - 1] + (128 >> 1),
+                                    chc->imdct_out[i], window, 128 >> 1);
 
-    c->fdsp->vector_fmul_window(out, ch->imdct_prev + (128 >> 1),
-                                ch->imdct_out, window, 128 >> 1);
+    return 0;
+}
+
+static void overlap_channel(HCAContext *c, ChannelContext *ch, float *overlap, float *out)
+{
+    c->fdsp->vector_fmul_window(out, overlap, ch->imdct_out[0], window, 128 >> 1);
 
-    memcpy(ch->imdct_prev, ch->imdct_out, 128 * sizeof(float));
+    memcpy(overlap, ch->imdct_out[7] + (128 >> 1), (128 >> 1) * sizeof(float));
 }
 
 static void apply_intensity_stereo(HCAContext *s, ChannelContext *ch1, ChannelContext *ch2,
@@ -415,8 +502,8 @@ static void apply_intensity_stereo(HCAContext *s, ChannelContext *ch1, ChannelCo
 {
     float ratio_l = intensity_ratio_table[ch2->intensity[index]];
     float ratio_r = ratio_l - 2.0f;
-    float *c1 = &ch1->imdct_in[base_band_count];
-    float *c2 = &ch2->imdct_in[base_band_count];
+    float *c1 = &ch1->imdct_in[index][base_band_count];
+    float *c2 = &ch2->imdct_in[index][base_band_count];
 
     if (ch1->chan_type != 1 || !stereo_band_count)
         return;
@@ -438,8 +525,8 @@ static void apply_ms_stereo(HCAContext *s, unsigned base_band_count,
 
     {
         const float ratio = 0.70710676908493f;
-        float *sp_l = &s->ch[0].imdct_in[subframe];
-        float *sp_r = &s->ch[1].imdct_in[subframe];
+        float *sp_l = &s->ch[0].imdct_in[subframe][subframe];
+        float *sp_r = &s->ch[1].imdct_in[subframe][subframe];
 
         for (int band = base_band_count; band < total_band_count; band++) {
             const float coef_l = (sp_l[band] + sp_r[band]) * ratio;
@@ -451,7 +538,7 @@ static void apply_ms_stereo(HCAContext *s, unsigned base_band_count,
     }
 }
 
-static void reconstruct_hfr(HCAContext *s, ChannelContext *ch,
+static void reconstruct_hfr(HCAContext *s, ChannelContext *ch, int index,
                             unsigned hfr_group_count,
                             unsigned bands_per_hfr_group,
                             unsigned start_band, unsigned total_band_count)
@@ -475,20 +562,20 @@ static void reconstruct_hfr(HCAContext *s, ChannelContext *ch,
         int lowband_sub = (i < group_limit) ? 1 : 0;
 
         for (int j = 0; j < bands_per_hfr_group && k < total_band_count && l >= 0; j++, k++, l -= lowband_sub) {
-            ch->imdct_in[k] = scale_conversion_table[ scale_conv_bias +
-                av_clip_intp2(ch->hfr_scale[i] - ch->scale_factors[l], 6) ] * ch->imdct_in[l];
+            ch->imdct_in[index][k] = scale_conversion_table[ scale_conv_bias +
+                av_clip_intp2(ch->hfr_scale[i] - ch->scale_factors[l], 6) ] * ch->imdct_in[index][l];
         }
     }
 
-    ch->imdct_in[127] = 0;
+    ch->imdct_in[index][127] = 0;
 }
 
 static void dequantize_coefficients(HCAContext *c, ChannelContext *ch,
-                                    GetBitContext *gb)
+                                    int index, GetBitContext *gb)
 {
     const float *base = ch->base;
     float *factors = ch->factors;
-    float *out = ch->imdct_in;
+    float *out = ch->imdct_in[index];
 
     for (int i = 0; i < ch->count; i++) {
         unsigned scale = ch->scale[i];
@@ -653,7 +740,7 @@ static int decode_frame(AVCodecContext *avctx, AVFrame *frame,
                         int *got_frame_ptr, AVPacket *avpkt)
 {
     HCAContext *c = avctx->priv_data;
-    int ch, offset = 0, ret, packed_noise_level;
+    int ch, offset = 0, ret, packed_noise_level, reset_overlap;
     GetBitContext gb0, *const gb = &gb0;
     float **samples;
 
@@ -665,6 +752,7 @@ static int decode_frame(AVCodecContext *avctx, AVFrame *frame,
             return AVERROR_INVALIDDATA;
         } else if (AV_RB16(avpkt->data + 6) <= avpkt->size) {
             ret = init_hca(avctx, avpkt->data, AV_RB16(avpkt->data + 6));
+            c->reset_overlap = 1;
             if (ret < 0) {
                 c->crc_table = NULL; // signal that init has not finished
                 return ret;
@@ -702,7 +790,7 @@ static int decode_frame(AVCodecContext *avctx, AVFrame *frame,
         return AVERROR_INVALIDDATA;
 
     frame->nb_samples = 1024;
-    if ((ret = ff_get_buffer(avctx, frame, 0)) < 0)
+    if ((ret = ff_thread_get_buffer(avctx, frame, 0)) < 0)
         return ret;
     samples = (float **)frame->extended_data;
 
@@ -711,11 +799,26 @@ static int decode_frame(AVCodecContext *avctx, AVFrame *frame,
     for (ch = 0; ch < avctx->ch_layout.nb_channels; ch++)
         unpack(c, &c->ch[ch], gb, c->hfr_group_count, packed_noise_level, c->ath);
 
+    reset_overlap = c->reset_overlap;
+    c->reset_overlap = 0;
+
+    /* everything the next frame inherits is known at this point, only the
+     * overlap-add with the previous frame has to wait for it */
+    av_assert1(!!c->progress_pool == !!(avctx->active_thread_type & FF_THREAD_FRAME));
+    if (c->progress_pool) {
+        av_refstruct_unref(&c->prev_progress);
+        c->prev_progress = av_refstruct_pool_get(c->progress_pool);
+        if (!c->prev_progress)
+            return AVERROR(ENOMEM);
+        FFSWAP(ThreadProgress*, c->prev_progress, c->curr_progress);
+        ff_thread_finish_setup(avctx);
+    }
+
     for (int i = 0; i < 8; i++) {
         for (ch = 0; ch < avctx->ch_layout.nb_channels; ch++)
-            dequantize_coefficients(c, &c->ch[ch], gb);
+            dequantize_coefficients(c, &c->ch[ch], i, gb);
         for (ch = 0; ch < avctx->ch_layout.nb_channels; ch++)
-            reconstruct_hfr(c, &c->ch[ch], c->hfr_group_count, c->bands_per_hfr_group,
+            reconstruct_hfr(c, &c->ch[ch], i, c->hfr_group_count, c->bands_per_hfr_group,
                             c->stereo_band_count + c->base_band_count, c->total_band_count);
         for (ch = 0; ch < avctx->ch_layout.nb_channels - 1; ch++) {
             apply_intensity_stereo(c, &c->ch[ch], &c->ch[ch+1], i,
@@ -723,10 +826,21 @@ static int decode_frame(AVCodecContext *avctx, AVFrame *frame,
                                    c->base_band_count, c->stereo_band_count);
             apply_ms_stereo(c, c->base_band_count, c->total_band_count, i);
         }
-        for (ch = 0; ch < avctx->ch_layout.nb_channels; ch++)
-            run_imdct(c, &c->ch[ch], i, samples[ch] + i * 128);
     }
 
+    /* the bitstream and the stereo coding tie the channels together up to
+     * here, the synthesis of each channel is independent */
+    avctx->execute2(avctx, imdct_channel, samples, NULL, avctx->ch_layout.nb_channels);
+
+    if (c->prev_progress)
+        ff_thread_progress_await(c->prev_progress, INT_MAX);
+    if (reset_overlap)
+        memset(c->overlap, 0, MAX_CHANNELS * sizeof(*c->overlap));
+    for (ch = 0; ch < avctx->ch_layout.nb_channels; ch++)
+        overlap_channel(c, &c->ch[ch], c->overlap[ch], samples[ch]);
+    if (c->curr_progress)
+        ff_thread_progress_report(c->curr_progress, INT_MAX);
+
     *got_frame_ptr = 1;
 
     return avpkt->size;
@@ -739,6 +853,11 @@ static av_cold int decode_close(AVCodecContext *avctx)
     av_freep(&c->fdsp);
     av_tx_uninit(&c->tx_ctx);
 
+    av_refstruct_unref(&c->curr_progress);
+    av_refstruct_unref(&c->prev_progress);
+    av_refstruct_pool_uninit(&c->progress_pool);
+    av_refstruct_unref(&c->overlap);
+
     return 0;
 }
 
@@ -746,8 +865,8 @@ static av_cold void decode_flush(AVCodecContext *avctx)
 {
     HCAContext *c = avctx->priv_data;
 
-    for (int ch = 0; ch < MAX_CHANNELS; ch++)
-        memset(c->ch[ch].imdct_prev, 0, sizeof(c->ch[ch].imdct_prev));
+    c->reset_overlap = 0;
+    memset(c->overlap, 0, MAX_CHANNELS * sizeof(*c->overlap));
 }
 
 const FFCodec ff_hca_decoder = {
@@ -760,7 +879,9 @@ const FFCodec ff_hca_decoder = {
     FF_CODEC_DECODE_CB(decode_frame),
     .flush          = decode_flush,
     .close          = decode_close,
-    .p.capabilities = AV_CODEC_CAP_DR1,
+    UPDATE_THREAD_CONTEXT(update_thread_context),
+    .p.capabilities = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_FRAME_THREADS |
+                      AV_CODEC_CAP_SLICE_THREADS,
     .caps_internal  = FF_CODEC_CAP_INIT_CLEANUP,
     CODEC_SAMPLEFMTS(AV_SAMPLE_FMT_FLTP),
 };
@@ -32,11 +32,13 @@
 #include "libavutil/crc.h"
 #include "libavutil/avstring.h"
 #include "libavutil/intmath.h"
+#include "libavutil/mem.h"
 #include "libavutil/opt.h"
 #include "libavutil/samplefmt.h"
 #include "libavutil/thread.h"
 #include "mlp_parse.h"
 #include "mlp.h"
+#include "mlpencdsp.h"
 #include "lpc.h"
 
 #define MAX_NCHANNELS (MAX_CHANNELS + 2)
@@ -131,6 +133,13 @@ typedef struct MLPSubstream {
     int32_t         coefs[MAX_CHANNELS][MAX_LPC_ORDER][MAX_LPC_ORDER];
 } MLPSubstream;
 
+/** Scratch buffers of one slice thread for the filter analysis. */
+typedef struct MLPThreadContext {
+    int32_t         filter_state[NUM_FILTERS][MAX_HEADER_INTERVAL * MAX_BLOCKSIZE];
+    int32_t         lpc_sample_buffer[MAX_HEADER_INTERVAL * MAX_BLOCKSIZE];
+    LPCContext      lpc_ctx;
+} MLPThreadContext;
+
 typedef struct MLPEncodeContext {
     AVClass        *class;
     AVCodecContext *avctx;
@@ -189,8 +198,6 @@ typedef struct MLPEncodeContext {
     uint8_t         ch8_presentation_mod;   ///< channel modifier for TrueHD stream 2
 
     MLPSubstream    s[MAX_SUBSTREAMS];
-    int32_t         filter_state[NUM_FILTERS][MAX_HEADER_INTERVAL * MAX_BLOCKSIZE];
-    int32_t         lpc_sample_buffer[MAX_HEADER_INTERVAL * MAX_BLOCKSIZE];
 
     AudioFrameQueue afq;
 
@@ -201,7 +208,10 @@ typedef struct MLPEncodeContext {
     int             shorten_by;
     uint8_t         remap_channel[MAX_CHANNELS];
 
-    LPCContext      lpc_ctx;
+    MLPThreadContext *threads;              ///< one per slice thread
+    int             nb_threads;
+
+    MLPEncDSPContext dsp;
 } MLPEncodeContext;
 
 static ChannelParams   restart_channel_params[MAX_CHANNELS];
@@ -697,9 +707,19 @@ static av_cold int mlp_encode_init(AVCodecContext *avctx)
         }
     }
 
-    if ((ret = ff_lpc_init(&ctx->lpc_ctx, ctx->avctx->frame_size,
-                           MLP_MAX_LPC_ORDER, ctx->lpc_type)) < 0)
-        return ret;
+    ctx->nb_threads = avctx->active_thread_type & FF_THREAD_SLICE ?
+                      avctx->thread_count : 1;
+    ctx->threads = av_calloc(ctx->nb_threads, sizeof(*ctx->threads));
+    if (!ctx->threads)
+        return AVERROR(ENOMEM);
+
+    for (int i = 0; i < ctx->nb_threads; i++) {
+        if ((ret = ff_lpc_init(&ctx->threads[i].lpc_ctx, ctx->avctx->frame_size,
+                               MLP_MAX_LPC_ORDER, ctx->lpc_type)) < 0)
+            return ret;
+    }
+
+    ff_mlpencdsp_init(&ctx->dsp);
 
     ff_af_queue_init(avctx, &ctx->afq);
 
@@ -1229,30 +1249,35 @@ static int write_access_unit(MLPEncodeContext *ctx, uint8_t *buf,
  *  appropriately depending on the bit-depth, and calculates the
  *  lossless_check_data that will be written to the restart header.
  */
-static void input_data_internal(MLPEncodeContext *ctx, MLPSubstream *s,
-                                uint8_t **const samples,
-                                int nb_samples, int is24)
+static av_always_inline void input_data_internal(MLPEncodeContext *ctx, MLPSubstream *s,
+                                                 uint8_t **const samples,
+                                                 int nb_samples, int is24)
 {
     int32_t *lossless_check_data = &s->b[ctx->frame_index].lossless_check_data;
     RestartHeader *rh = &s->restart_header;
     int32_t temp_lossless_check_data = 0;
     uint32_t bits = 0;
 
-    for (int i = 0; i < nb_samples; i++) {
-        for (int ch = 0; ch <= rh->max_channel; ch++) {
-            const int ch_idx = ctx->remap_channel[ch];
-            const int32_t *samples_32 = (const int32_t *)samples[ch_idx];
-            const int16_t *samples_16 = (const int16_t *)samples[ch_idx];
-            int32_t *sample_buffer = s->b[ctx->frame_index].inout_buffer[ch];
-            int32_t sample;
+    for (int ch = 0; ch <= rh->max_channel && nb_samples > 0; ch++) {
+        const int ch_idx = ctx->remap_channel[ch];
+        const int32_t *samples_32 = (const int32_t *)samples[ch_idx];
+        const int16_t *samples_16 = (const int16_t *)samples[ch_idx];
+        int32_t *sample_buffer = s->b[ctx->frame_index].inout_buffer[ch];
+        int32_t abs_bits = 0, check_data = 0;
 
-            sample = is24 ? samples_32[i] >> 8 : samples_16[i] * 256;
+        for (int i = 0; i < nb_samples; i++) {
+            int32_t sample = is24 ? samples_32[i] >> 8 : samples_16[i] * 256;
 
-            bits = FFMAX(number_sbits(sample), bits);
-
-            temp_lossless_check_data ^= (sample & 0x00ffffff) << ch;
+            abs_bits   |= FFABS(sample);
+            check_data ^= sample;
             sample_buffer[i] = sample;
         }
+
+        /* number_sbits() only depends on the highest set bit of |sample| and
+         * the check data is a xor, so both are reduced once per channel. */
+        bits = FFMAX(number_sbits(abs_bits), bits);
+
+        temp_lossless_check_data ^= (check_data & 0x00ffffff) << ch;
     }
 
     for (int ch = 0; ch <= rh->max_channel; ch++) {
@@ -1271,7 +1296,10 @@ static void input_data_internal(MLPEncodeContext *ctx, MLPSubstream *s,
 /** Wrapper function for inputting data in two different bit-depths. */
 static void input_data(MLPEncodeContext *ctx, MLPSubstream *s, uint8_t **const samples, int nb_samples)
 {
-    input_data_internal(ctx, s, samples, nb_samples, ctx->avctx->sample_fmt == AV_SAMPLE_FMT_S32P);
+    if (ctx->avctx->sample_fmt == AV_SAMPLE_FMT_S32P)
+        input_data_internal(ctx, s, samples, nb_samples, 1);
+    else
+        input_data_internal(ctx, s, samples, nb_samples, 0);
 }
 
 static void input_to_sample_buffer(MLPEncodeContext *ctx, MLPSubstream *s)
@@ -1399,7 +1427,7 @@ static void code_filter_coeffs(MLPEncodeContext *ctx, FilterParams *fp, const in
  *  necessary information to the context.
  */
 static void set_filter(MLPEncodeContext *ctx, MLPSubstream *s,
-                       int channel, int retry_filter)
+                       MLPThreadContext *t, int channel, int retry_filter)
 {
     ChannelParams *cp = &s->b[1].channel_params[channel];
     DecodingParams *dp1 = &s->b[1].decoding_params;
@@ -1411,7 +1439,7 @@ static void set_filter(MLPEncodeContext *ctx, MLPSubstream *s,
     if (dp1->max_order[channel] == 0) {
         fp->order = 0;
     } else {
-        int32_t *lpc_samples = ctx->lpc_sample_buffer;
+        int32_t *lpc_samples = t->lpc_sample_buffer;
         int32_t *fcoeff = cp->coeff[FIR];
         int shift[MAX_LPC_ORDER];
         int order;
@@ -1425,8 +1453,8 @@ static void set_filter(MLPEncodeContext *ctx, MLPSubstream *s,
             lpc_samples += dp->blocksize;
         }
 
-        order = ff_lpc_calc_coefs(&ctx->lpc_ctx, ctx->lpc_sample_buffer,
-                                  lpc_samples - ctx->lpc_sample_buffer,
+        order = ff_lpc_calc_coefs(&t->lpc_ctx, t->lpc_sample_buffer,
+                                  lpc_samples - t->lpc_sample_buffer,
                                   MLP_MIN_LPC_ORDER, dp1->max_order[channel],
                                   ctx->lpc_coeff_precision,
                                   s->coefs[channel], shift, ctx->lpc_type, ctx->lpc_passes,
@@ -1443,18 +1471,6 @@ static void set_filter(MLPEncodeContext *ctx, MLPSubstream *s,
     }
 }
 
-/** Tries to determine a good prediction filter, and applies it to the samples
- *  buffer if the filter is good enough. Sets the filter data to be cleared if
- *  no good filter was found.
- */
-static void determine_filters(MLPEncodeContext *ctx, MLPSubstream *s)
-{
-    RestartHeader *rh = s->cur_restart_header;
-
-    for (int ch = rh->min_channel; ch <= rh->max_channel; ch++)
-        set_filter(ctx, s, ch, 0);
-}
-
 static int estimate_coeff(MLPEncodeContext *ctx, MLPSubstream *s,
                           MatrixParams *mp,
                           int ch0, int ch1)
@@ -1746,62 +1762,58 @@ static inline void codebook_bits(MLPEncodeContext *ctx,
     }
 }
 
-/** Determines the least amount of bits needed to encode the samples using
- *  any or no codebook.
+/** Determines the least amount of bits needed to encode the samples of one
+ *  channel using any or no codebook.
  */
-static void determine_bits(MLPEncodeContext *ctx, MLPSubstream *s)
+static void determine_bits(MLPEncodeContext *ctx, MLPSubstream *s, int ch)
 {
-    RestartHeader *rh = s->cur_restart_header;
     for (unsigned int index = 0; index < ctx->number_of_subblocks; index++) {
         DecodingParams *dp = &s->b[index].decoding_params;
+        ChannelParams *cp = &s->b[index].channel_params[ch];
+        int32_t *sample_buffer = dp->sample_buffer[ch];
+        int32_t min = INT32_MAX, max = INT32_MIN;
+        int no_filters_used = !cp->filter_params[FIR].order;
+        int average = 0;
+        int offset = 0;
+
+        /* Determine extremes and average. */
+        for (int i = 0; i < dp->blocksize; i++) {
+            int32_t sample = sample_buffer[i] >> dp->quant_step_size[ch];
+            if (sample < min)
+                min = sample;
+            if (sample > max)
+                max = sample;
+            average += sample;
+        }
+        average /= dp->blocksize;
 
-        for (int ch = rh->min_channel; ch <= rh->max_channel; ch++) {
-            ChannelParams *cp = &s->b[index].channel_params[ch];
-            int32_t *sample_buffer = dp->sample_buffer[ch];
-            int32_t min = INT32_MAX, max = INT32_MIN;
-            int no_filters_used = !cp->filter_params[FIR].order;
-            int average = 0;
-            int offset = 0;
-
-            /* Determine extremes and average. */
-            for (int i = 0; i < dp->blocksize; i++) {
-                int32_t sample = sample_buffer[i] >> dp->quant_step_size[ch];
-                if (sample < min)
-                    min = sample;
-                if (sample > max)
-                    max = sample;
-                average += sample;
-            }
-            average /= dp->blocksize;
-
-            /* If filtering is used, we always set the offset to zero, otherwise
-             * we search for the offset that minimizes the bitcount. */
-            if (no_filters_used) {
-                no_codebook_bits(ctx, dp, ch, min, max, &s->b[index].best_offset[ch][0]);
-                offset = av_clip(average, HUFF_OFFSET_MIN, HUFF_OFFSET_MAX);
-            } else {
-                no_codebook_bits_offset(ctx, dp, ch, offset, min, max, &s->b[index].best_offset[ch][0]);
-            }
-
-            for (int i = 1; i < NUM_CODEBOOKS; i++) {
-                BestOffset temp_bo = { 0, UINT32_MAX, 0, 0, 0, };
-                int32_t offset_max;
+        /* If filtering is used, we always set the offset to zero, otherwise
+         * we search for the offset that minimizes the bitcount. */
+        if (no_filters_used) {
+            no_codebook_bits(ctx, dp, ch, min, max, &s->b[index].best_offset[ch][0]);
+            offset = av_clip(average, HUFF_OFFSET_MIN, HUFF_OFFSET_MAX);
+        } else {
+            no_codebook_bits_offset(ctx, dp, ch, offset, min, max, &s->b[index].best_offset[ch][0]);
+        }
 
-                codebook_bits_offset(ctx, dp, ch, i - 1,
-                                     min, max, offset,
-                                     &temp_bo);
+        for (int i = 1; i < NUM_CODEBOOKS; i++) {
+            BestOffset temp_bo = { 0, UINT32_MAX, 0, 0, 0, };
+            int32_t offset_max;
 
-                if (no_filters_used) {
-                    offset_max = temp_bo.max;
+            codebook_bits_offset(ctx, dp, ch, i - 1,
+                                 min, max, offset,
+                                 &temp_bo);
 
-                    codebook_bits(ctx, dp, ch, i - 1, temp_bo.min - 1,
-                                  min, max, &temp_bo, 0);
-                    codebook_bits(ctx, dp, ch, i - 1, offset_max + 1,
-                                  min, max, &temp_bo, 1);
-                }
+            if (no_filters_used) {
+                offset_max = temp_bo.max;
 
-                s->b[index].best_offset[ch][i] = temp_bo;
+                codebook_bits(ctx, dp, ch, i - 1, temp_bo.min - 1,
+                              min, max, &temp_bo, 0);
+                codebook_bits(ctx, dp, ch, i - 1, offset_max + 1,
+                              min, max, &temp_bo, 1);
             }
+
+            s->b[index].best_offset[ch][i] = temp_bo;
         }
     }
 }
@@ -1820,60 +1832,48 @@ static void determine_bits(MLPEncodeContext *ctx, MLPSubstream *s)
  *  maximum amount of bits allowed (24), the samples buffer is left as is and
  *  the function returns -1.
  */
-static int apply_filter(MLPEncodeContext *ctx, MLPSubstream *s, int channel)
+static int apply_filter(MLPEncodeContext *ctx, MLPSubstream *s,
+                        MLPThreadContext *t, int channel)
 {
     DecodingParams *dp = &s->b[1].decoding_params;
     ChannelParams *cp = &s->b[1].channel_params[channel];
-    FilterParams *fp[NUM_FILTERS] = { &cp->filter_params[FIR],
-                                      &cp->filter_params[IIR], };
+    FilterParams *fp = &cp->filter_params[FIR];
     const uint8_t codebook = cp->codebook;
     int32_t mask = MSB_MASK(dp->quant_step_size[channel]);
     int32_t *sample_buffer = s->b[0].decoding_params.sample_buffer[channel];
-    unsigned int filter_shift = fp[FIR]->shift;
-    int32_t *filter_state[NUM_FILTERS] = { ctx->filter_state[FIR],
-                                           ctx->filter_state[IIR], };
-    int i, j = 1, k = 0;
-
-    for (i = 0; i < 8; i++) {
-        filter_state[FIR][i] = sample_buffer[i];
-        filter_state[IIR][i] = sample_buffer[i];
+    int32_t *samples  = t->filter_state[FIR];
+    int32_t *residual = t->filter_state[IIR];
+    int nb_samples = 8;
+
+    for (int i = 0; i < 8; i++) {
+        samples[i]  = sample_buffer[i];
+        residual[i] = sample_buffer[i];
     }
 
-    while (1) {
+    for (int j = 1; j <= ctx->cur_restart_interval; j++) {
         int32_t *sample_buffer = s->b[j].decoding_params.sample_buffer[channel];
         unsigned int blocksize = s->b[j].decoding_params.blocksize;
-        int32_t sample, residual;
-        int64_t accum = 0;
 
         if (!blocksize)
             break;
 
-        for (int filter = 0; filter < NUM_FILTERS; filter++) {
-            int32_t *fcoeff = cp->coeff[filter];
-            for (unsigned int order = 0; order < fp[filter]->order; order++)
-                accum += (int64_t)filter_state[filter][i - 1 - order] *
-                    fcoeff[order];
-        }
-
-        sample = sample_buffer[k];
-        accum  >>= filter_shift;
-        residual = sample - (accum & mask);
-
-        if ((codebook > 0) &&
-            (residual < SAMPLE_MIN(24) ||
-             residual > SAMPLE_MAX(24)))
-            return -1;
-
-        filter_state[FIR][i] = sample;
-        filter_state[IIR][i] = residual;
+        memcpy(samples + nb_samples, sample_buffer, blocksize * sizeof(*samples));
+        nb_samples += blocksize;
+    }
 
-        i++;
-        k++;
-        if (k >= blocksize) {
-            k = 0;
-            j++;
-            if (j > ctx->cur_restart_interval)
-                break;
+    /* The encoder only uses FIR filters, so the residuals do not depend on
+     * each other. Block sizes are multiples of 8. */
+    if (fp->order)
+        ctx->dsp.fir_residual(residual + 8, samples + 8, cp->coeff[FIR],
+                              fp->order, fp->shift, mask, nb_samples - 8);
+    else
+        memcpy(residual + 8, samples + 8, (nb_samples - 8) * sizeof(*residual));
+
+    if (codebook > 0) {
+        for (int i = 8; i < nb_samples; i++) {
+            if (residual[i] < SAMPLE_MIN(24) ||
+                residual[i] > SAMPLE_MAX(24))
+                return -1;
         }
     }
 
@@ -1881,23 +1881,61 @@ static int apply_filter(MLPEncodeContext *ctx, MLPSubstream *s, int channel)
         int32_t *sample_buffer = s->b[j].decoding_params.sample_buffer[channel];
         unsigned int blocksize = s->b[j].decoding_params.blocksize;
 
+        if (!blocksize)
+            break;
+
         for (int i = 0; i < blocksize; i++, l++)
-            sample_buffer[i] = filter_state[IIR][l];
+            sample_buffer[i] = residual[l];
+    }
+
+    return 0;
+}
+
+static int apply_filters_ch(AVCodecContext *avctx, void *arg, int jobnr, int threadnr)
+{
+    MLPEncodeContext *ctx = avctx->priv_data;
+    MLPSubstream *s = arg;
+    MLPThreadContext *t = &ctx->threads[threadnr];
+    int ch = s->cur_restart_header->min_channel + jobnr;
+
+    while (apply_filter(ctx, s, t, ch) < 0) {
+        /* Filter is horribly wrong. Retry. */
+        set_filter(ctx, s, t, ch, 1);
     }
 
     return 0;
 }
 
+/** Applies the filters of all channels, in parallel with slice threads. */
 static void apply_filters(MLPEncodeContext *ctx, MLPSubstream *s)
 {
     RestartHeader *rh = s->cur_restart_header;
 
-    for (int ch = rh->min_channel; ch <= rh->max_channel; ch++) {
-        while (apply_filter(ctx, s, ch) < 0) {
-            /* Filter is horribly wrong. Retry. */
-            set_filter(ctx, s, ch, 1);
-        }
-    }
+    ctx->avctx->execute2(ctx->avctx, apply_filters_ch, s, NULL,
+                         rh->max_channel - rh->min_channel + 1);
+}
+
+static int determine_filters_ch(AVCodecContext *avctx, void *arg, int jobnr, int threadnr)
+{
+    MLPEncodeContext *ctx = avctx->priv_data;
+    MLPSubstream *s = arg;
+
+    set_filter(ctx, s, &ctx->threads[threadnr],
+               s->cur_restart_header->min_channel + jobnr, 0);
+
+    return apply_filters_ch(avctx, arg, jobnr, threadnr);
+}
+
+/** Tries to determine a good prediction filter, and applies it to the samples
+ *  buffer if the filter is good enough. Sets the filter data to be cleared if
+ *  no good filter was found.
+ */
+static void determine_filters(MLPEncodeContext *ctx, MLPSubstream *s)
+{
+    RestartHeader *rh = s->cur_restart_header;
+
+    ctx->avctx->execute2(ctx->avctx, determine_filters_ch, s, NULL,
+                         rh->max_channel - rh->min_channel + 1);
 }
 
 /** Generates two noise channels worth of data. */
@@ -2025,83 +2063,100 @@ static uint32_t best_codebook_path_cost(MLPEncodeContext *ctx, MLPSubstream *s,
     return bitcount;
 }
 
-static void set_best_codebook(MLPEncodeContext *ctx, MLPSubstream *s)
+static void set_best_codebook(MLPEncodeContext *ctx, MLPSubstream *s, int channel)
 {
-    RestartHeader *rh = s->cur_restart_header;
+    const BestOffset *prev_bo = restart_best_offset;
+    BestOffset *cur_bo;
+    PathCounter path_counter[NUM_CODEBOOKS + 1];
+    unsigned int best_codebook;
+    char *best_path;
+
+    clear_path_counter(path_counter);
+
+    for (unsigned int index = 0; index < ctx->number_of_subblocks; index++) {
+        uint32_t best_bitcount = UINT32_MAX;
+
+        cur_bo = s->b[index].best_offset[channel];
+
+        for (unsigned int codebook = 0; codebook < NUM_CODEBOOKS; codebook++) {
+            uint32_t prev_best_bitcount = UINT32_MAX;
+
+            for (unsigned int last_best = 0; last_best < 2; last_best++) {
+                PathCounter *dst_path = &path_counter[codebook];
+                PathCounter *src_path;
+                uint32_t temp_bitcount;
 
-    for (int channel = rh->min_channel; channel <= rh->max_channel; channel++) {
-        const BestOffset *prev_bo = restart_best_offset;
-        BestOffset *cur_bo;
-        PathCounter path_counter[NUM_CODEBOOKS + 1];
-        unsigned int best_codebook;
-        char *best_path;
-
-        clear_path_counter(path_counter);
-
-        for (unsigned int index = 0; index < ctx->number_of_subblocks; index++) {
-            uint32_t best_bitcount = UINT32_MAX;
-
-            cur_bo = s->b[index].best_offset[channel];
-
-            for (unsigned int codebook = 0; codebook < NUM_CODEBOOKS; codebook++) {
-                uint32_t prev_best_bitcount = UINT32_MAX;
-
-                for (unsigned int last_best = 0; last_best < 2; last_best++) {
-                    PathCounter *dst_path = &path_counter[codebook];
-                    PathCounter *src_path;
-                    uint32_t temp_bitcount;
-
-                    /* First test last path with same headers,
-                     * then with last best. */
-                    if (last_best) {
-                        src_path = &path_counter[NUM_CODEBOOKS];
-                    } else {
-                        if (compare_best_offset(&prev_bo[codebook], &cur_bo[codebook]))
-                            continue;
-                        else
-                            src_path = &path_counter[codebook];
-                    }
-
-                    temp_bitcount = best_codebook_path_cost(ctx, s, channel, src_path, codebook);
-
-                    if (temp_bitcount < best_bitcount) {
-                        best_bitcount = temp_bitcount;
-                        best_codebook = codebook;
-                    }
-
-                    if (temp_bitcount < prev_best_bitcount) {
-                        prev_best_bitcount = temp_bitcount;
-                        if (src_path != dst_path)
-                            memcpy(dst_path, src_path, sizeof(PathCounter));
-                        if (dst_path->cur_idx < FF_ARRAY_ELEMS(dst_path->path) - 1)
-                            dst_path->path[++dst_path->cur_idx] = codebook;
-                        dst_path->bitcount = temp_bitcount;
-                    }
+                /* First test last path with same headers,
+                 * then with last best. */
+                if (last_best) {
+                    src_path = &path_counter[NUM_CODEBOOKS];
+                } else {
+                    if (compare_best_offset(&prev_bo[codebook], &cur_bo[codebook]))
+                        continue;
+                    else
+                        src_path = &path_counter[codebook];
                 }
-            }
 
-            prev_bo = cur_bo;
+                temp_bitcount = best_codebook_path_cost(ctx, s, channel, src_path, codebook);
+
+                if (temp_bitcount < best_bitcount) {
+                    best_bitcount = temp_bitcount;
+                    best_codebook = codebook;
+                }
 
-            memcpy(&path_counter[NUM_CODEBOOKS], &path_counter[best_codebook], sizeof(PathCounter));
+                if (temp_bitcount < prev_best_bitcount) {
+                    prev_best_bitcount = temp_bitcount;
+                    if (src_path != dst_path)
+                        memcpy(dst_path, src_path, sizeof(PathCounter));
+                    if (dst_path->cur_idx < FF_ARRAY_ELEMS(dst_path->path) - 1)
+                        dst_path->path[++dst_path->cur_idx] = codebook;
+                    dst_path->bitcount = temp_bitcount;
+                }
+            }
         }
 
-        best_path = path_counter[NUM_CODEBOOKS].path + 1;
+        prev_bo = cur_bo;
 
-        /* Update context. */
-        for (unsigned int index = 0; index < ctx->number_of_subblocks; index++) {
-            ChannelParams *cp = &s->b[index].channel_params[channel];
-            DecodingParams *dp = &s->b[index].decoding_params;
+        memcpy(&path_counter[NUM_CODEBOOKS], &path_counter[best_codebook], sizeof(PathCounter));
+    }
 
-            best_codebook = *best_path++;
-            cur_bo = &s->b[index].best_offset[channel][best_codebook];
+    best_path = path_counter[NUM_CODEBOOKS].path + 1;
 
-            cp->huff_offset      = cur_bo->offset;
-            cp->huff_lsbs        = cur_bo->lsb_bits + dp->quant_step_size[channel];
-            cp->codebook         = best_codebook;
-        }
+    /* Update context. */
+    for (unsigned int index = 0; index < ctx->number_of_subblocks; index++) {
+        ChannelParams *cp = &s->b[index].channel_params[channel];
+        DecodingParams *dp = &s->b[index].decoding_params;
+
+        best_codebook = *best_path++;
+        cur_bo = &s->b[index].best_offset[channel][best_codebook];
+
+        cp->huff_offset      = cur_bo->offset;
+        cp->huff_lsbs        = cur_bo->lsb_bits + dp->quant_step_size[channel];
+        cp->codebook         = best_codebook;
     }
 }
 
+static int determine_codebooks_ch(AVCodecContext *avctx, void *arg, int jobnr, int threadnr)
+{
+    MLPEncodeContext *ctx = avctx->priv_data;
+    MLPSubstream *s = arg;
+    int ch = s->cur_restart_header->min_channel + jobnr;
+
+    determine_bits(ctx, s, ch);
+    set_best_codebook(ctx, s, ch);
+
+    return 0;
+}
+
+/** Chooses the codebooks of all channels, in parallel with slice threads. */
+static void determine_codebooks(MLPEncodeContext *ctx, MLPSubstream *s)
+{
+    RestartHeader *rh = s->cur_restart_header;
+
+    ctx->avctx->execute2(ctx->avctx, determine_codebooks_ch, s, NULL,
+                         rh->max_channel - rh->min_channel + 1);
+}
+
 /** Analyzes all collected bitcounts and selects the best parameters for each
  *  individual access unit.
  *  TODO This is just a stub!
@@ -2173,13 +2228,10 @@ static void analyze_sample_buffer(MLPEncodeContext *ctx, MLPSubstream *s)
     rematrix_channels        (ctx, s);
     determine_quant_step_size(ctx, s);
     determine_filters        (ctx, s);
-    apply_filters            (ctx, s);
 
     copy_restart_frame_params(ctx, s);
 
-    determine_bits(ctx, s);
-
-    set_best_codebook(ctx, s);
+    determine_codebooks(ctx, s);
 }
 
 static void process_major_frame(MLPEncodeContext *ctx, MLPSubstream *s)
@@ -2313,7 +2365,9 @@ static av_cold int mlp_encode_close(AVCodecContext *avctx)
 {
     MLPEncodeContext *ctx = avctx->priv_data;
 
-    ff_lpc_end(&ctx->lpc_ctx);
+    for (int i = 0; ctx->threads && i < ctx->nb_threads; i++)
+        ff_lpc_end(&ctx->threads[i].lpc_ctx);
+    av_freep(&ctx->threads);
     ff_af_queue_close(&ctx->afq);
 
     return 0;
@@ -2349,6 +2403,7 @@ const FFCodec ff_mlp_encoder = {
     .p.type                 = AVMEDIA_TYPE_AUDIO,
     .p.id                   = AV_CODEC_ID_MLP,
     .p.capabilities         = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_DELAY |
+                              AV_CODEC_CAP_SLICE_THREADS |
                               AV_CODEC_CAP_EXPERIMENTAL,
     .priv_data_size         = sizeof(MLPEncodeContext),
     .init                   = mlp_encode_init,
@@ -2369,6 +2424,7 @@ const FFCodec ff_truehd_encoder = {
     .p.id                   = AV_CODEC_ID_TRUEHD,
     .p.capabilities         = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_DELAY |
                               AV_CODEC_CAP_SMALL_LAST_FRAME |
+                              AV_CODEC_CAP_SLICE_THREADS |
                               AV_CODEC_CAP_EXPERIMENTAL,
     .priv_data_size         = sizeof(MLPEncodeContext),
     .init                   = mlp_encode_init,
@@ -0,0 +1,46 @@
+/*
+ * This file is part of Librempeg
+ *
+ * Librempeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Librempeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Librempeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "libavutil/attributes.h"
+#include "mlpencdsp.h"
+#include "config.h"
+
+static void fir_residual_c(int32_t *residual, const int32_t *samples,
+                           const int32_t *coeff, int order, int shift,
+                           int32_t mask, int len)
+{
+    for (int i = 0; i < len; i++) {
+        int64_t accum = 0;
+
+        for (int j = 0; j < order; j++)
+            accum += (int64_t)samples[i - 1 - j] * coeff[j];
+
+        residual[i] = samples[i] - (uint32_t)((accum >> shift) & mask);
+    }
+}
+
+av_cold void ff_mlpencdsp_init(MLPEncDSPContext *c)
+{
+    c->fir_residual = fir_residual_c;
+
+#if ARCH_AARCH64
+    ff_mlpencdsp_init_aarch64(c);
+#elif ARCH_X86
+    ff_mlpencdsp_init_x86(c);
+#endif
+}
@@ -0,0 +1,43 @@
+/*
+ * This file is part of Librempeg
+ *
+ * Librempeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Librempeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Librempeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef AVCODEC_MLPENCDSP_H
+#define AVCODEC_MLPENCDSP_H
+
+#include <stdint.h>
+
+typedef struct MLPEncDSPContext {
+    /**
+     * Compute the residuals of an FIR prediction filter,
+     * residual[i] = samples[i] - ((sum(samples[i - 1 - j] * coeff[j]) >> shift) & mask)
+     * with 64-bit accumulation.
+     * @param samples input, samples[-order] to samples[-1] hold the history
+     * @param order   filter order, between 1 and 8
+     * @param shift   between 0 and 15
+     * @param len     number of samples, a multiple of 8
+     */
+    void (*fir_residual)(int32_t *residual, const int32_t *samples,
+                         const int32_t *coeff, int order, int shift,
+                         int32_t mask, int len);
+} MLPEncDSPContext;
+
+void ff_mlpencdsp_init(MLPEncDSPContext *c);
+void ff_mlpencdsp_init_aarch64(MLPEncDSPContext *c);
+void ff_mlpencdsp_init_x86(MLPEncDSPContext *c);
+
+#endif /* AVCODEC_MLPENCDSP_H */
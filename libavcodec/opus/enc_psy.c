@@ -425,35 +425,69 @@ static int bands_dist(OpusPsyContext *s, CeltFrame *f, float *total_dist)
     return 0;
 }
 
+/* Each trial quantizes the whole frame on a private copy, starting from the
+ * same noise generator state, so the trials can run in any order. */
+static int run_trial(AVCodecContext *avctx, void *arg, int jobnr, int threadnr)
+{
+    OpusPsyContext *s = arg;
+    OpusPsyTrial *trial = &s->trials[jobnr];
+    CeltFrame *f = &s->trial_frames[threadnr];
+
+    memcpy(f, s->trial_src, sizeof(*f));
+    f->pvq              = s->trial_pvq[threadnr];
+    f->intensity_stereo = trial->intensity_stereo;
+    f->dual_stereo      = trial->dual_stereo;
+
+    bands_dist(s, f, &trial->dist);
+
+    trial->intensity_stereo = f->intensity_stereo;
+
+    return 0;
+}
+
+static void run_trials(OpusPsyContext *s, CeltFrame *f, int nb_trials)
+{
+    s->trial_src = f;
+    s->avctx->execute2(s->avctx, run_trial, s, NULL, nb_trials);
+}
+
 static void celt_search_for_dual_stereo(OpusPsyContext *s, CeltFrame *f)
 {
-    float td1, td2;
     f->dual_stereo = 0;
 
     if (s->avctx->ch_layout.nb_channels < 2)
         return;
 
-    bands_dist(s, f, &td1);
-    f->dual_stereo = 1;
-    bands_dist(s, f, &td2);
+    for (int i = 0; i < 2; i++) {
+        s->trials[i].intensity_stereo = f->intensity_stereo;
+        s->trials[i].dual_stereo      = i;
+    }
+    run_trials(s, f, 2);
 
-    f->dual_stereo = td2 < td1;
-    s->dual_stereo_used += td2 < td1;
+    /* The bit allocation may lower the intensity stereo band */
+    f->intensity_stereo = s->trials[1].intensity_stereo;
+    f->dual_stereo = s->trials[1].dist < s->trials[0].dist;
+    s->dual_stereo_used += f->dual_stereo;
 }
 
 static void celt_search_for_intensity(OpusPsyContext *s, CeltFrame *f)
 {
     int i, best_band = CELT_MAX_BANDS - 1;
-    float dist, best_dist = FLT_MAX;
+    float best_dist = FLT_MAX;
     /* TODO: fix, make some heuristic up here using the lambda value */
-    float end_band = 0;
+    int end_band = 0;
 
     if (s->avctx->ch_layout.nb_channels < 2)
         return;
 
     for (i = f->end_band; i >= end_band; i--) {
-        f->intensity_stereo = i;
-        bands_dist(s, f, &dist);
+        s->trials[f->end_band - i].intensity_stereo = i;
+        s->trials[f->end_band - i].dual_stereo      = f->dual_stereo;
+    }
+    run_trials(s, f, f->end_band - end_band + 1);
+
+    for (i = f->end_band; i >= end_band; i--) {
+        const float dist = s->trials[f->end_band - i].dist;
         if (best_dist > dist) {
             best_dist = dist;
             best_band = i;
@@ -586,6 +620,22 @@ av_cold int ff_opus_psy_init(OpusPsyContext *s, AVCodecContext *avctx,
         goto fail;
     }
 
+    if (avctx->ch_layout.nb_channels > 1) {
+        s->nb_trial_threads = 1;
+        if (avctx->active_thread_type & FF_THREAD_SLICE)
+            s->nb_trial_threads = FFMAX(avctx->thread_count, 1);
+
+        s->trial_frames = av_malloc_array(s->nb_trial_threads, sizeof(*s->trial_frames));
+        s->trial_pvq    = av_calloc(s->nb_trial_threads, sizeof(*s->trial_pvq));
+        if (!s->trial_frames || !s->trial_pvq) {
+            ret = AVERROR(ENOMEM);
+            goto fail;
+        }
+        for (i = 0; i < s->nb_trial_threads; i++)
+            if ((ret = ff_celt_pvq_init(&s->trial_pvq[i], 1)) < 0)
+                goto fail;
+    }
+
     for (ch = 0; ch < s->avctx->ch_layout.nb_channels; ch++) {
         for (i = 0; i < CELT_MAX_BANDS; i++) {
             bessel_init(&s->bfilter_hi[ch][i], 1.0f, 19.0f, 100.0f, 1);
@@ -623,6 +673,11 @@ fail:
     av_freep(&s->inflection_points);
     av_freep(&s->dsp);
 
+    for (i = 0; i < s->nb_trial_threads && s->trial_pvq; i++)
+        ff_celt_pvq_uninit(&s->trial_pvq[i]);
+    av_freep(&s->trial_pvq);
+    av_freep(&s->trial_frames);
+
     for (i = 0; i < CELT_BLOCK_NB; i++) {
         av_tx_uninit(&s->mdct[i]);
         av_freep(&s->window[i]);
@@ -646,6 +701,11 @@ av_cold int ff_opus_psy_end(OpusPsyContext *s)
     av_freep(&s->inflection_points);
     av_freep(&s->dsp);
 
+    for (i = 0; i < s->nb_trial_threads && s->trial_pvq; i++)
+        ff_celt_pvq_uninit(&s->trial_pvq[i]);
+    av_freep(&s->trial_pvq);
+    av_freep(&s->trial_frames);
+
     for (i = 0; i < CELT_BLOCK_NB; i++) {
         av_tx_uninit(&s->mdct[i]);
         av_freep(&s->window[i]);
@@ -49,6 +49,12 @@ typedef struct OpusBandExcitation {
     float excitation_init;
 } OpusBandExcitation;
 
+typedef struct OpusPsyTrial {
+    int intensity_stereo; /* Band to try, set to the coded one afterwards */
+    int dual_stereo;
+    float dist;
+} OpusPsyTrial;
+
 typedef struct OpusPsyContext {
     AVCodecContext *avctx;
     AVFloatDSPContext *dsp;
@@ -82,6 +88,13 @@ typedef struct OpusPsyContext {
     float lambda;
     int *inflection_points;
     int inflection_points_count;
+
+    /* Stereo searches, each trial is a job for avctx->execute2() */
+    CeltFrame *trial_src;
+    CeltFrame *trial_frames;                 /* One per thread */
+    struct CeltPVQ **trial_pvq;              /* One per thread */
+    int nb_trial_threads;
+    OpusPsyTrial trials[CELT_MAX_BANDS + 1];
 } OpusPsyContext;
 
 int  ff_opus_psy_process           (OpusPsyContext *s, OpusPacketInfo *p);
@@ -916,6 +916,8 @@ int av_cold ff_celt_pvq_init(CeltPVQ **pvq, int encode)
     s->pvq_search = ppp_pvq_search_c;
 #if ARCH_X86
     ff_celt_pvq_init_x86(s);
+#elif ARCH_AARCH64
+    ff_celt_pvq_init_aarch64(s);
 #endif
 #endif
 
@@ -43,6 +43,7 @@ typedef struct CeltPVQ {
 } CeltPVQ;
 
 void ff_celt_pvq_init_x86(struct CeltPVQ *s);
+void ff_celt_pvq_init_aarch64(struct CeltPVQ *s);
 
 int  ff_celt_pvq_init(struct CeltPVQ **pvq, int encode);
 void ff_celt_pvq_uninit(struct CeltPVQ **pvq);
@@ -0,0 +1,444 @@
+/*
+ * This file is part of Librempeg
+ *
+ * Librempeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Librempeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Librempeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * Decode synthetic HCA, ATRAC9 and multi-unit ATRAC3+ streams once
+ * serially and once with frame threads and check that the output is
+ * identical. The streams are generated here because no samples with
+ * these codecs are available to FATE; all fields that the decoders
+ * validate are written with legal values, the rest is pseudo-random.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "libavutil/channel_layout.h"
+#include "libavutil/crc.h"
+#include "libavutil/error.h"
+#include "libavutil/intreadwrite.h"
+#include "libavutil/lfg.h"
+#include "libavutil/log.h"
+#include "libavutil/mem.h"
+
+#include "libavcodec/atrac3plus.h"
+#include "libavcodec/atrac3plus_data.h"
+#include "libavcodec/atrac9tab.h"
+#include "libavcodec/avcodec.h"
+#include "libavcodec/put_bits.h"
+
+#define NB_PACKETS 24
+#define MAX_PACKET 2400
+
+typedef struct Stream {
+    enum AVCodecID codec_id;
+    int channels;
+    int sample_rate;
+    int block_align;
+    uint8_t extradata[64];
+    int extradata_size;
+    uint8_t data[NB_PACKETS][MAX_PACKET];
+    int size[NB_PACKETS];
+} Stream;
+
+static void put_random(PutBitContext *pb, AVLFG *lfg, int n)
+{
+    while (n > 0) {
+        int bits = FFMIN(n, 16);
+        put_bits(pb, bits, av_lfg_get(lfg) & ((1 << bits) - 1));
+        n -= bits;
+    }
+}
+
+/* HCA v2.0, stereo with intensity and HFR bands; after the sync word
+ * every bit pattern is valid, only the CRC has to match. */
+static void build_hca(Stream *st, AVLFG *lfg)
+{
+    uint8_t *p = st->extradata;
+    const int frame_size = 0x200;
+    const AVCRC *crc = av_crc_get_table(AV_CRC_16_ANSI);
+
+    st->codec_id    = AV_CODEC_ID_HCA;
+    st->channels    = 2;
+    st->sample_rate = 44100;
+    st->block_align = frame_size;
+
+    AV_WB32(p,      MKBETAG('H', 'C', 'A', 0));
+    AV_WB16(p +  4, 0x0200);
+    AV_WB16(p +  6, 40);
+    AV_WB32(p +  8, MKBETAG('f', 'm', 't', 0));
+    p[12] = st->channels;
+    AV_WB24(p + 13, st->sample_rate);
+    AV_WB32(p + 16, NB_PACKETS);
+    AV_WB32(p + 20, 0);
+    AV_WB32(p + 24, MKBETAG('c', 'o', 'm', 'p'));
+    AV_WB16(p + 28, frame_size);
+    p[30] = 1;   /* min resolution */
+    p[31] = 15;  /* max resolution */
+    p[32] = 1;   /* track count */
+    p[33] = 0;   /* channel config */
+    p[34] = 128; /* total bands */
+    p[35] = 64;  /* base bands */
+    p[36] = 32;  /* stereo bands */
+    p[37] = 8;   /* bands per HFR group */
+    p[38] = 0;   /* M/S stereo */
+    p[39] = 0;
+    st->extradata_size = 40;
+
+    for (int n = 0; n < NB_PACKETS; n++) {
+        uint8_t *buf = st->data[n];
+
+        AV_WB16(buf, 0xFFFF);
+        for (int i = 2; i < frame_size - 2; i++)
+            buf[i] = av_lfg_get(lfg);
+        AV_WL16(buf + frame_size - 2, av_crc(crc, 0, buf, frame_size - 2));
+        st->size[n] = frame_size;
+    }
+}
+
+/* One ATRAC9 SCE block without band extension. The gradient is flat over
+ * the coded units so the coefficient precision follows from the scale
+ * factors alone, and at the high sample rate table all coefficients are
+ * stored with fixed length codes. */
+static void put_atrac9_block(PutBitContext *pb, AVLFG *lfg, int first)
+{
+    int sf[31], mask[31] = { 0 }, coarse[31], fine[31];
+    int band_count, q_unit_cnt, grad_mode, gradient, boundary, base;
+
+    band_count = av_lfg_get(lfg) % 8 + 1;
+    q_unit_cnt = at9_tab_band_q_unit_map[band_count];
+    grad_mode  = av_lfg_get(lfg) % 3 + 1;
+    gradient   = av_lfg_get(lfg) % 32;
+    boundary   = av_lfg_get(lfg) % (FFMIN(q_unit_cnt, 15) + 1);
+    base       = av_lfg_get(lfg) % 29;
+
+    put_bits(pb, 1, !first);
+    put_bits(pb, 1, 0);                 /* reuse parameters */
+    put_bits(pb, 4, band_count - 1);
+    put_bits(pb, 1, 0);                 /* band extension */
+
+    put_bits(pb, 2, grad_mode);
+    put_bits(pb, 5, 30);                /* gradient range start */
+    put_bits(pb, 5, gradient);
+    put_bits(pb, 4, boundary);
+
+    put_bits(pb, 1, 0);                 /* band extension data */
+
+    put_bits(pb, 2, 1);                 /* CLC scale factors */
+    put_bits(pb, 2, 0);                 /* 2 bits each */
+    put_bits(pb, 5, base);
+    for (int i = 0; i < q_unit_cnt; i++) {
+        int v = av_lfg_get(lfg) & 3;
+        put_bits(pb, 2, v);
+        sf[i] = base + v;
+    }
+
+    for (int i = 1; i < q_unit_cnt; i++) {
+        const int delta = FFABS(sf[i] - sf[i - 1]) - 1;
+        if (delta > 0)
+            mask[i - (sf[i - 1] > sf[i])] += FFMIN(delta, 5);
+    }
+    for (int i = 0; i < q_unit_cnt; i++) {
+        int p = sf[i] + mask[i] - gradient;
+        if (p >= 0)
+            p = grad_mode == 1 ? p >> 1 : grad_mode == 2 ? (3 * p) >> 3 : p >> 2;
+        p = FFMAX(p, 1) + (i < boundary);
+        fine[i]   = p > 15 ? FFMIN(p, 30) - 15 : 0;
+        coarse[i] = FFMIN(p, 15);
+    }
+
+    for (int i = 0; i < q_unit_cnt; i++)
+        put_random(pb, lfg, at9_q_unit_to_coeff_cnt[i] * (coarse[i] + 1));
+    for (int i = 0; i < q_unit_cnt; i++)
+        if (fine[i])
+            put_random(pb, lfg, at9_q_unit_to_coeff_cnt[i] * (fine[i] + 1));
+
+    align_put_bits(pb);
+}
+
+/* ATRAC9 dual mono, 44.1 kHz, four frames per superframe */
+static void build_atrac9(Stream *st, AVLFG *lfg)
+{
+    const int frame_size = 600, frames = 4;
+    PutBitContext pb;
+
+    st->codec_id    = AV_CODEC_ID_ATRAC9;
+    st->channels    = 2;
+    st->sample_rate = 44100;
+    st->block_align = frame_size * frames;
+
+    AV_WL32(st->extradata, 2);
+    init_put_bits(&pb, st->extradata + 4, 8);
+    put_bits(&pb, 8, 0xFE);
+    put_bits(&pb, 4, 8);                /* sample rate index */
+    put_bits(&pb, 3, 1);                /* dual mono block config */
+    put_bits(&pb, 1, 0);
+    put_bits(&pb, 11, frame_size - 1);
+    put_bits(&pb, 2, 2);                /* superframe index */
+    flush_put_bits(&pb);
+    memset(put_bits_ptr(&pb), 0, st->extradata + 12 - put_bits_ptr(&pb));
+    st->extradata_size = 12;
+
+    for (int n = 0; n < NB_PACKETS; n++) {
+        init_put_bits(&pb, st->data[n], st->block_align);
+        for (int i = 0; i < frames; i++)
+            for (int j = 0; j < 2; j++)
+                put_atrac9_block(&pb, lfg, !i);
+        flush_put_bits(&pb);
+        memset(put_bits_ptr(&pb), 0, st->data[n] + st->block_align - put_bits_ptr(&pb));
+        st->size[n] = st->block_align;
+    }
+}
+
+/* Subset of table set B whose code tables group the spectral lines, so
+ * that every group can be coded as skipped with a single zero bit. */
+static const uint8_t at3p_grouped_codetab[3] = { 1, 2, 0 };
+
+static void put_atrac3p_unit(PutBitContext *pb, AVLFG *lfg, int channels)
+{
+    int wordlen[2][32] = { { 0 } };
+    int num_quant_units = av_lfg_get(lfg) % 28 + 1;
+    int used_quant_units = 0, num_coded_subbands;
+
+    put_bits(pb, 2, channels - 1);      /* unit type */
+    put_bits(pb, 5, num_quant_units - 1);
+    put_bits(pb, 1, 0);                 /* mute */
+
+    for (int ch = 0; ch < channels; ch++) {
+        put_bits(pb, 2, 0);             /* constant length word lengths */
+        for (int i = 0; i < num_quant_units; i++) {
+            wordlen[ch][i] = av_lfg_get(lfg) % 4;
+            put_bits(pb, 3, wordlen[ch][i]);
+        }
+    }
+    for (int i = num_quant_units - 1; i >= 0; i--) {
+        if (wordlen[0][i] || (channels == 2 && wordlen[1][i])) {
+            used_quant_units = i + 1;
+            break;
+        }
+    }
+
+    if (used_quant_units) {
+        for (int ch = 0; ch < channels; ch++) {
+            put_bits(pb, 2, 0);         /* constant length scale factors */
+            put_random(pb, lfg, 6 * used_quant_units);
+        }
+
+        put_bits(pb, 1, 0);             /* restricted code tables */
+        for (int ch = 0; ch < channels; ch++) {
+            put_bits(pb, 1, 1);         /* table set B */
+            put_bits(pb, 2, 0);         /* directly coded */
+            put_bits(pb, 1, 0);         /* all units */
+            for (int i = 0; i < used_quant_units; i++) {
+                if (wordlen[ch][i])
+                    put_bits(pb, 2, at3p_grouped_codetab[wordlen[ch][i] - 1]);
+                else if (ch && wordlen[0][i])
+                    put_bits(pb, 1, 0); /* copy the master spectrum */
+            }
+        }
+    }
+
+    num_coded_subbands = used_quant_units ?
+                         atrac3p_qu_to_subband[used_quant_units - 1] + 1 : 0;
+
+    for (int ch = 0; ch < channels; ch++) {
+        for (int i = 0; i < used_quant_units; i++) {
+            const int wl = wordlen[ch][i];
+            const Atrac3pSpecCodeTab *tab;
+            int num_specs;
+
+            if (!wl)
+                continue;
+            tab = &atrac3p_spectra_tabs[(8 + atrac3p_ct_restricted_to_full[1][wl - 1][at3p_grouped_codetab[wl - 1]]) * 7 + wl - 1];
+            num_specs = ff_atrac3p_qu_to_spec_pos[i + 1] - ff_atrac3p_qu_to_spec_pos[i];
+            put_bits(pb, num_specs / (tab->group_size * tab->num_coeffs), 0);
+        }
+        /* power compensation is what makes the skipped spectrum audible */
+        if (used_quant_units > 2)
+            put_random(pb, lfg, 4 * atrac3p_subband_to_num_powgrps[num_coded_subbands - 1]);
+    }
+
+    if (channels == 2) {
+        put_bits(pb, 1, 0);             /* swap channels */
+        put_bits(pb, 1, 0);             /* negate coefficients */
+    }
+    for (int ch = 0; ch < channels; ch++) {
+        if (av_lfg_get(lfg) & 1)
+            put_bits(pb, 2, 2);         /* all windows steep */
+        else
+            put_bits(pb, 1, 0);
+    }
+    for (int ch = 0; ch < channels; ch++)
+        put_bits(pb, 1, 0);             /* gain control */
+    put_bits(pb, 1, 0);                 /* tones */
+    if (av_lfg_get(lfg) & 1) {
+        put_bits(pb, 1, 1);
+        put_random(pb, lfg, 8);         /* noise level and table */
+    } else
+        put_bits(pb, 1, 0);
+}
+
+/* ATRAC3+ 5.1: two stereo and two mono channel units per frame */
+static void build_atrac3p(Stream *st, AVLFG *lfg)
+{
+    static const int units[] = { 2, 1, 2, 1 };
+    PutBitContext pb;
+
+    st->codec_id       = AV_CODEC_ID_ATRAC3P;
+    st->channels       = 6;
+    st->sample_rate    = 44100;
+    st->block_align    = 1024;
+    st->extradata_size = 0;
+
+    for (int n = 0; n < NB_PACKETS; n++) {
+        init_put_bits(&pb, st->data[n], st->block_align);
+        put_bits(&pb, 1, 0);            /* start bit */
+        for (int i = 0; i < FF_ARRAY_ELEMS(units); i++)
+            put_atrac3p_unit(&pb, lfg, units[i]);
+        put_bits(&pb, 2, 3);            /* terminator */
+        flush_put_bits(&pb);
+        memset(put_bits_ptr(&pb), 0, st->data[n] + st->block_align - put_bits_ptr(&pb));
+        st->size[n] = st->block_align;
+    }
+}
+
+static int receive_frames(AVCodecContext *avctx, AVFrame *frame,
+                          uint32_t *crc, int *nb_frames, int *nb_samples)
+{
+    const AVCRC *tab = av_crc_get_table(AV_CRC_32_IEEE_LE);
+    int ret;
+
+    while ((ret = avcodec_receive_frame(avctx, frame)) >= 0) {
+        for (int ch = 0; ch < frame->ch_layout.nb_channels; ch++)
+            *crc = av_crc(tab, *crc, frame->extended_data[ch],
+                          frame->nb_samples * sizeof(float));
+        *nb_frames  += 1;
+        *nb_samples += frame->nb_samples;
+        av_frame_unref(frame);
+    }
+
+    return ret == AVERROR(EAGAIN) || ret == AVERROR_EOF ? 0 : ret;
+}
+
+static int decode(const Stream *st, int threads, uint32_t *crc,
+                  int *nb_frames, int *nb_samples)
+{
+    const AVCodec *codec = avcodec_find_decoder(st->codec_id);
+    AVCodecContext *avctx = NULL;
+    AVPacket *pkt = av_packet_alloc();
+    AVFrame *frame = av_frame_alloc();
+    int ret;
+
+    *crc = *nb_frames = *nb_samples = 0;
+
+    if (!codec || !pkt || !frame) {
+        ret = codec ? AVERROR(ENOMEM) : AVERROR_DECODER_NOT_FOUND;
+        goto end;
+    }
+    avctx = avcodec_alloc_context3(codec);
+    if (!avctx) {
+        ret = AVERROR(ENOMEM);
+        goto end;
+    }
+
+    av_channel_layout_default(&avctx->ch_layout, st->channels);
+    avctx->sample_rate     = st->sample_rate;
+    avctx->block_align     = st->block_align;
+    avctx->flags          |= AV_CODEC_FLAG_BITEXACT;
+    avctx->err_recognition = AV_EF_CRCCHECK | AV_EF_EXPLODE;
+    avctx->thread_count    = threads;
+    avctx->thread_type     = FF_THREAD_FRAME;
+    if (st->extradata_size) {
+        avctx->extradata = av_mallocz(st->extradata_size + AV_INPUT_BUFFER_PADDING_SIZE);
+        if (!avctx->extradata) {
+            ret = AVERROR(ENOMEM);
+            goto end;
+        }
+        memcpy(avctx->extradata, st->extradata, st->extradata_size);
+        avctx->extradata_size = st->extradata_size;
+    }
+
+    if ((ret = avcodec_open2(avctx, codec, NULL)) < 0)
+        goto end;
+
+    for (int n = 0; n <= NB_PACKETS; n++) {
+        if (n < NB_PACKETS) {
+            if ((ret = av_new_packet(pkt, st->size[n])) < 0)
+                goto end;
+            memcpy(pkt->data, st->data[n], st->size[n]);
+            ret = avcodec_send_packet(avctx, pkt);
+            av_packet_unref(pkt);
+        } else {
+            ret = avcodec_send_packet(avctx, NULL);
+        }
+        if (ret < 0)
+            goto end;
+        if ((ret = receive_frames(avctx, frame, crc, nb_frames, nb_samples)) < 0)
+            goto end;
+    }
+
+end:
+    avcodec_free_context(&avctx);
+    av_packet_free(&pkt);
+    av_frame_free(&frame);
+    return ret;
+}
+
+static int test(const char *name, void (*build)(Stream *st, AVLFG *lfg))
+{
+    Stream *st = av_mallocz(sizeof(*st));
+    uint32_t crc[2];
+    int frames[2], samples[2], ret;
+    AVLFG lfg;
+
+    if (!st)
+        return AVERROR(ENOMEM);
+
+    av_lfg_init(&lfg, 0xC0DEC);
+    build(st, &lfg);
+
+    for (int i = 0; i < 2; i++) {
+        ret = decode(st, i ? 2 : 1, &crc[i], &frames[i], &samples[i]);
+        if (ret < 0) {
+            printf("%s: %s decoding failed: %s\n", name,
+                   i ? "threaded" : "serial", av_err2str(ret));
+            av_free(st);
+            return ret;
+        }
+    }
+
+    printf("%s: %d channels, %d frames, %d samples, threaded output %s\n",
+           name, st->channels, frames[0], samples[0],
+           crc[0] == crc[1] && frames[0] == frames[1] && samples[0] == samples[1] ?
+           "identical" : "differs");
+
+    av_free(st);
+    return crc[0] == crc[1] && frames[0] == frames[1] ? 0 : 1;
+}
+
+int main(void)
+{
+    int ret = 0;
+
+    av_log_set_level(AV_LOG_QUIET);
+
+    ret |= test("hca",     build_hca);
+    ret |= test("atrac9",  build_atrac9);
+    ret |= test("atrac3p", build_atrac3p);
+
+    return !!ret;
+}
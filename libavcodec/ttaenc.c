@@ -24,21 +24,68 @@
 #include "avcodec.h"
 #include "codec_internal.h"
 #include "encode.h"
+#include "encode_slots.h"
 #include "put_bits.h"
 #include "libavutil/crc.h"
 #include "libavutil/mem.h"
 
+/**
+ * A frame being encoded, possibly on a worker thread.
+ */
+typedef struct TTAEncSlot {
+    struct TTAEncContext *s;
+    TTAChannel *ch_ctx;
+    AVFrame *frame;
+    uint8_t *buf;
+    unsigned int buf_size;
+} TTAEncSlot;
+
 typedef struct TTAEncContext {
+    AVCodecContext *avctx;
     const AVCRC *crc_table;
     int bps;
-    TTAChannel *ch_ctx;
     TTAEncDSPContext dsp;
+
+    FFEncodeSlots slots;
 } TTAEncContext;
 
+static int encode_slot(void *opaque);
+static int output_slot(AVCodecContext *avctx, void *opaque, int out_bytes,
+                       AVPacket *avpkt);
+
+/**
+ * Set up one slot per thread. The channel states are reset for every
+ * frame, so frames can be encoded independently, each slot only needs its
+ * own channel states and output buffer.
+ */
+static av_cold int init_slots(AVCodecContext *avctx)
+{
+    TTAEncContext *s = avctx->priv_data;
+    int ret;
+
+    ret = ff_encode_slots_init(&s->slots, avctx, sizeof(TTAEncSlot),
+                               encode_slot, output_slot);
+    if (ret < 0)
+        return ret;
+
+    for (int i = 0; i < s->slots.nb_slots; i++) {
+        TTAEncSlot *slot = ff_encode_slots_get(&s->slots, i);
+
+        slot->s      = s;
+        slot->frame  = av_frame_alloc();
+        slot->ch_ctx = av_malloc_array(avctx->ch_layout.nb_channels, sizeof(*slot->ch_ctx));
+        if (!slot->frame || !slot->ch_ctx)
+            return AVERROR(ENOMEM);
+    }
+
+    return 0;
+}
+
 static av_cold int tta_encode_init(AVCodecContext *avctx)
 {
     TTAEncContext *s = avctx->priv_data;
 
+    s->avctx     = avctx;
     s->crc_table = av_crc_get_table(AV_CRC_32_IEEE_LE);
 
     switch (avctx->sample_fmt) {
@@ -57,13 +104,9 @@ static av_cold int tta_encode_init(AVCodecContext *avctx)
     s->bps = avctx->bits_per_raw_sample >> 3;
     avctx->frame_size = 256 * avctx->sample_rate / 245;
 
-    s->ch_ctx = av_malloc_array(avctx->ch_layout.nb_channels, sizeof(*s->ch_ctx));
-    if (!s->ch_ctx)
-        return AVERROR(ENOMEM);
-
     ff_ttaencdsp_init(&s->dsp);
 
-    return 0;
+    return init_slots(avctx);
 }
 
 static int32_t get_sample(const AVFrame *frame, int sample,
@@ -84,29 +127,38 @@ static int32_t get_sample(const AVFrame *frame, int sample,
     return ret;
 }
 
-static int tta_encode_frame(AVCodecContext *avctx, AVPacket *avpkt,
-                            const AVFrame *frame, int *got_packet_ptr)
+/**
+ * Encode the frame of a slot into its buffer.
+ * Only the slot's channel states are modified, this may run on a worker
+ * thread.
+ * @return size of the encoded frame or a negative error code
+ */
+static int encode_slot(void *opaque)
 {
-    TTAEncContext *s = avctx->priv_data;
+    TTAEncSlot *slot = opaque;
+    TTAEncContext *s = slot->s;
+    AVCodecContext *avctx = s->avctx;
+    const AVFrame *frame = slot->frame;
     PutBitContext pb;
-    int ret, i, out_bytes, cur_chan, res, samples;
+    int i, out_bytes, cur_chan, res, samples;
     int64_t pkt_size =  frame->nb_samples * 2LL * avctx->ch_layout.nb_channels * s->bps;
 
 pkt_alloc:
     cur_chan = 0, res = 0, samples = 0;
-    if ((ret = ff_alloc_packet(avctx, avpkt, pkt_size)) < 0)
-        return ret;
-    init_put_bits(&pb, avpkt->data, avpkt->size);
+    av_fast_padded_malloc(&slot->buf, &slot->buf_size, pkt_size);
+    if (!slot->buf)
+        return AVERROR(ENOMEM);
+    init_put_bits(&pb, slot->buf, pkt_size);
 
     // init per channel states
     for (i = 0; i < avctx->ch_layout.nb_channels; i++) {
-        s->ch_ctx[i].predictor = 0;
-        ff_tta_filter_init(&s->ch_ctx[i].filter, ff_tta_filter_configs[s->bps - 1]);
-        ff_tta_rice_init(&s->ch_ctx[i].rice, 10, 10);
+        slot->ch_ctx[i].predictor = 0;
+        ff_tta_filter_init(&slot->ch_ctx[i].filter, ff_tta_filter_configs[s->bps - 1]);
+        ff_tta_rice_init(&slot->ch_ctx[i].rice, 10, 10);
     }
 
     for (i = 0; i < frame->nb_samples * avctx->ch_layout.nb_channels; i++) {
-        TTAChannel *c = &s->ch_ctx[cur_chan];
+        TTAChannel *c = &slot->ch_ctx[cur_chan];
         TTAFilter *filter = &c->filter;
         TTARice *rice = &c->rice;
         uint32_t k, unary, outval;
@@ -156,7 +208,6 @@ pkt_alloc:
             if (unary + 100LL > put_bits_left(&pb)) {
                 if (pkt_size < INT_MAX/2) {
                     pkt_size *= 2;
-                    av_packet_unref(avpkt);
                     goto pkt_alloc;
                 } else
                     return AVERROR(ENOMEM);
@@ -185,18 +236,67 @@ pkt_alloc:
 
     flush_put_bits(&pb);
     out_bytes = put_bytes_output(&pb);
-    put_bits32(&pb, av_crc(s->crc_table, UINT32_MAX, avpkt->data, out_bytes) ^ UINT32_MAX);
+    put_bits32(&pb, av_crc(s->crc_table, UINT32_MAX, slot->buf, out_bytes) ^ UINT32_MAX);
     flush_put_bits(&pb);
 
-    avpkt->size     = out_bytes + 4;
-    *got_packet_ptr = 1;
+    return out_bytes + 4;
+}
+
+static int fill_slot(AVCodecContext *avctx, void *opaque, AVFrame *frame)
+{
+    TTAEncSlot *slot = opaque;
+
+    av_frame_move_ref(slot->frame, frame);
     return 0;
 }
 
+/**
+ * Return the oldest queued frame as a packet.
+ */
+static int output_slot(AVCodecContext *avctx, void *opaque, int out_bytes,
+                       AVPacket *avpkt)
+{
+    TTAEncSlot *slot = opaque;
+    int ret;
+
+    if (out_bytes < 0) {
+        ret = out_bytes;
+        goto end;
+    }
+
+    if ((ret = ff_get_encode_buffer(avctx, avpkt, out_bytes, 0)) < 0)
+        goto end;
+    memcpy(avpkt->data, slot->buf, out_bytes);
+
+    ret = ff_encode_slots_frame_props(avctx, avpkt, slot->frame);
+
+end:
+    av_frame_unref(slot->frame);
+    return ret;
+}
+
+static int tta_receive_packet(AVCodecContext *avctx, AVPacket *avpkt)
+{
+    TTAEncContext *s = avctx->priv_data;
+
+    return ff_encode_slots_receive_packet(&s->slots, avctx, avpkt, fill_slot);
+}
+
+static void free_slot(void *opaque)
+{
+    TTAEncSlot *slot = opaque;
+
+    av_frame_free(&slot->frame);
+    av_freep(&slot->buf);
+    av_freep(&slot->ch_ctx);
+}
+
 static av_cold int tta_encode_close(AVCodecContext *avctx)
 {
     TTAEncContext *s = avctx->priv_data;
-    av_freep(&s->ch_ctx);
+
+    ff_encode_slots_uninit(&s->slots, free_slot);
+
     return 0;
 }
 
@@ -205,11 +305,14 @@ const FFCodec ff_tta_encoder = {
     CODEC_LONG_NAME("TTA (True Audio)"),
     .p.type         = AVMEDIA_TYPE_AUDIO,
     .p.id           = AV_CODEC_ID_TTA,
-    .p.capabilities = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_SMALL_LAST_FRAME |
-                      AV_CODEC_CAP_ENCODER_REORDERED_OPAQUE,
+    .p.capabilities = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_DELAY |
+                      AV_CODEC_CAP_SMALL_LAST_FRAME |
+                      AV_CODEC_CAP_ENCODER_REORDERED_OPAQUE |
+                      AV_CODEC_CAP_OTHER_THREADS,
     .priv_data_size = sizeof(TTAEncContext),
     .init           = tta_encode_init,
     .close          = tta_encode_close,
-    FF_CODEC_ENCODE_CB(tta_encode_frame),
+    FF_CODEC_RECEIVE_PACKET_CB(tta_receive_packet),
     CODEC_SAMPLEFMTS(AV_SAMPLE_FMT_U8, AV_SAMPLE_FMT_S16, AV_SAMPLE_FMT_S32),
+    .caps_internal  = FF_CODEC_CAP_INIT_CLEANUP | FF_CODEC_CAP_AUTO_THREADS,
 };
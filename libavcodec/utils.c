@@ -33,6 +33,7 @@
 #include "libavutil/pixdesc.h"
 #include "libavutil/imgutils.h"
 #include "libavutil/pixfmt.h"
+#include "libavutil/syncscan.h"
 #include "libavutil/timecode_internal.h"
 #include "avcodec.h"
 #include "codec.h"
@@ -997,15 +998,9 @@ const uint8_t *avpriv_find_start_code(const uint8_t *restrict p,
             return p;
     }
 
-    while (p < end) {
-        if      (p[-1] > 1      ) p += 3;
-        else if (p[-2]          ) p += 2;
-        else if (p[-3]|(p[-1]-1)) p++;
-        else {
-            p++;
-            break;
-        }
-    }
+    /* p[-3] is the first byte not checked against the state yet,
+     * skip past the byte following the start code prefix */
+    p += avpriv_find_start_code_prefix(p - 3, end - p + 3) + 1;
 
     p = FFMIN(p, end) - 4;
     *state = AV_RB32(p);
@@ -32,10 +32,12 @@
 #include "avcodec.h"
 #include "codec_internal.h"
 #include "encode.h"
+#include "encode_slots.h"
 #include "mathops.h"
 #include "vorbis.h"
 #include "vorbis_data.h"
 #include "vorbis_enc_data.h"
+#include "vorbisencdsp.h"
 
 #include "audio_frame_queue.h"
 #include "libavfilter/bufferqueue.h"
@@ -57,7 +59,9 @@ typedef struct vorbis_enc_codebook {
     int lookup;
     int *quantlist;
     float *dimensions;
-    float *pow2;
+    float *pow2;      // infinite for unused entries and the padding
+    float *columns;   // dimensions transposed, stride entries per dimension
+    int stride;
 } vorbis_enc_codebook;
 
 typedef struct vorbis_enc_floor_class {
@@ -104,18 +108,26 @@ typedef struct vorbis_enc_mode {
     int mapping;
 } vorbis_enc_mode;
 
+/**
+ * A packet being encoded, possibly on a worker thread.
+ */
+typedef struct vorbis_enc_slot {
+    struct vorbis_enc_context *venc;
+    AVTXContext *mdct;
+    av_tx_fn mdct_fn;
+    float *samples;
+    float *floor;  // also used for tmp values for mdct
+    float *coeffs; // also used for residue after floor
+    uint8_t *buf;
+} vorbis_enc_slot;
+
 typedef struct vorbis_enc_context {
     int channels;
     int sample_rate;
     int log2_blocksize[2];
-    AVTXContext *mdct[2];
-    av_tx_fn mdct_fn[2];
     const float *win[2];
     int have_saved;
     float *saved;
-    float *samples;
-    float *floor;  // also used for tmp values for mdct
-    float *coeffs; // also used for residue after floor
     float *scratch; // used for tmp values for psy model
     float quality;
 
@@ -140,6 +152,9 @@ typedef struct vorbis_enc_context {
     int64_t next_pts;
 
     AVFloatDSPContext *fdsp;
+    VorbisEncDSPContext dsp;
+
+    FFEncodeSlots slots;
 } vorbis_enc_context;
 
 #define MAX_CHANNELS     2
@@ -149,6 +164,8 @@ typedef struct vorbis_enc_context {
 #define NUM_FLOOR_PARTITIONS 8
 #define MAX_FLOOR_VALUES     (MAX_FLOOR_CLASS_DIM*NUM_FLOOR_PARTITIONS+2)
 
+#define MAX_PACKET_SIZE 8192
+
 #define RESIDUE_SIZE           1600
 #define RESIDUE_PART_SIZE      32
 #define NUM_RESIDUE_PARTITIONS (RESIDUE_SIZE/RESIDUE_PART_SIZE)
@@ -184,9 +201,11 @@ static int ready_codebook(vorbis_enc_codebook *cb)
         cb->pow2 = cb->dimensions = NULL;
     } else {
         int vals = cb_lookup_vals(cb->lookup, cb->ndimensions, cb->nentries);
+        cb->stride = FFALIGN(cb->nentries, 16);
         cb->dimensions = av_malloc_array(cb->nentries, sizeof(float) * cb->ndimensions);
-        cb->pow2 = av_calloc(cb->nentries, sizeof(*cb->pow2));
-        if (!cb->dimensions || !cb->pow2)
+        cb->columns = av_calloc(cb->stride, sizeof(float) * cb->ndimensions);
+        cb->pow2 = av_calloc(cb->stride, sizeof(*cb->pow2));
+        if (!cb->dimensions || !cb->columns || !cb->pow2)
             return AVERROR(ENOMEM);
         for (i = 0; i < cb->nentries; i++) {
             float last = 0;
@@ -207,6 +226,16 @@ static int ready_codebook(vorbis_enc_codebook *cb)
             }
             cb->pow2[i] /= 2.0;
         }
+        // layout for VorbisEncDSPContext.find_entry(), entries without a
+        // codeword are never picked
+        for (i = 0; i < cb->stride; i++) {
+            if (i >= cb->nentries || !cb->lens[i]) {
+                cb->pow2[i] = INFINITY;
+                continue;
+            }
+            for (int j = 0; j < cb->ndimensions; j++)
+                cb->columns[j * cb->stride + i] = cb->dimensions[i * cb->ndimensions + j];
+        }
     }
     return 0;
 }
@@ -252,9 +281,6 @@ static int ready_residue(vorbis_enc_residue *rc, vorbis_enc_context *venc)
 
 static av_cold int dsp_init(AVCodecContext *avctx, vorbis_enc_context *venc)
 {
-    int ret = 0;
-    float scale = 1.0f;
-
     venc->fdsp = avpriv_float_dsp_alloc(avctx->flags & AV_CODEC_FLAG_BITEXACT);
     if (!venc->fdsp)
         return AVERROR(ENOMEM);
@@ -263,13 +289,47 @@ static av_cold int dsp_init(AVCodecContext *avctx, vorbis_enc_context *venc)
     venc->win[0] = ff_vorbis_vwin[venc->log2_blocksize[0] - 6];
     venc->win[1] = ff_vorbis_vwin[venc->log2_blocksize[1] - 6];
 
-    if ((ret = av_tx_init(&venc->mdct[0], &venc->mdct_fn[0], AV_TX_FLOAT_MDCT,
-                          0, 1 << (venc->log2_blocksize[0] - 1), &scale, 0)) < 0)
-        return ret;
-    if ((ret = av_tx_init(&venc->mdct[1], &venc->mdct_fn[1], AV_TX_FLOAT_MDCT,
-                          0, 1 << (venc->log2_blocksize[1] - 1), &scale, 0)) < 0)
+    ff_vorbisencdsp_init(&venc->dsp);
+
+    return 0;
+}
+
+static int encode_slot(void *opaque);
+static int output_slot(AVCodecContext *avctx, void *opaque, int ret,
+                       AVPacket *avpkt);
+
+/**
+ * Set up one slot per thread. A packet only depends on its own window of
+ * input samples, so each slot needs its own transform and buffers, and
+ * packets can be encoded ahead on the executor.
+ */
+static av_cold int init_slots(AVCodecContext *avctx, vorbis_enc_context *venc)
+{
+    int blocksize  = 1 << venc->log2_blocksize[1];
+    float scale    = 1.0f;
+    int ret;
+
+    ret = ff_encode_slots_init(&venc->slots, avctx, sizeof(vorbis_enc_slot),
+                               encode_slot, output_slot);
+    if (ret < 0)
         return ret;
 
+    for (int i = 0; i < venc->slots.nb_slots; i++) {
+        vorbis_enc_slot *slot = ff_encode_slots_get(&venc->slots, i);
+
+        slot->venc    = venc;
+        slot->samples = av_malloc_array(blocksize,     sizeof(float) * venc->channels);
+        slot->floor   = av_malloc_array(blocksize / 2, sizeof(float) * venc->channels);
+        slot->coeffs  = av_malloc_array(blocksize / 2, sizeof(float) * venc->channels);
+        slot->buf     = av_malloc(MAX_PACKET_SIZE);
+        if (!slot->samples || !slot->floor || !slot->coeffs || !slot->buf)
+            return AVERROR(ENOMEM);
+
+        if ((ret = av_tx_init(&slot->mdct, &slot->mdct_fn, AV_TX_FLOAT_MDCT,
+                              0, blocksize / 2, &scale, 0)) < 0)
+            return ret;
+    }
+
     return 0;
 }
 
@@ -464,18 +524,15 @@ static int create_vorbis_context(vorbis_enc_context *venc,
 
     venc->have_saved = 0;
     venc->saved      = av_malloc_array((1 << venc->log2_blocksize[1]) / 2, sizeof(float) * venc->channels);
-    venc->samples    = av_malloc_array((1 << venc->log2_blocksize[1]), sizeof(float) * venc->channels);
-    venc->floor      = av_malloc_array((1 << venc->log2_blocksize[1]) / 2, sizeof(float) * venc->channels);
-    venc->coeffs     = av_malloc_array((1 << venc->log2_blocksize[1]) / 2, sizeof(float) * venc->channels);
     venc->scratch    = av_malloc_array((1 << venc->log2_blocksize[1]), sizeof(float) * venc->channels);
 
-    if (!venc->saved || !venc->samples || !venc->floor || !venc->coeffs || !venc->scratch)
+    if (!venc->saved || !venc->scratch)
         return AVERROR(ENOMEM);
 
     if ((ret = dsp_init(avctx, venc)) < 0)
         return ret;
 
-    return 0;
+    return init_slots(avctx, venc);
 }
 
 static void put_float(PutBitContext *pb, float f)
@@ -788,13 +845,18 @@ static void floor_fit(vorbis_enc_context *venc, vorbis_enc_floor *fc,
     for (i = 0; i < fc->values; i++) {
         int position  = fc->list[fc->list[i].sort].x;
         float average = averages[i];
-        int j;
+        int lo = 0, hi = range - 1;
 
         average = sqrt(tot_average * average) * pow(1.25f, position*0.005f); // MAGIC!
-        for (j = 0; j < range - 1; j++)
-            if (ff_vorbis_floor1_inverse_db_table[j * fc->multiplier] > average)
-                break;
-        posts[fc->list[i].sort] = j;
+        // first post above the average, the table is increasing
+        while (lo < hi) {
+            int mid = (lo + hi) >> 1;
+            if (ff_vorbis_floor1_inverse_db_table[mid * fc->multiplier] > average)
+                hi = mid;
+            else
+                lo = mid + 1;
+        }
+        posts[fc->list[i].sort] = lo;
     }
 }
 
@@ -892,24 +954,13 @@ static int floor_encode(vorbis_enc_context *venc, vorbis_enc_floor *fc,
     return 0;
 }
 
-static float *put_vector(vorbis_enc_codebook *book, PutBitContext *pb,
-                         float *num)
+static float *put_vector(vorbis_enc_context *venc, vorbis_enc_codebook *book,
+                         PutBitContext *pb, float *num)
 {
-    int i, entry = -1;
-    float distance = FLT_MAX;
+    int entry;
     assert(book->dimensions);
-    for (i = 0; i < book->nentries; i++) {
-        float * vec = book->dimensions + i * book->ndimensions, d = book->pow2[i];
-        int j;
-        if (!book->lens[i])
-            continue;
-        for (j = 0; j < book->ndimensions; j++)
-            d -= vec[j] * num[j];
-        if (distance > d) {
-            entry    = i;
-            distance = d;
-        }
-    }
+    entry = venc->dsp.find_entry(book->columns, book->pow2, num,
+                                 book->ndimensions, book->stride);
     if (put_codeword(pb, book, entry))
         return NULL;
     return &book->dimensions[entry * book->ndimensions];
@@ -970,7 +1021,7 @@ static int residue_encode(vorbis_enc_context *venc, vorbis_enc_residue *rc,
                     if (rc->type == 0) {
                         for (k = 0; k < psize; k += book->ndimensions) {
                             int l;
-                            float *a = put_vector(book, pb, &buf[k]);
+                            float *a = put_vector(venc, book, pb, &buf[k]);
                             if (!a)
                                 return AVERROR(EINVAL);
                             for (l = 0; l < book->ndimensions; l++)
@@ -991,7 +1042,7 @@ static int residue_encode(vorbis_enc_context *venc, vorbis_enc_residue *rc,
                                     b2++;
                                 }
                             }
-                            pv = put_vector(book, pb, vec);
+                            pv = put_vector(venc, book, pb, vec);
                             if (!pv)
                                 return AVERROR(EINVAL);
                             for (dim = book->ndimensions; dim--; ) {
@@ -1010,7 +1061,7 @@ static int residue_encode(vorbis_enc_context *venc, vorbis_enc_residue *rc,
     return 0;
 }
 
-static int apply_window_and_mdct(vorbis_enc_context *venc)
+static int apply_window_and_mdct(vorbis_enc_context *venc, vorbis_enc_slot *slot)
 {
     int channel;
     const float * win = venc->win[1];
@@ -1019,7 +1070,7 @@ static int apply_window_and_mdct(vorbis_enc_context *venc)
     AVFloatDSPContext *fdsp = venc->fdsp;
 
     for (channel = 0; channel < venc->channels; channel++) {
-        float *offset = venc->samples + channel * window_len * 2;
+        float *offset = slot->samples + channel * window_len * 2;
 
         fdsp->vector_fmul(offset, offset, win, window_len);
         fdsp->vector_fmul_scalar(offset, offset, 1/n, window_len);
@@ -1029,8 +1080,8 @@ static int apply_window_and_mdct(vorbis_enc_context *venc)
         fdsp->vector_fmul_reverse(offset, offset, win, window_len);
         fdsp->vector_fmul_scalar(offset, offset, 1/n, window_len);
 
-        venc->mdct_fn[1](venc->mdct[1], venc->coeffs + channel * window_len,
-                         venc->samples + channel * window_len * 2, sizeof(float));
+        slot->mdct_fn(slot->mdct, slot->coeffs + channel * window_len,
+                      slot->samples + channel * window_len * 2, sizeof(float));
     }
     return 1;
 }
@@ -1062,7 +1113,7 @@ static AVFrame *spawn_empty_frame(AVCodecContext *avctx, int channels)
 }
 
 /* Set up audio samples for psy analysis and window/mdct */
-static void move_audio(vorbis_enc_context *venc, int sf_size)
+static void move_audio(vorbis_enc_context *venc, vorbis_enc_slot *slot, int sf_size)
 {
     AVFrame *cur = NULL;
     int frame_size = 1 << (venc->log2_blocksize[1] - 1);
@@ -1072,17 +1123,17 @@ static void move_audio(vorbis_enc_context *venc, int sf_size)
     /* Copy samples from last frame into current frame */
     if (venc->have_saved)
         for (ch = 0; ch < venc->channels; ch++)
-            memcpy(venc->samples + 2 * ch * frame_size,
+            memcpy(slot->samples + 2 * ch * frame_size,
                    venc->saved + ch * frame_size, sizeof(float) * frame_size);
     else
         for (ch = 0; ch < venc->channels; ch++)
-            memset(venc->samples + 2 * ch * frame_size, 0, sizeof(float) * frame_size);
+            memset(slot->samples + 2 * ch * frame_size, 0, sizeof(float) * frame_size);
 
     for (sf = 0; sf < subframes; sf++) {
         cur = ff_bufqueue_get(&venc->bufqueue);
 
         for (ch = 0; ch < venc->channels; ch++) {
-            float *offset = venc->samples + 2 * ch * frame_size + frame_size;
+            float *offset = slot->samples + 2 * ch * frame_size + frame_size;
             float *save = venc->saved + ch * frame_size;
             const float *input = (float *) cur->extended_data[ch];
             const size_t len  = cur->nb_samples * sizeof(float);
@@ -1093,61 +1144,28 @@ static void move_audio(vorbis_enc_context *venc, int sf_size)
         av_frame_free(&cur);
     }
     venc->have_saved = 1;
-    memcpy(venc->scratch, venc->samples, 2 * venc->channels * frame_size);
+    memcpy(venc->scratch, slot->samples, 2 * venc->channels * frame_size);
 }
 
-static int vorbis_encode_frame(AVCodecContext *avctx, AVPacket *avpkt,
-                               const AVFrame *frame, int *got_packet_ptr)
+/**
+ * Encode the packet of a slot into its buffer.
+ * Only the slot's buffers are modified, this may run on a worker thread.
+ * @return size of the packet or a negative error code
+ */
+static int encode_slot(void *opaque)
 {
-    vorbis_enc_context *venc = avctx->priv_data;
-    int i, ret, need_more;
+    vorbis_enc_slot *slot    = opaque;
+    vorbis_enc_context *venc = slot->venc;
+    int i;
     int frame_size = 1 << (venc->log2_blocksize[1] - 1);
     vorbis_enc_mode *mode;
     vorbis_enc_mapping *mapping;
     PutBitContext pb;
 
-    if (frame) {
-        AVFrame *clone;
-        if ((ret = ff_af_queue_add(&venc->afq, frame)) < 0)
-            return ret;
-        clone = av_frame_clone(frame);
-        if (!clone)
-            return AVERROR(ENOMEM);
-        ff_bufqueue_add(avctx, &venc->bufqueue, clone);
-    } else
-        if (!venc->afq.remaining_samples)
-            return 0;
-
-    need_more = venc->bufqueue.available * avctx->frame_size < frame_size;
-    need_more = frame && need_more;
-    if (need_more)
-        return 0;
-
-    /* Pad the bufqueue with empty frames for encoding the last packet. */
-    if (!frame) {
-        if (venc->bufqueue.available * avctx->frame_size < frame_size) {
-            int frames_needed = (frame_size/avctx->frame_size) - venc->bufqueue.available;
-            int i;
-
-            for (i = 0; i < frames_needed; i++) {
-               AVFrame *empty = spawn_empty_frame(avctx, venc->channels);
-               if (!empty)
-                   return AVERROR(ENOMEM);
-
-               ff_bufqueue_add(avctx, &venc->bufqueue, empty);
-            }
-        }
-    }
-
-    move_audio(venc, avctx->frame_size);
-
-    if (!apply_window_and_mdct(venc))
+    if (!apply_window_and_mdct(venc, slot))
         return 0;
 
-    if ((ret = ff_alloc_packet(avctx, avpkt, 8192)) < 0)
-        return ret;
-
-    init_put_bits(&pb, avpkt->data, avpkt->size);
+    init_put_bits(&pb, slot->buf, MAX_PACKET_SIZE);
 
     put_bits(&pb, 1, 0); // magic bit
 
@@ -1163,19 +1181,17 @@ static int vorbis_encode_frame(AVCodecContext *avctx, AVPacket *avpkt,
     for (i = 0; i < venc->channels; i++) {
         vorbis_enc_floor *fc = &venc->floors[mapping->floor[mapping->mux[i]]];
         uint16_t posts[MAX_FLOOR_VALUES];
-        floor_fit(venc, fc, &venc->coeffs[i * frame_size], posts, frame_size);
-        if (floor_encode(venc, fc, &pb, posts, &venc->floor[i * frame_size], frame_size)) {
-            av_log(avctx, AV_LOG_ERROR, "output buffer is too small\n");
+        floor_fit(venc, fc, &slot->coeffs[i * frame_size], posts, frame_size);
+        if (floor_encode(venc, fc, &pb, posts, &slot->floor[i * frame_size], frame_size))
             return AVERROR(EINVAL);
-        }
     }
 
     for (i = 0; i < venc->channels * frame_size; i++)
-        venc->coeffs[i] /= venc->floor[i];
+        slot->coeffs[i] /= slot->floor[i];
 
     for (i = 0; i < mapping->coupling_steps; i++) {
-        float *mag = venc->coeffs + mapping->magnitude[i] * frame_size;
-        float *ang = venc->coeffs + mapping->angle[i]     * frame_size;
+        float *mag = slot->coeffs + mapping->magnitude[i] * frame_size;
+        float *ang = slot->coeffs + mapping->angle[i]     * frame_size;
         int j;
         for (j = 0; j < frame_size; j++) {
             float a = ang[j];
@@ -1188,13 +1204,31 @@ static int vorbis_encode_frame(AVCodecContext *avctx, AVPacket *avpkt,
     }
 
     if (residue_encode(venc, &venc->residues[mapping->residue[mapping->mux[0]]],
-                       &pb, venc->coeffs, frame_size, venc->channels)) {
-        av_log(avctx, AV_LOG_ERROR, "output buffer is too small\n");
+                       &pb, slot->coeffs, frame_size, venc->channels))
         return AVERROR(EINVAL);
-    }
 
     flush_put_bits(&pb);
-    avpkt->size = put_bytes_output(&pb);
+    return put_bytes_output(&pb);
+}
+
+/**
+ * Return the oldest queued packet.
+ */
+static int output_slot(AVCodecContext *avctx, void *opaque, int ret,
+                       AVPacket *avpkt)
+{
+    vorbis_enc_context *venc = avctx->priv_data;
+    vorbis_enc_slot *slot    = opaque;
+    int frame_size = 1 << (venc->log2_blocksize[1] - 1);
+
+    if (ret < 0) {
+        av_log(avctx, AV_LOG_ERROR, "output buffer is too small\n");
+        return ret;
+    }
+
+    if ((ret = ff_get_encode_buffer(avctx, avpkt, ret, 0)) < 0)
+        return ret;
+    memcpy(avpkt->data, slot->buf, avpkt->size);
 
     ff_af_queue_remove(&venc->afq, frame_size, &avpkt->pts, &avpkt->duration);
 
@@ -1205,16 +1239,83 @@ static int vorbis_encode_frame(AVCodecContext *avctx, AVPacket *avpkt,
         AV_WL32(&side[4], frame_size - avpkt->duration);
     }
 
+    return 0;
+}
+
+static int vorbis_encode_frame(AVCodecContext *avctx, AVPacket *avpkt,
+                               const AVFrame *frame, int *got_packet_ptr)
+{
+    vorbis_enc_context *venc = avctx->priv_data;
+    vorbis_enc_slot *slot;
+    int ret;
+    int frame_size = 1 << (venc->log2_blocksize[1] - 1);
+
+    if (frame) {
+        AVFrame *clone;
+        if ((ret = ff_af_queue_add(&venc->afq, frame)) < 0)
+            return ret;
+        clone = av_frame_clone(frame);
+        if (!clone)
+            return AVERROR(ENOMEM);
+        ff_bufqueue_add(avctx, &venc->bufqueue, clone);
+    }
+
+    /* Queue packets while there are free slots and enough input. */
+    while ((slot = ff_encode_slots_next(&venc->slots))) {
+        if (!frame && venc->afq.remaining_samples <= venc->slots.nb_pending * frame_size)
+            break;
+
+        if (venc->bufqueue.available * avctx->frame_size < frame_size) {
+            int frames_needed = (frame_size/avctx->frame_size) - venc->bufqueue.available;
+
+            if (frame)
+                break;
+
+            /* Pad the bufqueue with empty frames for encoding the last packet. */
+            for (int i = 0; i < frames_needed; i++) {
+               AVFrame *empty = spawn_empty_frame(avctx, venc->channels);
+               if (!empty)
+                   return AVERROR(ENOMEM);
+
+               ff_bufqueue_add(avctx, &venc->bufqueue, empty);
+            }
+        }
+
+        move_audio(venc, slot, avctx->frame_size);
+        if ((ret = ff_encode_slots_submit(&venc->slots)) < 0)
+            return ret;
+    }
+
+    /* Only wait for a packet when all slots are busy or when flushing. */
+    if (!venc->slots.nb_pending || (frame && slot))
+        return 0;
+
+    if ((ret = ff_encode_slots_output(&venc->slots, avctx, avpkt)) < 0)
+        return ret;
+
     *got_packet_ptr = 1;
     return 0;
 }
 
 
+static void free_slot(void *opaque)
+{
+    vorbis_enc_slot *slot = opaque;
+
+    av_tx_uninit(&slot->mdct);
+    av_freep(&slot->samples);
+    av_freep(&slot->floor);
+    av_freep(&slot->coeffs);
+    av_freep(&slot->buf);
+}
+
 static av_cold int vorbis_encode_close(AVCodecContext *avctx)
 {
     vorbis_enc_context *venc = avctx->priv_data;
     int i;
 
+    ff_encode_slots_uninit(&venc->slots, free_slot);
+
     if (venc->codebooks)
         for (i = 0; i < venc->ncodebooks; i++) {
             av_freep(&venc->codebooks[i].lens);
@@ -1222,6 +1323,7 @@ static av_cold int vorbis_encode_close(AVCodecContext *avctx)
             av_freep(&venc->codebooks[i].quantlist);
             av_freep(&venc->codebooks[i].dimensions);
             av_freep(&venc->codebooks[i].pow2);
+            av_freep(&venc->codebooks[i].columns);
         }
     av_freep(&venc->codebooks);
 
@@ -1257,14 +1359,9 @@ static av_cold int vorbis_encode_close(AVCodecContext *avctx)
     av_freep(&venc->modes);
 
     av_freep(&venc->saved);
-    av_freep(&venc->samples);
-    av_freep(&venc->floor);
-    av_freep(&venc->coeffs);
     av_freep(&venc->scratch);
     av_freep(&venc->fdsp);
 
-    av_tx_uninit(&venc->mdct[0]);
-    av_tx_uninit(&venc->mdct[1]);
     ff_af_queue_close(&venc->afq);
     ff_bufqueue_discard_all(&venc->bufqueue);
 
@@ -1309,11 +1406,11 @@ const FFCodec ff_vorbis_encoder = {
     .p.type         = AVMEDIA_TYPE_AUDIO,
     .p.id           = AV_CODEC_ID_VORBIS,
     .p.capabilities = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_DELAY |
-                      AV_CODEC_CAP_EXPERIMENTAL,
+                      AV_CODEC_CAP_EXPERIMENTAL | AV_CODEC_CAP_OTHER_THREADS,
     .priv_data_size = sizeof(vorbis_enc_context),
     .init           = vorbis_encode_init,
     FF_CODEC_ENCODE_CB(vorbis_encode_frame),
     .close          = vorbis_encode_close,
     CODEC_SAMPLEFMTS(AV_SAMPLE_FMT_FLTP),
-    .caps_internal  = FF_CODEC_CAP_INIT_CLEANUP,
+    .caps_internal  = FF_CODEC_CAP_INIT_CLEANUP | FF_CODEC_CAP_AUTO_THREADS,
 };
@@ -0,0 +1,54 @@
+/*
+ * This file is part of Librempeg
+ *
+ * Librempeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Librempeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Librempeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <float.h>
+
+#include "libavutil/attributes.h"
+#include "vorbisencdsp.h"
+#include "config.h"
+
+static int find_entry_c(const float *dims, const float *pow2,
+                        const float *num, int ndim, int stride)
+{
+    float distance = FLT_MAX;
+    int entry = -1;
+
+    for (int i = 0; i < stride; i++) {
+        float d = pow2[i];
+
+        for (int j = 0; j < ndim; j++)
+            d -= dims[j * stride + i] * num[j];
+        if (distance > d) {
+            entry    = i;
+            distance = d;
+        }
+    }
+
+    return entry;
+}
+
+av_cold void ff_vorbisencdsp_init(VorbisEncDSPContext *c)
+{
+    c->find_entry = find_entry_c;
+
+#if ARCH_AARCH64
+    ff_vorbisencdsp_init_aarch64(c);
+#elif ARCH_X86
+    ff_vorbisencdsp_init_x86(c);
+#endif
+}
@@ -0,0 +1,43 @@
+/*
+ * This file is part of Librempeg
+ *
+ * Librempeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Librempeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Librempeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef AVCODEC_VORBISENCDSP_H
+#define AVCODEC_VORBISENCDSP_H
+
+typedef struct VorbisEncDSPContext {
+    /**
+     * Find the codebook entry nearest to a vector, i.e. the first entry
+     * with the lowest pow2[i] - sum(dims[j * stride + i] * num[j]).
+     * @param dims   entry values, dimension j of entry i at dims[j * stride + i]
+     * @param pow2   half the squared length of each entry, infinite for
+     *               the entries which must not be used
+     * @param num    vector of ndim values
+     * @param ndim   number of dimensions, between 1 and 8
+     * @param stride number of entries, a multiple of 16, dims and pow2
+     *               are aligned to 32 bytes
+     * @return index of the entry, -1 if none is usable
+     */
+    int (*find_entry)(const float *dims, const float *pow2,
+                      const float *num, int ndim, int stride);
+} VorbisEncDSPContext;
+
+void ff_vorbisencdsp_init(VorbisEncDSPContext *c);
+void ff_vorbisencdsp_init_aarch64(VorbisEncDSPContext *c);
+void ff_vorbisencdsp_init_x86(VorbisEncDSPContext *c);
+
+#endif /* AVCODEC_VORBISENCDSP_H */
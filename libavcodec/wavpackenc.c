@@ -30,6 +30,7 @@
 #include "put_bits.h"
 #include "bytestream.h"
 #include "wavpackenc.h"
+#include "wavpackencdsp.h"
 #include "wavpack.h"
 
 #define UPDATE_WEIGHT(weight, delta, source, result) \
@@ -63,6 +64,8 @@
 #define EXTRA_BRANCHES       8
 #define EXTRA_SORT_LAST     16
 
+#define MAX_SEARCH_JOBS     16
+
 typedef struct WavPackExtraInfo {
     struct Decorr dps[MAX_TERMS];
     int nterms, log_limit, gt16bit;
@@ -97,6 +100,10 @@ typedef struct WavPackEncodeContext {
     int32_t *best_buffer[2];
     int best_buffer_size[2];
 
+    int32_t *search_buffer[MAX_SEARCH_JOBS][5];
+    int search_buffer_size[MAX_SEARCH_JOBS][5];
+    int nb_search_jobs;
+
     int32_t *js_left, *js_right;
     int js_left_size, js_right_size;
 
@@ -123,8 +130,32 @@ typedef struct WavPackEncodeContext {
     struct Decorr decorr_passes[MAX_TERMS];
     const WavPackDecorrSpec *decorr_specs;
     float delta_decay;
+
+    WavPackEncDSPContext dsp;
 } WavPackEncodeContext;
 
+/**
+ * Candidate terms for one decorrelation pass, tried in parallel.
+ * The candidates are split into items of one term, or up to four terms
+ * tried at once with the quick stereo decorrelation.
+ */
+typedef struct WavPackTermSearch {
+    WavPackEncodeContext *s;
+    const WavPackExtraInfo *info;
+    int depth, delta;
+    int terms[22];
+    int nb_terms, nb_jobs;
+    int item[23];                   ///< first candidate of each item
+    int nb_items;
+
+    uint32_t bits[22];
+    struct Decorr dps[22];          ///< pass state of each candidate
+
+    int best[MAX_SEARCH_JOBS];      ///< best candidate of each job, -1 if none
+    uint32_t best_bits[MAX_SEARCH_JOBS];
+    int32_t *best_samples[MAX_SEARCH_JOBS][2];
+} WavPackTermSearch;
+
 static av_cold int wavpack_encode_init(AVCodecContext *avctx)
 {
     WavPackEncodeContext *s = avctx->priv_data;
@@ -192,6 +223,11 @@ static av_cold int wavpack_encode_init(AVCodecContext *avctx)
 
     s->delta_decay = 2.0;
 
+    s->nb_search_jobs = avctx->active_thread_type & FF_THREAD_SLICE ?
+                        av_clip(avctx->thread_count, 1, MAX_SEARCH_JOBS) : 1;
+
+    ff_wavpackencdsp_init(&s->dsp);
+
     return 0;
 }
 
@@ -680,6 +716,19 @@ static uint32_t log2stereo(int32_t *samples_l, int32_t *samples_r,
     return result;
 }
 
+static uint32_t log2stereo_lane(const int32_t *samples, int nb_samples,
+                                int lane, int limit)
+{
+    uint32_t result = 0;
+    while (nb_samples--) {
+        if (log2sample(abs(samples[lane]), limit, &result) ||
+            log2sample(abs(samples[lane + 4]), limit, &result))
+            return UINT32_MAX;
+        samples += 8;
+    }
+    return result;
+}
+
 static void decorr_mono_buffer(int32_t *samples, int32_t *outsamples,
                                int nb_samples, struct Decorr *dpp,
                                int tindex)
@@ -719,12 +768,93 @@ static void decorr_mono_buffer(int32_t *samples, int32_t *outsamples,
     decorr_mono(samples, outsamples, nb_samples, &dp, 1);
 }
 
+/**
+ * Try the candidate terms of a search job, every job keeps the output of
+ * its best candidate. Items are spread over the jobs in order, so that
+ * the lowest of the best candidates wins ties like in a serial search.
+ */
+static int search_terms_mono(AVCodecContext *avctx, void *arg, int jobnr, int threadnr)
+{
+    WavPackTermSearch *ts = arg;
+    WavPackEncodeContext *s = ts->s;
+    WavPackExtraInfo info = *ts->info;
+    int32_t *samples = s->sampleptrs[ts->depth][0];
+    int32_t *outsamples = s->search_buffer[jobnr][0];
+    int32_t *best = s->search_buffer[jobnr][2];
+
+    ts->best[jobnr] = -1;
+    ts->best_bits[jobnr] = info.best_bits;
+
+    for (int k = jobnr; k < ts->nb_items; k += ts->nb_jobs) {
+        int i = ts->item[k];
+
+        info.dps[ts->depth].value = ts->terms[i];
+        info.dps[ts->depth].delta = ts->delta;
+        decorr_mono_buffer(samples, outsamples, s->block_samples, info.dps, ts->depth);
+        ts->bits[i] = log2mono(outsamples, s->block_samples, info.log_limit);
+        ts->dps[i] = info.dps[ts->depth];
+
+        if (ts->bits[i] < ts->best_bits[jobnr]) {
+            ts->best_bits[jobnr] = ts->bits[i];
+            ts->best[jobnr] = i;
+            FFSWAP(int32_t *, outsamples, best);
+        }
+    }
+
+    ts->best_samples[jobnr][0] = best;
+
+    return 0;
+}
+
+/**
+ * Try all candidate terms of a decorrelation pass and keep the best one
+ * if it improves on the best result so far. The bits of every candidate
+ * are returned in term_bits.
+ */
+static void search_terms(WavPackEncodeContext *s, WavPackExtraInfo *info,
+                         WavPackTermSearch *ts, uint32_t *term_bits,
+                         int (*job)(AVCodecContext *avctx, void *arg,
+                                    int jobnr, int threadnr))
+{
+    int i, best = -1;
+
+    ts->s       = s;
+    ts->info    = info;
+    ts->nb_jobs = FFMIN(s->nb_search_jobs, ts->nb_items);
+    s->avctx->execute2(s->avctx, job, ts, NULL, ts->nb_jobs);
+
+    for (i = 0; i < ts->nb_jobs; i++) {
+        if (ts->best[i] < 0)
+            continue;
+        if (best < 0 || ts->best_bits[i] < ts->best_bits[best] ||
+            (ts->best_bits[i] == ts->best_bits[best] && ts->best[i] < ts->best[best]))
+            best = i;
+    }
+
+    if (best >= 0) {
+        info->best_bits = ts->best_bits[best];
+        CLEAR(s->decorr_passes);
+        memcpy(s->decorr_passes, info->dps, sizeof(info->dps[0]) * ts->depth);
+        s->decorr_passes[ts->depth] = ts->dps[ts->best[best]];
+        memcpy(s->sampleptrs[info->nterms + 1][0], ts->best_samples[best][0],
+               s->block_samples * 4);
+        if (!(s->flags & WV_MONO_DATA))
+            memcpy(s->sampleptrs[info->nterms + 1][1], ts->best_samples[best][1],
+                   s->block_samples * 4);
+    }
+
+    for (i = 0; i < ts->nb_terms; i++)
+        term_bits[ts->terms[i] + 3] = ts->bits[i];
+    info->dps[ts->depth] = ts->dps[ts->nb_terms - 1];
+}
+
 static void recurse_mono(WavPackEncodeContext *s, WavPackExtraInfo *info,
                          int depth, int delta, uint32_t input_bits)
 {
+    WavPackTermSearch ts = { .depth = depth, .delta = delta };
     int term, branches = s->num_branches - depth;
     int32_t *samples, *outsamples;
-    uint32_t term_bits[22], bits;
+    uint32_t term_bits[22];
 
     if (branches < 1 || depth + 1 == info->nterms)
         branches = 1;
@@ -743,22 +873,12 @@ static void recurse_mono(WavPackEncodeContext *s, WavPackExtraInfo *info,
         if (!s->extra_flags && (term > 4 && term < 17))
             continue;
 
-        info->dps[depth].value = term;
-        info->dps[depth].delta = delta;
-        decorr_mono_buffer(samples, outsamples, s->block_samples, info->dps, depth);
-        bits = log2mono(outsamples, s->block_samples, info->log_limit);
-
-        if (bits < info->best_bits) {
-            info->best_bits = bits;
-            CLEAR(s->decorr_passes);
-            memcpy(s->decorr_passes, info->dps, sizeof(info->dps[0]) * (depth + 1));
-            memcpy(s->sampleptrs[info->nterms + 1][0],
-                   s->sampleptrs[depth + 1][0], s->block_samples * 4);
-        }
-
-        term_bits[term + 3] = bits;
+        ts.item[ts.nb_items++] = ts.nb_terms;
+        ts.terms[ts.nb_terms++] = term;
     }
 
+    search_terms(s, info, &ts, term_bits, search_terms_mono);
+
     while (depth + 1 < info->nterms && branches--) {
         uint32_t local_best_bits = input_bits;
         int best_term = 0, i;
@@ -899,6 +1019,17 @@ static int allocate_buffers2(WavPackEncodeContext *s, int nterms)
         }
     }
 
+    for (i = 0; i < s->nb_search_jobs; i++) {
+        for (int j = 0; j < 5; j++) {
+            if ((j & 1) && (s->flags & WV_MONO_DATA))
+                continue;
+            av_fast_padded_malloc(&s->search_buffer[i][j], &s->search_buffer_size[i][j],
+                                  s->block_samples * (j < 4 ? 4 : 32));
+            if (!s->search_buffer[i][j])
+                return AVERROR(ENOMEM);
+        }
+    }
+
     return 0;
 }
 
@@ -1495,12 +1626,17 @@ static void decorr_stereo_quick(int32_t *in_left,  int32_t *in_right,
     }
 }
 
-static void decorr_stereo_buffer(WavPackExtraInfo *info,
-                                 int32_t *in_left,  int32_t *in_right,
-                                 int32_t *out_left, int32_t *out_right,
-                                 int nb_samples, int tindex)
+/**
+ * Set up the weights and history of decorrelation pass tindex from the
+ * start of the block, dp receives the state the pass over the whole block
+ * starts from. out_left and out_right are used as scratch buffers.
+ */
+static void init_stereo_pass(WavPackExtraInfo *info,
+                             int32_t *in_left,  int32_t *in_right,
+                             int32_t *out_left, int32_t *out_right,
+                             int nb_samples, int tindex, struct Decorr *dp)
 {
-    struct Decorr dp = {0}, *dppi = info->dps + tindex;
+    struct Decorr *dppi = info->dps + tindex;
     int delta = dppi->delta, pre_delta;
     int term = dppi->value;
 
@@ -1511,33 +1647,44 @@ static void decorr_stereo_buffer(WavPackExtraInfo *info,
     else
         pre_delta = delta + 1;
 
-    dp.value = term;
-    dp.delta = pre_delta;
+    dp->value = term;
+    dp->delta = pre_delta;
     decorr_stereo(in_left, in_right, out_left, out_right,
-                  FFMIN(2048, nb_samples), &dp, -1);
-    dp.delta = delta;
+                  FFMIN(2048, nb_samples), dp, -1);
+    dp->delta = delta;
 
     if (tindex == 0) {
-        reverse_decorr(&dp);
+        reverse_decorr(dp);
     } else {
-        CLEAR(dp.samplesA);
-        CLEAR(dp.samplesB);
+        CLEAR(dp->samplesA);
+        CLEAR(dp->samplesB);
     }
 
-    memcpy(dppi->samplesA, dp.samplesA, sizeof(dp.samplesA));
-    memcpy(dppi->samplesB, dp.samplesB, sizeof(dp.samplesB));
-    dppi->weightA = dp.weightA;
-    dppi->weightB = dp.weightB;
+    memcpy(dppi->samplesA, dp->samplesA, sizeof(dp->samplesA));
+    memcpy(dppi->samplesB, dp->samplesB, sizeof(dp->samplesB));
+    dppi->weightA = dp->weightA;
+    dppi->weightB = dp->weightB;
 
     if (delta == 0) {
-        dp.delta = 1;
-        decorr_stereo(in_left, in_right, out_left, out_right, nb_samples, &dp, 1);
-        dp.delta = 0;
-        memcpy(dp.samplesA, dppi->samplesA, sizeof(dp.samplesA));
-        memcpy(dp.samplesB, dppi->samplesB, sizeof(dp.samplesB));
-        dppi->weightA = dp.weightA = dp.sumA / nb_samples;
-        dppi->weightB = dp.weightB = dp.sumB / nb_samples;
+        dp->delta = 1;
+        decorr_stereo(in_left, in_right, out_left, out_right, nb_samples, dp, 1);
+        dp->delta = 0;
+        memcpy(dp->samplesA, dppi->samplesA, sizeof(dp->samplesA));
+        memcpy(dp->samplesB, dppi->samplesB, sizeof(dp->samplesB));
+        dppi->weightA = dp->weightA = dp->sumA / nb_samples;
+        dppi->weightB = dp->weightB = dp->sumB / nb_samples;
     }
+}
+
+static void decorr_stereo_buffer(WavPackExtraInfo *info,
+                                 int32_t *in_left,  int32_t *in_right,
+                                 int32_t *out_left, int32_t *out_right,
+                                 int nb_samples, int tindex)
+{
+    struct Decorr dp = {0};
+
+    init_stereo_pass(info, in_left, in_right, out_left, out_right,
+                     nb_samples, tindex, &dp);
 
     if (info->gt16bit)
         decorr_stereo(in_left, in_right, out_left, out_right,
@@ -1547,6 +1694,93 @@ static void decorr_stereo_buffer(WavPackExtraInfo *info,
                             nb_samples, &dp);
 }
 
+/**
+ * Write the predictions of a positive term for one channel to every
+ * eighth entry of dst, like decorr_stereo_quick() computes them.
+ */
+static void stereo_predictions(int32_t *dst, const int32_t *in,
+                               const int32_t *hist, int term, int nb_samples)
+{
+    int32_t head[2 * MAX_TERM] = { 0 };
+    int i, nb_head = FFMIN(nb_samples, MAX_TERM);
+
+    if (term > MAX_TERM) {
+        head[MAX_TERM - 1] = hist[0];
+        head[MAX_TERM - 2] = hist[1];
+    } else {
+        for (i = 0; i < term; i++)
+            head[MAX_TERM - term + i] = hist[i];
+    }
+    memcpy(head + MAX_TERM, in, nb_head * sizeof(*in));
+
+    switch (term) {
+    case 17:
+        for (i = 0; i < nb_head; i++)
+            dst[8 * i] = 2 * head[MAX_TERM + i - 1] - head[MAX_TERM + i - 2];
+        for (; i < nb_samples; i++)
+            dst[8 * i] = 2 * in[i - 1] - in[i - 2];
+        break;
+    case 18:
+        for (i = 0; i < nb_head; i++)
+            dst[8 * i] = head[MAX_TERM + i - 1] +
+                         ((head[MAX_TERM + i - 1] - head[MAX_TERM + i - 2]) >> 1);
+        for (; i < nb_samples; i++)
+            dst[8 * i] = in[i - 1] + ((in[i - 1] - in[i - 2]) >> 1);
+        break;
+    default:
+        for (i = 0; i < nb_head; i++)
+            dst[8 * i] = head[MAX_TERM + i - term];
+        for (; i < nb_samples; i++)
+            dst[8 * i] = in[i - term];
+        break;
+    }
+}
+
+/**
+ * Run decorr_stereo_buffer() with the quick decorrelation for up to four
+ * positive terms at once. The residuals of term j end up in lanes j (left)
+ * and 4 + j (right) of samples, dps receives the pass state of each term.
+ */
+static void decorr_stereo_buffer_quick4(WavPackEncodeContext *s,
+                                        WavPackExtraInfo *info,
+                                        int32_t *in_left,  int32_t *in_right,
+                                        int32_t *out_left, int32_t *out_right,
+                                        int32_t *samples, const int *terms,
+                                        int nb_terms, int tindex,
+                                        struct Decorr *dps)
+{
+    int nb_samples = s->block_samples, delta = info->dps[tindex].delta;
+    int32_t weight[8] = { 0 };
+
+    for (int j = 0; j < 4; j++) {
+        struct Decorr dp = { 0 };
+        int32_t hist[2][MAX_TERM];
+
+        if (j >= nb_terms) {
+            for (int i = 0; i < nb_samples; i++)
+                samples[8 * i + j] = samples[8 * i + 4 + j] = 0;
+            continue;
+        }
+
+        info->dps[tindex].value = terms[j];
+        init_stereo_pass(info, in_left, in_right, out_left, out_right,
+                         nb_samples, tindex, &dp);
+        dps[j] = info->dps[tindex];
+
+        weight[j]     = restore_weight(store_weight(dp.weightA));
+        weight[4 + j] = restore_weight(store_weight(dp.weightB));
+        for (int i = 0; i < MAX_TERM; i++) {
+            hist[0][i] = wp_exp2(log2s(dp.samplesA[i]));
+            hist[1][i] = wp_exp2(log2s(dp.samplesB[i]));
+        }
+
+        stereo_predictions(samples + j,     in_left,  hist[0], terms[j], nb_samples);
+        stereo_predictions(samples + 4 + j, in_right, hist[1], terms[j], nb_samples);
+    }
+
+    s->dsp.decorr_stereo_quick4(samples, in_left, in_right, weight, delta, nb_samples);
+}
+
 static void sort_stereo(WavPackEncodeContext *s, WavPackExtraInfo *info)
 {
     int reversed = 1;
@@ -1664,12 +1898,72 @@ static void delta_stereo(WavPackEncodeContext *s, WavPackExtraInfo *info)
     }
 }
 
+static int search_terms_stereo(AVCodecContext *avctx, void *arg, int jobnr, int threadnr)
+{
+    WavPackTermSearch *ts = arg;
+    WavPackEncodeContext *s = ts->s;
+    WavPackExtraInfo info = *ts->info;
+    int32_t *in_left  = s->sampleptrs[ts->depth][0];
+    int32_t *in_right = s->sampleptrs[ts->depth][1];
+    int32_t *out_left = s->search_buffer[jobnr][0], *out_right = s->search_buffer[jobnr][1];
+    int32_t *best_left = s->search_buffer[jobnr][2], *best_right = s->search_buffer[jobnr][3];
+    int32_t *samples = s->search_buffer[jobnr][4];
+
+    ts->best[jobnr] = -1;
+    ts->best_bits[jobnr] = info.best_bits;
+
+    for (int k = jobnr; k < ts->nb_items; k += ts->nb_jobs) {
+        int i = ts->item[k], nb_terms = ts->item[k + 1] - i;
+
+        info.dps[ts->depth].value = ts->terms[i];
+        info.dps[ts->depth].delta = ts->delta;
+
+        if (nb_terms == 1) {
+            decorr_stereo_buffer(&info, in_left, in_right, out_left, out_right,
+                                 s->block_samples, ts->depth);
+            ts->bits[i] = log2stereo(out_left, out_right, s->block_samples, info.log_limit);
+            ts->dps[i] = info.dps[ts->depth];
+
+            if (ts->bits[i] < ts->best_bits[jobnr]) {
+                ts->best_bits[jobnr] = ts->bits[i];
+                ts->best[jobnr] = i;
+                FFSWAP(int32_t *, out_left,  best_left);
+                FFSWAP(int32_t *, out_right, best_right);
+            }
+            continue;
+        }
+
+        decorr_stereo_buffer_quick4(s, &info, in_left, in_right, out_left, out_right,
+                                    samples, ts->terms + i, nb_terms, ts->depth,
+                                    ts->dps + i);
+
+        for (int j = 0; j < nb_terms; j++, i++) {
+            ts->bits[i] = log2stereo_lane(samples, s->block_samples, j, info.log_limit);
+
+            if (ts->bits[i] < ts->best_bits[jobnr]) {
+                ts->best_bits[jobnr] = ts->bits[i];
+                ts->best[jobnr] = i;
+                for (int n = 0; n < s->block_samples; n++) {
+                    best_left[n]  = samples[8 * n + j];
+                    best_right[n] = samples[8 * n + 4 + j];
+                }
+            }
+        }
+    }
+
+    ts->best_samples[jobnr][0] = best_left;
+    ts->best_samples[jobnr][1] = best_right;
+
+    return 0;
+}
+
 static void recurse_stereo(WavPackEncodeContext *s, WavPackExtraInfo *info,
                            int depth, int delta, uint32_t input_bits)
 {
+    WavPackTermSearch ts = { .depth = depth, .delta = delta };
     int term, branches = s->num_branches - depth;
     int32_t *in_left, *in_right, *out_left, *out_right;
-    uint32_t term_bits[22], bits;
+    uint32_t term_bits[22];
 
     if (branches < 1 || depth + 1 == info->nterms)
         branches = 1;
@@ -1694,24 +1988,14 @@ static void recurse_stereo(WavPackEncodeContext *s, WavPackExtraInfo *info,
         if (!s->extra_flags && (term > 4 && term < 17))
             continue;
 
-        info->dps[depth].value = term;
-        info->dps[depth].delta = delta;
-        decorr_stereo_buffer(info, in_left, in_right, out_left, out_right,
-                             s->block_samples, depth);
-        bits = log2stereo(out_left, out_right, s->block_samples, info->log_limit);
-
-        if (bits < info->best_bits) {
-            info->best_bits = bits;
-            CLEAR(s->decorr_passes);
-            memcpy(s->decorr_passes, info->dps, sizeof(info->dps[0]) * (depth + 1));
-            memcpy(s->sampleptrs[info->nterms + 1][0], s->sampleptrs[depth + 1][0],
-                   s->block_samples * 4);
-            memcpy(s->sampleptrs[info->nterms + 1][1], s->sampleptrs[depth + 1][1],
-                   s->block_samples * 4);
-        }
-
-        term_bits[term + 3] = bits;
+        if (info->gt16bit || term < 0 || !ts.nb_terms || ts.terms[ts.nb_terms - 1] < 0 ||
+            ts.nb_terms - ts.item[ts.nb_items - 1] == 4)
+            ts.item[ts.nb_items++] = ts.nb_terms;
+        ts.terms[ts.nb_terms++] = term;
     }
+    ts.item[ts.nb_items] = ts.nb_terms;
+
+    search_terms(s, info, &ts, term_bits, search_terms_stereo);
 
     while (depth + 1 < info->nterms && branches--) {
         uint32_t local_best_bits = input_bits;
@@ -2942,6 +3226,13 @@ static av_cold int wavpack_encode_close(AVCodecContext *avctx)
         s->temp_buffer_size[i][0] = s->temp_buffer_size[i][1] = 0;
     }
 
+    for (i = 0; i < MAX_SEARCH_JOBS; i++) {
+        for (int j = 0; j < 5; j++) {
+            av_freep(&s->search_buffer[i][j]);
+            s->search_buffer_size[i][j] = 0;
+        }
+    }
+
     av_freep(&s->js_left);
     av_freep(&s->js_right);
     s->js_left_size = s->js_right_size = 0;
@@ -2973,7 +3264,8 @@ const FFCodec ff_wavpack_encoder = {
     .p.type         = AVMEDIA_TYPE_AUDIO,
     .p.id           = AV_CODEC_ID_WAVPACK,
     .p.capabilities = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_SMALL_LAST_FRAME |
-                      AV_CODEC_CAP_ENCODER_REORDERED_OPAQUE,
+                      AV_CODEC_CAP_ENCODER_REORDERED_OPAQUE |
+                      AV_CODEC_CAP_SLICE_THREADS,
     .priv_data_size = sizeof(WavPackEncodeContext),
     .p.priv_class   = &wavpack_encoder_class,
     .init           = wavpack_encode_init,
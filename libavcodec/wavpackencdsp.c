@@ -0,0 +1,52 @@
+/*
+ * This file is part of Librempeg
+ *
+ * Librempeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Librempeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Librempeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "libavutil/attributes.h"
+#include "wavpackencdsp.h"
+#include "config.h"
+
+static void decorr_stereo_quick4_c(int32_t *samples, const int32_t *in_left,
+                                   const int32_t *in_right, int32_t *weight,
+                                   int delta, int nb_samples)
+{
+    for (int i = 0; i < nb_samples; i++) {
+        for (int j = 0; j < 8; j++) {
+            int32_t sam = samples[j];
+            int32_t tmp = (j < 4 ? in_left[i] : in_right[i]) -
+                          ((weight[j] * sam + 512) >> 10);
+
+            samples[j] = tmp;
+            if (sam && tmp) {
+                int32_t s = (sam ^ tmp) >> 31;
+                weight[j] = (delta ^ s) + (weight[j] - s);
+            }
+        }
+        samples += 8;
+    }
+}
+
+av_cold void ff_wavpackencdsp_init(WavPackEncDSPContext *c)
+{
+    c->decorr_stereo_quick4 = decorr_stereo_quick4_c;
+
+#if ARCH_AARCH64
+    ff_wavpackencdsp_init_aarch64(c);
+#elif ARCH_X86
+    ff_wavpackencdsp_init_x86(c);
+#endif
+}
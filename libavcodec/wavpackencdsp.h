@@ -0,0 +1,41 @@
+/*
+ * This file is part of Librempeg
+ *
+ * Librempeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Librempeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Librempeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef AVCODEC_WAVPACKENCDSP_H
+#define AVCODEC_WAVPACKENCDSP_H
+
+#include <stdint.h>
+
+typedef struct WavPackEncDSPContext {
+    /**
+     * Run the quick decorrelation of a stereo block for four terms at once.
+     * For every sample, samples holds the predictions of the four terms for
+     * the left channel followed by those for the right channel, they are
+     * replaced with the residuals. weight holds the eight weights in the
+     * same order and is updated.
+     */
+    void (*decorr_stereo_quick4)(int32_t *samples, const int32_t *in_left,
+                                 const int32_t *in_right, int32_t *weight,
+                                 int delta, int nb_samples);
+} WavPackEncDSPContext;
+
+void ff_wavpackencdsp_init(WavPackEncDSPContext *c);
+void ff_wavpackencdsp_init_aarch64(WavPackEncDSPContext *c);
+void ff_wavpackencdsp_init_x86(WavPackEncDSPContext *c);
+
+#endif /* AVCODEC_WAVPACKENCDSP_H */
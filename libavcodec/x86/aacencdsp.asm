@@ -108,3 +108,89 @@ INIT_XMM sse2
 AAC_QUANTIZE_BANDS
 INIT_YMM avx
 AAC_QUANTIZE_BANDS
+
+;*******************************************************************
+;void ff_aac_cb_index(int *idx, const int *quants, int size, int dim,
+;                     int range, int off)
+;*******************************************************************
+INIT_XMM sse2
+cglobal aac_cb_index, 6, 7, 4, idx, quants, size, dim, range, off, tmp
+    cmp       dimd, 2
+    jne      .dim4
+    ; idx = q0 * range + q1 + off * (range + 1)
+    lea       tmpd, [rangeq+1]
+    imul      offd, tmpd
+    lea       tmpd, [rangeq+0x10000]
+    movd        m2, tmpd
+    pshufd      m2, m2, 0
+    movd        m3, offd
+    pshufd      m3, m3, 0
+    sub      sized, 8
+    jl       .tail2
+.loop2:
+    movu        m0, [quantsq]
+    movu        m1, [quantsq+mmsize]
+    packssdw    m0, m1
+    pmaddwd     m0, m2
+    paddd       m0, m3
+    movu    [idxq], m0
+    add    quantsq, 2*mmsize
+    add       idxq, mmsize
+    sub      sized, 8
+    jge      .loop2
+.tail2:
+    add      sized, 8
+    jz       .end
+    movu        m0, [quantsq]
+    packssdw    m0, m0
+    pmaddwd     m0, m2
+    paddd       m0, m3
+    movq    [idxq], m0
+.end:
+    RET
+
+.dim4:
+    ; idx = q0 * range^3 + q1 * range^2 + q2 * range + q3
+    ;     + off * (range^2 + 1) * (range + 1)
+    mov       tmpd, rangeq
+    imul      tmpd, rangeq
+    lea       dimd, [rangeq+0x10000]
+    movd        m2, dimd
+    imul      dimd, tmpd
+    movd        m1, dimd
+    punpckldq   m1, m2
+    punpcklqdq  m1, m1
+    SWAP         1, 2
+    inc       tmpd
+    inc     rangeq
+    imul      tmpd, rangeq
+    imul      offd, tmpd
+    movd        m3, offd
+    pshufd      m3, m3, 0
+    sub      sized, 8
+    jl       .tail4
+.loop4:
+    movu        m0, [quantsq]
+    movu        m1, [quantsq+mmsize]
+    packssdw    m0, m1
+    pmaddwd     m0, m2
+    pshufd      m1, m0, q2301
+    paddd       m0, m1
+    pshufd      m0, m0, q2020
+    paddd       m0, m3
+    movq    [idxq], m0
+    add    quantsq, 2*mmsize
+    add       idxq, 8
+    sub      sized, 8
+    jge      .loop4
+.tail4:
+    add      sized, 8
+    jz       .end
+    movu        m0, [quantsq]
+    packssdw    m0, m0
+    pmaddwd     m0, m2
+    pshufd      m1, m0, q2301
+    paddd       m0, m1
+    paddd       m0, m3
+    movd    [idxq], m0
+    RET
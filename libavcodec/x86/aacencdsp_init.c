@@ -34,6 +34,9 @@ void ff_aac_quantize_bands_avx(int *out, const float *in, const float *scaled,
                                int size, int is_signed, int maxval, const float Q34,
                                const float rounding);
 
+void ff_aac_cb_index_sse2(int *idx, const int *quants, int size, int dim,
+                          int range, int off);
+
 av_cold void ff_aacenc_dsp_init_x86(AACEncDSPContext *s)
 {
     int cpu_flags = av_get_cpu_flags();
@@ -41,8 +44,10 @@ av_cold void ff_aacenc_dsp_init_x86(AACEncDSPContext *s)
     if (EXTERNAL_SSE(cpu_flags))
         s->abs_pow34   = ff_abs_pow34_sse;
 
-    if (EXTERNAL_SSE2(cpu_flags))
+    if (EXTERNAL_SSE2(cpu_flags)) {
         s->quant_bands = ff_aac_quantize_bands_sse2;
+        s->cb_index    = ff_aac_cb_index_sse2;
+    }
 
     if (EXTERNAL_AVX_FAST(cpu_flags))
         s->quant_bands = ff_aac_quantize_bands_avx;
@@ -35,6 +35,13 @@ pw_bap_mul2: dw 5, 7, 0, 7, 5, 7, 0, 7
 cextern pd_1
 pd_151: times 4 dd 151
 
+; used in ff_ac3_bit_alloc_calc_bap()
+cextern ac3_band_start_tab
+cextern ac3_bin_to_band_tab
+pw_63:     times 8 dw 63
+pb_16:     times 16 db 16
+pb_bap_lo: times 16 db 0x70
+
 SECTION .text
 
 ;-----------------------------------------------------------------------------
@@ -256,3 +263,131 @@ AC3_EXTRACT_EXPONENTS
 INIT_XMM ssse3
 AC3_EXTRACT_EXPONENTS
 %endif
+
+;------------------------------------------------------------------------------
+; void ff_ac3_bit_alloc_calc_bap(int16_t *mask, int16_t *psd, int start, int end,
+;                                int snr_offset, int floor,
+;                                const uint8_t *bap_tab, uint8_t *bap)
+;------------------------------------------------------------------------------
+
+; The masking value of each band is spread over its bins in a stack buffer,
+; then 16 bins at a time are turned into bap table addresses, which index the
+; 64-byte table through four pshufb, each one only keeping the addresses in
+; its 16-byte quarter.
+
+%if HAVE_SSSE3_EXTERNAL && ARCH_X86_64
+INIT_XMM ssse3
+cglobal ac3_bit_alloc_calc_bap, 8, 12, 12, (256+8)*2, mask, psd, start, end, snr, floor, tab, bap, band, band_end, val, bin
+    cmp           snrd, -960
+    je .zero
+    movsxd      startq, startd
+    movsxd        endq, endd
+    lea           binq, [ac3_bin_to_band_tab]
+    movzx        bandd, byte [binq+startq]
+    add           snrd, floord
+    mov           binq, startq
+
+.band:
+    movsx         vald, word [maskq+bandq*2]
+    xor      band_endd, band_endd
+    sub           vald, snrd
+    cmovl         vald, band_endd
+    and           vald, 0x1FE0
+    add           vald, floord
+    movd            m0, vald
+    SPLATW          m0, m0
+    lea           valq, [ac3_band_start_tab]
+    movzx    band_endd, byte [valq+bandq+1]
+    inc          bandd
+    cmp      band_endd, endd
+    cmovg    band_endd, endd
+.fill:
+    movu  [rsp+binq*2], m0
+    add           binq, 8
+    cmp           binq, band_endq
+    jl .fill
+    mov           binq, band_endq
+    cmp           endd, band_endd
+    jg .band
+
+    movu            m4, [tabq]
+    movu            m5, [tabq+16]
+    movu            m6, [tabq+32]
+    movu            m7, [tabq+48]
+    mova            m8, [pb_bap_lo]
+    mova            m9, [pb_16]
+    pxor           m10, m10
+    mova           m11, [pw_63]
+    lea           psdq, [psdq+startq*2]
+    add           bapq, startq
+    lea           binq, [rsp+startq*2]
+    sub           endq, startq
+    sub           endq, 16
+    jl .tail
+.loop:
+    movu            m0, [psdq]
+    movu            m1, [psdq+16]
+    movu            m2, [binq]
+    movu            m3, [binq+16]
+    psubw           m0, m2
+    psubw           m1, m3
+    psraw           m0, 5
+    psraw           m1, 5
+    pmaxsw          m0, m10
+    pmaxsw          m1, m10
+    pminsw          m0, m11
+    pminsw          m1, m11
+    packuswb        m0, m1
+    paddusb         m2, m0, m8
+    pshufb          m1, m4, m2
+    psubb           m0, m9
+    paddusb         m2, m0, m8
+    pshufb          m3, m5, m2
+    por             m1, m3
+    psubb           m0, m9
+    paddusb         m2, m0, m8
+    pshufb          m3, m6, m2
+    por             m1, m3
+    psubb           m0, m9
+    paddusb         m2, m0, m8
+    pshufb          m3, m7, m2
+    por             m1, m3
+    movu        [bapq], m1
+    add           psdq, 32
+    add           binq, 32
+    add           bapq, 16
+    sub           endq, 16
+    jge .loop
+.tail:
+    add           endq, 16
+    jz .end
+.tail_loop:
+    movsx         vald, word [psdq]
+    movsx        bandd, word [binq]
+    sub           vald, bandd
+    sar           vald, 5
+    xor          bandd, bandd
+    cmp           vald, bandd
+    cmovl         vald, bandd
+    mov          bandd, 63
+    cmp           vald, bandd
+    cmovg         vald, bandd
+    movzx         vald, byte [tabq+valq]
+    mov         [bapq], valb
+    add           psdq, 2
+    add           binq, 2
+    inc           bapq
+    dec           endq
+    jnz .tail_loop
+.end:
+    RET
+
+.zero:
+    pxor            m0, m0
+%assign i 0
+%rep 256 / 16
+    movu  [bapq+i*16], m0
+%assign i i+1
+%endrep
+    RET
+%endif
@@ -34,6 +34,10 @@ int ff_ac3_compute_mantissa_size_sse2(uint16_t mant_cnt[6][16]);
 void ff_ac3_extract_exponents_sse2 (uint8_t *exp, int32_t *coef, int nb_coefs);
 void ff_ac3_extract_exponents_ssse3(uint8_t *exp, int32_t *coef, int nb_coefs);
 
+void ff_ac3_bit_alloc_calc_bap_ssse3(int16_t *mask, int16_t *psd, int start, int end,
+                                     int snr_offset, int floor,
+                                     const uint8_t *bap_tab, uint8_t *bap);
+
 av_cold void ff_ac3dsp_init_x86(AC3DSPContext *c)
 {
     int cpu_flags = av_get_cpu_flags();
@@ -48,6 +52,9 @@ av_cold void ff_ac3dsp_init_x86(AC3DSPContext *c)
     if (EXTERNAL_SSSE3(cpu_flags)) {
         if (!(cpu_flags & AV_CPU_FLAG_ATOM))
             c->extract_exponents = ff_ac3_extract_exponents_ssse3;
+#if ARCH_X86_64
+        c->bit_alloc_calc_bap = ff_ac3_bit_alloc_calc_bap_ssse3;
+#endif
     }
     if (EXTERNAL_AVX_FAST(cpu_flags)) {
         c->float_to_fixed24 = ff_float_to_fixed24_avx;
@@ -0,0 +1,59 @@
+;******************************************************************************
+;* SIMD-optimized ADPCM DSP functions
+;*
+;* This file is part of Librempeg.
+;*
+;* Librempeg is free software; you can redistribute it and/or modify
+;* it under the terms of the GNU General Public License as published by
+;* the Free Software Foundation; either version 3 of the License, or
+;* (at your option) any later version.
+;*
+;* Librempeg is distributed in the hope that it will be useful,
+;* but WITHOUT ANY WARRANTY; without even the implied warranty of
+;* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+;* GNU General Public License for more details.
+;*
+;* You should have received a copy of the GNU General Public License along
+;* with Librempeg; if not, write to the Free Software Foundation, Inc.,
+;* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+;******************************************************************************
+
+%include "libavutil/x86/x86util.asm"
+
+SECTION_RODATA
+
+pb_0F: times 16 db 0x0F
+
+SECTION .text
+
+;-----------------------------------------------------------------------------
+; void ff_adpcm_unpack_nibbles_lo/hi(uint8_t *dst, const uint8_t *src, int len)
+;-----------------------------------------------------------------------------
+%macro UNPACK_NIBBLES 1
+cglobal adpcm_unpack_nibbles_%1, 3, 3, 4, dst, src, len
+    test      lend, lend
+    jle .end
+    mova        m3, [pb_0F]
+.loop:
+    movu        m0, [srcq]
+    psrlw       m1, m0, 4
+    pand        m0, m3
+    pand        m1, m3
+%ifidn %1, hi
+    SWAP         0, 1
+%endif
+    punpckhbw   m2, m0, m1
+    punpcklbw   m0, m1
+    movu [dstq],    m0
+    movu [dstq+16], m2
+    add       srcq, 16
+    add       dstq, 32
+    sub       lend, 16
+    jg .loop
+.end:
+    RET
+%endmacro
+
+INIT_XMM sse2
+UNPACK_NIBBLES lo
+UNPACK_NIBBLES hi
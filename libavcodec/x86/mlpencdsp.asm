@@ -0,0 +1,86 @@
+;******************************************************************************
+;* SIMD-optimized MLP encoder DSP functions
+;*
+;* This file is part of Librempeg.
+;*
+;* Librempeg is free software; you can redistribute it and/or modify
+;* it under the terms of the GNU General Public License as published by
+;* the Free Software Foundation; either version 3 of the License, or
+;* (at your option) any later version.
+;*
+;* Librempeg is distributed in the hope that it will be useful,
+;* but WITHOUT ANY WARRANTY; without even the implied warranty of
+;* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+;* GNU General Public License for more details.
+;*
+;* You should have received a copy of the GNU General Public License along
+;* with Librempeg; if not, write to the Free Software Foundation, Inc.,
+;* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+;******************************************************************************
+
+%include "libavutil/x86/x86util.asm"
+
+SECTION .text
+
+%if ARCH_X86_64
+;-----------------------------------------------------------------------------
+; void ff_mlp_fir_residual(int32_t *residual, const int32_t *samples,
+;                          const int32_t *coeff, int order, int shift,
+;                          int32_t mask, int len)
+;-----------------------------------------------------------------------------
+; The products of the even and odd samples are accumulated separately with
+; pmuldq, only the low 32 bits of the shifted sums are needed.
+%macro FIR_RESIDUAL 0
+cglobal mlp_fir_residual, 7, 7, 8, residual, samples, coeff, order, shift, mask, len
+    movd       xm6, shiftd
+    movd       xm7, maskd
+%if cpuflag(avx2)
+    vpbroadcastd m7, xm7
+%else
+    pshufd      m7, m7, 0
+%endif
+    DEFINE_ARGS residual, samples, coeff, order, src, tap, len
+.loop:
+    pxor        m0, m0
+    pxor        m1, m1
+    lea       srcq, [samplesq - 4]
+    xor       tapd, tapd
+.tap:
+%if cpuflag(avx2)
+    vpbroadcastd m3, [coeffq + tapq * 4]
+%else
+    movd        m3, [coeffq + tapq * 4]
+    pshufd      m3, m3, 0
+%endif
+    movu        m2, [srcq]
+    pmuldq      m4, m2, m3
+    psrlq       m2, 32
+    pmuldq      m2, m3
+    paddq       m0, m4
+    paddq       m1, m2
+    sub       srcq, 4
+    inc       tapd
+    cmp       tapd, orderd
+    jl .tap
+    psrlq       m0, xm6
+    psrlq       m1, xm6
+    psllq       m1, 32
+    pblendw     m0, m1, 0xCC
+    pand        m0, m7
+    movu        m2, [samplesq]
+    psubd       m2, m0
+    movu [residualq], m2
+    add   samplesq, mmsize
+    add  residualq, mmsize
+    sub       lend, mmsize / 4
+    jg .loop
+    RET
+%endmacro
+
+INIT_XMM sse4
+FIR_RESIDUAL
+%if HAVE_AVX2_EXTERNAL
+INIT_YMM avx2
+FIR_RESIDUAL
+%endif
+%endif
@@ -0,0 +1,42 @@
+/*
+ * This file is part of Librempeg
+ *
+ * Librempeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Librempeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Librempeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <stdint.h>
+
+#include "libavutil/attributes.h"
+#include "libavutil/x86/cpu.h"
+#include "libavcodec/mlpencdsp.h"
+
+void ff_mlp_fir_residual_sse4(int32_t *residual, const int32_t *samples,
+                              const int32_t *coeff, int order, int shift,
+                              int32_t mask, int len);
+void ff_mlp_fir_residual_avx2(int32_t *residual, const int32_t *samples,
+                              const int32_t *coeff, int order, int shift,
+                              int32_t mask, int len);
+
+av_cold void ff_mlpencdsp_init_x86(MLPEncDSPContext *c)
+{
+#if ARCH_X86_64
+    int cpu_flags = av_get_cpu_flags();
+
+    if (EXTERNAL_SSE4(cpu_flags))
+        c->fir_residual = ff_mlp_fir_residual_sse4;
+    if (EXTERNAL_AVX2_FAST(cpu_flags))
+        c->fir_residual = ff_mlp_fir_residual_avx2;
+#endif
+}
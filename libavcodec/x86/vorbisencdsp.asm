@@ -0,0 +1,108 @@
+;******************************************************************************
+;* SIMD-optimized Vorbis encoder DSP functions
+;*
+;* This file is part of Librempeg.
+;*
+;* Librempeg is free software; you can redistribute it and/or modify
+;* it under the terms of the GNU General Public License as published by
+;* the Free Software Foundation; either version 3 of the License, or
+;* (at your option) any later version.
+;*
+;* Librempeg is distributed in the hope that it will be useful,
+;* but WITHOUT ANY WARRANTY; without even the implied warranty of
+;* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+;* GNU General Public License for more details.
+;*
+;* You should have received a copy of the GNU General Public License along
+;* with Librempeg; if not, write to the Free Software Foundation, Inc.,
+;* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+;******************************************************************************
+
+%include "libavutil/x86/x86util.asm"
+
+SECTION_RODATA 32
+
+ps_lane_idx: dd 0.0, 1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0
+ps_flt_max:  times 8 dd 0x7f7fffff
+ps_m1:       times 8 dd -1.0
+ps_4:        times 8 dd 4.0
+ps_8:        times 8 dd 8.0
+ps_2p24:     times 8 dd 16777216.0
+
+SECTION .text
+
+%if ARCH_X86_64
+;-----------------------------------------------------------------------------
+; int ff_vorbis_find_entry(const float *dims, const float *pow2,
+;                          const float *num, int ndim, int stride)
+;-----------------------------------------------------------------------------
+; Each lane tracks the lowest distance and its entry index (as a float) for
+; every mmsize/4-th entry, the lanes are merged at the end.
+%macro FIND_ENTRY 0
+cglobal vorbis_find_entry, 5, 8, 8, dims, pow2, num, ndim, stride, cnt, ptr, dim
+    movsxdifnidn strideq, strided
+    mov        cntd, strided
+    shl     strideq, 2
+    mova         m2, [ps_flt_max]
+    mova         m3, [ps_m1]
+    mova         m4, [ps_lane_idx]
+    mova         m5, [ps_ %+ %1]
+.loop:
+    mova         m0, [pow2q]
+    mov        ptrq, dimsq
+    xor        dimd, dimd
+.dim:
+    VBROADCASTSS m1, [numq + dimq * 4]
+    mulps        m1, [ptrq]
+    subps        m0, m1
+    add        ptrq, strideq
+    inc        dimd
+    cmp        dimd, ndimd
+    jl .dim
+    cmpltps      m1, m0, m2
+    andps        m0, m1
+    andnps       m6, m1, m2
+    orps         m2, m0, m6
+    andps        m7, m1, m4
+    andnps       m6, m1, m3
+    orps         m3, m7, m6
+    addps        m4, m5
+    add       dimsq, mmsize
+    add       pow2q, mmsize
+    sub        cntd, mmsize / 4
+    jg .loop
+
+    ; lowest index among the lanes holding the lowest distance
+%if mmsize == 32
+    vperm2f128   m0, m2, m2, 0x01
+    minps        m0, m2
+%else
+    mova         m0, m2
+%endif
+    shufps       m1, m0, m0, q1032
+    minps        m0, m1
+    shufps       m1, m0, m0, q2301
+    minps        m0, m1
+    cmpeqps      m0, m2
+    andps        m3, m0
+    andnps       m0, [ps_2p24]
+    orps         m3, m0
+%if mmsize == 32
+    vperm2f128   m0, m3, m3, 0x01
+    minps        m3, m0
+%endif
+    shufps       m1, m3, m3, q1032
+    minps        m3, m1
+    shufps       m1, m3, m3, q2301
+    minps        m3, m1
+    cvttss2si   eax, xm3
+    RET
+%endmacro
+
+INIT_XMM sse
+FIND_ENTRY 4
+%if HAVE_AVX_EXTERNAL
+INIT_YMM avx
+FIND_ENTRY 8
+%endif
+%endif
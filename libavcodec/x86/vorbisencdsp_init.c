@@ -0,0 +1,38 @@
+/*
+ * This file is part of Librempeg
+ *
+ * Librempeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Librempeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Librempeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "libavutil/attributes.h"
+#include "libavutil/x86/cpu.h"
+#include "libavcodec/vorbisencdsp.h"
+
+int ff_vorbis_find_entry_sse(const float *dims, const float *pow2,
+                             const float *num, int ndim, int stride);
+int ff_vorbis_find_entry_avx(const float *dims, const float *pow2,
+                             const float *num, int ndim, int stride);
+
+av_cold void ff_vorbisencdsp_init_x86(VorbisEncDSPContext *c)
+{
+#if ARCH_X86_64
+    int cpu_flags = av_get_cpu_flags();
+
+    if (EXTERNAL_SSE(cpu_flags))
+        c->find_entry = ff_vorbis_find_entry_sse;
+    if (EXTERNAL_AVX_FAST(cpu_flags))
+        c->find_entry = ff_vorbis_find_entry_avx;
+#endif
+}
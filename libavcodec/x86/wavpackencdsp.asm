@@ -0,0 +1,91 @@
+;******************************************************************************
+;* SIMD-optimized WavPack encoder DSP functions
+;*
+;* This file is part of Librempeg.
+;*
+;* Librempeg is free software; you can redistribute it and/or modify
+;* it under the terms of the GNU General Public License as published by
+;* the Free Software Foundation; either version 3 of the License, or
+;* (at your option) any later version.
+;*
+;* Librempeg is distributed in the hope that it will be useful,
+;* but WITHOUT ANY WARRANTY; without even the implied warranty of
+;* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+;* GNU General Public License for more details.
+;*
+;* You should have received a copy of the GNU General Public License along
+;* with Librempeg; if not, write to the Free Software Foundation, Inc.,
+;* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+;******************************************************************************
+
+%include "libavutil/x86/x86util.asm"
+
+SECTION_RODATA
+
+pd_512: times 4 dd 512
+
+SECTION .text
+
+%if ARCH_X86_64
+;-----------------------------------------------------------------------------
+; void ff_wavpack_decorr_stereo_quick4(int32_t *samples, const int32_t *in_left,
+;                                      const int32_t *in_right, int32_t *weight,
+;                                      int delta, int nb_samples)
+;-----------------------------------------------------------------------------
+; The weights only depend on the previous sample, so the left and right
+; channels are run side by side to hide the latency of pmulld.
+INIT_XMM sse4
+cglobal wavpack_decorr_stereo_quick4, 6, 6, 11, samples, left, right, weight, delta, len
+    test      lend, lend
+    jle .end
+    movd        m8, deltad
+    pshufd      m8, m8, 0
+    mova        m9, [pd_512]
+    pxor       m10, m10
+    movu        m0, [weightq]
+    movu        m1, [weightq+16]
+.loop:
+    movd        m2, [leftq]
+    movd        m3, [rightq]
+    pshufd      m2, m2, 0
+    pshufd      m3, m3, 0
+    movu        m4, [samplesq]
+    movu        m5, [samplesq+16]
+    pmulld      m6, m4, m0
+    pmulld      m7, m5, m1
+    paddd       m6, m9
+    paddd       m7, m9
+    psrad       m6, 10
+    psrad       m7, 10
+    psubd       m2, m6              ; residual
+    psubd       m3, m7
+    movu [samplesq],    m2
+    movu [samplesq+16], m3
+    pxor        m6, m4, m2
+    pxor        m7, m5, m3
+    psrad       m6, 31              ; sign of prediction ^ residual
+    psrad       m7, 31
+    pcmpeqd     m4, m10
+    pcmpeqd     m5, m10
+    pcmpeqd     m2, m10
+    pcmpeqd     m3, m10
+    por         m4, m2              ; no update if either is 0
+    por         m5, m3
+    pxor        m2, m8, m6
+    pxor        m3, m8, m7
+    psubd       m2, m6              ; +-delta
+    psubd       m3, m7
+    pandn       m4, m2
+    pandn       m5, m3
+    paddd       m0, m4
+    paddd       m1, m5
+    add      leftq, 4
+    add     rightq, 4
+    add   samplesq, 32
+    dec       lend
+    jg .loop
+    movu [weightq],    m0
+    movu [weightq+16], m1
+.end:
+    RET
+%endif
@@ -47,8 +47,8 @@ typedef struct PlaneContext {
     float n;
 
     float *buffer[MAX_THREADS][BSIZE];
-    AVComplexFloat *hdata[MAX_THREADS], *vdata[MAX_THREADS];
-    AVComplexFloat *hdata_out[MAX_THREADS], *vdata_out[MAX_THREADS];
+    AVComplexFloat *hdata[MAX_THREADS];
+    AVComplexFloat *hdata_out[MAX_THREADS];
     int data_linesize;
     int buffer_linesize;
 } PlaneContext;
@@ -75,9 +75,11 @@ typedef struct FFTdnoizContext {
     float win[MAX_BLOCK][MAX_BLOCK];
 
     AVTXContext *fft[MAX_THREADS], *ifft[MAX_THREADS];
+    AVTXContext *fft_c[MAX_THREADS], *ifft_c[MAX_THREADS];
     AVTXContext *fft_r[MAX_THREADS], *ifft_r[MAX_THREADS];
 
     av_tx_fn tx_fn, itx_fn;
+    av_tx_fn tx_c_fn, itx_c_fn;
     av_tx_fn tx_r_fn, itx_r_fn;
 
     void (*import_row)(AVComplexFloat *dst, uint8_t *src, int rw, float scale, float *win, int off);
@@ -217,6 +219,10 @@ static int config_input(AVFilterLink *inlink)
                               0, s->block_size,               &scale,  0)) < 0 ||
             (ret = av_tx_init(&s->ifft[i],   &s->itx_fn,   AV_TX_FLOAT_FFT,
                               1, s->block_size,               &iscale, 0)) < 0 ||
+            (ret = av_tx_init_batch(&s->fft_c[i],  &s->tx_c_fn,  AV_TX_FLOAT_FFT,
+                                    0, s->block_size, s->block_size, &scale,  0)) < 0 ||
+            (ret = av_tx_init_batch(&s->ifft_c[i], &s->itx_c_fn, AV_TX_FLOAT_FFT,
+                                    1, s->block_size, s->block_size, &iscale, 0)) < 0 ||
             (ret = av_tx_init(&s->fft_r[i],  &s->tx_r_fn,  AV_TX_FLOAT_FFT,
                               0, 1 + s->nb_prev + s->nb_next, &scale,  0)) < 0 ||
             (ret = av_tx_init(&s->ifft_r[i], &s->itx_r_fn, AV_TX_FLOAT_FFT,
@@ -242,8 +248,6 @@ static int config_input(AVFilterLink *inlink)
         for (int j = 0; j < s->nb_threads; j++) {
             p->hdata[j] = av_calloc(p->b, p->data_linesize);
             p->hdata_out[j] = av_calloc(p->b, p->data_linesize);
-            p->vdata[j] = av_calloc(p->b, p->data_linesize);
-            p->vdata_out[j] = av_calloc(p->b, p->data_linesize);
             p->buffer[j][CURRENT] = av_calloc(p->b, p->buffer_linesize);
             if (!p->buffer[j][CURRENT])
                 return AVERROR(ENOMEM);
@@ -257,8 +261,7 @@ static int config_input(AVFilterLink *inlink)
                 if (!p->buffer[j][NEXT])
                     return AVERROR(ENOMEM);
             }
-            if (!p->hdata[j] || !p->vdata[j] ||
-                !p->hdata_out[j] || !p->vdata_out[j])
+            if (!p->hdata[j] || !p->hdata_out[j])
                 return AVERROR(ENOMEM);
         }
     }
@@ -290,15 +293,11 @@ static void import_block(FFTdnoizContext *s,
     const float scale = 1.f / ((1.f + s->nb_prev + s->nb_next) * s->block_size * s->block_size);
     AVComplexFloat *hdata = p->hdata[jobnr];
     AVComplexFloat *hdata_out = p->hdata_out[jobnr];
-    AVComplexFloat *vdata_out = p->vdata_out[jobnr];
     const int woff = -hoverlap;
     const int hoff = -hoverlap;
     const int rh = FFMIN(block, height - y * size + hoverlap);
     const int rw = FFMIN(block, width  - x * size + hoverlap);
-    AVComplexFloat *ssrc, *ddst, *dst = hdata, *dst_out = hdata_out;
-    float *bdst = buffer;
-
-    buffer_linesize /= sizeof(float);
+    AVComplexFloat *ddst, *dst = hdata, *dst_out = hdata_out;
 
     for (int i = 0; i < rh; i++) {
         uint8_t *src = srcp + src_linesize * abs(y * size + i + hoff) + x * size * bpp;
@@ -325,16 +324,9 @@ static void import_block(FFTdnoizContext *s,
         dst += data_linesize;
     }
 
-    ssrc = hdata_out;
-    dst = vdata_out;
-    for (int i = 0; i < block; i++) {
-        for (int j = 0; j < block; j++)
-            dst[j] = ssrc[j * data_linesize + i];
-        s->tx_fn(s->fft[jobnr], bdst, dst, sizeof(AVComplexFloat));
-
-        dst += data_linesize;
-        bdst += buffer_linesize;
-    }
+    /* the rows are contiguous, so the columns are interleaved transforms;
+     * the spectrum ends up transposed, which the filtering doesn't care about */
+    s->tx_c_fn(s->fft_c[jobnr], buffer, hdata_out, sizeof(AVComplexFloat));
 }
 
 static void export_block(FFTdnoizContext *s,
@@ -354,23 +346,11 @@ static void export_block(FFTdnoizContext *s,
     const int data_linesize = p->data_linesize / sizeof(AVComplexFloat);
     AVComplexFloat *hdata = p->hdata[jobnr];
     AVComplexFloat *hdata_out = p->hdata_out[jobnr];
-    AVComplexFloat *vdata_out = p->vdata_out[jobnr];
     const int rw = FFMIN(size, width  - x * size);
     const int rh = FFMIN(size, height - y * size);
-    AVComplexFloat *hdst, *vdst = vdata_out, *hdst_out = hdata_out;
-    float *bsrc = buffer;
+    AVComplexFloat *hdst, *hdst_out = hdata_out;
 
-    hdst = hdata;
-    buffer_linesize /= sizeof(float);
-
-    for (int i = 0; i < block; i++) {
-        s->itx_fn(s->ifft[jobnr], vdst, bsrc, sizeof(AVComplexFloat));
-        for (int j = 0; j < block; j++)
-            hdst[j * data_linesize + i] = vdst[j];
-
-        vdst += data_linesize;
-        bsrc += buffer_linesize;
-    }
+    s->itx_c_fn(s->ifft_c[jobnr], hdata, buffer, sizeof(AVComplexFloat));
 
     hdst = hdata + hoverlap * data_linesize;
     for (int i = 0; i < rh && (y * size + i) < height; i++) {
@@ -709,9 +689,7 @@ static av_cold void uninit(AVFilterContext *ctx)
 
         for (int j = 0; j < s->nb_threads; j++) {
             av_freep(&p->hdata[j]);
-            av_freep(&p->vdata[j]);
             av_freep(&p->hdata_out[j]);
-            av_freep(&p->vdata_out[j]);
             av_freep(&p->buffer[j][PREV]);
             av_freep(&p->buffer[j][CURRENT]);
             av_freep(&p->buffer[j][NEXT]);
@@ -721,6 +699,8 @@ static av_cold void uninit(AVFilterContext *ctx)
     for (i = 0; i < s->nb_threads; i++) {
         av_tx_uninit(&s->fft[i]);
         av_tx_uninit(&s->ifft[i]);
+        av_tx_uninit(&s->fft_c[i]);
+        av_tx_uninit(&s->ifft_c[i]);
         av_tx_uninit(&s->fft_r[i]);
         av_tx_uninit(&s->ifft_r[i]);
     }
@@ -88,6 +88,7 @@ const FFInputFormat ff_twopfs_demuxer = {
     .p.extensions   = "sap",
     .p.flags        = AVFMT_GENERIC_INDEX,
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "2PFS" }),
     .read_header    = read_header,
     .read_packet    = ff_pcm_read_packet,
 };
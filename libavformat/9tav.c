@@ -210,6 +210,7 @@ const FFInputFormat ff_ninetav_demuxer = {
     .priv_data_size = sizeof(NineTAVContext),
     .p.flags        = AVFMT_GENERIC_INDEX,
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "9TAV" }),
     .read_header    = read_header,
     .read_packet    = read_packet,
     .read_seek      = read_seek,
@@ -393,6 +393,7 @@ const FFInputFormat ff_aax_demuxer = {
     .priv_data_size = sizeof(AAXContext),
     .flags_internal = FF_INFMT_FLAG_INIT_CLEANUP,
     .read_probe     = aax_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "@UTF" }),
     .read_header    = aax_read_header,
     .read_packet    = aax_read_packet,
     .read_close     = aax_read_close,
@@ -24,6 +24,7 @@
 #include "avformat.h"
 #include "demux.h"
 #include "internal.h"
+#include "pcm.h"
 
 static int read_probe(const AVProbeData *p)
 {
@@ -97,9 +98,16 @@ static int read_packet(AVFormatContext *s, AVPacket *pkt)
 {
     AVCodecParameters *par = s->streams[0]->codecpar;
     AVIOContext *pb = s->pb;
-    int ret;
-
-    ret = av_get_packet(pb, pkt, par->block_align);
+    int ret, size = par->block_align;
+
+    /* the interleave of PSX ADPCM is often a single 16 byte frame per
+     * channel, read many blocks at once; PCM blocks are planar */
+    if (par->codec_id == AV_CODEC_ID_ADPCM_PSX) {
+        size = ff_pcm_default_packet_size(par);
+        if (size < 0)
+            return size;
+    }
+    ret = av_get_packet(pb, pkt, size);
     pkt->flags &= ~AV_PKT_FLAG_CORRUPT;
     pkt->stream_index = 0;
 
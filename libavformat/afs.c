@@ -256,6 +256,7 @@ const FFInputFormat ff_afs_demuxer = {
     .p.extensions   = "afs",
     .priv_data_size = sizeof(AFSDemuxContext),
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "AFS\0" }),
     .read_header    = read_header,
     .read_packet    = read_packet,
     .read_seek      = read_seek,
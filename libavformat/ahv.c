@@ -80,6 +80,7 @@ const FFInputFormat ff_ahv_demuxer = {
     .p.flags        = AVFMT_GENERIC_INDEX,
     .p.extensions   = "ahv",
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "AHV\0" }),
     .read_header    = read_header,
     .read_packet    = ff_pcm_read_packet,
 };
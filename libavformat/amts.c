@@ -108,6 +108,7 @@ const FFInputFormat ff_amts_demuxer = {
     .p.flags        = AVFMT_GENERIC_INDEX,
     .p.extensions   = "lstm",
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "AMTS" }),
     .read_header    = read_header,
     .read_packet    = ff_pcm_read_packet,
 };
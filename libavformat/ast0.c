@@ -88,6 +88,7 @@ const FFInputFormat ff_ast0_demuxer = {
     .p.flags        = AVFMT_GENERIC_INDEX,
     .p.extensions   = "ast",
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "AST\0" }),
     .read_header    = read_header,
     .read_packet    = ff_pcm_read_packet,
 };
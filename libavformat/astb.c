@@ -101,6 +101,7 @@ const FFInputFormat ff_astb_demuxer = {
     .p.extensions   = "ast",
     .p.flags        = AVFMT_GENERIC_INDEX,
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "ASTB" }),
     .read_header    = read_header,
     .read_packet    = ff_pcm_read_packet,
 };
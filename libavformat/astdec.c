@@ -117,6 +117,7 @@ const FFInputFormat ff_ast_demuxer = {
     .p.flags        = AVFMT_GENERIC_INDEX,
     .p.codec_tag    = ff_ast_codec_tags_list,
     .read_probe     = ast_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "STRM" }),
     .read_header    = ast_read_header,
     .read_packet    = ast_read_packet,
 };
@@ -102,6 +102,7 @@ const FFInputFormat ff_aus_demuxer = {
     .p.flags        = AVFMT_GENERIC_INDEX,
     .p.extensions   = "aus",
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "AUS " }),
     .read_header    = read_header,
     .read_packet    = ff_pcm_read_packet,
 };
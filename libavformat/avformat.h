@@ -1944,6 +1944,16 @@ typedef struct AVFormatContext {
      * Name of this format context, only used for logging purposes.
      */
     char *name;
+
+    /**
+     * Number of threads avformat_find_stream_info() uses to decode the
+     * first frames of the streams while the demuxer keeps reading.
+     * 1 decodes on the calling thread, 0 picks a number automatically.
+     * The stream parameters found do not depend on this value.
+     * - encoding: unused
+     * - decoding: set by user
+     */
+    int analyze_threads;
 } AVFormatContext;
 
 /**
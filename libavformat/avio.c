@@ -473,6 +473,8 @@ int ffio_fdopen(AVIOContext **sp, URLContext *h)
             s->seekable |= AVIO_SEEKABLE_TIME;
     }
     ((FFIOContext*)s)->short_seek_get = ffurl_get_short_seek;
+    if (!(h->flags & AVIO_FLAG_WRITE) && h->prot->url_map)
+        ((FFIOContext*)s)->map = ffurl_map;
     s->av_class = &ff_avio_class;
     return 0;
 }
@@ -853,6 +855,15 @@ int ffurl_get_short_seek(void *urlcontext)
     return h->prot->url_get_short_seek(h);
 }
 
+int ffurl_map(void *urlcontext, int64_t pos, int size, AVBufferRef **buf)
+{
+    URLContext *h = urlcontext;
+
+    if (!h || !h->prot || !h->prot->url_map)
+        return AVERROR(ENOSYS);
+    return h->prot->url_map(h, pos, size, buf);
+}
+
 int ffurl_shutdown(URLContext *h, int flags)
 {
     if (!h || !h->prot || !h->prot->url_shutdown)
@@ -21,6 +21,7 @@
 
 #include "avio.h"
 
+#include "libavutil/buffer.h"
 #include "libavutil/log.h"
 
 extern const AVClass ff_avio_class;
@@ -76,6 +77,12 @@ typedef struct FFIOContext {
      * is updated each time a successful writeout ends up further position-wise
      */
     int64_t written_output_size;
+
+    /**
+     * Map part of the resource, if the protocol supports it,
+     * used by ffio_read_mapping()
+     */
+    int (*map)(void *opaque, int64_t pos, int size, AVBufferRef **buf);
 } FFIOContext;
 
 static av_always_inline FFIOContext *ffiocontext(AVIOContext *ctx)
@@ -119,6 +126,20 @@ void ffio_init_write_context(FFIOContext *s, uint8_t *buffer, int buffer_size);
  */
 int ffio_read_indirect(AVIOContext *s, unsigned char *buf, int size, const unsigned char **data);
 
+/**
+ * Read size bytes from AVIOContext without copying them, by mapping them
+ * through the protocol.
+ * This is only done when the data is not already buffered. The resulting
+ * buffer is writable and followed by AV_INPUT_BUFFER_PADDING_SIZE zeroed
+ * bytes, so that it can be used as packet data.
+ *
+ * @param buf set to a new reference to the mapping, whose data points to
+ *            the data read
+ * @return size on success, AVERROR(ENOSYS) if the data cannot be read this
+ *         way and nothing was read, or another negative error code
+ */
+int ffio_read_mapping(AVIOContext *s, int size, AVBufferRef **buf);
+
 void ffio_fill(AVIOContext *s, int b, int64_t count);
 
 static av_always_inline void ffio_wfourcc(AVIOContext *pb, const uint8_t *s)
@@ -20,6 +20,7 @@
  */
 
 #include "libavutil/bprint.h"
+#include "libavutil/buffer.h"
 #include "libavutil/crc.h"
 #include "libavutil/dict.h"
 #include "libavutil/intreadwrite.h"
@@ -214,11 +215,20 @@ void avio_write(AVIOContext *s, const unsigned char *buf, int size)
     }
     do {
         int len = FFMIN(s->buf_end - s->buf_ptr, size);
-        memcpy(s->buf_ptr, buf, len);
-        s->buf_ptr += len;
 
-        if (s->buf_ptr >= s->buf_end)
-            flush_buffer(s);
+        if (len == s->buf_end - s->buffer && s->buf_ptr_max == s->buffer &&
+            s->write_flag && !s->update_checksum) {
+            /* The buffer is empty and would be filled and flushed at once:
+             * write the data from the caller instead of copying it first.
+             * The writes have the same size as when flushing the buffer. */
+            writeout(s, buf, len);
+        } else {
+            memcpy(s->buf_ptr, buf, len);
+            s->buf_ptr += len;
+
+            if (s->buf_ptr >= s->buf_end)
+                flush_buffer(s);
+        }
 
         buf += len;
         size -= len;
@@ -684,6 +694,39 @@ int ffio_read_indirect(AVIOContext *s, unsigned char *buf, int size, const unsig
     }
 }
 
+int ffio_read_mapping(AVIOContext *s, int size, AVBufferRef **buf)
+{
+    FFIOContext *const ctx = ffiocontext(s);
+    int64_t pos, ret;
+
+    if (!ctx->map || !s->seek || s->write_flag || s->update_checksum ||
+        size <= 0 || s->buf_end - s->buf_ptr >= size)
+        return AVERROR(ENOSYS);
+
+    pos = avio_tell(s);
+    if (pos < 0)
+        return AVERROR(ENOSYS);
+
+    ret = ctx->map(s->opaque, pos, size, buf);
+    if (ret < 0)
+        return ret;
+
+    /* seek past the data without reading it into the buffer,
+     * as avio_seek() would do for short seeks */
+    if ((ret = s->seek(s->opaque, pos + size, SEEK_SET)) < 0) {
+        av_buffer_unref(buf);
+        return ret;
+    }
+    ctx->seek_count++;
+    s->buf_end = s->buffer;
+    s->checksum_ptr = s->buf_ptr = s->buf_ptr_max = s->buffer;
+    s->pos = pos + size;
+    s->eof_reached = 0;
+    ctx->bytes_read += size;
+
+    return size;
+}
+
 int avio_read_partial(AVIOContext *s, unsigned char *buf, int size)
 {
     int len;
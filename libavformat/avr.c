@@ -91,6 +91,7 @@ const FFInputFormat ff_avr_demuxer = {
     .p.extensions   = "avr",
     .p.flags        = AVFMT_GENERIC_INDEX,
     .read_probe     = avr_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "2BIT" }),
     .read_header    = avr_read_header,
     .read_packet    = ff_pcm_read_packet,
     .read_seek      = ff_pcm_read_seek,
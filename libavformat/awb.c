@@ -294,6 +294,7 @@ const FFInputFormat ff_awb_demuxer = {
     .p.extensions   = "awb",
     .priv_data_size = sizeof(AWBDemuxContext),
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "AFS2" }),
     .read_header    = read_header,
     .read_packet    = read_packet,
     .read_seek      = read_seek,
@@ -40,6 +40,7 @@ typedef struct AWCBlock {
 } AWCBlock;
 
 typedef struct AWCDemuxContext {
+    FFSubsongContext sub;
     int is_streamed;
     int codec;
     int channels;
@@ -648,6 +649,20 @@ static int read_header(AVFormatContext *s)
         st->index = n;
     }
 
+    if (awc->sub.subsong >= 0) {
+        int ret;
+
+        /* streamed files hold a single subsong, its channels being the streams */
+        if (is_streamed && awc->sub.subsong > 0) {
+            av_log(s, AV_LOG_ERROR, "Invalid subsong index %d, there is 1 subsong\n",
+                   awc->sub.subsong);
+            return AVERROR(EINVAL);
+        } else if (!is_streamed &&
+                   (ret = ff_select_subsong(s, awc->sub.subsong, NULL)) < 0) {
+            return ret;
+        }
+    }
+
     {
         AVStream *st = s->streams[0];
         AWCStream *ast = st->priv_data;
@@ -718,6 +733,9 @@ static int read_packet(AVFormatContext *s, AVPacket *pkt)
         }
     }
 
+    if (ret == AVERROR_EOF && !awc->is_streamed && awc->sub.subsong >= 0)
+        return ret;
+
     if (ret == AVERROR_EOF) {
         AVStream *st = s->streams[s->nb_streams-1];
         AWCStream *ast = st->priv_data;
@@ -733,11 +751,13 @@ static int read_packet(AVFormatContext *s, AVPacket *pkt)
 const FFInputFormat ff_awc_demuxer = {
     .p.name         = "awc",
     .p.long_name    = NULL_IF_CONFIG_SMALL("AWC (Audio Wave Container)"),
+    .p.priv_class   = &ff_subsong_demuxer_class,
     .flags_internal = FF_INFMT_FLAG_INIT_CLEANUP,
     .p.flags        = AVFMT_GENERIC_INDEX,
     .p.extensions   = "awc",
     .priv_data_size = sizeof(AWCDemuxContext),
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "ADAT" }, { 0, 4, "TADA" }),
     .read_header    = read_header,
     .read_packet    = read_packet,
 };
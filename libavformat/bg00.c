@@ -83,6 +83,7 @@ const FFInputFormat ff_bg00_demuxer = {
     .p.flags        = AVFMT_GENERIC_INDEX,
     .p.extensions   = "bg00",
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "BG00" }),
     .read_header    = read_header,
     .read_packet    = ff_pcm_read_packet,
 };
@@ -107,6 +107,7 @@ const FFInputFormat ff_binka_demuxer = {
     .p.flags        = AVFMT_GENERIC_INDEX,
     .p.extensions   = "binka",
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "1FCB" }),
     .read_header    = read_header,
     .read_packet    = read_packet,
 };
@@ -305,6 +305,7 @@ const FFInputFormat ff_bkhd_demuxer = {
     .p.extensions   = "bnk",
     .priv_data_size = sizeof(BKHDDemuxContext),
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "BKHD" }),
     .read_header    = read_header,
     .read_packet    = read_packet,
     .read_seek      = read_seek,
@@ -115,6 +115,7 @@ const FFInputFormat ff_bnsf_demuxer = {
     .p.flags        = AVFMT_GENERIC_INDEX,
     .p.extensions   = "bnsf",
     .read_probe     = bnsf_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "BNSF" }),
     .read_header    = bnsf_read_header,
     .read_packet    = bnsf_read_packet,
 };
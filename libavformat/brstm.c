@@ -480,6 +480,7 @@ const FFInputFormat ff_brstm_demuxer = {
     .priv_data_size = sizeof(BRSTMDemuxContext),
     .flags_internal = FF_INFMT_FLAG_INIT_CLEANUP,
     .read_probe     = probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "RSTM" }),
     .read_header    = read_header,
     .read_packet    = read_packet,
     .read_close     = read_close,
@@ -493,6 +494,7 @@ const FFInputFormat ff_bfstm_demuxer = {
     .priv_data_size = sizeof(BRSTMDemuxContext),
     .flags_internal = FF_INFMT_FLAG_INIT_CLEANUP,
     .read_probe     = probe_bfstm,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "FSTM" }, { 0, 4, "CSTM" }),
     .read_header    = read_header,
     .read_packet    = read_packet,
     .read_close     = read_close,
@@ -116,6 +116,7 @@ const FFInputFormat ff_bwav_demuxer = {
     .p.flags        = AVFMT_GENERIC_INDEX,
     .p.extensions   = "bwav",
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "BWAV" }),
     .read_header    = read_header,
     .read_packet    = read_packet,
 };
@@ -591,6 +591,7 @@ const FFInputFormat ff_caf_demuxer = {
     .p.codec_tag    = ff_caf_codec_tags_list,
     .priv_data_size = sizeof(CafContext),
     .read_probe     = probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "caff" }),
     .read_header    = read_header,
     .read_packet    = read_packet,
     .read_seek      = read_seek,
@@ -110,6 +110,7 @@ const FFInputFormat ff_csmp_demuxer = {
     .p.long_name    = NULL_IF_CONFIG_SMALL("CSMP (Retro Studios Metroid Prime)"),
     .p.extensions   = "csmp",
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "CSMP" }),
     .read_header    = read_header,
     .read_packet    = ff_pcm_read_packet,
     .read_seek      = ff_pcm_read_seek,
@@ -93,6 +93,7 @@ const FFInputFormat ff_cxs_demuxer = {
     .p.flags        = AVFMT_GENERIC_INDEX,
     .p.extensions   = "cxs",
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "CXS " }),
     .read_header    = read_header,
     .read_packet    = ff_pcm_read_packet,
 };
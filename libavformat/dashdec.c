@@ -31,6 +31,7 @@
 #include "avio_internal.h"
 #include "dash.h"
 #include "demux.h"
+#include "segcache.h"
 #include "url.h"
 
 #define INITIAL_BUFFER_SIZE 32768
@@ -161,6 +162,10 @@ typedef struct DASHContext {
     int max_reload;
     char *cenc_decryption_key;
     char *cenc_decryption_keys;
+    int segment_prefetch;
+    char *segment_cache_dir;
+    int64_t segment_cache_size;
+    SegmentCache *segment_cache;
 
     /* Flags for init section*/
     int is_init_section_common_video;
@@ -412,14 +417,11 @@ static void free_subtitle_list(DASHContext *c)
     c->n_subtitles = 0;
 }
 
-static int open_url(AVFormatContext *s, AVIOContext **pb, const char *url,
-                    AVDictionary **opts, AVDictionary *opts2, int *is_http)
+static int check_url(AVFormatContext *s, const char *url, int *is_http)
 {
     DASHContext *c = s->priv_data;
-    AVDictionary *tmp = NULL;
     const char *proto_name = NULL;
     int proto_name_len;
-    int ret;
 
     if (av_strstart(url, "crypto", NULL)) {
         if (url[6] == '+' || url[6] == ':')
@@ -454,6 +456,22 @@ static int open_url(AVFormatContext *s, AVIOContext **pb, const char *url,
     else if (strcmp(proto_name, "file") || !strncmp(url, "file,", 5))
         return AVERROR_INVALIDDATA;
 
+    if (is_http)
+        *is_http = av_strstart(proto_name, "http", NULL);
+
+    return 0;
+}
+
+static int open_url(AVFormatContext *s, AVIOContext **pb, const char *url,
+                    AVDictionary **opts, AVDictionary *opts2, int *is_http)
+{
+    AVDictionary *tmp = NULL;
+    int ret;
+
+    ret = check_url(s, url, is_http);
+    if (ret < 0)
+        return ret;
+
     av_freep(pb);
     av_dict_copy(&tmp, *opts, 0);
     av_dict_copy(&tmp, opts2, 0);
@@ -473,9 +491,6 @@ static int open_url(AVFormatContext *s, AVIOContext **pb, const char *url,
 
     av_dict_free(&tmp);
 
-    if (is_http)
-        *is_http = av_strstart(proto_name, "http", NULL);
-
     return ret;
 }
 
@@ -1772,6 +1787,17 @@ static int open_input(DASHContext *c, struct representation *pls, struct fragmen
     ff_make_absolute_url(url, c->max_url_size, c->base_url, seg->url);
     av_log(pls->parent, AV_LOG_VERBOSE, "DASH request for url '%s', offset %"PRId64"\n",
            url, seg->url_offset);
+
+    if (c->segment_cache && check_url(pls->parent, url, NULL) >= 0) {
+        /* the whole resource is read when the size is unknown,
+         * use the same key as prefetch_fragments() */
+        ret = ff_segcache_open(c->segment_cache, &pls->input, url,
+                               seg->size >= 0 ? seg->url_offset : 0,
+                               seg->size, c->avio_opts);
+        if (ret >= 0 || ret == AVERROR_EXIT)
+            goto cleanup;
+    }
+
     ret = open_url(pls->parent, &pls->input, url, &c->avio_opts, opts, NULL);
 
 cleanup:
@@ -1838,6 +1864,43 @@ static int64_t seek_data(void *opaque, int64_t offset, int whence)
     return AVERROR(ENOSYS);
 }
 
+static void prefetch_fragments(DASHContext *c, struct representation *pls)
+{
+    char *name = av_malloc(c->max_url_size);
+    char *url  = av_malloc(c->max_url_size);
+
+    if (!name || !url)
+        goto end;
+
+    for (int i = 1; i <= c->segment_prefetch; i++) {
+        int64_t seq_no = pls->cur_seq_no + i;
+        int64_t offset = 0, size = -1;
+
+        if (pls->n_fragments) {
+            if (seq_no >= pls->n_fragments)
+                break;
+            av_strlcpy(name, pls->fragments[seq_no]->url, c->max_url_size);
+            offset = pls->fragments[seq_no]->url_offset;
+            size   = pls->fragments[seq_no]->size;
+        } else if (pls->url_template && seq_no <= pls->last_seq_no) {
+            ff_dash_fill_tmpl_params(name, c->max_url_size, pls->url_template, 0, seq_no, 0,
+                                     get_segment_start_time_based_on_timeline(pls, seq_no));
+        } else
+            break;
+
+        ff_make_absolute_url(url, c->max_url_size, c->base_url, name);
+        if (check_url(pls->parent, url, NULL) < 0)
+            continue;
+        if (ff_segcache_prefetch(c->segment_cache, url, size >= 0 ? offset : 0,
+                                 size, c->avio_opts) < 0)
+            break;
+    }
+
+end:
+    av_free(name);
+    av_free(url);
+}
+
 static int read_data(void *opaque, uint8_t *buf, int buf_size)
 {
     int ret = 0;
@@ -1876,6 +1939,9 @@ restart:
             goto restart;
         }
         v->n_open_failures = 0;
+
+        if (c->segment_cache && !c->is_live)
+            prefetch_fragments(c, v);
     }
 
     if (v->init_sec_buf_read_offset < v->init_sec_data_len) {
@@ -2149,6 +2215,18 @@ static int dash_read_header(AVFormatContext *s)
     if ((ret = parse_manifest(s, s->url, s->pb)) < 0)
         return ret;
 
+    if (c->segment_prefetch || c->segment_cache_dir) {
+        /* segments are downloaded with the builtin protocols */
+        if (!ffio_geturlcontext(s->pb)) {
+            av_log(s, AV_LOG_WARNING, "Disabling segment prefetching and caching due to custom io_open.\n");
+        } else {
+            ret = ff_segcache_alloc(&c->segment_cache, s, c->segment_cache_dir,
+                                    c->segment_cache_size, c->segment_prefetch);
+            if (ret < 0)
+                return ret;
+        }
+    }
+
     /* If this isn't a live stream, fill the total duration of the
      * stream. */
     if (!c->is_live) {
@@ -2400,6 +2478,7 @@ static int dash_read_packet(AVFormatContext *s, AVPacket *pkt)
 static int dash_close(AVFormatContext *s)
 {
     DASHContext *c = s->priv_data;
+    ff_segcache_free(&c->segment_cache);
     free_audio_list(c);
     free_video_list(c);
     free_subtitle_list(c);
@@ -2530,6 +2609,12 @@ static const AVOption dash_options[] = {
     { "cenc_decryption_keys", "Media decryption keys by KID (hex)", OFFSET(cenc_decryption_keys), AV_OPT_TYPE_STRING, {.str = NULL}, INT_MIN, INT_MAX, .flags = FLAGS },
     { "max_reload", "Maximum number of manifest reloads in get_current_fragment() before giving up",
         OFFSET(max_reload), AV_OPT_TYPE_INT, { .i64 = 100 }, 0, INT_MAX, FLAGS },
+    { "segment_prefetch", "Number of segments to download ahead of time",
+        OFFSET(segment_prefetch), AV_OPT_TYPE_INT, { .i64 = 0 }, 0, 64, FLAGS },
+    { "segment_cache_dir", "Directory to keep downloaded segments in",
+        OFFSET(segment_cache_dir), AV_OPT_TYPE_STRING, { .str = NULL }, 0, 0, FLAGS },
+    { "segment_cache_size", "Maximum size of the segment cache directory in bytes, 0 for no limit",
+        OFFSET(segment_cache_size), AV_OPT_TYPE_INT64, { .i64 = 1LL << 30 }, 0, INT64_MAX, FLAGS },
     {NULL}
 };
 
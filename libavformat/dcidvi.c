@@ -89,6 +89,7 @@ const FFInputFormat ff_dcidvi_demuxer = {
     .p.flags        = AVFMT_GENERIC_INDEX,
     .p.extensions   = "idvi",
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "IDVI" }),
     .read_header    = read_header,
     .read_packet    = read_packet,
 };
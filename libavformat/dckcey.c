@@ -90,6 +90,7 @@ const FFInputFormat ff_dckcey_demuxer = {
     .p.flags        = AVFMT_GENERIC_INDEX,
     .p.extensions   = "kcey",
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "KCEY" }),
     .read_header    = read_header,
     .read_packet    = read_packet,
 };
@@ -188,6 +188,30 @@ static int init_input(AVFormatContext *s, const char *filename,
 
 static int codec_close(FFStream *sti);
 
+/* Wait for the probe decoding job of a stream, if any. This must be done
+ * before the stream's decoder context is used on the calling thread.
+ * returns the value returned by the job, or 0 if there was none */
+static int stream_info_sync(FFStream *sti)
+{
+    FFStreamInfo *const info = sti->info;
+    int ret;
+
+    if (!info || !info->job)
+        return 0;
+
+    ret = av_executor_job_wait(info->job);
+    av_executor_job_free(&info->job);
+    av_packet_unref(info->job_pkt);
+
+    return ret;
+}
+
+static void stream_info_sync_all(AVFormatContext *s)
+{
+    for (unsigned i = 0; i < s->nb_streams; i++)
+        stream_info_sync(ffstream(s->streams[i]));
+}
+
 static int update_stream_avctx(AVFormatContext *s)
 {
     int ret;
@@ -198,6 +222,8 @@ static int update_stream_avctx(AVFormatContext *s)
         if (!sti->need_context_update)
             continue;
 
+        stream_info_sync(sti);
+
         if (avcodec_is_open(sti->avctx)) {
             av_log(s, AV_LOG_DEBUG, "Demuxer context update while decoder is open, closing and trying to re-open\n");
             ret = codec_close(sti);
@@ -758,10 +784,10 @@ static void compute_frame_duration(AVFormatContext *s, int *pnum, int *pden,
     }
 }
 
-static int has_decode_delay_been_guessed(AVStream *st)
+static int decode_delay_guessed(AVStream *st, enum AVCodecID codec_id)
 {
     FFStream *const sti = ffstream(st);
-    if (st->codecpar->codec_id != AV_CODEC_ID_H264) return 1;
+    if (codec_id != AV_CODEC_ID_H264) return 1;
     if (!sti->info) // if we have left find_stream_info then nb_decoded_frames won't increase anymore for stream copy
         return 1;
     av_assert0(sti->avctx->codec_id == AV_CODEC_ID_H264 || (sti->avctx->codec_id == AV_CODEC_ID_NONE && !avcodec_is_open(sti->avctx)));
@@ -778,6 +804,11 @@ static int has_decode_delay_been_guessed(AVStream *st)
         return sti->nb_decoded_frames >= 20;
 }
 
+static int has_decode_delay_been_guessed(AVStream *st)
+{
+    return decode_delay_guessed(st, st->codecpar->codec_id);
+}
+
 static PacketListEntry *get_next_pkt(AVFormatContext *s, AVStream *st,
                                      PacketListEntry *pktl)
 {
@@ -1407,6 +1438,7 @@ static int read_frame_internal(AVFormatContext *s, AVPacket *pkt)
             for (unsigned i = 0; i < s->nb_streams; i++) {
                 AVStream *const st  = s->streams[i];
                 FFStream *const sti = ffstream(st);
+                stream_info_sync(sti);
                 if (sti->parser && sti->need_parsing)
                     parse_packet(s, pkt, st->index, 1);
             }
@@ -1418,6 +1450,9 @@ static int read_frame_internal(AVFormatContext *s, AVPacket *pkt)
         st  = s->streams[pkt->stream_index];
         sti = ffstream(st);
 
+        /* the timestamps of the packet are computed from the decoder state */
+        stream_info_sync(sti);
+
         st->event_flags |= AVSTREAM_EVENT_FLAG_NEW_PACKETS;
 
         int new_extradata = !!av_packet_side_data_get(pkt->side_data, pkt->side_data_elems,
@@ -2088,7 +2123,20 @@ static int determinable_frame_size(const AVCodecContext *avctx)
     return 0;
 }
 
-static int has_codec_parameters(const AVStream *st, const char **errmsg_ptr)
+static FFStreamProbeState stream_probe_state(const AVStream *st)
+{
+    return (FFStreamProbeState) {
+        .codec_id             = st->codecpar->codec_id,
+        .codec_info_nb_frames = cffstream(st)->codec_info_nb_frames,
+        .has_sar              = st->sample_aspect_ratio.num ||
+                                st->codecpar->sample_aspect_ratio.num,
+    };
+}
+
+/* Only reads the stream state given in ps and the decoder context, so that
+ * it can run on the analysis threads. */
+static int check_codec_parameters(const AVStream *st, const FFStreamProbeState *ps,
+                                  const char **errmsg_ptr)
 {
     const FFStream *const sti = cffstream(st);
     const AVCodecContext *const avctx = sti->avctx;
@@ -2121,8 +2169,8 @@ static int has_codec_parameters(const AVStream *st, const char **errmsg_ptr)
             FAIL("unspecified size");
         if (sti->info->found_decoder >= 0 && avctx->pix_fmt == AV_PIX_FMT_NONE)
             FAIL("unspecified pixel format");
-        if (st->codecpar->codec_id == AV_CODEC_ID_RV30 || st->codecpar->codec_id == AV_CODEC_ID_RV40)
-            if (!st->sample_aspect_ratio.num && !st->codecpar->sample_aspect_ratio.num && !sti->codec_info_nb_frames)
+        if (ps->codec_id == AV_CODEC_ID_RV30 || ps->codec_id == AV_CODEC_ID_RV40)
+            if (!ps->has_sar && !ps->codec_info_nb_frames)
                 FAIL("no frame in rv30/40 and no sar");
         break;
     case AVMEDIA_TYPE_SUBTITLE:
@@ -2136,22 +2184,21 @@ static int has_codec_parameters(const AVStream *st, const char **errmsg_ptr)
     return 1;
 }
 
-/* returns 1 or 0 if or if not decoded data was returned, or a negative error */
-static int try_decode_frame(AVFormatContext *s, AVStream *st,
-                            const AVPacket *pkt, AVDictionary **options)
+static int has_codec_parameters(const AVStream *st, const char **errmsg_ptr)
+{
+    FFStreamProbeState ps = stream_probe_state(st);
+
+    return check_codec_parameters(st, &ps, errmsg_ptr);
+}
+
+/* returns 0 if the decoder of the stream is open, or a negative error */
+static int open_probe_decoder(AVFormatContext *s, AVStream *st,
+                              AVDictionary **options)
 {
     FFStream *const sti = ffstream(st);
     AVCodecContext *const avctx = sti->avctx;
     const AVCodec *codec;
-    int got_picture = 1, ret = 0;
-    AVFrame *frame = av_frame_alloc();
-    AVSubtitle subtitle;
-    int do_skip_frame = 0;
-    enum AVDiscard skip_frame;
-    int pkt_to_send = pkt->size > 0;
-
-    if (!frame)
-        return AVERROR(ENOMEM);
+    int ret;
 
     if (!avcodec_is_open(avctx) &&
         sti->info->found_decoder <= 0 &&
@@ -2162,8 +2209,7 @@ static int try_decode_frame(AVFormatContext *s, AVStream *st,
 
         if (!codec) {
             sti->info->found_decoder = -st->codecpar->codec_id;
-            ret                     = -1;
-            goto fail;
+            return -1;
         }
 
         /* Force thread count to 1 since the H.264 decoder will not extract
@@ -2180,16 +2226,44 @@ static int try_decode_frame(AVFormatContext *s, AVStream *st,
             av_dict_free(&thread_opt);
         if (ret < 0) {
             sti->info->found_decoder = -avctx->codec_id;
-            goto fail;
+            return ret;
         }
         sti->info->found_decoder = 1;
     } else if (!sti->info->found_decoder)
         sti->info->found_decoder = 1;
 
-    if (sti->info->found_decoder < 0) {
-        ret = -1;
-        goto fail;
-    }
+    if (sti->info->found_decoder < 0)
+        return -1;
+
+    return 0;
+}
+
+static int probe_decode_needed(AVStream *st, const FFStreamProbeState *ps)
+{
+    const AVCodecContext *const avctx = ffstream(st)->avctx;
+
+    return !check_codec_parameters(st, ps, NULL) || !decode_delay_guessed(st, ps->codec_id) ||
+           (!ps->codec_info_nb_frames && (avctx->codec->capabilities & AV_CODEC_CAP_CHANNEL_CONF));
+}
+
+/* Decode pkt with the open decoder of the stream. The stream state is
+ * passed in ps because this runs on the analysis threads. Only the decoder
+ * context and nb_decoded_frames of the stream are modified.
+ * returns 1 or 0 if or if not decoded data was returned, or a negative error */
+static int decode_probe_frame(AVStream *st, const AVPacket *pkt,
+                              const FFStreamProbeState *ps)
+{
+    FFStream *const sti = ffstream(st);
+    AVCodecContext *const avctx = sti->avctx;
+    int got_picture = 1, ret = 0;
+    AVFrame *frame = av_frame_alloc();
+    AVSubtitle subtitle;
+    int do_skip_frame = 0;
+    enum AVDiscard skip_frame;
+    int pkt_to_send = pkt->size > 0;
+
+    if (!frame)
+        return AVERROR(ENOMEM);
 
     if (avpriv_codec_get_cap_skip_frame_fill_param(avctx->codec)) {
         do_skip_frame = 1;
@@ -2198,10 +2272,7 @@ static int try_decode_frame(AVFormatContext *s, AVStream *st,
     }
 
     while ((pkt_to_send || (!pkt->data && got_picture)) &&
-           ret >= 0 &&
-           (!has_codec_parameters(st, NULL) || !has_decode_delay_been_guessed(st) ||
-            (!sti->codec_info_nb_frames &&
-             (avctx->codec->capabilities & AV_CODEC_CAP_CHANNEL_CONF)))) {
+           ret >= 0 && probe_decode_needed(st, ps)) {
         got_picture = 0;
         if (avctx->codec_type == AVMEDIA_TYPE_VIDEO ||
             avctx->codec_type == AVMEDIA_TYPE_AUDIO) {
@@ -2230,7 +2301,6 @@ static int try_decode_frame(AVFormatContext *s, AVStream *st,
         }
     }
 
-fail:
     if (do_skip_frame) {
         avctx->skip_frame = skip_frame;
     }
@@ -2239,6 +2309,62 @@ fail:
     return ret;
 }
 
+/* returns 1 or 0 if or if not decoded data was returned, or a negative error */
+static int try_decode_frame(AVFormatContext *s, AVStream *st,
+                            const AVPacket *pkt, AVDictionary **options)
+{
+    FFStreamProbeState ps;
+    int ret = open_probe_decoder(s, st, options);
+    if (ret < 0)
+        return ret;
+
+    ps = stream_probe_state(st);
+    return decode_probe_frame(st, pkt, &ps);
+}
+
+static int probe_decode_job(void *opaque)
+{
+    AVStream *const st = opaque;
+    FFStreamInfo *const info = ffstream(st)->info;
+
+    return decode_probe_frame(st, info->job_pkt, &info->job_state);
+}
+
+/* Run decode_probe_frame() for pkt on the analysis threads. The decoder
+ * must be open and no job may be pending for the stream. */
+static int submit_probe_decode(AVExecutor *e, AVStream *st, const AVPacket *pkt)
+{
+    FFStream *const sti = ffstream(st);
+    FFStreamInfo *const info = sti->info;
+
+    info->job_state = stream_probe_state(st);
+
+    /* most packets are read after the stream parameters are known */
+    if (!probe_decode_needed(st, &info->job_state))
+        return 0;
+
+    if (!info->job_pkt) {
+        info->job_pkt = av_packet_alloc();
+        if (!info->job_pkt)
+            return AVERROR(ENOMEM);
+    }
+    /* an empty packet flushes the decoder, keep its data NULL */
+    if (pkt->data) {
+        int ret = av_packet_ref(info->job_pkt, pkt);
+        if (ret < 0)
+            return ret;
+    }
+
+    info->job = av_executor_job_alloc(e, probe_decode_job, st, 0);
+    if (!info->job) {
+        av_packet_unref(info->job_pkt);
+        return AVERROR(ENOMEM);
+    }
+    av_executor_job_submit(info->job);
+
+    return 0;
+}
+
 static int chapter_start_cmp(const void *p1, const void *p2)
 {
     const AVChapter *const ch1 = *(AVChapter**)p1;
@@ -2606,6 +2732,53 @@ fail:
     return ret;
 }
 
+/* returns 1 if enough packets of the stream have been analyzed */
+static int stream_info_complete(AVFormatContext *ic, AVStream *st)
+{
+    FFStream *const sti = ffstream(st);
+    int fps_analyze_framecount = 20;
+    int count;
+
+    if (!has_codec_parameters(st, NULL))
+        return 0;
+    /* If the timebase is coarse (like the usual millisecond precision
+     * of mkv), we need to analyze more frames to reliably arrive at
+     * the correct fps. */
+    if (av_q2d(st->time_base) > 0.0005)
+        fps_analyze_framecount *= 2;
+    if (!tb_unreliable(ic, st))
+        fps_analyze_framecount = 0;
+    if (ic->fps_probe_size >= 0)
+        fps_analyze_framecount = ic->fps_probe_size;
+    if (st->disposition & AV_DISPOSITION_ATTACHED_PIC)
+        fps_analyze_framecount = 0;
+    /* variable fps and no guess at the real fps */
+    count = (ic->iformat->flags & AVFMT_NOTIMESTAMPS) ?
+               sti->info->codec_info_duration_fields/2 :
+               sti->info->duration_count;
+    if (!(st->r_frame_rate.num && st->avg_frame_rate.num) &&
+        st->codecpar->codec_type == AVMEDIA_TYPE_VIDEO) {
+        if (count < fps_analyze_framecount)
+            return 0;
+    }
+    // Look at the first 3 frames if there is evidence of frame delay
+    // but the decoder delay is not set.
+    if (sti->info->frame_delay_evidence && count < 2 && sti->avctx->has_b_frames == 0)
+        return 0;
+    if (!sti->avctx->extradata &&
+        (!sti->extract_extradata.inited || sti->extract_extradata.bsf) &&
+        extract_extradata_check(st))
+        return 0;
+    if (sti->first_dts == AV_NOPTS_VALUE &&
+        (!(ic->iformat->flags & AVFMT_NOTIMESTAMPS) || sti->need_parsing == AVSTREAM_PARSE_FULL_RAW) &&
+        sti->codec_info_nb_frames < ((st->disposition & AV_DISPOSITION_ATTACHED_PIC) ? 1 : ic->max_ts_probe) &&
+        (st->codecpar->codec_type == AVMEDIA_TYPE_VIDEO ||
+         st->codecpar->codec_type == AVMEDIA_TYPE_AUDIO))
+        return 0;
+
+    return 1;
+}
+
 int avformat_find_stream_info(AVFormatContext *ic, AVDictionary **options)
 {
     FFFormatContext *const si = ffformatcontext(ic);
@@ -2621,6 +2794,7 @@ int avformat_find_stream_info(AVFormatContext *ic, AVDictionary **options)
     int64_t max_subtitle_analyze_duration;
     int64_t probesize = ic->probesize;
     int eof_reached = 0;
+    AVExecutor *executor = NULL;
 
     flush_codecs = probesize > 0;
 
@@ -2700,13 +2874,24 @@ int avformat_find_stream_info(AVFormatContext *ic, AVDictionary **options)
             av_dict_free(&thread_opt);
     }
 
+    if (ic->analyze_threads != 1) {
+        /* share the worker threads of the process unless a number of
+         * threads was requested */
+        executor = ic->analyze_threads ? av_executor_alloc_job_executor(ic->analyze_threads)
+                                       : av_executor_shared_acquire();
+        if (!executor) {
+            ret = AVERROR(ENOMEM);
+            goto find_stream_info_err;
+        }
+    }
+
     read_size = 0;
     for (;;) {
         const AVPacket *pkt;
         AVStream *st;
         FFStream *sti;
         AVCodecContext *avctx;
-        int analyzed_all_streams;
+        int analyzed_all_streams, pending;
         unsigned i;
         if (ff_check_interrupt(&ic->interrupt_callback)) {
             ret = AVERROR_EXIT;
@@ -2721,50 +2906,23 @@ int avformat_find_stream_info(AVFormatContext *ic, AVDictionary **options)
         if (ret < 0)
             goto unref_then_goto_end;
 
-        /* check if one codec still needs to be handled */
+        /* check if one codec still needs to be handled, streams whose
+         * probe decoding job is still running are checked last */
+        pending = 0;
         for (i = 0; i < ic->nb_streams; i++) {
-            AVStream *const st  = ic->streams[i];
-            FFStream *const sti = ffstream(st);
-            int fps_analyze_framecount = 20;
-            int count;
-
-            if (!has_codec_parameters(st, NULL))
-                break;
-            /* If the timebase is coarse (like the usual millisecond precision
-             * of mkv), we need to analyze more frames to reliably arrive at
-             * the correct fps. */
-            if (av_q2d(st->time_base) > 0.0005)
-                fps_analyze_framecount *= 2;
-            if (!tb_unreliable(ic, st))
-                fps_analyze_framecount = 0;
-            if (ic->fps_probe_size >= 0)
-                fps_analyze_framecount = ic->fps_probe_size;
-            if (st->disposition & AV_DISPOSITION_ATTACHED_PIC)
-                fps_analyze_framecount = 0;
-            /* variable fps and no guess at the real fps */
-            count = (ic->iformat->flags & AVFMT_NOTIMESTAMPS) ?
-                       sti->info->codec_info_duration_fields/2 :
-                       sti->info->duration_count;
-            if (!(st->r_frame_rate.num && st->avg_frame_rate.num) &&
-                st->codecpar->codec_type == AVMEDIA_TYPE_VIDEO) {
-                if (count < fps_analyze_framecount)
-                    break;
+            if (ffstream(ic->streams[i])->info->job) {
+                pending = 1;
+                continue;
             }
-            // Look at the first 3 frames if there is evidence of frame delay
-            // but the decoder delay is not set.
-            if (sti->info->frame_delay_evidence && count < 2 && sti->avctx->has_b_frames == 0)
-                break;
-            if (!sti->avctx->extradata &&
-                (!sti->extract_extradata.inited || sti->extract_extradata.bsf) &&
-                extract_extradata_check(st))
-                break;
-            if (sti->first_dts == AV_NOPTS_VALUE &&
-                (!(ic->iformat->flags & AVFMT_NOTIMESTAMPS) || sti->need_parsing == AVSTREAM_PARSE_FULL_RAW) &&
-                sti->codec_info_nb_frames < ((st->disposition & AV_DISPOSITION_ATTACHED_PIC) ? 1 : ic->max_ts_probe) &&
-                (st->codecpar->codec_type == AVMEDIA_TYPE_VIDEO ||
-                 st->codecpar->codec_type == AVMEDIA_TYPE_AUDIO))
+            if (!stream_info_complete(ic, ic->streams[i]))
                 break;
         }
+        if (i == ic->nb_streams && pending) {
+            stream_info_sync_all(ic);
+            for (i = 0; i < ic->nb_streams; i++)
+                if (!stream_info_complete(ic, ic->streams[i]))
+                    break;
+        }
         analyzed_all_streams = 0;
         if (i == ic->nb_streams && !si->missing_streams) {
             analyzed_all_streams = 1;
@@ -2822,6 +2980,8 @@ int avformat_find_stream_info(AVFormatContext *ic, AVDictionary **options)
 
         st  = ic->streams[pkt->stream_index];
         sti = ffstream(st);
+        /* packets returned from the parse queue were not synced */
+        stream_info_sync(sti);
         if (!(st->disposition & AV_DISPOSITION_ATTACHED_PIC))
             read_size += pkt->size;
 
@@ -2935,8 +3095,16 @@ int avformat_find_stream_info(AVFormatContext *ic, AVDictionary **options)
          * least one frame of codec data, this makes sure the codec initializes
          * the channel configuration and does not only trust the values from
          * the container. */
-        try_decode_frame(ic, st, pkt,
-                         (options && i < orig_nb_streams) ? &options[i] : NULL);
+        if (executor) {
+            if (open_probe_decoder(ic, st, (options && st->index < orig_nb_streams) ?
+                                           &options[st->index] : NULL) >= 0) {
+                ret = submit_probe_decode(executor, st, pkt);
+                if (ret < 0)
+                    goto unref_then_goto_end;
+            }
+        } else
+            try_decode_frame(ic, st, pkt,
+                             (options && i < orig_nb_streams) ? &options[i] : NULL);
 
         if (ic->flags & AVFMT_FLAG_NOBUFFER)
             av_packet_unref(pkt1);
@@ -2945,6 +3113,8 @@ int avformat_find_stream_info(AVFormatContext *ic, AVDictionary **options)
         count++;
     }
 
+    stream_info_sync_all(ic);
+
     if (eof_reached) {
         for (unsigned stream_index = 0; stream_index < ic->nb_streams; stream_index++) {
             AVStream *const st = ic->streams[stream_index];
@@ -2981,6 +3151,9 @@ int avformat_find_stream_info(AVFormatContext *ic, AVDictionary **options)
 
             /* flush the decoders */
             if (sti->info->found_decoder == 1) {
+                if (executor && submit_probe_decode(executor, st, empty_pkt) >= 0)
+                    continue;
+
                 err = try_decode_frame(ic, st, empty_pkt,
                                         (options && i < orig_nb_streams)
                                         ? &options[i] : NULL);
@@ -2991,6 +3164,12 @@ int avformat_find_stream_info(AVFormatContext *ic, AVDictionary **options)
                 }
             }
         }
+
+        for (unsigned i = 0; i < ic->nb_streams; i++) {
+            if (stream_info_sync(ffstream(ic->streams[i])) < 0)
+                av_log(ic, AV_LOG_INFO,
+                       "decoding for stream %u failed\n", i);
+        }
     }
 
     ff_rfps_calculate(ic);
@@ -3191,6 +3370,8 @@ find_stream_info_err:
         int err;
 
         if (sti->info) {
+            stream_info_sync(sti);
+            av_packet_free(&sti->info->job_pkt);
             av_freep(&sti->info->duration_error);
             av_freep(&sti->info);
         }
@@ -3203,6 +3384,10 @@ find_stream_info_err:
 
         av_bsf_free(&sti->extract_extradata.bsf);
     }
+    if (ic->analyze_threads)
+        av_executor_free(&executor);
+    else
+        av_executor_shared_release(&executor);
     if (ic->pb) {
         FFIOContext *const ctx = ffiocontext(ic->pb);
         av_log(ic, AV_LOG_DEBUG, "After avformat_find_stream_info() pos: %"PRId64" bytes read:%"PRId64" seeks:%d frames:%d\n",
@@ -22,6 +22,7 @@
 #define AVFORMAT_DEMUX_H
 
 #include <stdint.h>
+#include "libavutil/executor.h"
 #include "libavutil/rational.h"
 #include "libavcodec/packet.h"
 #include "avformat.h"
@@ -63,6 +64,23 @@ enum FFInputFormatCommandOption {
     FF_INFMT_COMMAND_GET_REPLY,
 };
 
+/**
+ * A magic number a probe buffer must contain for a demuxer to be probed.
+ * The mask selects the bits to compare; a zeroed mask compares all bits.
+ */
+typedef struct FFProbeSignature {
+    uint16_t offset;    ///< byte offset of the magic in the probe buffer
+    uint8_t  size;      ///< size of the magic in bytes, 0 ends a list
+    uint8_t  magic[8];
+    uint8_t  mask[8];
+} FFProbeSignature;
+
+/**
+ * Build a signature list for FFInputFormat.signatures, e.g.
+ * FF_PROBE_SIGNATURES({ 0, 4, "RIFF" }, { 0, 4, "RIFX" })
+ */
+#define FF_PROBE_SIGNATURES(...) ((const FFProbeSignature[]){ __VA_ARGS__, { 0 } })
+
 typedef struct FFInputFormat {
     /**
      * The public AVInputFormat. See avformat.h for it.
@@ -91,6 +109,14 @@ typedef struct FFInputFormat {
      */
     int (*read_probe)(const AVProbeData *);
 
+    /**
+     * Optional list of magic numbers, see FF_PROBE_SIGNATURES().
+     * If set, read_probe() is only called for probe buffers matching at
+     * least one of them, so read_probe() must return 0 for any buffer that
+     * matches none. Extension and MIME type matching are not affected.
+     */
+    const FFProbeSignature *signatures;
+
     /**
      * Read the format header and initialize the AVFormatContext
      * structure. Return 0 if OK. 'avformat_new_stream' should be
@@ -188,6 +214,17 @@ static inline const FFInputFormat *ffifmt(const AVInputFormat *fmt)
     return (const FFInputFormat*)fmt;
 }
 
+/**
+ * Stream state checked to decide whether probe decoding is still needed.
+ * Probe decoding jobs use a copy taken when they are submitted, as the
+ * calling thread keeps updating the stream.
+ */
+typedef struct FFStreamProbeState {
+    enum AVCodecID codec_id;    ///< AVStream.codecpar->codec_id
+    int codec_info_nb_frames;   ///< FFStream.codec_info_nb_frames
+    int has_sar;                ///< the stream or its codecpar has a sample aspect ratio
+} FFStreamProbeState;
+
 #define MAX_STD_TIMEBASES (30*12+30+3+6)
 typedef struct FFStreamInfo {
     int64_t last_dts;
@@ -215,6 +252,15 @@ typedef struct FFStreamInfo {
     int     fps_first_dts_idx;
     int64_t fps_last_dts;
     int     fps_last_dts_idx;
+
+    /**
+     * Probe decoding job running on the analysis threads, see
+     * AVFormatContext.analyze_threads. The job owns job_pkt and the
+     * decoder context until it has been waited for.
+     */
+    AVExecutorJob *job;
+    AVPacket *job_pkt;
+    FFStreamProbeState job_state;
 } FFStreamInfo;
 
 /**
@@ -384,6 +430,31 @@ int ff_get_extradata(void *logctx, AVCodecParameters *par, AVIOContext *pb, int
  */
 int ff_find_stream_index(const AVFormatContext *s, int id);
 
+/**
+ * First member of the private context of the sound bank demuxers using
+ * ff_subsong_demuxer_class.
+ */
+typedef struct FFSubsongContext {
+    const AVClass *class;
+    int subsong;            ///< index of the only subsong to demux, -1 for all
+} FFSubsongContext;
+
+/**
+ * AVClass with the subsong option of the sound bank demuxers.
+ */
+extern const AVClass ff_subsong_demuxer_class;
+
+/**
+ * Keep only one subsong of a sound bank, given by the index of its stream.
+ * All other streams are freed and the kept stream becomes stream 0.
+ *
+ * @param free_stream if not NULL, called for each removed stream before it
+ *                    is freed, to release what its priv_data references
+ * @return 0 on success, AVERROR(EINVAL) if subsong is out of range
+ */
+int ff_select_subsong(AVFormatContext *s, int subsong,
+                      void (*free_stream)(AVStream *st));
+
 int ff_buffer_packet(AVFormatContext *s, AVPacket *pkt);
 
 #endif /* AVFORMAT_DEMUX_H */
@@ -22,6 +22,7 @@
 #include "libavutil/mem.h"
 
 #include "libavutil/avassert.h"
+#include "libavutil/opt.h"
 #include "libavcodec/bytestream.h"
 #include "libavcodec/packet_internal.h"
 #include "avformat.h"
@@ -360,3 +361,42 @@ int ff_find_stream_index(const AVFormatContext *s, int id)
             return i;
     return -1;
 }
+
+int ff_select_subsong(AVFormatContext *s, int subsong,
+                      void (*free_stream)(AVStream *st))
+{
+    AVStream *st;
+
+    if (subsong < 0 || subsong >= s->nb_streams) {
+        av_log(s, AV_LOG_ERROR, "Invalid subsong index %d, there are %u subsongs\n",
+               subsong, s->nb_streams);
+        return AVERROR(EINVAL);
+    }
+
+    st = s->streams[subsong];
+    for (unsigned i = 0; i < s->nb_streams; i++) {
+        if (i == subsong)
+            continue;
+        if (free_stream)
+            free_stream(s->streams[i]);
+        ff_free_stream(&s->streams[i]);
+    }
+
+    s->streams[0] = st;
+    s->nb_streams = 1;
+    st->index = 0;
+
+    return av_dict_set_int(&s->metadata, "track", subsong + 1, 0);
+}
+
+static const AVOption subsong_options[] = {
+    { "subsong", "only demux the subsong with this index, -1 for all", offsetof(FFSubsongContext, subsong),
+        AV_OPT_TYPE_INT, {.i64=-1}, .min = -1, .max = INT_MAX, .flags = AV_OPT_FLAG_DECODING_PARAM },
+    { NULL },
+};
+
+const AVClass ff_subsong_demuxer_class = {
+    .class_name = "sound bank demuxer",
+    .option     = subsong_options,
+    .version    = LIBAVUTIL_VERSION_INT,
+};
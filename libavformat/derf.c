@@ -77,6 +77,7 @@ const FFInputFormat ff_derf_demuxer = {
     .p.long_name    = NULL_IF_CONFIG_SMALL("Xilam DERF Audio"),
     .p.extensions   = "adp",
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "DERF" }),
     .read_header    = read_header,
     .read_packet    = ff_pcm_read_packet,
     .read_seek      = ff_pcm_read_seek,
@@ -155,6 +155,7 @@ const FFInputFormat ff_derfvideo_demuxer = {
     .p.flags        = AVFMT_GENERIC_INDEX,
     .priv_data_size = sizeof(DERFDemuxContext),
     .read_probe     = derfvideo_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "DERF" }),
     .read_header    = derfvideo_read_header,
     .read_packet    = derfvideo_read_packet,
 };
@@ -83,6 +83,7 @@ const FFInputFormat ff_diva_demuxer = {
     .p.flags        = AVFMT_GENERIC_INDEX,
     .p.extensions   = "diva",
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "DIVA" }),
     .read_header    = read_header,
     .read_packet    = ff_pcm_read_packet,
 };
@@ -68,6 +68,7 @@ const FFInputFormat ff_dvi_demuxer = {
     .p.extensions   = "dvi",
     .p.flags        = AVFMT_GENERIC_INDEX,
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "DVI." }),
     .read_header    = read_header,
     .read_packet    = ff_pcm_read_packet,
 };
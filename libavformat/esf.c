@@ -106,6 +106,7 @@ const FFInputFormat ff_esf_demuxer = {
     .p.flags        = AVFMT_GENERIC_INDEX,
     .p.extensions   = "esf",
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "ESF\6" }),
     .read_header    = read_header,
     .read_packet    = read_packet,
 };
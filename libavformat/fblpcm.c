@@ -89,6 +89,7 @@ const FFInputFormat ff_fblpcm_demuxer = {
     .p.flags        = AVFMT_GENERIC_INDEX,
     .p.extensions   = "ladpcm",
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "LPCM" }),
     .read_header    = read_header,
     .read_packet    = ff_pcm_read_packet,
 };
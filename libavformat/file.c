@@ -22,10 +22,12 @@
 #include "config_components.h"
 
 #include "libavutil/avstring.h"
+#include "libavutil/buffer.h"
 #include "libavutil/file_open.h"
 #include "libavutil/internal.h"
 #include "libavutil/mem.h"
 #include "libavutil/opt.h"
+#include "libavcodec/defs.h"
 #include "avio.h"
 #if HAVE_DIRENT_H
 #include <dirent.h>
@@ -38,6 +40,9 @@
 #include <unistd.h>
 #endif
 #include <sys/stat.h>
+#if HAVE_MMAP
+#include <sys/mman.h>
+#endif
 #include <stdlib.h>
 #include "os_support.h"
 #include "url.h"
@@ -89,6 +94,9 @@
 
 /* standard file protocol */
 
+/* initial read-ahead window, doubled on sequential reads up to the maximum */
+#define READAHEAD_MIN (128 * 1024)
+
 typedef struct FileContext {
     const AVClass *class;
     int fd;
@@ -97,6 +105,13 @@ typedef struct FileContext {
     int pkt_size;
     int follow;
     int seekable;
+    int readahead;
+    int ra_window;
+    int64_t pos;
+    int64_t ra_start;
+    int64_t ra_end;
+    int mmap;
+    size_t page_size;
 #if HAVE_DIRENT_H
     DIR *dir;
 #endif
@@ -108,6 +123,8 @@ static const AVOption file_options[] = {
     { "follow", "Follow a file as it is being written", offsetof(FileContext, follow), AV_OPT_TYPE_INT, { .i64 = 0 }, 0, 1, AV_OPT_FLAG_DECODING_PARAM },
     { "seekable", "Sets if the file is seekable", offsetof(FileContext, seekable), AV_OPT_TYPE_INT, { .i64 = -1 }, -1, 0, AV_OPT_FLAG_DECODING_PARAM | AV_OPT_FLAG_ENCODING_PARAM },
     { "pkt_size", "Maximum packet size", offsetof(FileContext, pkt_size), AV_OPT_TYPE_INT, { .i64 = 0 }, 0, INT_MAX, AV_OPT_FLAG_DECODING_PARAM | AV_OPT_FLAG_ENCODING_PARAM },
+    { "readahead", "Maximum size of the adaptive read-ahead window, 0 to disable", offsetof(FileContext, readahead), AV_OPT_TYPE_INT, { .i64 = 0 }, 0, INT_MAX, AV_OPT_FLAG_DECODING_PARAM },
+    { "mmap", "Map the file to return packets without copying them", offsetof(FileContext, mmap), AV_OPT_TYPE_BOOL, { .i64 = 0 }, 0, 1, AV_OPT_FLAG_DECODING_PARAM },
     { NULL }
 };
 
@@ -135,12 +152,44 @@ static const AVClass fd_class = {
     .version    = LIBAVUTIL_VERSION_INT,
 };
 
+/**
+ * Ask the kernel to start reading the data ahead of the current position
+ * asynchronously. The window grows while reads stay within or just after the
+ * range already requested, and shrinks back to its initial size after a seek
+ * elsewhere, so that interleaved files read with short forward seeks keep a
+ * large window.
+ */
+static void file_readahead(FileContext *c)
+{
+#if HAVE_POSIX_FADVISE
+    int64_t start;
+
+    if (!c->ra_window || c->pos < c->ra_start || c->pos > c->ra_end + c->ra_window) {
+        c->ra_window = FFMIN(READAHEAD_MIN, c->readahead);
+        c->ra_start  = c->ra_end = c->pos;
+    }
+
+    if (c->ra_end - c->pos >= c->ra_window / 2)
+        return;
+
+    start = FFMAX(c->ra_end, c->pos);
+    posix_fadvise(c->fd, start, c->pos + c->ra_window - start, POSIX_FADV_WILLNEED);
+    c->ra_start  = c->pos;
+    c->ra_end    = c->pos + c->ra_window;
+    c->ra_window = FFMIN(2LL * c->ra_window, c->readahead);
+#endif
+}
+
 static int file_read(URLContext *h, unsigned char *buf, int size)
 {
     FileContext *c = h->priv_data;
     int ret;
     size = FFMIN(size, c->blocksize);
+    if (c->readahead)
+        file_readahead(c);
     ret = read(c->fd, buf, size);
+    if (ret > 0)
+        c->pos += ret;
     if (ret == 0 && c->follow)
         return AVERROR(EAGAIN);
     if (ret == 0)
@@ -240,6 +289,8 @@ static int64_t file_seek(URLContext *h, int64_t pos, int whence)
     }
 
     ret = lseek(c->fd, pos, whence);
+    if (ret >= 0)
+        c->pos = ret;
 
     return ret < 0 ? AVERROR(errno) : ret;
 }
@@ -282,6 +333,66 @@ static int file_move(URLContext *h_src, URLContext *h_dst)
     return 0;
 }
 
+#if HAVE_MMAP && HAVE_SYSCONF
+/* smaller packets are copied, as mapping them costs more than the copy */
+#define MAP_MIN_SIZE (64 * 1024)
+
+static void file_unmap(void *opaque, uint8_t *data)
+{
+    size_t page_size = sysconf(_SC_PAGESIZE);
+    uint8_t *base = (uint8_t *)((uintptr_t)data & ~(uintptr_t)(page_size - 1));
+
+    munmap(base, (size_t)opaque);
+}
+#endif
+
+/**
+ * Map size bytes at pos privately, so that avio can return packets
+ * referencing the pages of the file instead of copying the data twice,
+ * from the kernel into its buffer and from its buffer into the packet.
+ * The mapping is copy-on-write, so demuxers can edit the packet in place.
+ * Only the page holding the padding is copied, to zero it.
+ */
+static int file_map(URLContext *h, int64_t pos, int size, AVBufferRef **buf)
+{
+#if HAVE_MMAP && HAVE_SYSCONF
+    FileContext *c = h->priv_data;
+    struct stat st;
+    int64_t offset;
+    size_t len;
+    uint8_t *base;
+
+    if (!c->page_size || size < MAP_MIN_SIZE)
+        return AVERROR(ENOSYS);
+
+    /* the padding must lie within the file, a truncated tail is copied */
+    if (fstat(c->fd, &st) < 0 || pos < 0 ||
+        pos + size + AV_INPUT_BUFFER_PADDING_SIZE > st.st_size)
+        return AVERROR(ENOSYS);
+
+    offset = pos & ~(int64_t)(c->page_size - 1);
+    len    = pos - offset + size + AV_INPUT_BUFFER_PADDING_SIZE;
+
+    base = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE, c->fd, offset);
+    if (base == MAP_FAILED) {
+        av_log(h, AV_LOG_VERBOSE, "Could not map the file: %s\n", av_err2str(AVERROR(errno)));
+        return AVERROR(ENOSYS);
+    }
+    memset(base + len - AV_INPUT_BUFFER_PADDING_SIZE, 0, AV_INPUT_BUFFER_PADDING_SIZE);
+
+    *buf = av_buffer_create(base + pos - offset, size + AV_INPUT_BUFFER_PADDING_SIZE,
+                            file_unmap, (void *)len, 0);
+    if (!*buf) {
+        munmap(base, len);
+        return AVERROR(ENOMEM);
+    }
+
+    return 0;
+#else
+    return AVERROR(ENOSYS);
+#endif
+}
+
 static int file_open(URLContext *h, const char *filename, int flags)
 {
     FileContext *c = h->priv_data;
@@ -312,6 +423,15 @@ static int file_open(URLContext *h, const char *filename, int flags)
 
     h->is_streamed = !fstat(fd, &st) && S_ISFIFO(st.st_mode);
 
+    if (c->mmap && !(flags & AVIO_FLAG_WRITE) && !c->follow &&
+        !fstat(fd, &st) && S_ISREG(st.st_mode)) {
+#if HAVE_MMAP && HAVE_SYSCONF
+        c->page_size = sysconf(_SC_PAGESIZE);
+#else
+        av_log(h, AV_LOG_WARNING, "mmap is not supported on this system\n");
+#endif
+    }
+
     if (c->pkt_size) {
         h->max_packet_size = c->pkt_size;
     } else {
@@ -328,6 +448,11 @@ static int file_open(URLContext *h, const char *filename, int flags)
     if (c->seekable >= 0)
         h->is_streamed = !c->seekable;
 
+#if !HAVE_POSIX_FADVISE
+    if (c->readahead)
+        av_log(h, AV_LOG_WARNING, "readahead is not supported on this system\n");
+#endif
+
     return 0;
 }
 
@@ -336,6 +461,8 @@ static int file_open_dir(URLContext *h)
 #if HAVE_LSTAT
     FileContext *c = h->priv_data;
 
+    /* no file is opened, keep file_close() from closing fd 0 */
+    c->fd = -1;
     c->dir = opendir(h->filename);
     if (!c->dir)
         return AVERROR(errno);
@@ -423,6 +550,7 @@ const URLProtocol ff_file_protocol = {
     .url_seek            = file_seek,
     .url_close           = file_close,
     .url_get_file_handle = file_get_handle,
+    .url_map             = file_map,
     .url_check           = file_check,
     .url_delete          = file_delete,
     .url_move            = file_move,
@@ -24,6 +24,7 @@
 #include "libavutil/avstring.h"
 #include "libavutil/mem.h"
 #include "libavutil/opt.h"
+#include "libavutil/thread.h"
 
 #include "avio_internal.h"
 #include "avformat.h"
@@ -153,6 +154,90 @@ const AVInputFormat *av_find_input_format(const char *short_name)
     return NULL;
 }
 
+/* Must be larger than the number of demuxers, the rest is not indexed */
+#define MAX_PROBE_FILTERS 1024
+
+/* Prebuilt index of the demuxer signatures: the set of values the byte at
+ * the signatures' common offset may take. It rejects most demuxers with a
+ * single bit test before their signature list is even looked at. */
+typedef struct ProbeFilter {
+    int     offset;     /* common offset of all signatures, -1 if none */
+    uint8_t bytes[32];  /* bitset of the accepted byte values */
+} ProbeFilter;
+
+static ProbeFilter probe_filters[MAX_PROBE_FILTERS];
+static int nb_probe_filters;
+static AVOnce probe_filters_once = AV_ONCE_INIT;
+
+static int signature_has_mask(const FFProbeSignature *sig)
+{
+    for (int j = 0; j < sig->size; j++)
+        if (sig->mask[j])
+            return 1;
+    return 0;
+}
+
+static av_cold void build_probe_filters(void)
+{
+    const AVInputFormat *fmt;
+    void *i = 0;
+    int n;
+
+    for (n = 0; n < MAX_PROBE_FILTERS && (fmt = av_demuxer_iterate(&i)); n++) {
+        const FFProbeSignature *sig = ffifmt(fmt)->signatures;
+        ProbeFilter *f = &probe_filters[n];
+
+        f->offset = sig ? sig->offset : -1;
+        for (; sig && sig->size; sig++) {
+            const uint8_t mask = signature_has_mask(sig) ? sig->mask[0] : 0xFF;
+
+            if (sig->offset != f->offset) {
+                f->offset = -1;
+                break;
+            }
+            for (int b = 0; b < 256; b++)
+                if (!((b ^ sig->magic[0]) & mask))
+                    f->bytes[b >> 3] |= 1 << (b & 7);
+        }
+    }
+    nb_probe_filters = n;
+}
+
+static int probe_signatures_match(const FFInputFormat *fmt, int idx,
+                                  const AVProbeData *pd)
+{
+    const FFProbeSignature *sig = fmt->signatures;
+
+    if (!sig)
+        return 1;
+
+    if (idx < nb_probe_filters && probe_filters[idx].offset >= 0) {
+        const ProbeFilter *f = &probe_filters[idx];
+        if (f->offset >= pd->buf_size + AVPROBE_PADDING_SIZE)
+            return 0;
+        if (!(f->bytes[pd->buf[f->offset] >> 3] & (1 << (pd->buf[f->offset] & 7))))
+            return 0;
+    }
+
+    /* The buffer is zero padded, so reading the padding behaves like
+     * read_probe() would on a short buffer. */
+    for (; sig->size; sig++) {
+        const uint8_t *buf = pd->buf + sig->offset;
+        const int masked = signature_has_mask(sig);
+        int j;
+
+        if (sig->offset + sig->size > pd->buf_size + AVPROBE_PADDING_SIZE)
+            continue;
+        for (j = 0; j < sig->size; j++)
+            if ((buf[j] ^ sig->magic[j]) & (masked ? sig->mask[j] : 0xFF))
+                break;
+        if (j == sig->size)
+            return 1;
+    }
+
+    return 0;
+}
+
 const AVInputFormat *av_probe_input_format3(const AVProbeData *pd,
                                             int is_opened, int *score_ret)
 {
@@ -172,6 +257,8 @@ const AVInputFormat *av_probe_input_format3(const AVProbeData *pd,
     if (!lpd.buf)
         lpd.buf = (unsigned char *) zerobuffer;
 
+    ff_thread_once(&probe_filters_once, build_probe_filters);
+
     while (lpd.buf_size > 10 && ff_id3v2_match(lpd.buf, ID3v2_DEFAULT_MAGIC)) {
         int id3len = ff_id3v2_tag_len(lpd.buf);
         if (lpd.buf_size > id3len + 16) {
@@ -188,14 +275,15 @@ const AVInputFormat *av_probe_input_format3(const AVProbeData *pd,
         }
     }
 
-    while ((fmt1 = av_demuxer_iterate(&i))) {
+    for (int idx = 0; (fmt1 = av_demuxer_iterate(&i)); idx++) {
         if (fmt1->flags & AVFMT_EXPERIMENTAL)
             continue;
         if (!is_opened == !(fmt1->flags & AVFMT_NOFILE) && strcmp(fmt1->name, "image2"))
             continue;
         score = 0;
         if (ffifmt(fmt1)->read_probe) {
-            score = ffifmt(fmt1)->read_probe(&lpd);
+            if (probe_signatures_match(ffifmt(fmt1), idx, &lpd))
+                score = ffifmt(fmt1)->read_probe(&lpd);
             if (score)
                 av_log(NULL, AV_LOG_TRACE, "Probing %s score:%d size:%d\n", fmt1->name, score, lpd.buf_size);
             if (fmt1->extensions && av_match_ext(lpd.filename, fmt1->extensions)) {
@@ -29,6 +29,10 @@
 #include "internal.h"
 #include "fsbvorbis_data.h"
 
+typedef struct FSBDemuxContext {
+    FFSubsongContext sub;
+} FSBDemuxContext;
+
 typedef struct FSBStream {
     int64_t name_offset;
     int64_t start_offset;
@@ -83,6 +87,7 @@ static int sort_streams(const void *a, const void *b)
 
 static int fsb_read_header(AVFormatContext *s)
 {
+    FSBDemuxContext *fsb = s->priv_data;
     AVIOContext *pb = s->pb;
     unsigned format, version, nb_streams;
     int minor_version, flags = 0;
@@ -832,6 +837,14 @@ static int fsb_read_header(AVFormatContext *s)
         st->index = n;
     }
 
+    if (fsb->sub.subsong >= 0) {
+        if ((ret = ff_select_subsong(s, fsb->sub.subsong, NULL)) < 0)
+            return ret;
+
+        fst = s->streams[0]->priv_data;
+        offset = fst->start_offset;
+    }
+
     avio_seek(pb, offset, SEEK_SET);
 
     return 0;
@@ -896,9 +909,12 @@ static int fsb_read_packet(AVFormatContext *s, AVPacket *pkt)
 const FFInputFormat ff_fsb_demuxer = {
     .p.name         = "fsb",
     .p.long_name    = NULL_IF_CONFIG_SMALL("FMOD Sample Bank"),
+    .p.priv_class   = &ff_subsong_demuxer_class,
     .p.extensions   = "fsb",
     .p.flags        = AVFMT_GENERIC_INDEX,
+    .priv_data_size = sizeof(FSBDemuxContext),
     .read_probe     = fsb_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 3, "FSB" }),
     .read_header    = fsb_read_header,
     .read_packet    = fsb_read_packet,
 };
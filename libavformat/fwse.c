@@ -95,6 +95,7 @@ const FFInputFormat ff_fwse_demuxer = {
     .p.long_name    = NULL_IF_CONFIG_SMALL("Capcom's MT Framework sound"),
     .p.extensions   = "fwse",
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "FWSE" }),
     .read_header    = read_header,
     .read_packet    = ff_pcm_read_packet,
     .read_seek      = ff_pcm_read_seek,
@@ -51,6 +51,9 @@ static av_cold int g723_1_init(AVFormatContext *s)
     return 0;
 }
 
+/* One frame per packet: the frame size depends on the mode bits of each
+ * frame, and the decoder splits a packet evenly between the channels, so
+ * several frames cannot be batched like the ADPCM blocks. */
 static int g723_1_read_packet(AVFormatContext *s, AVPacket *pkt)
 {
     int size, byte, ret;
@@ -109,6 +109,7 @@ const FFInputFormat ff_gccstr_demuxer = {
     .p.flags        = AVFMT_GENERIC_INDEX,
     .p.extensions   = "dsp",
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "Cstr" }),
     .read_header    = read_header,
     .read_packet    = ff_pcm_read_packet,
 };
@@ -110,6 +110,7 @@ const FFInputFormat ff_gcstr_demuxer = {
     .priv_data_size = sizeof(GCSTRContext),
     .p.extensions   = "str",
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "STR\0" }),
     .read_header    = read_header,
     .read_packet    = read_packet,
 };
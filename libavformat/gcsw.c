@@ -87,6 +87,7 @@ const FFInputFormat ff_gcsw_demuxer = {
     .p.flags        = AVFMT_GENERIC_INDEX,
     .p.extensions   = "gcw",
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "GCSW" }),
     .read_header    = read_header,
     .read_packet    = read_packet,
 };
@@ -92,6 +92,7 @@ const FFInputFormat ff_gcub_demuxer = {
     .p.flags        = AVFMT_GENERIC_INDEX,
     .p.extensions   = "gcub",
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "GCub" }),
     .read_header    = read_header,
     .read_packet    = ff_pcm_read_packet,
 };
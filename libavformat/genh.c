@@ -200,6 +200,7 @@ const FFInputFormat ff_genh_demuxer = {
     .p.extensions   = "genh",
     .priv_data_size = sizeof(GENHDemuxContext),
     .read_probe     = genh_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "GENH" }),
     .read_header    = genh_read_header,
     .read_packet    = genh_read_packet,
 };
@@ -158,6 +158,7 @@ const FFInputFormat ff_hca_demuxer = {
     .p.flags        = AVFMT_GENERIC_INDEX,
     .priv_data_size = sizeof(HCADemuxContext),
     .read_probe     = hca_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "HCA", { 0x7f, 0x7f, 0x7f, 0x7f } }),
     .read_header    = hca_read_header,
     .read_packet    = hca_read_packet,
 };
@@ -194,6 +194,7 @@ const FFInputFormat ff_his0_demuxer = {
     .p.extensions   = "his",
     .priv_data_size = sizeof(HIS0DemuxContext),
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "HIS\0" }),
     .read_header    = read_header,
     .read_packet    = read_packet,
     .read_seek      = read_seek,
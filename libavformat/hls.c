@@ -47,6 +47,7 @@
 #include "url.h"
 
 #include "hls_sample_encryption.h"
+#include "segcache.h"
 
 #define INITIAL_BUFFER_SIZE 32768
 
@@ -231,6 +232,10 @@ typedef struct HLSContext {
     int http_multiple;
     int http_seekable;
     int seg_max_retry;
+    int segment_prefetch;
+    char *segment_cache_dir;
+    int64_t segment_cache_size;
+    SegmentCache *segment_cache;
     AVIOContext *playlist_pb;
     HLSCryptoContext  crypto_ctx;
 } HLSContext;
@@ -655,13 +660,10 @@ static int open_url_keepalive(AVFormatContext *s, AVIOContext **pb,
 #endif
 }
 
-static int open_url(AVFormatContext *s, AVIOContext **pb, const char *url,
-                    AVDictionary **opts, AVDictionary *opts2, int *is_http_out)
+static int check_url(AVFormatContext *s, const char *url, int *is_http_out)
 {
     HLSContext *c = s->priv_data;
-    AVDictionary *tmp = NULL;
     const char *proto_name = NULL;
-    int ret;
     int is_http = 0;
 
     if (av_strstart(url, "crypto", NULL)) {
@@ -703,6 +705,22 @@ static int open_url(AVFormatContext *s, AVIOContext **pb, const char *url,
     else if (strcmp(proto_name, "file") || !strncmp(url, "file,", 5))
         return AVERROR_INVALIDDATA;
 
+    *is_http_out = is_http;
+    return 0;
+}
+
+static int open_url(AVFormatContext *s, AVIOContext **pb, const char *url,
+                    AVDictionary **opts, AVDictionary *opts2, int *is_http_out)
+{
+    HLSContext *c = s->priv_data;
+    AVDictionary *tmp = NULL;
+    int ret;
+    int is_http;
+
+    ret = check_url(s, url, &is_http);
+    if (ret < 0)
+        return ret;
+
     av_dict_copy(&tmp, *opts, 0);
     av_dict_copy(&tmp, opts2, 0);
 
@@ -1425,6 +1443,14 @@ static int open_input(HLSContext *c, struct playlist *pls, struct segment *seg,
         }
     }
 
+    if (c->segment_cache && seg->key_type != KEY_AES_128 &&
+        check_url(pls->parent, seg->url, &is_http) >= 0) {
+        ret = ff_segcache_open(c->segment_cache, in, seg->url, seg->url_offset,
+                               seg->size, c->avio_opts);
+        if (ret >= 0 || ret == AVERROR_EXIT)
+            goto cleanup;
+    }
+
     if (seg->key_type == KEY_AES_128) {
         char iv[33], key[33], url[MAX_URL_SIZE];
         ff_data_to_hex(iv, seg->iv, sizeof(seg->iv), 0);
@@ -1658,6 +1684,23 @@ reload:
     return ret;
 }
 
+static void prefetch_segments(HLSContext *c, struct playlist *pls)
+{
+    int64_t n = pls->cur_seq_no - pls->start_seq_no;
+    int is_http;
+
+    for (int i = 1; i <= c->segment_prefetch && n + i < pls->n_segments; i++) {
+        struct segment *seg = pls->segments[n + i];
+
+        if (seg->key_type == KEY_AES_128 ||
+            check_url(pls->parent, seg->url, &is_http) < 0)
+            continue;
+        if (ff_segcache_prefetch(c->segment_cache, seg->url, seg->url_offset,
+                                 seg->size, c->avio_opts) < 0)
+            break;
+    }
+}
+
 static int read_data_continuous(void *opaque, uint8_t *buf, int buf_size)
 {
     struct playlist *v = opaque;
@@ -1715,6 +1758,9 @@ restart:
         }
         segment_retries = 0;
         just_opened = 1;
+
+        if (c->segment_cache)
+            prefetch_segments(c, v);
     }
 
     if (c->http_multiple == -1) {
@@ -2138,6 +2184,7 @@ static int hls_close(AVFormatContext *s)
 {
     HLSContext *c = s->priv_data;
 
+    ff_segcache_free(&c->segment_cache);
     free_playlist_list(c);
     free_variant_list(c);
     free_rendition_list(c);
@@ -2183,6 +2230,21 @@ static int hls_read_header(AVFormatContext *s)
         }
     }
 
+    if (c->segment_prefetch || c->segment_cache_dir) {
+        /* segments are downloaded with the builtin protocols */
+        if (!ffio_geturlcontext(s->pb)) {
+            av_log(s, AV_LOG_WARNING, "Disabling segment prefetching and caching due to custom io_open.\n");
+        } else {
+            ret = ff_segcache_alloc(&c->segment_cache, s, c->segment_cache_dir,
+                                    c->segment_cache_size, c->segment_prefetch);
+            if (ret < 0)
+                return ret;
+            /* segments are read from local files instead */
+            c->http_persistent = 0;
+            c->http_multiple   = 0;
+        }
+    }
+
     /* XXX: Some HLS servers don't like being sent the range header,
        in this case, we need to set http_seekable = 0 to disable
        the range header */
@@ -2897,6 +2959,12 @@ static const AVOption hls_options[] = {
         OFFSET(seg_format_opts), AV_OPT_TYPE_DICT, {.str = NULL}, 0, 0, FLAGS},
     {"seg_max_retry", "Maximum number of times to reload a segment on error.",
      OFFSET(seg_max_retry), AV_OPT_TYPE_INT, {.i64 = 0}, 0, INT_MAX, FLAGS},
+    {"segment_prefetch", "Number of segments to download ahead of time",
+        OFFSET(segment_prefetch), AV_OPT_TYPE_INT, {.i64 = 0}, 0, 64, FLAGS},
+    {"segment_cache_dir", "Directory to keep downloaded segments in",
+        OFFSET(segment_cache_dir), AV_OPT_TYPE_STRING, {.str = NULL}, 0, 0, FLAGS},
+    {"segment_cache_size", "Maximum size of the segment cache directory in bytes, 0 for no limit",
+        OFFSET(segment_cache_size), AV_OPT_TYPE_INT64, {.i64 = 1LL << 30}, 0, INT64_MAX, FLAGS},
     {NULL}
 };
 
@@ -76,6 +76,7 @@ const FFInputFormat ff_hwas_demuxer = {
     .p.flags        = AVFMT_GENERIC_INDEX,
     .p.extensions   = "hwas",
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "sawh" }),
     .read_header    = read_header,
     .read_packet    = ff_pcm_read_packet,
 };
@@ -299,6 +299,7 @@ const FFInputFormat ff_hxd_demuxer = {
     .p.extensions   = "hxd",
     .priv_data_size = sizeof(HXDContext),
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "\0DXH" }),
     .read_header    = read_header,
     .read_packet    = read_packet,
     .read_seek      = read_seek,
@@ -97,6 +97,7 @@ const FFInputFormat ff_idsp_demuxer = {
     .p.flags        = AVFMT_GENERIC_INDEX,
     .p.extensions   = "idsp",
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "IDSP" }),
     .read_header    = read_header,
     .read_packet    = ff_pcm_read_packet,
 };
@@ -79,6 +79,7 @@ const FFInputFormat ff_iivb_demuxer = {
     .p.flags        = AVFMT_GENERIC_INDEX,
     .p.extensions   = "ivb",
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "BVII" }),
     .read_header    = read_header,
     .read_packet    = ff_pcm_read_packet,
 };
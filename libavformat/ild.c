@@ -81,6 +81,7 @@ const FFInputFormat ff_ild_demuxer = {
     .p.flags        = AVFMT_GENERIC_INDEX,
     .p.extensions   = "ild",
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "ILD\0" }),
     .read_header    = read_header,
     .read_packet    = ff_pcm_read_packet,
 };
@@ -0,0 +1,188 @@
+/*
+ * Sidecar index cache
+ *
+ * This file is part of Librempeg
+ *
+ * Librempeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Librempeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Librempeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+
+#include "libavutil/avstring.h"
+#include "libavutil/crc.h"
+#include "libavutil/error.h"
+#include "libavutil/intreadwrite.h"
+#include "libavutil/mem.h"
+
+#include "avio_internal.h"
+#include "indexcache.h"
+#include "internal.h"
+#include "os_support.h"
+
+#define INDEX_CACHE_MAGIC   MKBETAG('L','I','D','X')
+#define INDEX_CACHE_VERSION 1
+#define INDEX_CACHE_HEADER  36
+#define INDEX_ENTRY_SIZE    25
+
+static int source_stat(AVFormatContext *s, int64_t *size, int64_t *mtime)
+{
+    const char *path = s->url;
+    struct stat st;
+
+    av_strstart(path, "file:", &path);
+    if (strstr(path, "://") || stat(path, &st) < 0) {
+        av_log(s, AV_LOG_WARNING, "Index cache is only supported for local files\n");
+        return AVERROR(ENOSYS);
+    }
+
+    *size  = st.st_size;
+    *mtime = st.st_mtime;
+
+    return 0;
+}
+
+static uint32_t payload_crc(const uint8_t *data, int size)
+{
+    return av_crc(av_crc_get_table(AV_CRC_32_IEEE_LE), UINT32_MAX, data, size);
+}
+
+int ff_index_cache_read(AVFormatContext *s, const char *path, uint32_t tag,
+                        uint8_t **data)
+{
+    uint8_t header[INDEX_CACHE_HEADER];
+    AVIOContext *pb = NULL;
+    int64_t size, mtime;
+    uint32_t payload_size;
+    int ret;
+
+    *data = NULL;
+
+    if ((ret = source_stat(s, &size, &mtime)) < 0)
+        return ret;
+
+    if ((ret = s->io_open(s, &pb, path, AVIO_FLAG_READ, NULL)) < 0)
+        return ret;
+
+    if ((ret = ffio_read_size(pb, header, sizeof(header))) < 0)
+        goto end;
+
+    if (AV_RB32(header     ) != INDEX_CACHE_MAGIC   ||
+        AV_RB32(header +  4) != INDEX_CACHE_VERSION ||
+        AV_RB32(header +  8) != tag                 ||
+        AV_RB64(header + 12) != size                ||
+        AV_RB64(header + 20) != mtime) {
+        av_log(s, AV_LOG_VERBOSE, "Index cache %s does not match the file\n", path);
+        ret = AVERROR_INVALIDDATA;
+        goto end;
+    }
+
+    payload_size = AV_RB32(header + 28);
+    if (payload_size > INT_MAX / 2) {
+        ret = AVERROR_INVALIDDATA;
+        goto end;
+    }
+
+    *data = av_malloc(FFMAX(payload_size, 1));
+    if (!*data) {
+        ret = AVERROR(ENOMEM);
+        goto end;
+    }
+
+    if ((ret = ffio_read_size(pb, *data, payload_size)) < 0)
+        goto end;
+
+    if (payload_crc(*data, payload_size) != AV_RB32(header + 32)) {
+        av_log(s, AV_LOG_WARNING, "Index cache %s is corrupt\n", path);
+        ret = AVERROR_INVALIDDATA;
+    }
+
+end:
+    ff_format_io_close(s, &pb);
+    if (ret < 0) {
+        av_freep(data);
+        return ret;
+    }
+
+    av_log(s, AV_LOG_VERBOSE, "Using index cache %s\n", path);
+
+    return payload_size;
+}
+
+int ff_index_cache_write(AVFormatContext *s, const char *path, uint32_t tag,
+                         const uint8_t *data, int size)
+{
+    AVIOContext *pb = NULL;
+    int64_t file_size, mtime;
+    int ret, ret2;
+
+    if ((ret = source_stat(s, &file_size, &mtime)) < 0)
+        return ret;
+
+    if ((ret = s->io_open(s, &pb, path, AVIO_FLAG_WRITE, NULL)) < 0) {
+        av_log(s, AV_LOG_WARNING, "Could not open index cache %s for writing\n", path);
+        return ret;
+    }
+
+    avio_wb32(pb, INDEX_CACHE_MAGIC);
+    avio_wb32(pb, INDEX_CACHE_VERSION);
+    avio_wb32(pb, tag);
+    avio_wb64(pb, file_size);
+    avio_wb64(pb, mtime);
+    avio_wb32(pb, size);
+    avio_wb32(pb, payload_crc(data, size));
+    avio_write(pb, data, size);
+    avio_flush(pb);
+
+    ret  = pb->error;
+    ret2 = ff_format_io_close(s, &pb);
+
+    return ret < 0 ? ret : ret2;
+}
+
+void ff_index_cache_put_index(AVIOContext *pb, AVStream *st)
+{
+    const int nb_entries = avformat_index_get_entries_count(st);
+
+    avio_wb32(pb, nb_entries);
+    for (int i = 0; i < nb_entries; i++) {
+        const AVIndexEntry *e = avformat_index_get_entry(st, i);
+
+        avio_wb64(pb, e->pos);
+        avio_wb64(pb, e->timestamp);
+        avio_wb32(pb, e->size);
+        avio_wb32(pb, e->min_distance);
+        avio_w8(pb, e->flags);
+    }
+}
+
+int ff_index_cache_get_index(GetByteContext *gb, AVStream *st)
+{
+    unsigned nb_entries = bytestream2_get_be32(gb);
+
+    if (bytestream2_get_bytes_left(gb) < nb_entries * (uint64_t)INDEX_ENTRY_SIZE)
+        return AVERROR_INVALIDDATA;
+
+    for (unsigned i = 0; i < nb_entries; i++) {
+        const int64_t pos       = bytestream2_get_be64u(gb);
+        const int64_t timestamp = bytestream2_get_be64u(gb);
+        const int size          = bytestream2_get_be32u(gb);
+        const int distance      = bytestream2_get_be32u(gb);
+        const int flags         = bytestream2_get_byteu(gb);
+
+        av_add_index_entry(st, pos, timestamp, size, distance, flags);
+    }
+
+    return 0;
+}
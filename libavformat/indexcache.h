@@ -0,0 +1,72 @@
+/*
+ * This file is part of Librempeg
+ *
+ * Librempeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Librempeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Librempeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef AVFORMAT_INDEXCACHE_H
+#define AVFORMAT_INDEXCACHE_H
+
+#include <stdint.h>
+
+#include "libavcodec/bytestream.h"
+
+#include "avformat.h"
+#include "avio.h"
+
+/**
+ * Sidecar index caches let demuxers store the index they built for a file
+ * and restore it on the next open, instead of scanning the file again.
+ * A cache records the demuxer that wrote it and the size and modification
+ * time of the file, and is ignored if any of them changed. Only local files
+ * are supported.
+ */
+
+/**
+ * Read the payload of an index cache.
+ *
+ * @param path path of the cache
+ * @param tag  tag identifying the demuxer and its payload version
+ * @param data set to the payload, which must be freed with av_free()
+ * @return the payload size, or a negative error code if there is no cache
+ *         usable for the file opened in s
+ */
+int ff_index_cache_read(AVFormatContext *s, const char *path, uint32_t tag,
+                        uint8_t **data);
+
+/**
+ * Write an index cache for the file opened in s, replacing any existing one.
+ *
+ * @param path path of the cache
+ * @param tag  tag identifying the demuxer and its payload version
+ * @param data the payload, e.g. built with ff_index_cache_put_index()
+ * @return 0 on success, a negative error code on failure
+ */
+int ff_index_cache_write(AVFormatContext *s, const char *path, uint32_t tag,
+                         const uint8_t *data, int size);
+
+/**
+ * Write the index entries of a stream.
+ */
+void ff_index_cache_put_index(AVIOContext *pb, AVStream *st);
+
+/**
+ * Add the index entries written by ff_index_cache_put_index() to a stream.
+ *
+ * @return 0 on success, AVERROR_INVALIDDATA if the payload is truncated
+ */
+int ff_index_cache_get_index(GetByteContext *gb, AVStream *st);
+
+#endif /* AVFORMAT_INDEXCACHE_H */
@@ -83,6 +83,7 @@ const FFInputFormat ff_ipu_demuxer = {
     .p.flags        = AVFMT_GENERIC_INDEX,
     .p.priv_class   = &ff_raw_demuxer_class,
     .read_probe     = ipu_read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "ipum" }),
     .read_header    = ipu_read_header,
     .read_packet    = ff_raw_read_partial_packet,
     .raw_codec_id   = AV_CODEC_ID_IPU,
@@ -392,6 +392,9 @@ typedef struct MOVContext {
     int interleaved_read;
     AVDictionary* decryption_keys;
     unsigned heif_icc_profile_items;
+    char *index_cache;          ///< path of the sidecar fragment index cache
+    int has_looked_for_index_cache;
+    int index_cache_loaded;
 } MOVContext;
 
 int ff_mp4_read_descr_len(AVIOContext *pb);
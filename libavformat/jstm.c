@@ -88,6 +88,7 @@ const FFInputFormat ff_jstm_demuxer = {
     .p.long_name    = NULL_IF_CONFIG_SMALL("JSTM PS2"),
     .p.extensions   = "jstm,stm",
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "JSTM" }),
     .read_header    = read_header,
     .read_packet    = read_packet,
     .read_seek      = ff_pcm_read_seek,
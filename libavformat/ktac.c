@@ -133,6 +133,7 @@ const FFInputFormat ff_ktac_demuxer = {
     .p.long_name    = NULL_IF_CONFIG_SMALL("KTAC (Koei Tecmo)"),
     .p.extensions   = "ktac",
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "KTAC" }),
     .read_header    = read_header,
     .read_packet    = read_packet,
 };
@@ -24,6 +24,7 @@
 #include "avformat.h"
 #include "demux.h"
 #include "internal.h"
+#include "pcm.h"
 
 typedef struct KTSSDemuxContext {
     int64_t data_end;
@@ -195,7 +196,11 @@ static int ktss_read_packet(AVFormatContext *s, AVPacket *pkt)
         ret = av_get_packet(pb, pkt, size);
         pkt->pos = pos;
     } else {
-        ret = av_get_packet(pb, pkt, s->streams[0]->codecpar->block_align);
+        /* many 14 sample frames per packet */
+        int size = ff_pcm_default_packet_size(s->streams[0]->codecpar);
+        if (size < 0)
+            return size;
+        ret = av_get_packet(pb, pkt, size);
     }
     pkt->flags &= ~AV_PKT_FLAG_CORRUPT;
     pkt->stream_index = 0;
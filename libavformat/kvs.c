@@ -174,6 +174,7 @@ const FFInputFormat ff_kvs_demuxer = {
     .p.extensions   = "kvs",
     .priv_data_size = sizeof(KVSDemuxContext),
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "KOVS" }),
     .read_header    = read_header,
     .read_packet    = read_packet,
     .read_seek      = read_seek,
@@ -128,6 +128,7 @@ const FFInputFormat ff_lopu_demuxer = {
     .p.extensions   = "lopus",
     .priv_data_size = sizeof(LOPUDemuxContext),
     .read_probe     = lopu_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "LOPU" }),
     .read_header    = lopu_read_header,
     .read_packet    = lopu_read_packet,
 };
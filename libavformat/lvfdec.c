@@ -154,6 +154,7 @@ const FFInputFormat ff_lvf_demuxer = {
     .p.extensions   = "lvf",
     .p.flags        = AVFMT_GENERIC_INDEX,
     .read_probe  = lvf_probe,
+    .signatures  = FF_PROBE_SIGNATURES({ 0, 4, "LVFF" }),
     .read_header = lvf_read_header,
     .read_packet = lvf_read_packet,
 };
@@ -63,6 +63,7 @@
 #include "avio_internal.h"
 #include "demux.h"
 #include "dovi_isom.h"
+#include "indexcache.h"
 #include "internal.h"
 #include "isom.h"
 #include "matroska.h"
@@ -439,6 +440,11 @@ typedef struct MatroskaDemuxContext {
 
     /* Bandwidth value for WebM DASH Manifest */
     int bandwidth;
+
+    /* Sidecar index cache path, and number of index entries when it was
+     * read, -1 if the header was not read successfully */
+    char *index_cache;
+    int index_cache_entries;
 } MatroskaDemuxContext;
 
 #define CHILD_OF(parent) { .def = { .n = parent } }
@@ -3417,6 +3423,65 @@ static int matroska_parse_dovi_streams(AVFormatContext *s)
     return 0;
 }
 
+#define INDEX_CACHE_TAG MKBETAG('M','K','V','1')
+
+static int count_index_entries(AVFormatContext *s)
+{
+    int nb_entries = 0;
+
+    for (unsigned i = 0; i < s->nb_streams; i++)
+        nb_entries += avformat_index_get_entries_count(s->streams[i]);
+
+    return nb_entries;
+}
+
+static void matroska_read_index_cache(MatroskaDemuxContext *matroska)
+{
+    AVFormatContext *s = matroska->ctx;
+    GetByteContext gb;
+    uint8_t *data;
+    int ret;
+
+    ret = ff_index_cache_read(s, matroska->index_cache, INDEX_CACHE_TAG, &data);
+    if (ret >= 0) {
+        bytestream2_init(&gb, data, ret);
+        if (bytestream2_get_be32(&gb) != s->nb_streams)
+            ret = AVERROR_INVALIDDATA;
+        for (unsigned i = 0; i < s->nb_streams && ret >= 0; i++)
+            ret = ff_index_cache_get_index(&gb, s->streams[i]);
+        if (ret < 0)
+            av_log(s, AV_LOG_WARNING, "Ignoring invalid index cache\n");
+        av_free(data);
+    }
+
+    matroska->index_cache_entries = count_index_entries(s);
+}
+
+/* Only rewrite the cache if reading the file added index entries. */
+static void matroska_write_index_cache(MatroskaDemuxContext *matroska)
+{
+    AVFormatContext *s = matroska->ctx;
+    AVIOContext *dyn;
+    uint8_t *data;
+    int size;
+
+    if (matroska->index_cache_entries < 0 ||
+        count_index_entries(s) <= matroska->index_cache_entries)
+        return;
+
+    if (avio_open_dyn_buf(&dyn) < 0)
+        return;
+
+    avio_wb32(dyn, s->nb_streams);
+    for (unsigned i = 0; i < s->nb_streams; i++)
+        ff_index_cache_put_index(dyn, s->streams[i]);
+
+    size = avio_close_dyn_buf(dyn, &data);
+    if (size > 0)
+        ff_index_cache_write(s, matroska->index_cache, INDEX_CACHE_TAG, data, size);
+    av_free(data);
+}
+
 static int matroska_read_header(AVFormatContext *s)
 {
     FFFormatContext *const si = ffformatcontext(s);
@@ -3432,6 +3497,7 @@ static int matroska_read_header(AVFormatContext *s)
 
     matroska->ctx = s;
     matroska->cues_parsing_deferred = 1;
+    matroska->index_cache_entries = -1;
 
     /* First read the EBML header. */
     if (ebml_parse(matroska, ebml_syntax, &ebml) || !ebml.doctype) {
@@ -3570,6 +3636,9 @@ static int matroska_read_header(AVFormatContext *s)
     if (res < 0)
         return res;
 
+    if (matroska->index_cache && s->pb->seekable & AVIO_SEEKABLE_NORMAL)
+        matroska_read_index_cache(matroska);
+
     return 0;
 }
 
@@ -4570,6 +4639,9 @@ static int matroska_read_close(AVFormatContext *s)
     MatroskaTrack *tracks = matroska->tracks.elem;
     int n;
 
+    if (matroska->index_cache)
+        matroska_write_index_cache(matroska);
+
     matroska_clear_queue(matroska);
 
     for (n = 0; n < matroska->tracks.nb_elem; n++)
@@ -5032,14 +5104,27 @@ const FFInputFormat ff_webm_dash_manifest_demuxer = {
 };
 #endif
 
+static const AVOption matroska_options[] = {
+    { "index_cache", "path of a sidecar file caching the seek index", offsetof(MatroskaDemuxContext, index_cache), AV_OPT_TYPE_STRING, {.str = NULL}, 0, 0, AV_OPT_FLAG_DECODING_PARAM },
+    { NULL },
+};
+
+static const AVClass matroska_class = {
+    .class_name = "matroska,webm demuxer",
+    .option     = matroska_options,
+    .version    = LIBAVUTIL_VERSION_INT,
+};
+
 const FFInputFormat ff_matroska_demuxer = {
     .p.name         = "matroska,webm",
     .p.long_name    = NULL_IF_CONFIG_SMALL("Matroska / WebM"),
     .p.extensions   = "mkv,mk3d,mka,mks,webm",
     .p.mime_type    = "audio/webm,audio/x-matroska,video/webm,video/x-matroska",
+    .p.priv_class   = &matroska_class,
     .priv_data_size = sizeof(MatroskaDemuxContext),
     .flags_internal = FF_INFMT_FLAG_INIT_CLEANUP,
     .read_probe     = matroska_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "\x1a\x45\xdf\xa3" }),
     .read_header    = matroska_read_header,
     .read_packet    = matroska_read_packet,
     .read_close     = matroska_read_close,
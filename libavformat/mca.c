@@ -137,6 +137,7 @@ const FFInputFormat ff_mca_demuxer = {
     .p.extensions   = "mca",
     .p.flags        = AVFMT_GENERIC_INDEX,
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "MADP" }),
     .read_header    = read_header,
     .read_packet    = ff_pcm_read_packet,
 };
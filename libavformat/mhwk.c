@@ -127,6 +127,7 @@ const FFInputFormat ff_mhwk_demuxer = {
     .p.flags        = AVFMT_GENERIC_INDEX,
     .p.extensions   = "mhk",
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "MHWK" }),
     .read_header    = read_header,
     .read_packet    = ff_pcm_read_packet,
 };
@@ -342,6 +342,7 @@ const FFInputFormat ff_mo_demuxer = {
     .p.flags        = AVFMT_GENERIC_INDEX,
     .priv_data_size = sizeof(MODemuxContext),
     .read_probe     = mo_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "MOC5" }),
     .read_header    = mo_read_header,
     .read_packet    = mo_read_packet,
     .read_seek      = mo_read_seek,
@@ -69,6 +69,7 @@
 #include "isom.h"
 #include "libavcodec/get_bits.h"
 #include "id3v1.h"
+#include "indexcache.h"
 #include "mov_chan.h"
 #include "replaygain.h"
 
@@ -1866,11 +1867,144 @@ static void fix_frag_index_entries(MOVFragmentIndex *frag_index, int index,
     }
 }
 
+#define INDEX_CACHE_TAG MKBETAG('M','O','V','1')
+
+/* The cache holds the fragment index built by scanning all moof atoms, with
+ * the start time of each track in each fragment stored like a tfra entry,
+ * and the track durations. Loading it marks the fragment index complete, so
+ * the header is read without scanning the file, like with a sidx or mfra. */
+static int mov_read_index_cache(MOVContext *c)
+{
+    AVFormatContext *s = c->fc;
+    int nb_streams, nb_items, ret;
+    GetByteContext gb;
+    uint8_t *data;
+
+    ret = ff_index_cache_read(s, c->index_cache, INDEX_CACHE_TAG, &data);
+    if (ret < 0)
+        return ret;
+    bytestream2_init(&gb, data, ret);
+
+    nb_streams = bytestream2_get_be32(&gb);
+    if (nb_streams != s->nb_streams ||
+        bytestream2_get_bytes_left(&gb) < nb_streams * 12LL + 4) {
+        ret = AVERROR_INVALIDDATA;
+        goto end;
+    }
+    for (int i = 0; i < nb_streams; i++) {
+        MOVStreamContext *sc = s->streams[i]->priv_data;
+        int64_t duration;
+
+        if (bytestream2_get_be32u(&gb) != sc->id) {
+            ret = AVERROR_INVALIDDATA;
+            goto end;
+        }
+        duration = bytestream2_get_be64u(&gb);
+        s->streams[i]->duration = FFMAX(s->streams[i]->duration, duration);
+    }
+
+    nb_items = bytestream2_get_be32u(&gb);
+    for (int i = 0; i < nb_items; i++) {
+        int64_t moof_offset = bytestream2_get_be64(&gb);
+        int nb_stream_info = bytestream2_get_be32(&gb);
+        int index;
+
+        if (bytestream2_get_bytes_left(&gb) < nb_stream_info * 12LL) {
+            ret = AVERROR_INVALIDDATA;
+            goto end;
+        }
+
+        index = update_frag_index(c, moof_offset);
+        if (index < 0) {
+            ret = AVERROR(ENOMEM);
+            goto end;
+        }
+
+        for (int j = 0; j < nb_stream_info; j++) {
+            MOVFragmentStreamInfo *frag_stream_info;
+            int id = bytestream2_get_be32u(&gb);
+            int64_t time = bytestream2_get_be64u(&gb);
+
+            frag_stream_info = get_frag_stream_info(&c->frag_index, index, id);
+            if (frag_stream_info && frag_stream_info->first_tfra_pts == AV_NOPTS_VALUE)
+                frag_stream_info->first_tfra_pts = time;
+        }
+    }
+
+    c->frag_index.complete = 1;
+    c->index_cache_loaded = 1;
+
+end:
+    if (ret < 0)
+        av_log(s, AV_LOG_WARNING, "Ignoring invalid index cache\n");
+    av_free(data);
+    return ret;
+}
+
+static void mov_write_index_cache(MOVContext *c)
+{
+    AVFormatContext *s = c->fc;
+    AVIOContext *dyn;
+    uint8_t *data;
+    int size;
+
+    if (avio_open_dyn_buf(&dyn) < 0)
+        return;
+
+    avio_wb32(dyn, s->nb_streams);
+    for (int i = 0; i < s->nb_streams; i++) {
+        MOVStreamContext *sc = s->streams[i]->priv_data;
+
+        avio_wb32(dyn, sc->id);
+        avio_wb64(dyn, s->streams[i]->duration);
+    }
+
+    avio_wb32(dyn, c->frag_index.nb_items);
+    for (int i = 0; i < c->frag_index.nb_items; i++) {
+        MOVFragmentIndexItem *item = &c->frag_index.item[i];
+
+        avio_wb64(dyn, item->moof_offset);
+        avio_wb32(dyn, item->nb_stream_info);
+        for (int j = 0; j < item->nb_stream_info; j++) {
+            MOVFragmentStreamInfo *frag_stream_info = &item->stream_info[j];
+            int64_t time = get_stream_info_time(frag_stream_info);
+
+            /* Without tfdt, use the timestamp of the first sample of the
+             * fragment, which was added to the index when it was read. */
+            if (time == AV_NOPTS_VALUE && frag_stream_info->index_entry >= 0) {
+                for (int k = 0; k < s->nb_streams; k++) {
+                    MOVStreamContext *sc = s->streams[k]->priv_data;
+                    FFStream *const sti = ffstream(s->streams[k]);
+
+                    if (sc->id == frag_stream_info->id &&
+                        frag_stream_info->index_entry < sti->nb_index_entries)
+                        time = sti->index_entries[frag_stream_info->index_entry].timestamp;
+                }
+            }
+
+            avio_wb32(dyn, frag_stream_info->id);
+            avio_wb64(dyn, time);
+        }
+    }
+
+    size = avio_close_dyn_buf(dyn, &data);
+    if (size > 0)
+        ff_index_cache_write(s, c->index_cache, INDEX_CACHE_TAG, data, size);
+    av_free(data);
+}
+
 static int mov_read_moof(MOVContext *c, AVIOContext *pb, MOVAtom atom)
 {
     // Set by mov_read_tfhd(). mov_read_trun() will reject files missing tfhd.
     c->fragment.found_tfhd = 0;
 
+    if (c->index_cache && !c->has_looked_for_index_cache) {
+        c->has_looked_for_index_cache = 1;
+        if ((pb->seekable & AVIO_SEEKABLE_NORMAL) && !c->frag_index.complete &&
+            !(c->fc->flags & AVFMT_FLAG_IGNIDX))
+            mov_read_index_cache(c);
+    }
+
     if (!c->has_looked_for_mfra && c->use_mfra_for > 0) {
         c->has_looked_for_mfra = 1;
         if (pb->seekable & AVIO_SEEKABLE_NORMAL) {
@@ -11454,6 +11588,13 @@ static int mov_read_header(AVFormatContext *s)
         if (mov->frag_index.item[i].moof_offset <= mov->fragment.moof_offset)
             mov->frag_index.item[i].headers_read = 1;
 
+    /* Without sidx or mfra, the fragment index was built by reading every
+     * moof atom of the file, which is what the cache saves. */
+    if (mov->index_cache && !mov->index_cache_loaded && !mov->frag_index.complete &&
+        mov->frag_index.nb_items > 1 && (pb->seekable & AVIO_SEEKABLE_NORMAL) &&
+        !(s->flags & AVFMT_FLAG_IGNIDX))
+        mov_write_index_cache(mov);
+
     return 0;
 }
 
@@ -12126,6 +12267,8 @@ static const AVOption mov_options[] = {
         FLAGS, .unit = "use_mfra_for" },
     {"use_tfdt", "use tfdt for fragment timestamps", OFFSET(use_tfdt), AV_OPT_TYPE_BOOL, {.i64 = 1},
         0, 1, FLAGS},
+    {"index_cache", "path of a sidecar file caching the fragment index", OFFSET(index_cache),
+        AV_OPT_TYPE_STRING, {.str = NULL}, 0, 0, FLAGS},
     { "export_all", "Export unrecognized metadata entries", OFFSET(export_all),
         AV_OPT_TYPE_BOOL, { .i64 = 0 }, 0, 1, .flags = FLAGS },
     { "export_xmp", "Export full XMP metadata", OFFSET(export_xmp),
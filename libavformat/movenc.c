@@ -8186,7 +8186,12 @@ static int mov_init(AVFormatContext *s)
     }
 
     if (mov->flags & FF_MOV_FLAG_FASTSTART) {
-        mov->reserved_moov_size = -1;
+        /* With moov_size, the moov is written in the reserved space, and
+         * the second pass is only run if it does not fit. */
+        if (mov->reserved_moov_size > 0 && !(mov->flags & FF_MOV_FLAG_FRAGMENT))
+            mov->reserved_moov_size = FFMAX(mov->reserved_moov_size, 8);
+        else
+            mov->reserved_moov_size = -1;
     }
 
     if (mov->use_editlist < 0) {
@@ -8829,7 +8834,7 @@ static int mov_write_header(AVFormatContext *s)
             update_size(pb, mov->mdat_pos);
         }
     } else if (mov->mode != MODE_AVIF) {
-        if (mov->flags & FF_MOV_FLAG_FASTSTART)
+        if (mov->flags & FF_MOV_FLAG_FASTSTART && mov->reserved_moov_size < 0)
             mov->reserved_header_pos = avio_tell(pb);
         mov_write_mdat_tag(pb, mov);
     }
@@ -9005,7 +9010,7 @@ static int mov_write_trailer(AVFormatContext *s)
     MOVMuxContext *mov = s->priv_data;
     AVIOContext *pb = s->pb;
     int res = 0;
-    int i;
+    int i, reserved_free = 0;
     int64_t moov_pos;
 
     /*
@@ -9062,9 +9067,19 @@ static int mov_write_trailer(AVFormatContext *s)
         if (!(mov->flags & FF_MOV_FLAG_HYBRID_FRAGMENTED))
             mov_write_mdat_size(s);
 
+        if (mov->flags & FF_MOV_FLAG_FASTSTART && mov->reserved_moov_size > 0) {
+            if ((res = get_moov_size(s)) < 0)
+                return res;
+            if (res > mov->reserved_moov_size - 8) {
+                av_log(s, AV_LOG_INFO, "The moov atom needs %d bytes, more than moov_size\n", res);
+                reserved_free = mov->reserved_moov_size;
+                mov->reserved_moov_size = -1;
+            }
+        }
+
         avio_seek(pb, mov->reserved_moov_size > 0 ? mov->reserved_header_pos : moov_pos, SEEK_SET);
 
-        if (mov->flags & FF_MOV_FLAG_FASTSTART) {
+        if (mov->flags & FF_MOV_FLAG_FASTSTART && mov->reserved_moov_size < 0) {
             av_log(s, AV_LOG_INFO, "Starting second pass: moving the moov atom to the beginning of the file\n");
             res = shift_data(s);
             if (res < 0)
@@ -9072,6 +9087,12 @@ static int mov_write_trailer(AVFormatContext *s)
             avio_seek(pb, mov->reserved_header_pos, SEEK_SET);
             if ((res = mov_write_moov_tag(pb, mov, s)) < 0)
                 return res;
+            /* the space reserved for the moov follows it */
+            if (reserved_free) {
+                avio_wb32(pb, reserved_free);
+                ffio_wfourcc(pb, "free");
+                ffio_fill(pb, 0, reserved_free - 8);
+            }
         } else if (mov->reserved_moov_size > 0) {
             int64_t size;
             if ((res = mov_write_moov_tag(pb, mov, s)) < 0)
@@ -103,6 +103,7 @@ const FFInputFormat ff_mpds_demuxer = {
     .p.extensions   = "dsp",
     .p.flags        = AVFMT_GENERIC_INDEX,
     .read_probe     = mpds_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "MPDS" }),
     .read_header    = mpds_read_header,
     .read_packet    = mpds_read_packet,
 };
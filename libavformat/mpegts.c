@@ -615,16 +615,19 @@ static int analyze(const uint8_t *buf, int size, int packet_size,
     memset(stat, 0, packet_size * sizeof(*stat));
 
     for (i = 0; i < size - 3; i++) {
-        if (buf[i] == SYNC_BYTE) {
-            int pid = AV_RB16(buf+1) & 0x1FFF;
-            int asc = buf[i + 3] & 0x30;
-            if (!probe || pid == 0x1FFF || asc) {
-                int x = i % packet_size;
-                stat[x]++;
-                stat_all++;
-                if (stat[x] > best_score) {
-                    best_score = stat[x];
-                }
+        const uint8_t *p = memchr(buf + i, SYNC_BYTE, size - 3 - i);
+        int pid, asc;
+        if (!p)
+            break;
+        i   = p - buf;
+        pid = AV_RB16(buf+1) & 0x1FFF;
+        asc = buf[i + 3] & 0x30;
+        if (!probe || pid == 0x1FFF || asc) {
+            int x = i % packet_size;
+            stat[x]++;
+            stat_all++;
+            if (stat[x] > best_score) {
+                best_score = stat[x];
             }
         }
     }
@@ -3321,6 +3324,14 @@ static int mpegts_resync(AVFormatContext *s, int seekback, const uint8_t *curren
     avio_seek(pb, -back, SEEK_CUR);
 
     for (i = 0; i < ts->resync_size; i++) {
+        /* skip ahead to the next sync byte in the buffered data */
+        int len = FFMIN(pb->buf_end - pb->buf_ptr, ts->resync_size - i);
+        if (len > 1) {
+            const uint8_t *p = memchr(pb->buf_ptr, SYNC_BYTE, len);
+            int skip = p ? p - pb->buf_ptr : len - 1;
+            avio_skip(pb, skip);
+            i += skip;
+        }
         c = avio_r8(pb);
         if (avio_feof(pb))
             return AVERROR_EOF;
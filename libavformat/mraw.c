@@ -75,6 +75,7 @@ const FFInputFormat ff_mraw_demuxer = {
     .p.long_name    = NULL_IF_CONFIG_SMALL("3DO MRAW"),
     .p.flags        = AVFMT_GENERIC_INDEX,
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "MRAW" }),
     .read_header    = read_header,
     .read_packet    = ff_pcm_read_packet,
 };
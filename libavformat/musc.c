@@ -82,6 +82,7 @@ const FFInputFormat ff_musc_demuxer = {
     .p.extensions   = "musc,mus",
     .p.flags        = AVFMT_GENERIC_INDEX,
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "MUSC" }),
     .read_header    = read_header,
     .read_packet    = ff_pcm_read_packet,
 };
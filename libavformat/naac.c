@@ -85,6 +85,7 @@ const FFInputFormat ff_naac_demuxer = {
     .p.extensions   = "naac",
     .p.flags        = AVFMT_GENERIC_INDEX,
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "AAC " }),
     .read_header    = read_header,
     .read_packet    = ff_pcm_read_packet,
 };
@@ -92,6 +92,7 @@ const FFInputFormat ff_npsf_demuxer = {
     .p.extensions   = "npsf,nps",
     .p.flags        = AVFMT_GENERIC_INDEX,
     .read_probe     = npsf_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "NPSF" }),
     .read_header    = npsf_read_header,
     .read_packet    = ff_pcm_read_packet,
 };
@@ -27,6 +27,7 @@
 #include "internal.h"
 
 typedef struct NUS3BankDemuxContext {
+    FFSubsongContext sub;
     int current_stream;
 } NUS3BankDemuxContext;
 
@@ -93,6 +94,7 @@ static int64_t seek_data(void *opaque, int64_t offset, int whence)
 
 static int read_header(AVFormatContext *s)
 {
+    NUS3BankDemuxContext *g = s->priv_data;
     int64_t first_start_offset, offset, tone_offset = 0, pack_offset = 0;
     int ret, chunk_count, entries;
     AVIOContext *pb = s->pb;
@@ -218,6 +220,10 @@ static int read_header(AVFormatContext *s)
         st->index = n;
     }
 
+    if (g->sub.subsong >= 0 &&
+        (ret = ff_select_subsong(s, g->sub.subsong, NULL)) < 0)
+        return ret;
+
     for (int i = 0; i < s->nb_streams; i++) {
         AVStream *st = s->streams[i];
         NUS3Stream *nst = st->priv_data;
@@ -347,11 +353,13 @@ static int read_close(AVFormatContext *s)
 const FFInputFormat ff_nus3bank_demuxer = {
     .p.name         = "nus3bank",
     .p.long_name    = NULL_IF_CONFIG_SMALL("Namco NUS3 Bank"),
+    .p.priv_class   = &ff_subsong_demuxer_class,
     .flags_internal = FF_INFMT_FLAG_INIT_CLEANUP,
     .p.flags        = AVFMT_GENERIC_INDEX,
     .p.extensions   = "nus3bank,nub2",
     .priv_data_size = sizeof(NUS3BankDemuxContext),
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "NUS3" }),
     .read_header    = read_header,
     .read_packet    = read_packet,
     .read_seek      = read_seek,
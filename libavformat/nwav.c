@@ -135,6 +135,7 @@ const FFInputFormat ff_nwav_demuxer = {
     .p.extensions   = "nwav",
     .priv_data_size = sizeof(NWAVDemuxContext),
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "NWAV" }),
     .read_header    = read_header,
     .read_packet    = read_packet,
     .read_close     = read_close,
@@ -144,6 +144,7 @@ const FFInputFormat ff_nxa1_demuxer = {
     .p.extensions   = "nxa",
     .priv_data_size = sizeof(NXA1DemuxContext),
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "NXA1" }),
     .read_header    = read_header,
     .read_packet    = read_packet,
 };
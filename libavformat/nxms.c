@@ -159,6 +159,7 @@ const FFInputFormat ff_nxms_demuxer = {
     .p.extensions   = "nxms",
     .priv_data_size = sizeof(NXMSDemuxContext),
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "NXMS" }),
     .read_header    = read_header,
     .read_packet    = read_packet,
 };
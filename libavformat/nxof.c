@@ -138,6 +138,7 @@ const FFInputFormat ff_nxof_demuxer = {
     .p.extensions   = "nxopus",
     .priv_data_size = sizeof(NXOFDemuxContext),
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "foxn" }),
     .read_header    = read_header,
     .read_packet    = read_packet,
 };
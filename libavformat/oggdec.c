@@ -1007,6 +1007,7 @@ const FFInputFormat ff_ogg_demuxer = {
     .priv_data_size = sizeof(struct ogg),
     .flags_internal = FF_INFMT_FLAG_INIT_CLEANUP,
     .read_probe     = ogg_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 5, "OggS" }),
     .read_header    = ogg_read_header,
     .read_packet    = ogg_read_packet,
     .read_close     = ogg_read_close,
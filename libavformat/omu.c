@@ -91,6 +91,7 @@ const FFInputFormat ff_omu_demuxer = {
     .p.flags        = AVFMT_GENERIC_INDEX,
     .p.extensions   = "omu",
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "OMU " }),
     .read_header    = read_header,
     .read_packet    = read_packet,
 };
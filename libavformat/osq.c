@@ -111,6 +111,7 @@ const FFInputFormat ff_osq_demuxer = {
     .p.flags        = AVFMT_NOBINSEARCH | AVFMT_NOGENSEARCH | AVFMT_NO_BYTE_SEEK | AVFMT_NOTIMESTAMPS,
     .p.priv_class   = &ff_raw_demuxer_class,
     .read_probe     = osq_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "OSQ " }),
     .read_header    = osq_read_header,
     .read_packet    = ff_raw_read_partial_packet,
     .raw_codec_id   = AV_CODEC_ID_OSQ,
@@ -91,6 +91,8 @@ typedef struct PSBHeader {
 } PSBHeader;
 
 typedef struct PSBContext {
+    FFSubsongContext sub;
+
     uint32_t header_id;
     uint16_t version;
     uint16_t encrypt_value;
@@ -1277,6 +1279,17 @@ static int read_header(AVFormatContext *s)
         st->index = n;
     }
 
+    if (p->sub.subsong >= 0) {
+        PSBStream *pst;
+
+        if ((ret = ff_select_subsong(s, p->sub.subsong, NULL)) < 0)
+            return ret;
+
+        pst = s->streams[0]->priv_data;
+        if (!p->wav_ctx)
+            avio_seek(pb, pst->start_offset, SEEK_SET);
+    }
+
     p->target_stream = 0;
 
     return 0;
@@ -1362,11 +1375,13 @@ static int read_close(AVFormatContext *s)
 const FFInputFormat ff_psb_demuxer = {
     .p.name         = "psb",
     .p.long_name    = NULL_IF_CONFIG_SMALL("PSB M2"),
+    .p.priv_class   = &ff_subsong_demuxer_class,
     .priv_data_size = sizeof(PSBContext),
     .flags_internal = FF_INFMT_FLAG_INIT_CLEANUP,
     .p.flags        = AVFMT_GENERIC_INDEX,
     .p.extensions   = "psb",
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "PSB\0" }),
     .read_header    = read_header,
     .read_packet    = read_packet,
     .read_seek      = read_seek,
@@ -97,6 +97,7 @@ const FFInputFormat ff_psnd_demuxer = {
     .p.extensions   = "psn",
     .p.flags        = AVFMT_GENERIC_INDEX,
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "PSND" }),
     .read_header    = read_header,
     .read_packet    = ff_pcm_read_packet,
 };
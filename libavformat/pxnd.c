@@ -78,6 +78,7 @@ const FFInputFormat ff_pxnd_demuxer = {
     .p.long_name    = NULL_IF_CONFIG_SMALL("Pixelbite PXND"),
     .p.flags        = AVFMT_GENERIC_INDEX,
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "PXND" }),
     .read_header    = read_header,
     .read_packet    = ff_pcm_read_packet,
 };
@@ -25,6 +25,7 @@
 #include "avio.h"
 #include "demux.h"
 #include "internal.h"
+#include "pcm.h"
 
 #define HEADER_SIZE 0x3000
 #define rol(value, bits) (((value) << (bits)) | ((value) >> (32 - (bits))))
@@ -152,20 +153,29 @@ static int redspark_read_packet(AVFormatContext *s, AVPacket *pkt)
 {
     AVCodecParameters *par = s->streams[0]->codecpar;
     RedSparkContext *redspark = s->priv_data;
-    int ret;
+    int64_t left = redspark->data_stop - avio_tell(s->pb);
+    int ret, size;
 
-    if (avio_tell(s->pb) >= redspark->data_stop)
+    if (left <= 0)
         return AVERROR_EOF;
 
     if (avio_feof(s->pb))
         return AVERROR_EOF;
 
-    ret = av_get_packet(s->pb, pkt, par->block_align);
-    if (ret != par->block_align)
+    /* the frames are only 14 samples long, read many of them at once */
+    size = ff_pcm_default_packet_size(par);
+    if (size < 0)
+        return size;
+    size = FFMAX(FFMIN(size, left - left % par->block_align), par->block_align);
+
+    ret = av_get_packet(s->pb, pkt, size);
+    if (ret < par->block_align)
         return AVERROR_INVALIDDATA;
+    if (ret % par->block_align)
+        av_shrink_packet(pkt, ret - ret % par->block_align);
     pkt->stream_index = 0;
 
-    return ret;
+    return 0;
 }
 
 const FFInputFormat ff_redspark_demuxer = {
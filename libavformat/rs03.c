@@ -98,6 +98,7 @@ const FFInputFormat ff_rs03_demuxer = {
     .p.flags        = AVFMT_GENERIC_INDEX,
     .p.extensions   = "dsp",
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "RS\0\3" }),
     .read_header    = read_header,
     .read_packet    = read_packet,
 };
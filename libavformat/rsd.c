@@ -25,6 +25,7 @@
 #include "avio_internal.h"
 #include "demux.h"
 #include "internal.h"
+#include "pcm.h"
 
 static const AVCodecTag rsd_tags[] = {
     { AV_CODEC_ID_ADPCM_PSX,       MKTAG('V','A','G',' ') },
@@ -193,9 +194,14 @@ static int rsd_read_packet(AVFormatContext *s, AVPacket *pkt)
     pos = avio_tell(pb);
     if (par->codec_id == AV_CODEC_ID_ADPCM_IMA_RAD ||
         par->codec_id == AV_CODEC_ID_ADPCM_PSX     ||
-        par->codec_id == AV_CODEC_ID_ADPCM_NDSP_SI ||
-        par->codec_id == AV_CODEC_ID_ADPCM_IMA_WAV ||
-        par->codec_id == AV_CODEC_ID_XMA2) {
+        par->codec_id == AV_CODEC_ID_ADPCM_IMA_WAV) {
+        /* the blocks are tiny, read many of them at once */
+        size = ff_pcm_default_packet_size(par);
+        if (size < 0)
+            return size;
+        ret = av_get_packet(pb, pkt, size);
+    } else if (par->codec_id == AV_CODEC_ID_ADPCM_NDSP_SI ||
+               par->codec_id == AV_CODEC_ID_XMA2) {
         ret = av_get_packet(pb, pkt, par->block_align);
     } else {
         ret = av_get_packet(pb, pkt, size);
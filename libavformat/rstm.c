@@ -79,6 +79,7 @@ const FFInputFormat ff_rstm_demuxer = {
     .p.extensions   = "rstm,rsm",
     .p.flags        = AVFMT_GENERIC_INDEX,
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "RSTM" }),
     .read_header    = read_header,
     .read_packet    = ff_pcm_read_packet,
 };
@@ -47,6 +47,7 @@ typedef struct SABStream {
 } SABStream;
 
 typedef struct SABDemuxContext {
+    FFSubsongContext sub;
     int big_endian;
     int type;
     int filename_offset;
@@ -149,6 +150,13 @@ static int sort_streams(const void *a, const void *b)
     return FFDIFFSIGN(xs1->start_offset, xs2->start_offset);
 }
 
+static void free_stream(AVStream *st)
+{
+    SABStream *sst = st->priv_data;
+
+    avformat_close_input(&sst->xctx);
+}
+
 static int read_header(AVFormatContext *s)
 {
     SABDemuxContext *ctx = s->priv_data;
@@ -156,7 +164,7 @@ static int read_header(AVFormatContext *s)
     avio_r32 avio_r32;
     avio_r16 avio_r16;
     uint32_t tag;
-    int entries;
+    int entries, ret;
 
     tag = avio_rb32(pb);
     switch (tag) {
@@ -391,6 +399,10 @@ static int read_header(AVFormatContext *s)
         return AVERROR_INVALIDDATA;
 
     qsort(s->streams, s->nb_streams, sizeof(AVStream *), sort_streams);
+    if (ctx->sub.subsong >= 0 &&
+        (ret = ff_select_subsong(s, ctx->sub.subsong, free_stream)) < 0)
+        return ret;
+
     for (int n = 0; n < s->nb_streams; n++) {
         AVStream *st = s->streams[n];
 
@@ -415,26 +427,30 @@ static int read_packet(AVFormatContext *s, AVPacket *pkt)
     AVStream *st;
 
 redo:
-    if (avio_feof(pb))
-        return AVERROR_EOF;
-
     if (ctx->current_stream >= s->nb_streams)
         return AVERROR_EOF;
 
     st = s->streams[ctx->current_stream];
     sst = st->priv_data;
     if (do_seek)
-        avio_seek(pb, sst->start_offset, SEEK_SET);
+        avio_seek(pb, sst->data_offset, SEEK_SET);
 
-    if (avio_tell(pb) >= sst->stop_offset) {
-        do_seek = 1;
-        ctx->current_stream++;
-        goto redo;
+    /* nested demuxers read ahead of the bank position, let them report EOF */
+    if (!sst->xctx) {
+        if (avio_feof(pb))
+            return AVERROR_EOF;
+
+        if (avio_tell(pb) >= sst->stop_offset) {
+            do_seek = 1;
+            ctx->current_stream++;
+            goto redo;
+        }
     }
 
     if (sst->xctx) {
         ret = av_read_frame(sst->xctx, pkt);
         if (ret == AVERROR_EOF) {
+            do_seek = 1;
             ctx->current_stream++;
             goto redo;
         }
@@ -447,6 +463,7 @@ redo:
     }
     pkt->stream_index = st->index;
     if (ret == AVERROR_EOF) {
+        do_seek = 1;
         ctx->current_stream++;
         goto redo;
     }
@@ -481,12 +498,8 @@ static int read_seek(AVFormatContext *s, int stream_index,
 
 static int read_close(AVFormatContext *s)
 {
-    for (int i = 0; i < s->nb_streams; i++) {
-        AVStream *st = s->streams[i];
-        SABStream *sst = st->priv_data;
-
-        avformat_close_input(&sst->xctx);
-    }
+    for (int i = 0; i < s->nb_streams; i++)
+        free_stream(s->streams[i]);
 
     return 0;
 }
@@ -494,11 +507,13 @@ static int read_close(AVFormatContext *s)
 const FFInputFormat ff_sab_demuxer = {
     .p.name         = "sab",
     .p.long_name    = NULL_IF_CONFIG_SMALL("Square Enix SAB"),
+    .p.priv_class   = &ff_subsong_demuxer_class,
     .p.extensions   = "sab,mab,sbin",
     .p.flags        = AVFMT_GENERIC_INDEX,
     .priv_data_size = sizeof(SABDemuxContext),
     .flags_internal = FF_INFMT_FLAG_INIT_CLEANUP,
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "sabf" }, { 0, 4, "mabf" }),
     .read_header    = read_header,
     .read_packet    = read_packet,
     .read_seek      = read_seek,
@@ -76,6 +76,7 @@ const FFInputFormat ff_saud_demuxer = {
     .p.long_name    = NULL_IF_CONFIG_SMALL("LucasArts SAUD"),
     .p.extensions   = "sad",
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "SAUD" }),
     .read_header    = read_header,
     .read_packet    = ff_pcm_read_packet,
     .read_seek      = ff_pcm_read_seek,
@@ -118,6 +118,7 @@ const FFInputFormat ff_sdr2_demuxer = {
     .p.extensions= "sdr2",
     .p.flags     = AVFMT_GENERIC_INDEX,
     .read_probe  = sdr2_probe,
+    .signatures  = FF_PROBE_SIGNATURES({ 0, 4, "SRA\1" }),
     .read_header = sdr2_read_header,
     .read_packet = sdr2_read_packet,
 };
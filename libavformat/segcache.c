@@ -0,0 +1,483 @@
+/*
+ * Segment prefetching and caching for HLS and DASH
+ *
+ * This file is part of Librempeg
+ *
+ * Librempeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Librempeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Librempeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "config.h"
+
+#if HAVE_IO_H
+#include <io.h>
+#endif
+#if HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+
+#include "libavutil/avstring.h"
+#include "libavutil/executor.h"
+#include "libavutil/file_open.h"
+#include "libavutil/mem.h"
+#include "libavutil/random_seed.h"
+#include "libavutil/sha.h"
+#include "avio_internal.h"
+#include "internal.h"
+#include "segcache.h"
+#include "url.h"
+
+#define KEY_SIZE 64
+#define COPY_BUFFER_SIZE 65536
+
+typedef struct SegmentEntry {
+    SegmentCache *sc;
+    char key[KEY_SIZE + 1];
+    char *url;
+    int64_t offset;
+    int64_t size;
+    AVDictionary *opts;
+
+    AVExecutorJob *job;
+    char *path;                     ///< local copy, set once downloaded
+    int temporary;                  ///< path is removed once opened
+} SegmentEntry;
+
+struct SegmentCache {
+    AVFormatContext *s;
+    char *dir;
+    int64_t max_size;
+
+    AVExecutor *executor;
+    int priority;
+    atomic_int abort;
+    AVIOInterruptCB interrupt_callback;
+
+    SegmentEntry **entries;
+    int nb_entries;
+};
+
+static int segcache_interrupt(void *opaque)
+{
+    SegmentCache *sc = opaque;
+    return atomic_load(&sc->abort) ||
+           ff_check_interrupt(&sc->s->interrupt_callback);
+}
+
+static int segment_key(char *key, const char *url, int64_t offset, int64_t size)
+{
+    struct AVSHA *sha = av_sha_alloc();
+    uint8_t hash[KEY_SIZE / 2];
+    char range[48];
+
+    if (!sha)
+        return AVERROR(ENOMEM);
+
+    snprintf(range, sizeof(range), "\n%"PRId64"\n%"PRId64, offset, size);
+    av_sha_init(sha, 256);
+    av_sha_update(sha, url, strlen(url));
+    av_sha_update(sha, range, strlen(range));
+    av_sha_final(sha, hash);
+    av_free(sha);
+
+    ff_data_to_hex(key, hash, sizeof(hash), 1);
+    return 0;
+}
+
+static char *cache_path(const SegmentCache *sc, const char *name)
+{
+    return av_asprintf("%s/%s", sc->dir, name);
+}
+
+static void free_entry(SegmentEntry **pe)
+{
+    SegmentEntry *e = *pe;
+
+    if (!e)
+        return;
+
+    if (e->job) {
+        av_executor_job_wait(e->job);
+        av_executor_job_free(&e->job);
+    }
+    if (e->path && e->temporary)
+        ffurl_delete(e->path);
+    av_freep(&e->path);
+    av_freep(&e->url);
+    av_dict_free(&e->opts);
+    av_freep(pe);
+}
+
+static void remove_entry(SegmentCache *sc, int i)
+{
+    free_entry(&sc->entries[i]);
+    sc->entries[i] = sc->entries[--sc->nb_entries];
+}
+
+static int find_entry(const SegmentCache *sc, const char *key)
+{
+    for (int i = 0; i < sc->nb_entries; i++)
+        if (!strcmp(sc->entries[i]->key, key))
+            return i;
+    return -1;
+}
+
+static int is_cache_name(const char *name)
+{
+    return strlen(name) == KEY_SIZE && strspn(name, "0123456789abcdef") == KEY_SIZE;
+}
+
+static int cmp_age(const void *a, const void *b)
+{
+    const AVIODirEntry *ea = *(const AVIODirEntry * const *)a;
+    const AVIODirEntry *eb = *(const AVIODirEntry * const *)b;
+    return FFDIFFSIGN(ea->modification_timestamp, eb->modification_timestamp);
+}
+
+/* remove the oldest segments until the directory fits max_size again,
+ * keep is the name of a segment which must not be removed */
+static void evict(SegmentCache *sc, const char *keep)
+{
+    AVIODirContext *dir = NULL;
+    AVIODirEntry *entry, **entries = NULL;
+    unsigned nb_entries = 0;
+    int64_t total = 0;
+
+    if (!sc->max_size || avio_open_dir(&dir, sc->dir, NULL) < 0)
+        return;
+
+    while (avio_read_dir(dir, &entry) >= 0 && entry) {
+        if (entry->type != AVIO_ENTRY_FILE || !is_cache_name(entry->name) ||
+            av_dynarray_add_nofree(&entries, &nb_entries, entry) < 0) {
+            avio_free_directory_entry(&entry);
+            continue;
+        }
+        total += FFMAX(entry->size, 0);
+    }
+    avio_close_dir(&dir);
+
+    if (total > sc->max_size) {
+        qsort(entries, nb_entries, sizeof(*entries), cmp_age);
+        for (unsigned i = 0; i < nb_entries && total > sc->max_size; i++) {
+            char *path;
+
+            if (!strcmp(entries[i]->name, keep))
+                continue;
+            path = cache_path(sc, entries[i]->name);
+            if (path && ffurl_delete(path) >= 0)
+                total -= FFMAX(entries[i]->size, 0);
+            av_free(path);
+        }
+    }
+
+    for (unsigned i = 0; i < nb_entries; i++)
+        avio_free_directory_entry(&entries[i]);
+    av_free(entries);
+}
+
+/* create the file the segment is downloaded to, and the name it is
+ * renamed to once complete */
+static int create_file(SegmentCache *sc, SegmentEntry *e, AVIOContext **out,
+                       char **tmp_path)
+{
+    int ret;
+
+    if (sc->dir) {
+        *tmp_path = av_asprintf("%s/%s.%08"PRIx32".part", sc->dir, e->key,
+                                av_get_random_seed());
+        e->path   = cache_path(sc, e->key);
+        if (!*tmp_path || !e->path)
+            return AVERROR(ENOMEM);
+    } else {
+        int fd = avpriv_tempfile("ffsegment", tmp_path, 0, sc->s);
+        if (fd < 0)
+            return fd;
+        close(fd);
+        e->temporary = 1;
+    }
+
+    ret = avio_open(out, *tmp_path, AVIO_FLAG_WRITE);
+    if (ret < 0)
+        av_log(sc->s, AV_LOG_ERROR, "Could not create '%s'\n", *tmp_path);
+    return ret;
+}
+
+static int download(void *opaque)
+{
+    SegmentEntry *e = opaque;
+    SegmentCache *sc = e->sc;
+    AVIOContext *in = NULL, *out = NULL;
+    AVDictionary *opts = NULL;
+    const char *proto = avio_find_protocol_name(e->url);
+    int is_http = proto && av_strstart(proto, "http", NULL);
+    int64_t left = e->size;
+    char *tmp_path = NULL;
+    uint8_t *buf = NULL;
+    int ret;
+
+    av_dict_copy(&opts, e->opts, 0);
+    if (is_http && e->size >= 0) {
+        av_dict_set_int(&opts, "offset", e->offset, 0);
+        av_dict_set_int(&opts, "end_offset", e->offset + e->size, 0);
+    }
+    ret = ffio_open_whitelist(&in, e->url, AVIO_FLAG_READ, &sc->interrupt_callback,
+                              &opts, sc->s->protocol_whitelist,
+                              sc->s->protocol_blacklist);
+    av_dict_free(&opts);
+    if (ret < 0)
+        goto fail;
+
+    if (!is_http && e->offset) {
+        int64_t pos = avio_seek(in, e->offset, SEEK_SET);
+        if (pos < 0) {
+            ret = pos;
+            goto fail;
+        }
+    }
+
+    buf = av_malloc(COPY_BUFFER_SIZE);
+    if (!buf) {
+        ret = AVERROR(ENOMEM);
+        goto fail;
+    }
+    ret = create_file(sc, e, &out, &tmp_path);
+    if (ret < 0)
+        goto fail;
+
+    while (left) {
+        int len = left > 0 ? FFMIN(left, COPY_BUFFER_SIZE) : COPY_BUFFER_SIZE;
+
+        len = avio_read(in, buf, len);
+        if (len == AVERROR_EOF)
+            break;
+        if (len < 0) {
+            ret = len;
+            goto fail;
+        }
+        avio_write(out, buf, len);
+        if (left > 0)
+            left -= len;
+    }
+    avio_flush(out);
+    ret = out->error;
+    if (ret < 0)
+        goto fail;
+    avio_closep(&out);
+
+    if (sc->dir) {
+        ret = ff_rename(tmp_path, e->path, sc->s);
+        if (ret < 0)
+            goto fail;
+        av_freep(&tmp_path);
+    } else {
+        e->path  = tmp_path;
+        tmp_path = NULL;
+    }
+
+    av_log(sc->s, AV_LOG_DEBUG, "Downloaded '%s', offset %"PRId64"\n",
+           e->url, e->offset);
+
+fail:
+    avio_closep(&out);
+    if (tmp_path)
+        ffurl_delete(tmp_path);
+    av_free(tmp_path);
+    av_free(buf);
+    avio_closep(&in);
+    if (ret < 0) {
+        if (ret != AVERROR_EXIT)
+            av_log(sc->s, AV_LOG_WARNING, "Prefetching '%s' failed: %s\n",
+                   e->url, av_err2str(ret));
+        e->temporary = 0;
+        av_freep(&e->path);
+    }
+    return ret;
+}
+
+static int new_entry(SegmentCache *sc, SegmentEntry **pe, const char *key,
+                     const char *url, int64_t offset, int64_t size,
+                     const AVDictionary *opts)
+{
+    SegmentEntry *e = av_mallocz(sizeof(*e));
+    int ret;
+
+    if (!e)
+        return AVERROR(ENOMEM);
+
+    e->sc     = sc;
+    e->url    = av_strdup(url);
+    e->offset = offset;
+    e->size   = size;
+    memcpy(e->key, key, sizeof(e->key));
+    ret = e->url ? av_dict_copy(&e->opts, opts, 0) : AVERROR(ENOMEM);
+    if (ret >= 0)
+        ret = av_dynarray_add_nofree(&sc->entries, &sc->nb_entries, e);
+    if (ret < 0) {
+        free_entry(&e);
+        return ret;
+    }
+
+    *pe = e;
+    return 0;
+}
+
+static int is_cached(const SegmentCache *sc, const char *key)
+{
+    char *path;
+    int ret;
+
+    if (!sc->dir)
+        return 0;
+    path = cache_path(sc, key);
+    if (!path)
+        return 0;
+    ret = avio_check(path, AVIO_FLAG_READ);
+    av_free(path);
+    return ret > 0;
+}
+
+int ff_segcache_alloc(SegmentCache **psc, AVFormatContext *s, const char *dir,
+                      int64_t max_size, int prefetch)
+{
+    SegmentCache *sc = av_mallocz(sizeof(*sc));
+
+    if (!sc)
+        return AVERROR(ENOMEM);
+
+    sc->s        = s;
+    sc->max_size = max_size;
+    atomic_init(&sc->abort, 0);
+    sc->interrupt_callback.callback = segcache_interrupt;
+    sc->interrupt_callback.opaque   = sc;
+
+    if (dir && *dir) {
+        sc->dir = av_strdup(dir);
+        if (!sc->dir)
+            goto fail;
+        /* fails if the directory exists already */
+        ff_mkdir_p(sc->dir);
+    }
+    if (prefetch > 0) {
+        /* not the shared executor: downloads block on network I/O and would
+         * hold up the CPU bound jobs of the other users */
+        sc->executor = av_executor_alloc_job_executor(prefetch);
+        if (!sc->executor)
+            goto fail;
+    }
+
+    *psc = sc;
+    return 0;
+fail:
+    ff_segcache_free(&sc);
+    return AVERROR(ENOMEM);
+}
+
+void ff_segcache_free(SegmentCache **psc)
+{
+    SegmentCache *sc = *psc;
+
+    if (!sc)
+        return;
+
+    atomic_store(&sc->abort, 1);
+    for (int i = 0; i < sc->nb_entries; i++)
+        free_entry(&sc->entries[i]);
+    av_freep(&sc->entries);
+    av_executor_free(&sc->executor);
+    av_freep(&sc->dir);
+    av_freep(psc);
+}
+
+int ff_segcache_prefetch(SegmentCache *sc, const char *url,
+                         int64_t offset, int64_t size, const AVDictionary *opts)
+{
+    SegmentEntry *e;
+    char key[KEY_SIZE + 1];
+    int ret;
+
+    if (!sc->executor)
+        return 0;
+
+    ret = segment_key(key, url, offset, size);
+    if (ret < 0)
+        return ret;
+    if (find_entry(sc, key) >= 0 || is_cached(sc, key))
+        return 0;
+
+    ret = new_entry(sc, &e, key, url, offset, size, opts);
+    if (ret < 0)
+        return ret;
+
+    /* segments requested first are needed first */
+    e->job = av_executor_job_alloc(sc->executor, download, e, --sc->priority);
+    if (!e->job) {
+        remove_entry(sc, sc->nb_entries - 1);
+        return AVERROR(ENOMEM);
+    }
+    av_executor_job_submit(e->job);
+
+    return 0;
+}
+
+int ff_segcache_open(SegmentCache *sc, AVIOContext **pb, const char *url,
+                     int64_t offset, int64_t size, const AVDictionary *opts)
+{
+    AVFormatContext *s = sc->s;
+    SegmentEntry *e;
+    char key[KEY_SIZE + 1];
+    int i, ret;
+
+    ret = segment_key(key, url, offset, size);
+    if (ret < 0)
+        return ret;
+
+    i = find_entry(sc, key);
+    if (i >= 0) {
+        e = sc->entries[i];
+        if (e->job) {
+            ret = av_executor_job_wait(e->job);
+            av_executor_job_free(&e->job);
+        }
+    } else if (sc->dir) {
+        ret = new_entry(sc, &e, key, url, offset, size, opts);
+        if (ret < 0)
+            return ret;
+        i = sc->nb_entries - 1;
+
+        if (is_cached(sc, key)) {
+            e->path = cache_path(sc, key);
+            ret = e->path ? 0 : AVERROR(ENOMEM);
+        } else {
+            ret = download(e);
+        }
+    } else {
+        return AVERROR(ENOENT);
+    }
+
+    if (ret >= 0) {
+        av_log(s, AV_LOG_DEBUG, "Reading '%s', offset %"PRId64" from '%s'\n",
+               url, offset, e->path);
+        ret = s->io_open(s, pb, e->path, AVIO_FLAG_READ, NULL);
+        if (ret >= 0 && sc->dir)
+            evict(sc, key);
+    }
+
+    remove_entry(sc, i);
+    return ret;
+}
@@ -0,0 +1,84 @@
+/*
+ * Segment prefetching and caching for HLS and DASH
+ *
+ * This file is part of Librempeg
+ *
+ * Librempeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Librempeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Librempeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef AVFORMAT_SEGCACHE_H
+#define AVFORMAT_SEGCACHE_H
+
+#include <stdint.h>
+
+#include "libavutil/dict.h"
+#include "avformat.h"
+
+/**
+ * Downloads media segments ahead of time on worker threads and keeps
+ * them in local files.
+ *
+ * A segment is identified by its URL and byte range. With a cache
+ * directory, every segment that is opened is stored there under the
+ * SHA-256 of its identity, so that later runs and other variants
+ * reading the same segment do not download it again. Without one,
+ * only prefetched segments are stored, in temporary files which are
+ * removed once read.
+ *
+ * All functions must be called from the demuxer thread.
+ */
+typedef struct SegmentCache SegmentCache;
+
+/**
+ * @param s        demuxer, its interrupt callback and protocol lists are
+ *                 used for the downloads
+ * @param dir      cache directory or NULL
+ * @param max_size size cap for the cache directory in bytes, 0 for none
+ * @param prefetch number of concurrent downloads
+ */
+int ff_segcache_alloc(SegmentCache **psc, AVFormatContext *s, const char *dir,
+                      int64_t max_size, int prefetch);
+
+/**
+ * Abort the pending downloads and free the cache, along with any
+ * temporary file.
+ */
+void ff_segcache_free(SegmentCache **psc);
+
+/**
+ * Start downloading a segment in the background, unless it is already
+ * pending or cached.
+ *
+ * @param size size of the byte range starting at offset, or -1 for
+ *             the whole resource
+ * @param opts protocol options, they are copied
+ */
+int ff_segcache_prefetch(SegmentCache *sc, const char *url,
+                         int64_t offset, int64_t size, const AVDictionary *opts);
+
+/**
+ * Open the local copy of a segment, waiting for a pending download or,
+ * with a cache directory, downloading it first. The returned context
+ * starts at the beginning of the byte range, it is closed with
+ * ff_format_io_close().
+ *
+ * @return 0 on success, AVERROR(ENOENT) if the segment is neither
+ *         pending nor cacheable, another negative error code if its
+ *         download failed; the caller should open the URL directly then
+ */
+int ff_segcache_open(SegmentCache *sc, AVIOContext **pb, const char *url,
+                     int64_t offset, int64_t size, const AVDictionary *opts);
+
+#endif /* AVFORMAT_SEGCACHE_H */
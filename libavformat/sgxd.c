@@ -336,6 +336,7 @@ const FFInputFormat ff_sgxd_demuxer = {
     .p.extensions   = "sgh,sgd,sgb",
     .p.flags        = AVFMT_GENERIC_INDEX,
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "SGXD" }),
     .read_header    = read_header,
     .read_packet    = read_packet,
     .read_seek      = read_seek,
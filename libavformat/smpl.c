@@ -79,6 +79,7 @@ const FFInputFormat ff_smpl_demuxer = {
     .p.flags        = AVFMT_GENERIC_INDEX,
     .p.extensions   = "v0,v1",
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "SMPL" }),
     .read_header    = read_header,
     .read_packet    = ff_pcm_read_packet,
 };
@@ -80,6 +80,7 @@ const FFInputFormat ff_smss_demuxer = {
     .p.extensions   = "vsf",
     .p.flags        = AVFMT_GENERIC_INDEX,
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "SMSS" }),
     .read_header    = read_header,
     .read_packet    = ff_pcm_read_packet,
 };
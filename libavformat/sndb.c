@@ -266,6 +266,7 @@ const FFInputFormat ff_sndb_demuxer = {
     .p.extensions   = "snd",
     .priv_data_size = sizeof(SNDBDemuxContext),
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "SNDB" }),
     .read_header    = read_header,
     .read_packet    = read_packet,
     .read_seek      = read_seek,
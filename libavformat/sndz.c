@@ -350,6 +350,7 @@ const FFInputFormat ff_sndz_demuxer = {
     .p.extensions   = "szd1,szd,szd3",
     .priv_data_size = sizeof(SNDZContext),
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "SNDZ" }),
     .read_header    = read_header,
     .read_packet    = read_packet,
     .read_seek      = read_seek,
@@ -85,6 +85,7 @@ const FFInputFormat ff_spcm_demuxer = {
     .p.flags        = AVFMT_GENERIC_INDEX,
     .p.extensions   = "pcm",
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "PCM " }),
     .read_header    = read_header,
     .read_packet    = ff_pcm_read_packet,
 };
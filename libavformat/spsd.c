@@ -118,6 +118,7 @@ const FFInputFormat ff_spsd_demuxer = {
     .p.flags        = AVFMT_GENERIC_INDEX,
     .p.extensions   = "str,spsd",
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "SPSD" }),
     .read_header    = read_header,
     .read_packet    = ff_pcm_read_packet,
 };
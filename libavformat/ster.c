@@ -81,6 +81,7 @@ const FFInputFormat ff_ster_demuxer = {
     .p.extensions   = "ster,sfs",
     .p.flags        = AVFMT_GENERIC_INDEX,
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "STER" }),
     .read_header    = read_header,
     .read_packet    = ff_pcm_read_packet,
 };
@@ -122,6 +122,7 @@ const FFInputFormat ff_sthd_demuxer = {
     .p.extensions   = "stx",
     .p.flags        = AVFMT_GENERIC_INDEX,
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "STHD" }),
     .read_header    = read_header,
     .read_packet    = read_packet,
 };
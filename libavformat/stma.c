@@ -108,6 +108,7 @@ const FFInputFormat ff_stma_demuxer = {
     .p.flags        = AVFMT_GENERIC_INDEX,
     .p.extensions   = "lstm",
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "STMA" }),
     .read_header    = read_header,
     .read_packet    = read_packet,
 };
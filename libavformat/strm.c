@@ -125,6 +125,7 @@ const FFInputFormat ff_strm_demuxer = {
     .p.flags        = AVFMT_GENERIC_INDEX,
     .p.extensions   = "strm",
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "STRM" }),
     .read_header    = read_header,
     .read_packet    = read_packet,
 };
@@ -78,6 +78,7 @@ const FFInputFormat ff_svag_demuxer = {
     .p.flags        = AVFMT_GENERIC_INDEX,
     .p.extensions   = "svag",
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "Svag" }),
     .read_header    = read_header,
     .read_packet    = ff_pcm_read_packet,
 };
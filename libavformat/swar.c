@@ -224,6 +224,7 @@ const FFInputFormat ff_swar_demuxer = {
     .p.flags        = AVFMT_GENERIC_INDEX,
     .p.extensions   = "swar",
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "SWAR" }),
     .read_header    = read_header,
     .read_packet    = read_packet,
 };
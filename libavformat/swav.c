@@ -132,6 +132,7 @@ const FFInputFormat ff_swav_demuxer = {
     .p.flags        = AVFMT_GENERIC_INDEX,
     .p.extensions   = "swav",
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "SWAV" }),
     .read_header    = read_header,
     .read_packet    = read_packet,
 };
@@ -0,0 +1,423 @@
+/*
+ * This file is part of Librempeg
+ *
+ * Librempeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Librempeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Librempeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * Build small sound banks in memory and check that demuxing them with the
+ * subsong option returns the same stream as demuxing the whole bank.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "libavutil/crc.h"
+#include "libavutil/error.h"
+#include "libavutil/intreadwrite.h"
+#include "libavutil/log.h"
+#include "libavutil/mem.h"
+
+#include "libavformat/avformat.h"
+
+#define MAX_STREAMS 4
+#define WAV_HEADER_SIZE 44
+
+typedef struct Bank {
+    uint8_t data[65536];
+    int size;
+    int64_t pos;
+} Bank;
+
+typedef struct StreamSummary {
+    enum AVCodecID codec_id;
+    int sample_rate;
+    int channels;
+    int nb_packets;
+    int64_t bytes;
+    uint32_t crc;
+} StreamSummary;
+
+static int read_bank(void *opaque, uint8_t *buf, int buf_size)
+{
+    Bank *b = opaque;
+    int size = FFMIN(buf_size, b->size - b->pos);
+
+    if (size <= 0)
+        return AVERROR_EOF;
+    memcpy(buf, b->data + b->pos, size);
+    b->pos += size;
+
+    return size;
+}
+
+static int64_t seek_bank(void *opaque, int64_t offset, int whence)
+{
+    Bank *b = opaque;
+
+    switch (whence) {
+    case AVSEEK_SIZE:
+        return b->size;
+    case SEEK_SET:
+        break;
+    case SEEK_CUR:
+        offset += b->pos;
+        break;
+    case SEEK_END:
+        offset += b->size;
+        break;
+    default:
+        return AVERROR(EINVAL);
+    }
+    if (offset < 0 || offset > b->size)
+        return AVERROR(EINVAL);
+    b->pos = offset;
+
+    return offset;
+}
+
+static void fill_samples(uint8_t *dst, int size, int seed)
+{
+    /* keep clear of chunk tags and of the 0xFFFFFFFF AWC block sync */
+    for (int i = 0; i < size; i++)
+        dst[i] = (seed * 37 + i * 7) & 0x7F;
+}
+
+static int put_wav(uint8_t *dst, int rate, int channels, int data_size, int seed)
+{
+    AV_WB32(dst +  0, MKBETAG('R','I','F','F'));
+    AV_WL32(dst +  4, WAV_HEADER_SIZE - 8 + data_size);
+    AV_WB32(dst +  8, MKBETAG('W','A','V','E'));
+    AV_WB32(dst + 12, MKBETAG('f','m','t',' '));
+    AV_WL32(dst + 16, 16);
+    AV_WL16(dst + 20, 1);
+    AV_WL16(dst + 22, channels);
+    AV_WL32(dst + 24, rate);
+    AV_WL32(dst + 28, rate * channels * 2);
+    AV_WL16(dst + 32, channels * 2);
+    AV_WL16(dst + 34, 16);
+    AV_WB32(dst + 36, MKBETAG('d','a','t','a'));
+    AV_WL32(dst + 40, data_size);
+    fill_samples(dst + WAV_HEADER_SIZE, data_size, seed);
+
+    return WAV_HEADER_SIZE + data_size;
+}
+
+/* XWB version 1: two PCM streams and a nested RIFF WAVE stream */
+static void build_xwb(Bank *b)
+{
+    static const int sizes[] = { 3000, 5000 };
+    uint8_t *p = b->data;
+    int data_offset = 0x50 + 3 * 0x14, pos = 0;
+
+    AV_WB32(p, MKBETAG('W','B','N','D'));
+    AV_WL32(p + 0x04, 1);
+    AV_WL32(p + 0x0C, 3);
+    memcpy(p + 0x10, "bank", 4);
+
+    for (int i = 0; i < 3; i++) {
+        uint8_t *entry = p + 0x50 + i * 0x14;
+        int size;
+
+        if (i < 2) {
+            size = sizes[i];
+            fill_samples(p + data_offset + pos, size, i);
+        } else {
+            size = put_wav(p + data_offset + pos, 8000, 1, 8192, i);
+        }
+        AV_WL32(entry + 0, (1U << 31) | ((22050 + 11025 * i) << 4) | ((1 + (i == 1)) << 1));
+        AV_WL32(entry + 4, pos);
+        AV_WL32(entry + 8, size);
+        pos += size;
+    }
+    b->size = data_offset + pos;
+}
+
+/* FSB5 with three PCM16 samples */
+static void build_fsb5(Bank *b)
+{
+    static const int sizes[] = { 4096, 2080, 3136 };
+    const int base = 0x3C, header_size = 3 * 8;
+    uint8_t *p = b->data;
+    int pos = 0;
+
+    memcpy(p, "FSB5", 4);
+    AV_WL32(p + 0x04, 1);
+    AV_WL32(p + 0x08, 3);
+    AV_WL32(p + 0x0C, header_size);
+    AV_WL32(p + 0x10, 0);
+    AV_WL32(p + 0x18, 2);
+
+    for (int i = 0; i < 3; i++) {
+        uint64_t mode = (uint64_t)(sizes[i] / 2) << 34 |
+                        (uint64_t)(pos / 32) << 7 |
+                        (i == 2) << 5 | (7 + i) << 1;
+
+        AV_WL64(p + base + i * 8, mode);
+        fill_samples(p + base + header_size + pos, sizes[i], i);
+        pos += sizes[i];
+    }
+    AV_WL32(p + 0x14, pos);
+    b->size = base + header_size + pos;
+}
+
+/* little-endian AWC with three mono PCM streams */
+static void build_awc(Bank *b)
+{
+    static const int sizes[] = { 2500, 1024, 3000 };
+    const int nb_streams = 3, tags = 2;
+    const int fmt_offset = 0x10 + 4 * nb_streams + 8 * tags * nb_streams;
+    const int data_offset = fmt_offset + 0x14 * nb_streams;
+    uint8_t *p = b->data;
+    int pos = data_offset;
+
+    AV_WB32(p + 0x00, MKBETAG('A','D','A','T'));
+    AV_WL32(p + 0x04, 0xFF000001);
+    AV_WL32(p + 0x08, nb_streams);
+
+    for (int i = 0; i < nb_streams; i++) {
+        uint8_t *tag = p + 0x10 + 4 * nb_streams + 8 * tags * i;
+        uint8_t *fmt = p + fmt_offset + 0x14 * i;
+
+        AV_WL32(p + 0x10 + 4 * i, (uint32_t)tags << 29 | (0x1000 + i));
+        AV_WL64(tag,     (uint64_t)0xFA << 56 | (uint64_t)0x14 << 28 | (fmt - p));
+        AV_WL64(tag + 8, (uint64_t)0x55 << 56 | (uint64_t)sizes[i] << 28 | pos);
+        AV_WL32(fmt, sizes[i] / 2);
+        AV_WL16(fmt + 8, 16000 * (i + 1));
+        fill_samples(p + pos, sizes[i], i);
+        pos += sizes[i];
+    }
+    b->size = pos;
+}
+
+/* little-endian SAB with two PCM materials and a nested RIFF WAVE one */
+static void build_sab(Bank *b)
+{
+    static const int sizes[] = { 2048, 3000 };
+    const int mtrl = 0x60;
+    uint8_t *p = b->data;
+    int pos = mtrl + 0x20;
+
+    AV_WB32(p, MKBETAG('s','a','b','f'));
+    AV_WL16(p + 0x06, 1);
+    AV_WB32(p + 0x20, MKBETAG('s','n','d',' '));
+    AV_WB32(p + 0x30, MKBETAG('s','e','q',' '));
+    AV_WB32(p + 0x40, MKBETAG('t','r','k',' '));
+    AV_WB32(p + 0x50, MKBETAG('m','t','r','l'));
+    AV_WL32(p + 0x58, mtrl);
+    AV_WL16(p + mtrl + 4, 3);
+
+    for (int i = 0; i < 3; i++) {
+        uint8_t *entry = p + pos;
+        int size;
+
+        AV_WL32(p + mtrl + 0x10 + 4 * i, pos - mtrl);
+        if (i < 2) {
+            size = sizes[i];
+            entry[5] = 0x01;
+            fill_samples(entry + 0x20, size, i);
+        } else {
+            size = put_wav(entry + 0x20, 11025, 2, 8192, i);
+            entry[5] = 0x03;
+        }
+        entry[4] = 1 + (i == 1);
+        AV_WL32(entry + 0x08, 24000 + 8000 * i);
+        AV_WL32(entry + 0x18, size);
+        pos += 0x20 + size;
+    }
+    b->size = pos;
+}
+
+/* NUS3BANK holding three RIFF WAVE tones */
+static void build_nus3bank(Bank *b)
+{
+    const int nb_tones = 3, tone_header_size = 28;
+    const int toc = 0x18, tone = toc + 2 * 8 + 8;
+    const int tone_size = 4 + nb_tones * 8 + nb_tones * tone_header_size;
+    const int pack = tone + tone_size + 8;
+    uint8_t *p = b->data;
+    int pos = 0;
+
+    AV_WB32(p + 0x00, MKBETAG('N','U','S','3'));
+    AV_WB32(p + 0x08, MKBETAG('B','A','N','K'));
+    AV_WB32(p + 0x0C, MKBETAG('T','O','C',' '));
+    AV_WL32(p + 0x10, 4 + 2 * 8);
+    AV_WL32(p + 0x14, 2);
+    AV_WB32(p + toc,      MKBETAG('T','O','N','E'));
+    AV_WL32(p + toc + 4,  tone_size);
+    AV_WB32(p + toc + 8,  MKBETAG('P','A','C','K'));
+    AV_WB32(p + tone - 8, MKBETAG('T','O','N','E'));
+    AV_WL32(p + tone - 4, tone_size);
+    AV_WL32(p + tone, nb_tones);
+
+    for (int i = 0; i < nb_tones; i++) {
+        int header = 4 + nb_tones * 8 + i * tone_header_size;
+        uint8_t *h = p + tone + header;
+        int size = put_wav(p + pack + pos, 8000 * (i + 1), 1, 4096 + 1024 * i, i);
+
+        AV_WL32(p + tone + 4 + 8 * i, header);
+        AV_WL32(p + tone + 8 + 8 * i, tone_header_size);
+        h[8] = 3;
+        h[9] = 't';
+        h[10] = '0' + i;
+        AV_WL32(h + 16, 8);
+        AV_WL32(h + 20, pos);
+        AV_WL32(h + 24, size);
+        pos += size;
+    }
+    AV_WB32(p + pack - 8, MKBETAG('P','A','C','K'));
+    AV_WL32(p + pack - 4, pos);
+    AV_WL32(p + toc + 12, pos);
+    b->size = pack + pos;
+}
+
+static int demux(Bank *b, const char *name, int subsong,
+                 StreamSummary *sum, int *nb_streams)
+{
+    const AVCRC *crc_table = av_crc_get_table(AV_CRC_32_IEEE_LE);
+    AVFormatContext *s = avformat_alloc_context();
+    AVDictionary *opts = NULL;
+    AVPacket *pkt = av_packet_alloc();
+    uint8_t *iobuf = av_malloc(4096);
+    AVIOContext *pb = NULL;
+    int ret;
+
+    if (!s || !pkt || !iobuf) {
+        ret = AVERROR(ENOMEM);
+        goto end;
+    }
+
+    b->pos = 0;
+    pb = avio_alloc_context(iobuf, 4096, 0, b, read_bank, NULL, seek_bank);
+    if (!pb) {
+        ret = AVERROR(ENOMEM);
+        goto end;
+    }
+    iobuf = NULL;
+    s->pb = pb;
+
+    if (subsong >= 0)
+        av_dict_set_int(&opts, "subsong", subsong, 0);
+    ret = avformat_open_input(&s, NULL, av_find_input_format(name), &opts);
+    if (ret < 0)
+        goto end;
+
+    *nb_streams = s->nb_streams;
+    if (s->nb_streams > MAX_STREAMS) {
+        ret = AVERROR_INVALIDDATA;
+        goto end;
+    }
+    for (int i = 0; i < s->nb_streams; i++) {
+        const AVCodecParameters *par = s->streams[i]->codecpar;
+
+        memset(&sum[i], 0, sizeof(sum[i]));
+        sum[i].codec_id    = par->codec_id;
+        sum[i].sample_rate = par->sample_rate;
+        sum[i].channels    = par->ch_layout.nb_channels;
+        sum[i].crc         = UINT32_MAX;
+    }
+
+    while ((ret = av_read_frame(s, pkt)) >= 0) {
+        StreamSummary *ss = &sum[pkt->stream_index];
+
+        ss->nb_packets++;
+        ss->bytes += pkt->size;
+        ss->crc = av_crc(crc_table, ss->crc, pkt->data, pkt->size);
+        av_packet_unref(pkt);
+    }
+    if (ret == AVERROR_EOF)
+        ret = 0;
+
+end:
+    avformat_close_input(&s);
+    if (pb)
+        av_freep(&pb->buffer);
+    avio_context_free(&pb);
+    av_packet_free(&pkt);
+    av_dict_free(&opts);
+    av_free(iobuf);
+
+    return ret;
+}
+
+static void print_summary(const char *name, const char *what, const StreamSummary *ss)
+{
+    printf("%s %s: %s %d Hz %d ch, %d packets, %"PRId64" bytes, crc 0x%08"PRIx32"\n",
+           name, what, avcodec_get_name(ss->codec_id), ss->sample_rate, ss->channels,
+           ss->nb_packets, ss->bytes, ss->crc);
+}
+
+static int test_bank(const char *name, void (*build)(Bank *b))
+{
+    StreamSummary all[MAX_STREAMS], one[MAX_STREAMS];
+    int nb_streams, nb, ret, failed = 0;
+    Bank *b = av_mallocz(sizeof(*b));
+
+    if (!b)
+        return 1;
+    build(b);
+
+    ret = demux(b, name, -1, all, &nb_streams);
+    if (ret < 0) {
+        printf("%s: demuxing failed: %s\n", name, av_err2str(ret));
+        av_free(b);
+        return 1;
+    }
+    printf("%s: %d streams\n", name, nb_streams);
+
+    for (int i = 0; i < nb_streams; i++) {
+        char what[32];
+
+        snprintf(what, sizeof(what), "stream %d", i);
+        print_summary(name, what, &all[i]);
+
+        ret = demux(b, name, i, one, &nb);
+        if (ret < 0) {
+            printf("%s subsong %d: demuxing failed: %s\n", name, i, av_err2str(ret));
+            failed = 1;
+            continue;
+        }
+        if (nb != 1 || memcmp(&one[0], &all[i], sizeof(one[0]))) {
+            snprintf(what, sizeof(what), "subsong %d", i);
+            print_summary(name, what, &one[0]);
+            printf("%s subsong %d: does not match stream %d\n", name, i, i);
+            failed = 1;
+        }
+    }
+
+    ret = demux(b, name, nb_streams, one, &nb);
+    printf("%s subsong %d: %s\n", name, nb_streams,
+           ret == AVERROR(EINVAL) ? "rejected" : "accepted");
+    failed |= ret != AVERROR(EINVAL);
+
+    av_free(b);
+
+    return failed;
+}
+
+int main(void)
+{
+    int ret = 0;
+
+    av_log_set_level(AV_LOG_QUIET);
+
+    ret |= test_bank("xwb",      build_xwb);
+    ret |= test_bank("fsb",      build_fsb5);
+    ret |= test_bank("awc",      build_awc);
+    ret |= test_bank("sab",      build_sab);
+    ret |= test_bank("nus3bank", build_nus3bank);
+
+    return ret;
+}
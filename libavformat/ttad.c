@@ -274,6 +274,7 @@ const FFInputFormat ff_ttad_demuxer = {
     .p.extensions   = "audio_data",
     .priv_data_size = sizeof(TTADDemuxContext),
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "FMT " }),
     .read_header    = read_header,
     .read_packet    = read_packet,
     .read_seek      = read_seek,
@@ -138,6 +138,7 @@ const FFInputFormat ff_ueba_demuxer = {
     .p.long_name    = NULL_IF_CONFIG_SMALL("Unreal Engine Bink Audio"),
     .p.flags        = AVFMT_GENERIC_INDEX,
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "ABEU" }),
     .read_header    = read_header,
     .read_packet    = read_packet,
 };
@@ -26,6 +26,7 @@
 
 #include "avio.h"
 
+#include "libavutil/buffer.h"
 #include "libavutil/dict.h"
 #include "libavutil/log.h"
 
@@ -83,6 +84,7 @@ typedef struct URLProtocol {
     int (*url_get_multi_file_handle)(URLContext *h, int **handles,
                                      int *numhandles);
     int (*url_get_short_seek)(URLContext *h);
+    int (*url_map)(URLContext *h, int64_t pos, int size, AVBufferRef **buf);
     int (*url_shutdown)(URLContext *h, int flags);
     const AVClass *priv_data_class;
     int priv_data_size;
@@ -263,6 +265,18 @@ int ffurl_get_multi_file_handle(URLContext *h, int **handles, int *numhandles);
  */
 int ffurl_get_short_seek(void *urlcontext);
 
+/**
+ * Map size bytes of the resource starting at pos into a private, writable
+ * buffer, followed by AV_INPUT_BUFFER_PADDING_SIZE zeroed bytes.
+ * The current position of the URLContext is not changed.
+ *
+ * @param buf set to a new reference to the mapping, whose data points to
+ *            the byte at pos
+ * @return 0 on success or <0 on error, AVERROR(ENOSYS) if the data cannot
+ *         be mapped
+ */
+int ffurl_map(void *urlcontext, int64_t pos, int size, AVBufferRef **buf);
+
 /**
  * Signal the URLContext that we are done reading or writing the stream.
  *
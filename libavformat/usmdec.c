@@ -488,6 +488,7 @@ const FFInputFormat ff_usm_demuxer = {
     .p.flags        = AVFMT_GENERIC_INDEX | AVFMT_NO_BYTE_SEEK | AVFMT_NOBINSEARCH,
     .priv_data_size = sizeof(USMDemuxContext),
     .read_probe     = usm_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "CRID" }),
     .read_header    = usm_read_header,
     .read_packet    = usm_read_packet,
     .read_close     = usm_read_close,
@@ -97,6 +97,8 @@ static int append_packet_chunked(AVIOContext *s, AVPacket *pkt, int size)
 
 int av_get_packet(AVIOContext *s, AVPacket *pkt, int size)
 {
+    int ret;
+
 #if FF_API_INIT_PACKET
 FF_DISABLE_DEPRECATION_WARNINGS
     av_init_packet(pkt);
@@ -108,6 +110,15 @@ FF_ENABLE_DEPRECATION_WARNINGS
 #endif
     pkt->pos  = avio_tell(s);
 
+    ret = ffio_read_mapping(s, size, &pkt->buf);
+    if (ret != AVERROR(ENOSYS)) {
+        if (ret >= 0) {
+            pkt->data = pkt->buf->data;
+            pkt->size = ret;
+        }
+        return ret;
+    }
+
     return append_packet_chunked(s, pkt, size);
 }
 
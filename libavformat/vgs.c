@@ -87,6 +87,7 @@ const FFInputFormat ff_vgs_demuxer = {
     .p.extensions   = "vgs",
     .p.flags        = AVFMT_GENERIC_INDEX,
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "VGS\0" }),
     .read_header    = read_header,
     .read_packet    = ff_pcm_read_packet,
 };
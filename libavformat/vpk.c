@@ -83,6 +83,7 @@ const FFInputFormat ff_vpk_demuxer = {
     .p.flags        = AVFMT_GENERIC_INDEX,
     .p.extensions   = "vpk",
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, " KPV" }),
     .read_header    = read_header,
     .read_packet    = ff_pcm_read_packet,
 };
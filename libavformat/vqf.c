@@ -304,6 +304,7 @@ const FFInputFormat ff_vqf_demuxer = {
     .p.extensions   = "vqf,vql,vqe",
     .priv_data_size = sizeof(VqfContext),
     .read_probe     = vqf_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "TWIN" }),
     .read_header    = vqf_read_header,
     .read_packet    = vqf_read_packet,
     .read_seek      = vqf_read_seek,
@@ -79,6 +79,7 @@ const FFInputFormat ff_vsf_demuxer = {
     .p.extensions   = "vsf",
     .p.flags        = AVFMT_GENERIC_INDEX,
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "VSF\0" }),
     .read_header    = read_header,
     .read_packet    = ff_pcm_read_packet,
 };
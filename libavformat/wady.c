@@ -87,6 +87,7 @@ const FFInputFormat ff_wady_demuxer = {
     .p.flags        = AVFMT_GENERIC_INDEX,
     .p.extensions   = "way",
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "WADY" }),
     .read_header    = read_header,
     .read_packet    = ff_pcm_read_packet,
     .read_seek      = ff_pcm_read_seek,
@@ -874,6 +874,7 @@ const FFInputFormat ff_wav_demuxer = {
     .p.priv_class   = &wav_demuxer_class,
     .priv_data_size = sizeof(WAVDemuxContext),
     .read_probe     = wav_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 8, 4, "WAVE" }),
     .read_header    = wav_read_header,
     .read_packet    = wav_read_packet,
     .read_seek      = wav_read_seek,
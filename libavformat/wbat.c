@@ -282,6 +282,7 @@ const FFInputFormat ff_wbat_demuxer = {
     .priv_data_size = sizeof(WBATDemuxContext),
     .flags_internal = FF_INFMT_FLAG_INIT_CLEANUP,
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "TABW" }),
     .read_header    = read_header,
     .read_packet    = read_packet,
     .read_seek      = read_seek,
@@ -77,6 +77,7 @@ const FFInputFormat ff_wmw_demuxer = {
     .p.flags        = AVFMT_GENERIC_INDEX,
     .p.extensions   = "wmw",
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "WMW " }),
     .read_header    = read_header,
     .read_packet    = ff_pcm_read_packet,
 };
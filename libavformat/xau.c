@@ -132,6 +132,7 @@ const FFInputFormat ff_xau_demuxer = {
     .p.flags        = AVFMT_GENERIC_INDEX,
     .p.extensions   = "xau",
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "XAU\0" }),
     .read_header    = read_header,
     .read_packet    = ff_pcm_read_packet,
 };
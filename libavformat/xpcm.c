@@ -122,6 +122,7 @@ const FFInputFormat ff_xpcm_demuxer = {
     .p.flags        = AVFMT_GENERIC_INDEX,
     .p.extensions   = "xpcm",
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "XPCM" }),
     .read_header    = read_header,
     .read_packet    = read_packet,
 };
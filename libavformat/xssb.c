@@ -223,6 +223,7 @@ const FFInputFormat ff_xssb_demuxer = {
     .p.extensions   = "bin,lbin",
     .priv_data_size = sizeof(XSSBDemuxContext),
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "XSSB" }),
     .read_header    = read_header,
     .read_packet    = read_packet,
     .read_seek      = read_seek,
@@ -27,6 +27,7 @@
 #include "internal.h"
 
 typedef struct XWBDemuxContext {
+    FFSubsongContext sub;
     int current_stream;
 } XWBDemuxContext;
 
@@ -89,14 +90,22 @@ static const uint16_t wma_block_align_index[17] = {
     929, 1487, 1280, 2230, 8917, 8192, 4459, 5945, 2304, 1536, 1485, 1008, 2731, 4096, 6827, 5462, 1280
 };
 
+static void free_stream(AVStream *st)
+{
+    XWBStream *xst = st->priv_data;
+
+    avformat_close_input(&xst->xctx);
+}
+
 static int read_header(AVFormatContext *s)
 {
+    XWBDemuxContext *xwb = s->priv_data;
     int64_t suboffset, offset, first_start_offset, entry_offset, entry_size, data_offset;
     int entry_alignment = 0, entry_elem_size, version, is_crackdown = 0;
     int nb_streams, ret, bps, rate, channels, tag, block_align = 1024, le;
     int64_t names_offset, names_size, names_entry_size;
     int64_t base_offset, duration = 0;
-    uint32_t base_flags, format = 0;
+    uint32_t base_flags = 0, format = 0;
     av_unused uint32_t entry_flags;
     av_unused int64_t extra_offset;
     av_unused int64_t extra_size;
@@ -559,6 +568,10 @@ static int read_header(AVFormatContext *s)
         }
     }
 
+    if (xwb->sub.subsong >= 0 &&
+        (ret = ff_select_subsong(s, xwb->sub.subsong, free_stream)) < 0)
+        return ret;
+
     {
         AVStream *st = s->streams[0];
         XWBStream *xst = st->priv_data;
@@ -581,9 +594,6 @@ static int read_packet(AVFormatContext *s, AVPacket *pkt)
     AVStream *st;
 
 redo:
-    if (avio_feof(pb))
-        return AVERROR_EOF;
-
     if (xwb->current_stream >= s->nb_streams)
         return AVERROR_EOF;
 
@@ -592,10 +602,16 @@ redo:
     if (do_seek)
         avio_seek(pb, xst->data_offset, SEEK_SET);
 
-    if (avio_tell(pb) >= xst->stop_offset) {
-        do_seek = 1;
-        xwb->current_stream++;
-        goto redo;
+    /* nested demuxers read ahead of the bank position, let them report EOF */
+    if (!xst->xctx) {
+        if (avio_feof(pb))
+            return AVERROR_EOF;
+
+        if (avio_tell(pb) >= xst->stop_offset) {
+            do_seek = 1;
+            xwb->current_stream++;
+            goto redo;
+        }
     }
 
     if (xst->xctx) {
@@ -629,6 +645,7 @@ redo:
     }
     pkt->stream_index = st->index;
     if (ret == AVERROR_EOF) {
+        do_seek = 1;
         xwb->current_stream++;
         goto redo;
     }
@@ -664,12 +681,8 @@ static int read_seek(AVFormatContext *s, int stream_index,
 
 static int read_close(AVFormatContext *s)
 {
-    for (int i = 0; i < s->nb_streams; i++) {
-        AVStream *st = s->streams[i];
-        XWBStream *xst = st->priv_data;
-
-        avformat_close_input(&xst->xctx);
-    }
+    for (int i = 0; i < s->nb_streams; i++)
+        free_stream(s->streams[i]);
 
     return 0;
 }
@@ -677,11 +690,13 @@ static int read_close(AVFormatContext *s)
 const FFInputFormat ff_xwb_demuxer = {
     .p.name         = "xwb",
     .p.long_name    = NULL_IF_CONFIG_SMALL("XWB (Microsoft Wave Bank)"),
+    .p.priv_class   = &ff_subsong_demuxer_class,
     .flags_internal = FF_INFMT_FLAG_INIT_CLEANUP,
     .p.flags        = AVFMT_GENERIC_INDEX,
     .p.extensions   = "xwb",
     .priv_data_size = sizeof(XWBDemuxContext),
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "WBND" }, { 0, 4, "DNBW" }),
     .read_header    = read_header,
     .read_packet    = read_packet,
     .read_seek      = read_seek,
@@ -125,6 +125,7 @@ const FFInputFormat ff_xwv_demuxer = {
     .p.flags        = AVFMT_GENERIC_INDEX,
     .p.extensions   = "wav,lwav",
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "XWV " }),
     .read_header    = read_header,
     .read_packet    = ff_pcm_read_packet,
 };
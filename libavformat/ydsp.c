@@ -100,6 +100,7 @@ const FFInputFormat ff_ydsp_demuxer = {
     .p.flags        = AVFMT_GENERIC_INDEX,
     .p.extensions   = "ydsp",
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "YDSP" }),
     .read_header    = read_header,
     .read_packet    = ff_pcm_read_packet,
 };
@@ -84,6 +84,7 @@ const FFInputFormat ff_zsd_demuxer = {
     .p.long_name    = NULL_IF_CONFIG_SMALL("ZSD (Dragon Booster DS)"),
     .p.extensions   = "zsd",
     .read_probe     = read_probe,
+    .signatures     = FF_PROBE_SIGNATURES({ 0, 4, "ZSD\0" }),
     .read_header    = read_header,
     .read_packet    = ff_pcm_read_packet,
     .read_seek      = ff_pcm_read_seek,
@@ -0,0 +1,35 @@
+/*
+ * This file is part of Librempeg
+ *
+ * Librempeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Librempeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Librempeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "libavutil/attributes.h"
+#include "libavutil/syncscan.h"
+#include "libavutil/aarch64/cpu.h"
+
+int ff_find_start_code_neon(const uint8_t *buf, int size);
+int ff_find_sync_word_neon(const uint8_t *buf, int size,
+                           unsigned sync, unsigned mask);
+
+av_cold void ff_syncscan_init_aarch64(SyncScanContext *c)
+{
+    int cpu_flags = av_get_cpu_flags();
+
+    if (have_neon(cpu_flags)) {
+        c->find_start_code = ff_find_start_code_neon;
+        c->find_sync_word  = ff_find_sync_word_neon;
+    }
+}
@@ -20,8 +20,11 @@
 
 #include "config.h"
 
+#include <stdatomic.h>
 #include <stdbool.h>
 
+#include "cpu.h"
+#include "error.h"
 #include "mem.h"
 #include "thread.h"
 
@@ -48,19 +51,52 @@ typedef struct ThreadInfo {
     ExecutorThread thread;
 } ThreadInfo;
 
+/**
+ * Per worker task list, sorted by priority. Workers take tasks from their
+ * own queue first and steal from the other ones when it has nothing ready.
+ */
+typedef struct TaskQueue {
+    AVMutex lock;
+    AVTask *tasks;
+} TaskQueue;
+
 struct AVExecutor {
     AVTaskCallbacks cb;
     int thread_count;
+    bool threaded;          ///< queues need locking, set before any thread starts
     bool recursive;
 
     ThreadInfo *threads;
     uint8_t *local_contexts;
 
+    TaskQueue *queues;
+    int nb_queues;
+    atomic_uint next_queue;
+
     AVMutex lock;
     AVCond cond;
     int die;
+    unsigned generation;    ///< bumped on every submission or wakeup, protected by lock
+};
 
-    AVTask *tasks;
+struct AVExecutorJob {
+    AVTask task;
+
+    AVExecutor *e;
+    int (*run)(void *opaque);
+    void *opaque;
+    int priority;
+    int ret;
+
+    /* unfinished dependencies, plus one until the job is submitted */
+    atomic_int deps;
+
+    AVMutex lock;
+    AVCond cond;
+    int done;
+    AVExecutorJob **dependents;
+    int nb_dependents;
+    unsigned dependents_size;
 };
 
 static AVTask* remove_task(AVTask **prev, AVTask *t)
@@ -76,21 +112,32 @@ static void add_task(AVTask **prev, AVTask *t)
     *prev   = t;
 }
 
-static int run_one_task(AVExecutor *e, void *lc)
+static AVTask *take_ready_task(AVExecutor *e, TaskQueue *q)
 {
     AVTaskCallbacks *cb = &e->cb;
-    AVTask **prev;
+    AVTask **prev, *t = NULL;
 
-    for (prev = &e->tasks; *prev && !cb->ready(*prev, cb->user_data); prev = &(*prev)->next)
+    if (e->threaded)
+        ff_mutex_lock(&q->lock);
+    for (prev = &q->tasks; *prev && !cb->ready(*prev, cb->user_data); prev = &(*prev)->next)
         /* nothing */;
-    if (*prev) {
-        AVTask *t = remove_task(prev, *prev);
-        if (e->thread_count > 0)
-            ff_mutex_unlock(&e->lock);
-        cb->run(t, lc, cb->user_data);
-        if (e->thread_count > 0)
-            ff_mutex_lock(&e->lock);
-        return 1;
+    if (*prev)
+        t = remove_task(prev, *prev);
+    if (e->threaded)
+        ff_mutex_unlock(&q->lock);
+    return t;
+}
+
+static int run_one_task(AVExecutor *e, int queue, void *lc)
+{
+    AVTaskCallbacks *cb = &e->cb;
+
+    for (int i = 0; i < e->nb_queues; i++) {
+        AVTask *t = take_ready_task(e, &e->queues[(queue + i) % e->nb_queues]);
+        if (t) {
+            cb->run(t, lc, cb->user_data);
+            return 1;
+        }
     }
     return 0;
 }
@@ -100,18 +147,29 @@ static void *executor_worker_task(void *data)
 {
     ThreadInfo *ti = (ThreadInfo*)data;
     AVExecutor *e  = ti->e;
-    void *lc       = e->local_contexts + (ti - e->threads) * e->cb.local_context_size;
+    const int idx  = ti - e->threads;
+    void *lc       = e->local_contexts + idx * e->cb.local_context_size;
 
-    ff_mutex_lock(&e->lock);
     while (1) {
-        if (e->die) break;
+        unsigned generation;
+
+        ff_mutex_lock(&e->lock);
+        generation = e->generation;
+        ff_mutex_unlock(&e->lock);
+
+        if (run_one_task(e, idx, lc))
+            continue;
 
-        if (!run_one_task(e, lc)) {
-            //no task in one loop
+        ff_mutex_lock(&e->lock);
+        //no task in one loop, wait for a new one unless one arrived meanwhile
+        while (!e->die && e->generation == generation)
             ff_cond_wait(&e->cond, &e->lock);
+        if (e->die) {
+            ff_mutex_unlock(&e->lock);
+            break;
         }
+        ff_mutex_unlock(&e->lock);
     }
-    ff_mutex_unlock(&e->lock);
     return NULL;
 }
 #endif
@@ -130,9 +188,13 @@ static void executor_free(AVExecutor *e, const int has_lock, const int has_cond)
     }
     if (has_cond)
         ff_cond_destroy(&e->cond);
-    if (has_lock)
+    if (has_lock) {
         ff_mutex_destroy(&e->lock);
+        for (int i = 0; i < e->nb_queues; i++)
+            ff_mutex_destroy(&e->queues[i].lock);
+    }
 
+    av_free(e->queues);
     av_free(e->threads);
     av_free(e->local_contexts);
 
@@ -159,8 +221,15 @@ AVExecutor* av_executor_alloc(const AVTaskCallbacks *cb, int thread_count)
     if (!e->threads)
         goto free_executor;
 
-    if (!thread_count)
+    e->queues = av_calloc(FFMAX(thread_count, 1), sizeof(*e->queues));
+    if (!e->queues)
+        goto free_executor;
+    atomic_init(&e->next_queue, 0);
+
+    if (!thread_count) {
+        e->nb_queues = 1;
         return e;
+    }
 
     has_lock = !ff_mutex_init(&e->lock, NULL);
     has_cond = !ff_cond_init(&e->cond, NULL);
@@ -168,6 +237,12 @@ AVExecutor* av_executor_alloc(const AVTaskCallbacks *cb, int thread_count)
     if (!has_lock || !has_cond)
         goto free_executor;
 
+    for (/* nothing */; e->nb_queues < thread_count; e->nb_queues++) {
+        if (ff_mutex_init(&e->queues[e->nb_queues].lock, NULL))
+            goto free_executor;
+    }
+
+    e->threaded = true;
     for (/* nothing */; e->thread_count < thread_count; e->thread_count++) {
         ThreadInfo *ti = e->threads + e->thread_count;
         ti->e = e;
@@ -197,25 +272,203 @@ void av_executor_execute(AVExecutor *e, AVTask *t)
     AVTaskCallbacks *cb = &e->cb;
     AVTask **prev;
 
-    if (e->thread_count)
-        ff_mutex_lock(&e->lock);
     if (t) {
-        for (prev = &e->tasks; *prev && cb->priority_higher(*prev, t); prev = &(*prev)->next)
+        TaskQueue *q = &e->queues[atomic_fetch_add_explicit(&e->next_queue, 1, memory_order_relaxed) % e->nb_queues];
+
+        if (e->threaded)
+            ff_mutex_lock(&q->lock);
+        for (prev = &q->tasks; *prev && cb->priority_higher(*prev, t); prev = &(*prev)->next)
             /* nothing */;
         add_task(prev, t);
+        if (e->threaded)
+            ff_mutex_unlock(&q->lock);
     }
-    if (e->thread_count) {
+    if (e->threaded) {
+        ff_mutex_lock(&e->lock);
+        e->generation++;
         ff_cond_signal(&e->cond);
         ff_mutex_unlock(&e->lock);
     }
 
-    if (!e->thread_count || !HAVE_THREADS) {
+    if (!e->threaded || !HAVE_THREADS) {
         if (e->recursive)
             return;
         e->recursive = true;
         // We are running in a single-threaded environment, so we must handle all tasks ourselves
-        while (run_one_task(e, e->local_contexts))
+        while (run_one_task(e, 0, e->local_contexts))
             /* nothing */;
         e->recursive = false;
     }
 }
+
+static int job_priority_higher(const AVTask *a, const AVTask *b)
+{
+    return ((const AVExecutorJob *)a)->priority > ((const AVExecutorJob *)b)->priority;
+}
+
+static int job_ready(const AVTask *t, void *user_data)
+{
+    // jobs are only queued once all their dependencies are done
+    return 1;
+}
+
+static int job_run(AVTask *t, void *local_context, void *user_data)
+{
+    AVExecutorJob *job = (AVExecutorJob *)t;
+    AVExecutorJob **dependents;
+    int nb_dependents;
+
+    job->ret = job->run(job->opaque);
+
+    // take over the dependents, the job may be freed as soon as done is set
+    ff_mutex_lock(&job->lock);
+    job->done           = 1;
+    dependents          = job->dependents;
+    nb_dependents       = job->nb_dependents;
+    job->dependents     = NULL;
+    job->nb_dependents  = 0;
+    ff_cond_broadcast(&job->cond);
+    ff_mutex_unlock(&job->lock);
+
+    for (int i = 0; i < nb_dependents; i++) {
+        AVExecutorJob *d = dependents[i];
+        if (atomic_fetch_sub_explicit(&d->deps, 1, memory_order_acq_rel) == 1)
+            av_executor_execute(d->e, &d->task);
+    }
+    av_free(dependents);
+    return 0;
+}
+
+AVExecutor *av_executor_alloc_job_executor(int thread_count)
+{
+    static const AVTaskCallbacks cb = {
+        .user_data       = (void *)&cb,
+        .priority_higher = job_priority_higher,
+        .ready           = job_ready,
+        .run             = job_run,
+    };
+
+    if (thread_count <= 0)
+        thread_count = HAVE_THREADS ? av_cpu_count() : 0;
+    return av_executor_alloc(&cb, thread_count);
+}
+
+static AVMutex shared_executor_lock = AV_MUTEX_INITIALIZER;
+static AVExecutor *shared_executor;
+static unsigned shared_executor_refs;
+
+AVExecutor *av_executor_shared_acquire(void)
+{
+    AVExecutor *e;
+
+    ff_mutex_lock(&shared_executor_lock);
+    if (!shared_executor)
+        shared_executor = av_executor_alloc_job_executor(0);
+    if (shared_executor)
+        shared_executor_refs++;
+    e = shared_executor;
+    ff_mutex_unlock(&shared_executor_lock);
+
+    return e;
+}
+
+void av_executor_shared_release(AVExecutor **pe)
+{
+    AVExecutor *e = NULL;
+
+    if (!pe || !*pe)
+        return;
+
+    ff_mutex_lock(&shared_executor_lock);
+    if (*pe == shared_executor && !--shared_executor_refs) {
+        e = shared_executor;
+        shared_executor = NULL;
+    }
+    ff_mutex_unlock(&shared_executor_lock);
+
+    av_executor_free(&e);
+    *pe = NULL;
+}
+
+AVExecutorJob *av_executor_job_alloc(AVExecutor *e, int (*run)(void *opaque),
+                                     void *opaque, int priority)
+{
+    AVExecutorJob *job;
+
+    if (!e || !run || e->cb.run != job_run)
+        return NULL;
+
+    job = av_mallocz(sizeof(*job));
+    if (!job)
+        return NULL;
+
+    if (ff_mutex_init(&job->lock, NULL)) {
+        av_free(job);
+        return NULL;
+    }
+    if (ff_cond_init(&job->cond, NULL)) {
+        ff_mutex_destroy(&job->lock);
+        av_free(job);
+        return NULL;
+    }
+
+    job->e        = e;
+    job->run      = run;
+    job->opaque   = opaque;
+    job->priority = priority;
+    atomic_init(&job->deps, 1);
+
+    return job;
+}
+
+int av_executor_job_add_dependency(AVExecutorJob *job, AVExecutorJob *dep)
+{
+    int ret = 0;
+
+    if (!job || !dep || job == dep)
+        return AVERROR(EINVAL);
+
+    ff_mutex_lock(&dep->lock);
+    if (!dep->done) {
+        AVExecutorJob **dependents = av_fast_realloc(dep->dependents, &dep->dependents_size,
+                                                     (dep->nb_dependents + 1) * sizeof(*dependents));
+        if (dependents) {
+            dep->dependents = dependents;
+            dep->dependents[dep->nb_dependents++] = job;
+            atomic_fetch_add_explicit(&job->deps, 1, memory_order_relaxed);
+        } else
+            ret = AVERROR(ENOMEM);
+    }
+    ff_mutex_unlock(&dep->lock);
+
+    return ret;
+}
+
+void av_executor_job_submit(AVExecutorJob *job)
+{
+    if (atomic_fetch_sub_explicit(&job->deps, 1, memory_order_acq_rel) == 1)
+        av_executor_execute(job->e, &job->task);
+}
+
+int av_executor_job_wait(AVExecutorJob *job)
+{
+    ff_mutex_lock(&job->lock);
+    while (!job->done)
+        ff_cond_wait(&job->cond, &job->lock);
+    ff_mutex_unlock(&job->lock);
+
+    return job->ret;
+}
+
+void av_executor_job_free(AVExecutorJob **pjob)
+{
+    AVExecutorJob *job = *pjob;
+
+    if (!job)
+        return;
+
+    ff_cond_destroy(&job->cond);
+    ff_mutex_destroy(&job->lock);
+    av_free(job->dependents);
+    av_freep(pjob);
+}
@@ -59,9 +59,79 @@ void av_executor_free(AVExecutor **e);
 
 /**
  * Add task to executor
+ *
+ * Tasks are spread over per worker queues, each kept sorted by priority.
+ * A worker runs the highest priority ready task of its own queue, and
+ * steals from the other queues when none is ready there.
+ *
  * @param e pointer to executor
  * @param t pointer to task. If NULL, it will wakeup one work thread
  */
 void av_executor_execute(AVExecutor *e, AVTask *t);
 
+/**
+ * A job with a priority and dependencies on other jobs, run by an executor
+ * allocated with av_executor_alloc_job_executor() or av_executor_shared_acquire().
+ */
+typedef struct AVExecutorJob AVExecutorJob;
+
+/**
+ * Alloc an executor running AVExecutorJob
+ * @param thread_count worker thread number, 0 for one per CPU core
+ * @return return the executor, to be freed with av_executor_free()
+ */
+AVExecutor *av_executor_alloc_job_executor(int thread_count);
+
+/**
+ * Get a reference to the process wide job executor, so that several users
+ * share one set of worker threads. It is created on first use, with one
+ * thread per CPU core.
+ * @return return the executor or NULL on failure
+ */
+AVExecutor *av_executor_shared_acquire(void);
+
+/**
+ * Release a reference obtained with av_executor_shared_acquire(). The shared
+ * executor is freed with its last reference, all jobs submitted through
+ * this reference must have completed.
+ * @param e pointer to the executor, set to NULL
+ */
+void av_executor_shared_release(AVExecutor **e);
+
+/**
+ * Alloc a job
+ * @param e executor the job will run on
+ * @param run function run by the job, its return value is returned by
+ *            av_executor_job_wait()
+ * @param opaque argument passed to run
+ * @param priority jobs with higher priority run first
+ * @return return the job or NULL on failure
+ */
+AVExecutorJob *av_executor_job_alloc(AVExecutor *e, int (*run)(void *opaque),
+                                     void *opaque, int priority);
+
+/**
+ * Make job wait for dep to complete before running. Must be called before
+ * job is submitted.
+ * @return return 0 on success or a negative AVERROR code
+ */
+int av_executor_job_add_dependency(AVExecutorJob *job, AVExecutorJob *dep);
+
+/**
+ * Submit a job. It is queued as soon as all its dependencies have completed.
+ */
+void av_executor_job_submit(AVExecutorJob *job);
+
+/**
+ * Wait for a submitted job to complete
+ * @return return the value returned by the job function
+ */
+int av_executor_job_wait(AVExecutorJob *job);
+
+/**
+ * Free a job, which must be either completed or never submitted
+ * @param job pointer to the job, set to NULL
+ */
+void av_executor_job_free(AVExecutorJob **job);
+
 #endif //AVUTIL_EXECUTOR_H
@@ -0,0 +1,82 @@
+/*
+ * This file is part of Librempeg
+ *
+ * Librempeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Librempeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Librempeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "config.h"
+#include "attributes.h"
+#include "intreadwrite.h"
+#include "syncscan.h"
+#include "thread.h"
+
+static int find_start_code_c(const uint8_t *buf, int size)
+{
+    int i = 2;
+
+    /* buf[i] is the candidate for the 0x01 byte */
+    while (i < size) {
+        if      (buf[i] > 1)                  i += 3;
+        else if (buf[i - 1])                  i += 2;
+        else if (buf[i - 2] | (buf[i] - 1))   i++;
+        else
+            return i - 2;
+    }
+
+    return size;
+}
+
+static int find_sync_word_c(const uint8_t *buf, int size,
+                            unsigned sync, unsigned mask)
+{
+    for (int i = 0; i < size - 1; i++)
+        if ((AV_RB16(buf + i) & mask) == sync)
+            return i;
+
+    return size;
+}
+
+av_cold void avpriv_syncscan_init(SyncScanContext *c)
+{
+    c->find_start_code = find_start_code_c;
+    c->find_sync_word  = find_sync_word_c;
+
+#if ARCH_AARCH64
+    ff_syncscan_init_aarch64(c);
+#elif ARCH_X86
+    ff_syncscan_init_x86(c);
+#endif
+}
+
+static SyncScanContext scan;
+static AVOnce scan_init = AV_ONCE_INIT;
+
+static av_cold void syncscan_init_once(void)
+{
+    avpriv_syncscan_init(&scan);
+}
+
+int avpriv_find_start_code_prefix(const uint8_t *buf, int size)
+{
+    ff_thread_once(&scan_init, syncscan_init_once);
+    return scan.find_start_code(buf, size);
+}
+
+int avpriv_find_sync_word(const uint8_t *buf, int size,
+                          unsigned sync, unsigned mask)
+{
+    ff_thread_once(&scan_init, syncscan_init_once);
+    return scan.find_sync_word(buf, size, sync, mask);
+}
@@ -0,0 +1,63 @@
+/*
+ * This file is part of Librempeg
+ *
+ * Librempeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Librempeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Librempeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef AVUTIL_SYNCSCAN_H
+#define AVUTIL_SYNCSCAN_H
+
+#include <stdint.h>
+
+/**
+ * Scanners for the start codes and sync words of elementary streams.
+ * None of the functions reads past buf + size, so no padding is needed.
+ */
+
+typedef struct SyncScanContext {
+    /**
+     * Find the first 0x00 0x00 0x01 start code prefix.
+     *
+     * @return offset of the prefix, or size if there is none
+     */
+    int (*find_start_code)(const uint8_t *buf, int size);
+
+    /**
+     * Find the first big endian 16 bit word w with (w & mask) == sync.
+     *
+     * @return offset of the word, or size if there is none
+     */
+    int (*find_sync_word)(const uint8_t *buf, int size,
+                          unsigned sync, unsigned mask);
+} SyncScanContext;
+
+void avpriv_syncscan_init(SyncScanContext *c);
+void ff_syncscan_init_aarch64(SyncScanContext *c);
+void ff_syncscan_init_x86(SyncScanContext *c);
+
+/**
+ * SyncScanContext.find_start_code() with the fastest implementation
+ * for the CPU.
+ */
+int avpriv_find_start_code_prefix(const uint8_t *buf, int size);
+
+/**
+ * SyncScanContext.find_sync_word() with the fastest implementation
+ * for the CPU.
+ */
+int avpriv_find_sync_word(const uint8_t *buf, int size,
+                          unsigned sync, unsigned mask);
+
+#endif /* AVUTIL_SYNCSCAN_H */
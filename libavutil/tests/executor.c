@@ -0,0 +1,131 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <stdatomic.h>
+#include <stdio.h>
+
+#include "libavutil/executor.h"
+#include "libavutil/macros.h"
+
+#define NB_LAYERS 8
+#define WIDTH     16
+
+typedef struct Node {
+    atomic_int *clock;
+    int layer;
+    int finished_at;
+    const struct Node *deps[WIDTH];
+    int nb_deps;
+    int failed;
+} Node;
+
+static int run_node(void *opaque)
+{
+    Node *n = opaque;
+
+    /* every dependency must have completed before this job started */
+    for (int i = 0; i < n->nb_deps; i++)
+        if (!n->deps[i]->finished_at)
+            n->failed = 1;
+    n->finished_at = atomic_fetch_add(n->clock, 1) + 1;
+    return n->layer;
+}
+
+static int test_graph(AVExecutor *e)
+{
+    static Node nodes[NB_LAYERS][WIDTH];
+    AVExecutorJob *jobs[NB_LAYERS][WIDTH] = { { NULL } };
+    atomic_int clock;
+    int ret = 0;
+
+    atomic_init(&clock, 0);
+
+    for (int l = 0; l < NB_LAYERS; l++) {
+        for (int i = 0; i < WIDTH; i++) {
+            Node *n = &nodes[l][i];
+            *n = (Node){ .clock = &clock, .layer = l };
+            jobs[l][i] = av_executor_job_alloc(e, run_node, n, NB_LAYERS - l);
+            if (!jobs[l][i]) {
+                ret = 1;
+                goto end;
+            }
+            /* depend on a few jobs of the previous layer */
+            for (int k = 0; l && k < 3; k++) {
+                int d = (i * 5 + k * 7) % WIDTH;
+                n->deps[n->nb_deps++] = &nodes[l - 1][d];
+                if (av_executor_job_add_dependency(jobs[l][i], jobs[l - 1][d]) < 0) {
+                    ret = 1;
+                    goto end;
+                }
+            }
+        }
+    }
+
+    /* submit in reverse order, dependencies must hold the later layers back */
+    for (int l = NB_LAYERS - 1; l >= 0; l--)
+        for (int i = 0; i < WIDTH; i++)
+            av_executor_job_submit(jobs[l][i]);
+
+    for (int l = 0; l < NB_LAYERS; l++) {
+        for (int i = 0; i < WIDTH; i++) {
+            if (av_executor_job_wait(jobs[l][i]) != l || nodes[l][i].failed) {
+                printf("layer %d job %d ran out of order\n", l, i);
+                ret = 1;
+            }
+        }
+    }
+
+end:
+    for (int l = 0; l < NB_LAYERS; l++)
+        for (int i = 0; i < WIDTH; i++)
+            av_executor_job_free(&jobs[l][i]);
+    return ret;
+}
+
+int main(void)
+{
+    static const int thread_counts[] = { 0, 1, 4 };
+    AVExecutor *e, *shared, *shared2;
+    int ret = 0;
+
+    for (int i = 0; i < FF_ARRAY_ELEMS(thread_counts); i++) {
+        e = av_executor_alloc_job_executor(thread_counts[i]);
+        if (!e)
+            return 1;
+        if (test_graph(e)) {
+            printf("graph test failed with %d threads\n", thread_counts[i]);
+            ret = 1;
+        }
+        av_executor_free(&e);
+    }
+
+    shared  = av_executor_shared_acquire();
+    shared2 = av_executor_shared_acquire();
+    if (!shared || shared != shared2) {
+        printf("shared executor is not shared\n");
+        ret = 1;
+    }
+    av_executor_shared_release(&shared2);
+    if (shared && test_graph(shared)) {
+        printf("graph test failed on the shared executor\n");
+        ret = 1;
+    }
+    av_executor_shared_release(&shared);
+
+    return ret;
+}
@@ -0,0 +1,130 @@
+/*
+ * Check that batched transforms match the same transforms done one by one.
+ * With -bench, also print the time taken by both approaches.
+ *
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "libavutil/lfg.h"
+#include "libavutil/macros.h"
+#include "libavutil/mem.h"
+#include "libavutil/time.h"
+#include "libavutil/tx.h"
+
+#define BENCH_RUNS 200
+
+static int test(int len, int nb, int inv, int inplace, int bench, AVLFG *lfg)
+{
+    AVTXContext *single = NULL, *batch = NULL;
+    av_tx_fn single_fn, batch_fn;
+    AVComplexFloat *in, *out, *ref, *tmp_in, *tmp_out;
+    const size_t size = (size_t)len * nb;
+    const float eps = 2e-6f * len;
+    int64_t t_single = 0, t_batch = 0;
+    int ret = 1;
+
+    in      = av_malloc_array(size, sizeof(*in));
+    out     = av_malloc_array(size, sizeof(*out));
+    ref     = av_malloc_array(size, sizeof(*ref));
+    tmp_in  = av_malloc_array(len,  sizeof(*tmp_in));
+    tmp_out = av_malloc_array(len,  sizeof(*tmp_out));
+    if (!in || !out || !ref || !tmp_in || !tmp_out)
+        goto end;
+
+    if (av_tx_init(&single, &single_fn, AV_TX_FLOAT_FFT, inv, len, NULL, 0) < 0 ||
+        av_tx_init_batch(&batch, &batch_fn, AV_TX_FLOAT_FFT, inv, len, nb, NULL,
+                         inplace ? AV_TX_INPLACE : 0) < 0) {
+        printf("init failed for len %d, %d transforms\n", len, nb);
+        goto end;
+    }
+
+    for (size_t i = 0; i < size; i++) {
+        in[i].re = av_lfg_get(lfg) / (float)UINT32_MAX - 0.5f;
+        in[i].im = av_lfg_get(lfg) / (float)UINT32_MAX - 0.5f;
+    }
+
+    for (int run = 0; run < (bench ? BENCH_RUNS : 1); run++) {
+        int64_t t = av_gettime_relative();
+        for (int n = 0; n < nb; n++) {
+            for (int i = 0; i < len; i++)
+                tmp_in[i] = in[i*nb + n];
+            single_fn(single, tmp_out, tmp_in, sizeof(*tmp_out));
+            for (int i = 0; i < len; i++)
+                ref[i*nb + n] = tmp_out[i];
+        }
+        t_single += av_gettime_relative() - t;
+
+        t = av_gettime_relative();
+        if (inplace) {
+            memcpy(out, in, size * sizeof(*out));
+            batch_fn(batch, out, out, sizeof(*out));
+        } else {
+            batch_fn(batch, out, in, sizeof(*out));
+        }
+        t_batch += av_gettime_relative() - t;
+    }
+
+    ret = 0;
+    for (size_t i = 0; i < size; i++) {
+        if (fabsf(out[i].re - ref[i].re) > eps || fabsf(out[i].im - ref[i].im) > eps) {
+            printf("len %d, %d transforms, inv %d, inplace %d: mismatch at %zu: "
+                   "%f %f != %f %f\n", len, nb, inv, inplace, i,
+                   out[i].re, out[i].im, ref[i].re, ref[i].im);
+            ret = 1;
+            break;
+        }
+    }
+
+    if (bench)
+        printf("len %5d, %2d transforms: single %8"PRId64" us, batch %8"PRId64" us\n",
+               len, nb, t_single, t_batch);
+
+end:
+    av_tx_uninit(&single);
+    av_tx_uninit(&batch);
+    av_free(in);
+    av_free(out);
+    av_free(ref);
+    av_free(tmp_in);
+    av_free(tmp_out);
+    return ret;
+}
+
+int main(int argc, char **argv)
+{
+    static const int lens[] = { 2, 16, 256, 1024, 4096, 15, 60, 480 };
+    static const int nbs[]  = { 2, 6, 8 };
+    int bench = argc > 1 && !strcmp(argv[1], "-bench");
+    AVLFG lfg;
+    int ret = 0;
+
+    av_lfg_init(&lfg, 0xdeadbeef);
+
+    for (int l = 0; l < FF_ARRAY_ELEMS(lens); l++)
+        for (int b = 0; b < FF_ARRAY_ELEMS(nbs); b++)
+            for (int inv = 0; inv < 2; inv++)
+                for (int inplace = 0; inplace < 2; inplace++)
+                    ret |= test(lens[l], nbs[b], inv, inplace,
+                                bench && !inv && !inplace, &lfg);
+
+    return ret;
+}
@@ -596,6 +596,8 @@ static void print_flags(AVBPrint *bp, uint64_t f)
         av_bprintf(bp, "%sreal_to_imaginary", prev > 1 ? sep : "");
     if ((f & FF_TX_ASM_CALL) && ++prev)
         av_bprintf(bp, "%sasm_call", prev > 1 ? sep : "");
+    if ((f & FF_TX_BATCHED) && ++prev)
+        av_bprintf(bp, "%sbatched", prev > 1 ? sep : "");
     av_bprintf(bp, "]");
 }
 
@@ -765,7 +767,8 @@ av_cold int ff_tx_init_subtx(AVTXContext *s, enum AVTXType type,
                             AV_TX_REAL_TO_REAL |
                             AV_TX_REAL_TO_IMAGINARY |
                             FF_TX_PRESHUFFLE |
-                            FF_TX_ASM_CALL;
+                            FF_TX_ASM_CALL |
+                            FF_TX_BATCHED;
 
     /* Unaligned codelets are compatible with the aligned flag */
     if (req_flags & FF_TX_ALIGNED)
@@ -930,8 +933,9 @@ end:
     return ret;
 }
 
-av_cold int av_tx_init(AVTXContext **ctx, av_tx_fn *tx, enum AVTXType type,
-                       int inv, int len, const void *scale, uint64_t flags)
+static av_cold int tx_init(AVTXContext **ctx, av_tx_fn *tx, enum AVTXType type,
+                           int inv, int len, const void *scale, uint64_t flags,
+                           FFTXCodeletOptions *opts)
 {
     int ret;
     AVTXContext tmp = { 0 };
@@ -957,7 +961,7 @@ av_cold int av_tx_init(AVTXContext **ctx, av_tx_fn *tx, enum AVTXType type,
     else if (!scale && !TYPE_IS(FFT, type))
         scale = &default_scale_f;
 
-    ret = ff_tx_init_subtx(&tmp, type, flags, NULL, len, inv, scale);
+    ret = ff_tx_init_subtx(&tmp, type, flags, opts, len, inv, scale);
     if (ret < 0)
         return ret;
 
@@ -971,3 +975,27 @@ av_cold int av_tx_init(AVTXContext **ctx, av_tx_fn *tx, enum AVTXType type,
 
     return ret;
 }
+
+av_cold int av_tx_init(AVTXContext **ctx, av_tx_fn *tx, enum AVTXType type,
+                       int inv, int len, const void *scale, uint64_t flags)
+{
+    return tx_init(ctx, tx, type, inv, len, scale, flags, NULL);
+}
+
+av_cold int av_tx_init_batch(AVTXContext **ctx, av_tx_fn *tx, enum AVTXType type,
+                             int inv, int len, int nb, const void *scale,
+                             uint64_t flags)
+{
+    FFTXCodeletOptions opts = {
+        .map_dir  = FF_TX_MAP_NONE,
+        .nb_batch = nb,
+    };
+
+    if (nb < 1 || type >= AV_TX_NB || !TYPE_IS(FFT, type))
+        return AVERROR(EINVAL);
+
+    if (nb == 1)
+        return av_tx_init(ctx, tx, type, inv, len, scale, flags);
+
+    return tx_init(ctx, tx, type, inv, len, scale, flags | FF_TX_BATCHED, &opts);
+}
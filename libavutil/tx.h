@@ -212,6 +212,28 @@ enum AVTXFlags {
 int av_tx_init(AVTXContext **ctx, av_tx_fn *tx, enum AVTXType type,
                int inv, int len, const void *scale, uint64_t flags);
 
+/**
+ * Initialize a transform context performing nb transforms of the same
+ * configuration with a single call of the returned function.
+ *
+ * The transforms are interleaved in the input and output arrays: sample i of
+ * transform b is located at index i*nb + b, like the channels of interleaved
+ * audio. This allows implementations to run the same step of all transforms
+ * at once, loading each twiddle factor only once and spreading vector lanes
+ * across transforms rather than within a single one.
+ *
+ * Only the complex FFT types are currently supported. The stride parameter
+ * of the returned function must be set to the size of a single sample.
+ * With nb == 1, this is equivalent to av_tx_init().
+ *
+ * @param nb number of interleaved transforms, must be at least 1
+ *
+ * All other parameters and the return value are as for av_tx_init().
+ */
+int av_tx_init_batch(AVTXContext **ctx, av_tx_fn *tx, enum AVTXType type,
+                     int inv, int len, int nb, const void *scale,
+                     uint64_t flags);
+
 /**
  * Frees a context and sets *ctx to NULL, does nothing when *ctx == NULL.
  */
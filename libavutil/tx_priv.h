@@ -234,6 +234,7 @@ typedef void TXComplex;
 #define FF_TX_INVERSE_ONLY (1ULL << 60) /* For non-orthogonal inverse-only transforms */
 #define FF_TX_FORWARD_ONLY (1ULL << 59) /* For non-orthogonal forward-only transforms */
 #define FF_TX_ASM_CALL     (1ULL << 58) /* For asm->asm functions only                */
+#define FF_TX_BATCHED      (1ULL << 57) /* Performs interleaved batches of transforms */
 
 typedef enum FFTXCodeletPriority {
     FF_TX_PRIO_BASE = 0,               /* Baseline priority */
@@ -262,6 +263,9 @@ typedef struct FFTXCodeletOptions {
      * direction in AVTXContext. If the codelet does not respect this, a
      * conversion will be performed. */
     FFTXMapDirection map_dir;
+
+    /* Number of interleaved transforms FF_TX_BATCHED codelets must perform. */
+    int nb_batch;
 } FFTXCodeletOptions;
 
 /* Maximum number of factors a codelet may have. Arbitrary. */
@@ -353,6 +357,8 @@ struct AVTXContext {
     PassEntry         *leaves;
     int                nb_leaves;
     int                nb_schedules;
+    int                nb_batch;        /* Number of interleaved transforms,
+                                         * only set for FF_TX_BATCHED */
 };
 
 /* This function embeds a Ruritanian PFA input map into an existing lookup table
@@ -1501,6 +1501,204 @@ static const FFTXCodelet TX_NAME(ff_tx_fft_inplace_def) = {
     .prio       = FF_TX_PRIO_BASE - 512,
 };
 
+static av_cold int TX_NAME(ff_tx_fft_batch_init)(AVTXContext *s,
+                                                 const FFTXCodelet *cd,
+                                                 uint64_t flags,
+                                                 FFTXCodeletOptions *opts,
+                                                 int len, int inv,
+                                                 const void *scale)
+{
+    const int bits = av_log2(len);
+    const double phase = inv ? 2.0*M_PI/len : -2.0*M_PI/len;
+
+    /* Too few lanes to beat separate split-radix transforms */
+    if (opts->nb_batch < 4)
+        return AVERROR(ENOSYS);
+
+    s->nb_batch = opts->nb_batch;
+
+    if (!(s->map = av_malloc(len*sizeof(*s->map))) ||
+        !(s->exp = av_malloc(len*sizeof(*s->exp))) ||
+        !(s->tmp = av_malloc(s->nb_batch*sizeof(*s->tmp))))
+        return AVERROR(ENOMEM);
+
+    for (int i = 0; i < len; i++) {
+        int rev = 0;
+        for (int j = 0; j < bits; j++)
+            rev |= ((i >> j) & 1) << (bits - 1 - j);
+        s->map[i] = rev;
+    }
+
+    /* Radix-4 butterflies need up to 3/4 of the circle */
+    for (int i = 0; i < len; i++) {
+        s->exp[i].re = RESCALE(cos(phase*i));
+        s->exp[i].im = RESCALE(sin(phase*i));
+    }
+
+    return 0;
+}
+
+/* Radix-4 FFT over interleaved transforms. The innermost loops run over the
+ * transforms, so each twiddle is loaded once per butterfly for all of them,
+ * and the loops vectorize with lanes spanning transforms. */
+static void TX_NAME(ff_tx_fft_batch)(AVTXContext *s, void *_dst,
+                                     void *_src, ptrdiff_t stride)
+{
+    TXComplex *src = _src;
+    TXComplex *dst = _dst;
+    const TXComplex *exp = s->exp;
+    const int len = s->len;
+    const int nb = s->nb_batch;
+    const int inv = s->inv;
+    const size_t row = nb*sizeof(*dst);
+    int m = 1;
+
+    if (src != dst) {
+        for (int i = 0; i < len; i++)
+            memcpy(dst + s->map[i]*nb, src + i*nb, row);
+    } else {
+        for (int i = 0; i < len; i++) {
+            const int j = s->map[i];
+            if (j > i) {
+                memcpy(s->tmp,      dst + i*nb, row);
+                memcpy(dst + i*nb,  dst + j*nb, row);
+                memcpy(dst + j*nb,  s->tmp,     row);
+            }
+        }
+    }
+
+    /* Odd power of two: start with a twiddle-less radix-2 pass */
+    if (av_log2(len) & 1) {
+        for (int k = 0; k < len; k += 2) {
+            TXComplex *a = dst + k*nb;
+            TXComplex *b = a + nb;
+
+            for (int n = 0; n < nb; n++) {
+                TXComplex t = b[n];
+                BF(b[n].re, a[n].re, a[n].re, t.re);
+                BF(b[n].im, a[n].im, a[n].im, t.im);
+            }
+        }
+        m = 2;
+    }
+
+    for (; m < len; m <<= 2) {
+        const int step = len / (m << 2);
+
+        for (int k = 0; k < len; k += m << 2) {
+            for (int j = 0; j < m; j++) {
+                const TXComplex w1 = exp[1*j*step];
+                const TXComplex w2 = exp[2*j*step];
+                const TXComplex w3 = exp[3*j*step];
+                TXComplex *x0 = dst + (k + j)*nb;
+                TXComplex *x1 = x0 + 1*m*nb;
+                TXComplex *x2 = x0 + 2*m*nb;
+                TXComplex *x3 = x0 + 3*m*nb;
+
+                for (int n = 0; n < nb; n++) {
+                    TXComplex t0 = x0[n], t1, t2, t3, a, b, c, d, e;
+
+                    /* Bit reversal leaves the odd quarter in x2 */
+                    CMUL3(t1, x2[n], w1);
+                    CMUL3(t2, x1[n], w2);
+                    CMUL3(t3, x3[n], w3);
+
+                    BF(b.re, a.re, t0.re, t2.re);
+                    BF(b.im, a.im, t0.im, t2.im);
+                    BF(d.re, c.re, t1.re, t3.re);
+                    BF(d.im, c.im, t1.im, t3.im);
+
+                    if (inv)
+                        CMUL_I_FORWARD2(e, d);
+                    else
+                        CMUL_I_INVERSE2(e, d);
+
+                    BF(x2[n].re, x0[n].re, a.re, c.re);
+                    BF(x2[n].im, x0[n].im, a.im, c.im);
+                    BF(x3[n].re, x1[n].re, b.re, e.re);
+                    BF(x3[n].im, x1[n].im, b.im, e.im);
+                }
+            }
+        }
+    }
+}
+
+static const FFTXCodelet TX_NAME(ff_tx_fft_batch_def) = {
+    .name       = TX_NAME_STR("fft_batch"),
+    .function   = TX_NAME(ff_tx_fft_batch),
+    .type       = TX_TYPE(FFT),
+    .flags      = AV_TX_UNALIGNED | FF_TX_OUT_OF_PLACE | AV_TX_INPLACE |
+                  FF_TX_BATCHED,
+    .factors[0] = 2,
+    .nb_factors = 1,
+    .min_len    = 2,
+    .max_len    = TX_LEN_UNLIMITED,
+    .init       = TX_NAME(ff_tx_fft_batch_init),
+    .cpu_flags  = FF_TX_CPU_FLAGS_ALL,
+    .prio       = FF_TX_PRIO_BASE,
+};
+
+static av_cold int TX_NAME(ff_tx_fft_batch_split_init)(AVTXContext *s,
+                                                       const FFTXCodelet *cd,
+                                                       uint64_t flags,
+                                                       FFTXCodeletOptions *opts,
+                                                       int len, int inv,
+                                                       const void *scale)
+{
+    int ret;
+
+    s->nb_batch = opts->nb_batch;
+
+    flags &= ~(FF_TX_BATCHED | AV_TX_INPLACE | AV_TX_UNALIGNED);
+    flags |= FF_TX_OUT_OF_PLACE | FF_TX_ALIGNED;
+
+    if ((ret = ff_tx_init_subtx(s, TX_TYPE(FFT), flags, NULL, len, inv, scale)))
+        return ret;
+
+    if (!(s->tmp = av_malloc(2*FFALIGN(len, 16)*sizeof(*s->tmp))))
+        return AVERROR(ENOMEM);
+
+    return 0;
+}
+
+/* Any length: deinterleave each transform, run a regular FFT on it and
+ * interleave the result back. */
+static void TX_NAME(ff_tx_fft_batch_split)(AVTXContext *s, void *_dst,
+                                           void *_src, ptrdiff_t stride)
+{
+    TXComplex *src = _src;
+    TXComplex *dst = _dst;
+    TXComplex *in  = s->tmp;
+    TXComplex *out = s->tmp + FFALIGN(s->len, 16);
+    const int len = s->len;
+    const int nb = s->nb_batch;
+
+    for (int n = 0; n < nb; n++) {
+        for (int i = 0; i < len; i++)
+            in[i] = src[i*nb + n];
+
+        s->fn[0](&s->sub[0], out, in, sizeof(*out));
+
+        for (int i = 0; i < len; i++)
+            dst[i*nb + n] = out[i];
+    }
+}
+
+static const FFTXCodelet TX_NAME(ff_tx_fft_batch_split_def) = {
+    .name       = TX_NAME_STR("fft_batch_split"),
+    .function   = TX_NAME(ff_tx_fft_batch_split),
+    .type       = TX_TYPE(FFT),
+    .flags      = AV_TX_UNALIGNED | FF_TX_OUT_OF_PLACE | AV_TX_INPLACE |
+                  FF_TX_BATCHED,
+    .factors[0] = TX_FACTOR_ANY,
+    .nb_factors = 1,
+    .min_len    = 2,
+    .max_len    = TX_LEN_UNLIMITED,
+    .init       = TX_NAME(ff_tx_fft_batch_split_init),
+    .cpu_flags  = FF_TX_CPU_FLAGS_ALL,
+    .prio       = FF_TX_PRIO_BASE - 256,
+};
+
 static av_cold int TX_NAME(ff_tx_fft_init_naive_small)(AVTXContext *s,
                                                        const FFTXCodelet *cd,
                                                        uint64_t flags,
@@ -4811,6 +5009,8 @@ const FFTXCodelet * const TX_NAME(ff_tx_codelet_list)[] = {
     &TX_NAME(ff_tx_fft_def),
     &TX_NAME(ff_tx_fft_inplace_def),
     &TX_NAME(ff_tx_fft_inplace_small_def),
+    &TX_NAME(ff_tx_fft_batch_def),
+    &TX_NAME(ff_tx_fft_batch_split_def),
     &TX_NAME(ff_tx_fft_pfa_def),
     &TX_NAME(ff_tx_fft_pfa_slow_def),
     &TX_NAME(ff_tx_fft_pfa_slow_ns_def),
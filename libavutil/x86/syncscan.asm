@@ -0,0 +1,159 @@
+;******************************************************************************
+;* SIMD start code and sync word scanning
+;*
+;* This file is part of Librempeg
+;*
+;* Librempeg is free software; you can redistribute it and/or modify
+;* it under the terms of the GNU General Public License as published by
+;* the Free Software Foundation; either version 3 of the License, or
+;* (at your option) any later version.
+;*
+;* Librempeg is distributed in the hope that it will be useful,
+;* but WITHOUT ANY WARRANTY; without even the implied warranty of
+;* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+;* GNU General Public License for more details.
+;*
+;* You should have received a copy of the GNU General Public License along
+;* with Librempeg; if not, write to the Free Software Foundation, Inc.,
+;* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+;******************************************************************************
+
+%include "libavutil/x86/x86util.asm"
+
+SECTION .text
+
+; splat the low byte of a gpr
+%macro SPLATB_GPR 2 ; dst register number, src gpr
+    movd           xm%1, %2d
+%if cpuflag(avx2)
+    vpbroadcastb    m%1, xm%1
+%else
+    punpcklbw       m%1, m%1
+    pshuflw         m%1, m%1, 0
+    punpcklqdq      m%1, m%1
+%endif
+%endmacro
+
+;-----------------------------------------------------------------------------
+; int ff_find_start_code(const uint8_t *buf, int size)
+;-----------------------------------------------------------------------------
+%macro FIND_START_CODE 0
+cglobal find_start_code, 2, 5, 5, buf, size, i, end, tmp
+    movsxdifnidn sizeq, sized
+    pcmpeqb         m4, m4
+    pxor            m3, m3
+    psubb           m3, m4          ; 0x01
+    pxor            m4, m4          ; 0x00
+    xor             iq, iq
+    lea           endq, [sizeq - mmsize - 2]
+    cmp             iq, endq
+    jg .tail
+.loop:
+    movu            m0, [bufq + iq]
+    movu            m1, [bufq + iq + 1]
+    movu            m2, [bufq + iq + 2]
+    pcmpeqb         m0, m4
+    pcmpeqb         m1, m4
+    pcmpeqb         m2, m3
+    pand            m0, m1
+    pand            m0, m2
+    pmovmskb      tmpd, m0
+    test          tmpd, tmpd
+    jnz .found
+    add             iq, mmsize
+    cmp             iq, endq
+    jle .loop
+.tail:
+    lea           endq, [sizeq - 2]
+    jmp .tail_cond
+.tail_loop:
+    cmp   byte [bufq + iq], 0
+    jne .tail_next
+    cmp   byte [bufq + iq + 1], 0
+    jne .tail_next
+    cmp   byte [bufq + iq + 2], 1
+    je .end
+.tail_next:
+    inc             iq
+.tail_cond:
+    cmp             iq, endq
+    jl .tail_loop
+    mov             iq, sizeq
+    jmp .end
+.found:
+    bsf           tmpd, tmpd
+    add             iq, tmpq
+.end:
+    mov            eax, id
+    RET
+%endmacro
+
+INIT_XMM sse2
+FIND_START_CODE
+%if HAVE_AVX2_EXTERNAL
+INIT_YMM avx2
+FIND_START_CODE
+%endif
+
+;-----------------------------------------------------------------------------
+; int ff_find_sync_word(const uint8_t *buf, int size,
+;                       unsigned sync, unsigned mask)
+;-----------------------------------------------------------------------------
+%macro FIND_SYNC_WORD 0
+cglobal find_sync_word, 4, 7, 6, buf, size, sync, mask, i, end, tmp
+    movsxdifnidn sizeq, sized
+    mov           tmpd, syncd
+    shr           tmpd, 8
+    SPLATB_GPR       2, tmp         ; sync >> 8
+    SPLATB_GPR       3, sync        ; sync & 0xff
+    mov           tmpd, maskd
+    shr           tmpd, 8
+    SPLATB_GPR       4, tmp         ; mask >> 8
+    SPLATB_GPR       5, mask        ; mask & 0xff
+    xor             iq, iq
+    lea           endq, [sizeq - mmsize - 1]
+    cmp             iq, endq
+    jg .tail
+.loop:
+    movu            m0, [bufq + iq]
+    movu            m1, [bufq + iq + 1]
+    pand            m0, m4
+    pand            m1, m5
+    pcmpeqb         m0, m2
+    pcmpeqb         m1, m3
+    pand            m0, m1
+    pmovmskb      tmpd, m0
+    test          tmpd, tmpd
+    jnz .found
+    add             iq, mmsize
+    cmp             iq, endq
+    jle .loop
+.tail:
+    lea           endq, [sizeq - 1]
+    jmp .tail_cond
+.tail_loop:
+    movzx         tmpd, word [bufq + iq]
+    rol           tmpw, 8
+    and           tmpd, maskd
+    cmp           tmpd, syncd
+    je .end
+    inc             iq
+.tail_cond:
+    cmp             iq, endq
+    jl .tail_loop
+    mov             iq, sizeq
+    jmp .end
+.found:
+    bsf           tmpd, tmpd
+    add             iq, tmpq
+.end:
+    mov            eax, id
+    RET
+%endmacro
+
+INIT_XMM sse2
+FIND_SYNC_WORD
+%if HAVE_AVX2_EXTERNAL
+INIT_YMM avx2
+FIND_SYNC_WORD
+%endif
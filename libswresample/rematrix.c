@@ -567,8 +567,83 @@ av_cold void swri_rematrix_free(SwrContext *s){
     av_freep(&s->native_simd_matrix);
 }
 
+typedef struct RematrixThreadData {
+    SwrContext *s;
+    AudioData *out, *in;
+    int len, len1, off;
+    int mustcopy;
+} RematrixThreadData;
+
+static void rematrix_channel(void *arg, int out_i)
+{
+    RematrixThreadData *td = arg;
+    SwrContext *s = td->s;
+    AudioData *out = td->out, *in = td->in;
+    int len = td->len, len1 = td->len1, off = td->off;
+    int in_i, i, j;
+
+    switch(s->matrix_ch[out_i][0]){
+    case 0:
+        if(td->mustcopy)
+            memset(out->ch[out_i], 0, len * av_get_bytes_per_sample(s->int_sample_fmt));
+        break;
+    case 1:
+        in_i= s->matrix_ch[out_i][1];
+        if(s->matrix[out_i][in_i]!=1.0){
+            if(s->mix_1_1_simd && len1)
+                s->mix_1_1_simd(out->ch[out_i]    , in->ch[in_i]    , s->native_simd_matrix, in->ch_count*out_i + in_i, len1);
+            if(len != len1)
+                s->mix_1_1_f   (out->ch[out_i]+off, in->ch[in_i]+off, s->native_matrix, in->ch_count*out_i + in_i, len-len1);
+        }else if(td->mustcopy){
+            memcpy(out->ch[out_i], in->ch[in_i], len*out->bps);
+        }else{
+            out->ch[out_i]= in->ch[in_i];
+        }
+        break;
+    case 2: {
+        int in_i1 = s->matrix_ch[out_i][1];
+        int in_i2 = s->matrix_ch[out_i][2];
+        if(s->mix_2_1_simd && len1)
+            s->mix_2_1_simd(out->ch[out_i]    , in->ch[in_i1]    , in->ch[in_i2]    , s->native_simd_matrix, in->ch_count*out_i + in_i1, in->ch_count*out_i + in_i2, len1);
+        else
+            s->mix_2_1_f   (out->ch[out_i]    , in->ch[in_i1]    , in->ch[in_i2]    , s->native_matrix, in->ch_count*out_i + in_i1, in->ch_count*out_i + in_i2, len1);
+        if(len != len1)
+            s->mix_2_1_f   (out->ch[out_i]+off, in->ch[in_i1]+off, in->ch[in_i2]+off, s->native_matrix, in->ch_count*out_i + in_i1, in->ch_count*out_i + in_i2, len-len1);
+        break;}
+    default:
+        if(s->int_sample_fmt == AV_SAMPLE_FMT_FLTP){
+            for(i=0; i<len; i++){
+                float v=0;
+                for(j=0; j<s->matrix_ch[out_i][0]; j++){
+                    in_i= s->matrix_ch[out_i][1+j];
+                    v+= ((float*)in->ch[in_i])[i] * s->matrix_flt[out_i][in_i];
+                }
+                ((float*)out->ch[out_i])[i]= v;
+            }
+        }else if(s->int_sample_fmt == AV_SAMPLE_FMT_DBLP){
+            for(i=0; i<len; i++){
+                double v=0;
+                for(j=0; j<s->matrix_ch[out_i][0]; j++){
+                    in_i= s->matrix_ch[out_i][1+j];
+                    v+= ((double*)in->ch[in_i])[i] * s->matrix[out_i][in_i];
+                }
+                ((double*)out->ch[out_i])[i]= v;
+            }
+        }else{
+            for(i=0; i<len; i++){
+                int v=0;
+                for(j=0; j<s->matrix_ch[out_i][0]; j++){
+                    in_i= s->matrix_ch[out_i][1+j];
+                    v+= ((int16_t*)in->ch[in_i])[i] * s->matrix32[out_i][in_i];
+                }
+                ((int16_t*)out->ch[out_i])[i]= (v + 16384)>>15;
+            }
+        }
+    }
+}
+
 int swri_rematrix(SwrContext *s, AudioData *out, AudioData *in, int len, int mustcopy){
-    int out_i, in_i, i, j;
+    RematrixThreadData td;
     int len1 = 0;
     int off = 0;
 
@@ -585,65 +660,7 @@ int swri_rematrix(SwrContext *s, AudioData *out, AudioData *in, int len, int mus
     av_assert0(s->out_ch_layout.order == AV_CHANNEL_ORDER_UNSPEC || out->ch_count == s->out_ch_layout.nb_channels);
     av_assert0(s-> in_ch_layout.order == AV_CHANNEL_ORDER_UNSPEC || in ->ch_count == s->in_ch_layout.nb_channels);
 
-    for(out_i=0; out_i<out->ch_count; out_i++){
-        switch(s->matrix_ch[out_i][0]){
-        case 0:
-            if(mustcopy)
-                memset(out->ch[out_i], 0, len * av_get_bytes_per_sample(s->int_sample_fmt));
-            break;
-        case 1:
-            in_i= s->matrix_ch[out_i][1];
-            if(s->matrix[out_i][in_i]!=1.0){
-                if(s->mix_1_1_simd && len1)
-                    s->mix_1_1_simd(out->ch[out_i]    , in->ch[in_i]    , s->native_simd_matrix, in->ch_count*out_i + in_i, len1);
-                if(len != len1)
-                    s->mix_1_1_f   (out->ch[out_i]+off, in->ch[in_i]+off, s->native_matrix, in->ch_count*out_i + in_i, len-len1);
-            }else if(mustcopy){
-                memcpy(out->ch[out_i], in->ch[in_i], len*out->bps);
-            }else{
-                out->ch[out_i]= in->ch[in_i];
-            }
-            break;
-        case 2: {
-            int in_i1 = s->matrix_ch[out_i][1];
-            int in_i2 = s->matrix_ch[out_i][2];
-            if(s->mix_2_1_simd && len1)
-                s->mix_2_1_simd(out->ch[out_i]    , in->ch[in_i1]    , in->ch[in_i2]    , s->native_simd_matrix, in->ch_count*out_i + in_i1, in->ch_count*out_i + in_i2, len1);
-            else
-                s->mix_2_1_f   (out->ch[out_i]    , in->ch[in_i1]    , in->ch[in_i2]    , s->native_matrix, in->ch_count*out_i + in_i1, in->ch_count*out_i + in_i2, len1);
-            if(len != len1)
-                s->mix_2_1_f   (out->ch[out_i]+off, in->ch[in_i1]+off, in->ch[in_i2]+off, s->native_matrix, in->ch_count*out_i + in_i1, in->ch_count*out_i + in_i2, len-len1);
-            break;}
-        default:
-            if(s->int_sample_fmt == AV_SAMPLE_FMT_FLTP){
-                for(i=0; i<len; i++){
-                    float v=0;
-                    for(j=0; j<s->matrix_ch[out_i][0]; j++){
-                        in_i= s->matrix_ch[out_i][1+j];
-                        v+= ((float*)in->ch[in_i])[i] * s->matrix_flt[out_i][in_i];
-                    }
-                    ((float*)out->ch[out_i])[i]= v;
-                }
-            }else if(s->int_sample_fmt == AV_SAMPLE_FMT_DBLP){
-                for(i=0; i<len; i++){
-                    double v=0;
-                    for(j=0; j<s->matrix_ch[out_i][0]; j++){
-                        in_i= s->matrix_ch[out_i][1+j];
-                        v+= ((double*)in->ch[in_i])[i] * s->matrix[out_i][in_i];
-                    }
-                    ((double*)out->ch[out_i])[i]= v;
-                }
-            }else{
-                for(i=0; i<len; i++){
-                    int v=0;
-                    for(j=0; j<s->matrix_ch[out_i][0]; j++){
-                        in_i= s->matrix_ch[out_i][1+j];
-                        v+= ((int16_t*)in->ch[in_i])[i] * s->matrix32[out_i][in_i];
-                    }
-                    ((int16_t*)out->ch[out_i])[i]= (v + 16384)>>15;
-                }
-            }
-        }
-    }
+    td = (RematrixThreadData){ s, out, in, len, len1, off, mustcopy };
+    swri_execute_channels(s, rematrix_channel, &td, out->ch_count);
     return 0;
 }
@@ -28,8 +28,29 @@
 
 #include "libavutil/avassert.h"
 #include "libavutil/mem.h"
+#include "libavutil/thread.h"
 #include "resample.h"
 
+/**
+ * Filter banks are read-only once built, so contexts with identical filter
+ * parameters share a single refcounted copy.
+ */
+typedef struct FilterBankEntry {
+    struct FilterBankEntry *next;
+    enum AVSampleFormat format;
+    enum SwrFilterType filter_type;
+    double factor;
+    double kaiser_beta;
+    int phase_count;
+    int filter_length;
+    int filter_alloc;
+    unsigned refcount;
+    uint8_t *filter_bank;
+} FilterBankEntry;
+
+static AVMutex filter_bank_mutex = AV_MUTEX_INITIALIZER;
+static FilterBankEntry *filter_bank_cache;
+
 /**
  * builds a polyphase filterbank.
  * @param factor resampling factor
@@ -173,11 +194,125 @@ fail:
     return ret;
 }
 
+static FilterBankEntry *find_filter_bank(const ResampleContext *c)
+{
+    FilterBankEntry *e;
+
+    for (e = filter_bank_cache; e; e = e->next) {
+        if (e->format        == c->format        &&
+            e->filter_type   == c->filter_type   &&
+            e->factor        == c->factor        &&
+            e->kaiser_beta   == c->kaiser_beta   &&
+            e->phase_count   == c->phase_count   &&
+            e->filter_length == c->filter_length &&
+            e->filter_alloc  == c->filter_alloc)
+            return e;
+    }
+    return NULL;
+}
+
+static uint8_t *build_filter_bank(ResampleContext *c)
+{
+    uint8_t *filter_bank = av_calloc(c->filter_alloc, (c->phase_count+1)*c->felem_size);
+
+    if (!filter_bank)
+        return NULL;
+    if (build_filter(c, (void*)filter_bank, c->factor, c->filter_length, c->filter_alloc, c->phase_count, 1<<c->filter_shift, c->filter_type, c->kaiser_beta)) {
+        av_free(filter_bank);
+        return NULL;
+    }
+    memcpy(filter_bank + (c->filter_alloc*c->phase_count+1)*c->felem_size, filter_bank, (c->filter_alloc-1)*c->felem_size);
+    memcpy(filter_bank + (c->filter_alloc*c->phase_count  )*c->felem_size, filter_bank + (c->filter_alloc - 1)*c->felem_size, c->felem_size);
+    return filter_bank;
+}
+
+static int get_filter_bank(ResampleContext *c)
+{
+    FilterBankEntry *e, *new_e;
+    uint8_t *filter_bank;
+
+    ff_mutex_lock(&filter_bank_mutex);
+    e = find_filter_bank(c);
+    if (e)
+        e->refcount++;
+    ff_mutex_unlock(&filter_bank_mutex);
+
+    if (!e) {
+        /* build outside of the lock, another thread may have inserted an
+         * identical bank meanwhile, in which case ours is discarded */
+        filter_bank = build_filter_bank(c);
+        if (!filter_bank)
+            return AVERROR(ENOMEM);
+
+        new_e = av_mallocz(sizeof(*new_e));
+        if (!new_e) {
+            /* still usable, just not shared */
+            c->filter_bank = filter_bank;
+            return 0;
+        }
+
+        ff_mutex_lock(&filter_bank_mutex);
+        e = find_filter_bank(c);
+        if (e) {
+            e->refcount++;
+        } else {
+            e = new_e;
+            e->format        = c->format;
+            e->filter_type   = c->filter_type;
+            e->factor        = c->factor;
+            e->kaiser_beta   = c->kaiser_beta;
+            e->phase_count   = c->phase_count;
+            e->filter_length = c->filter_length;
+            e->filter_alloc  = c->filter_alloc;
+            e->refcount      = 1;
+            e->filter_bank   = filter_bank;
+            e->next          = filter_bank_cache;
+            filter_bank_cache = e;
+            new_e = NULL;
+            filter_bank = NULL;
+        }
+        ff_mutex_unlock(&filter_bank_mutex);
+
+        av_free(new_e);
+        av_free(filter_bank);
+    }
+
+    c->filter_bank       = e->filter_bank;
+    c->filter_bank_entry = e;
+    return 0;
+}
+
+static void release_filter_bank(ResampleContext *c)
+{
+    FilterBankEntry *e = c->filter_bank_entry, **p;
+
+    if (!e) {
+        av_freep(&c->filter_bank);
+        return;
+    }
+
+    ff_mutex_lock(&filter_bank_mutex);
+    if (!--e->refcount) {
+        for (p = &filter_bank_cache; *p != e; p = &(*p)->next)
+            ;
+        *p = e->next;
+    } else
+        e = NULL;
+    ff_mutex_unlock(&filter_bank_mutex);
+
+    if (e) {
+        av_free(e->filter_bank);
+        av_free(e);
+    }
+    c->filter_bank       = NULL;
+    c->filter_bank_entry = NULL;
+}
+
 static void resample_free(ResampleContext **cc){
     ResampleContext *c = *cc;
     if(!c)
         return;
-    av_freep(&c->filter_bank);
+    release_filter_bank(c);
     av_freep(cc);
 }
 
@@ -242,16 +377,11 @@ static ResampleContext *resample_init(ResampleContext *c, int out_rate, int in_r
         c->factor        = factor;
         c->filter_length = filter_length;
         c->filter_alloc  = FFALIGN(c->filter_length, 8);
-        c->filter_bank   = av_calloc(c->filter_alloc, (phase_count+1)*c->felem_size);
         c->filter_type   = filter_type;
         c->kaiser_beta   = kaiser_beta;
         c->phase_count_compensation = phase_count_compensation;
-        if (!c->filter_bank)
+        if (get_filter_bank(c) < 0)
             goto error;
-        if (build_filter(c, (void*)c->filter_bank, factor, c->filter_length, c->filter_alloc, phase_count, 1<<c->filter_shift, filter_type, kaiser_beta))
-            goto error;
-        memcpy(c->filter_bank + (c->filter_alloc*phase_count+1)*c->felem_size, c->filter_bank, (c->filter_alloc-1)*c->felem_size);
-        memcpy(c->filter_bank + (c->filter_alloc*phase_count  )*c->felem_size, c->filter_bank + (c->filter_alloc - 1)*c->felem_size, c->felem_size);
     }
 
     c->compensation_distance= 0;
@@ -272,7 +402,7 @@ static ResampleContext *resample_init(ResampleContext *c, int out_rate, int in_r
 
     return c;
 error:
-    av_freep(&c->filter_bank);
+    release_filter_bank(c);
     av_free(c);
     return NULL;
 }
@@ -320,7 +450,7 @@ static int rebuild_filter_bank_with_compensation(ResampleContext *c)
     c->dst_incr_mod   = c->dst_incr % c->src_incr;
     c->index         *= phase_count / c->phase_count;
     c->phase_count    = phase_count;
-    av_freep(&c->filter_bank);
+    release_filter_bank(c);
     c->filter_bank = new_filter_bank;
     return 0;
 }
@@ -346,7 +476,21 @@ static int set_compensation(ResampleContext *c, int sample_delta, int compensati
     return 0;
 }
 
-static int multiple_resample(ResampleContext *c, AudioData *dst, int dst_size, AudioData *src, int src_size, int *consumed){
+typedef struct ResampleThreadData {
+    ResampleContext *c;
+    AudioData *dst, *src;
+    int dst_size;
+    int (*resample_func)(struct ResampleContext *c, void *dst,
+                         const void *src, int n, int update_ctx);
+} ResampleThreadData;
+
+static void resample_channel(void *arg, int ch)
+{
+    ResampleThreadData *td = arg;
+    td->resample_func(td->c, td->dst->ch[ch], td->src->ch[ch], td->dst_size, 0);
+}
+
+static int multiple_resample(struct SwrContext *s, ResampleContext *c, AudioData *dst, int dst_size, AudioData *src, int src_size, int *consumed){
     int i;
     int64_t max_src_size = (INT64_MAX/2 / c->phase_count) / c->src_incr;
 
@@ -388,8 +532,17 @@ static int multiple_resample(ResampleContext *c, AudioData *dst, int dst_size, A
              * when frac and dst_incr_mod are zero */
             resample_func = (c->linear && (c->frac || c->dst_incr_mod)) ?
                             c->dsp.resample_linear : c->dsp.resample_common;
-            for (i = 0; i < dst->ch_count; i++)
-                *consumed = resample_func(c, dst->ch[i], src->ch[i], dst_size, i+1 == dst->ch_count);
+            if (s->slicethread) {
+                /* all but the last channel leave the context untouched and
+                 * can run concurrently, the last one updates the state */
+                ResampleThreadData td = { c, dst, src, dst_size, resample_func };
+                i = dst->ch_count - 1;
+                swri_execute_channels(s, resample_channel, &td, i);
+                *consumed = resample_func(c, dst->ch[i], src->ch[i], dst_size, 1);
+            } else {
+                for (i = 0; i < dst->ch_count; i++)
+                    *consumed = resample_func(c, dst->ch[i], src->ch[i], dst_size, i+1 == dst->ch_count);
+            }
         }
     }
 
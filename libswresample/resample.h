@@ -49,6 +49,7 @@ typedef struct ResampleContext {
     int felem_size;
     int filter_shift;
     int phase_count_compensation;      /* desired phase_count when compensation is enabled */
+    struct FilterBankEntry *filter_bank_entry; /* shared cache entry owning filter_bank, NULL if private */
 
     struct {
         void (*resample_one)(void *dst, const void *src,
@@ -25,6 +25,7 @@
 #include "libavutil/avassert.h"
 #include "libavutil/channel_layout.h"
 #include "libavutil/internal.h"
+#include "libavutil/slicethread.h"
 
 #include <float.h>
 
@@ -129,11 +130,33 @@ static void clear_context(SwrContext *s){
     swri_audio_convert_free(&s->out_convert);
     swri_audio_convert_free(&s->full_convert);
     swri_rematrix_free(s);
+    avpriv_slicethread_free(&s->slicethread);
 
     s->delayed_samples_fixup = 0;
     s->flushed = 0;
 }
 
+static void channel_worker(void *priv, int jobnr, int threadnr, int nb_jobs, int nb_threads)
+{
+    SwrContext *s = priv;
+    s->channel_func(s->channel_arg, jobnr);
+}
+
+void swri_execute_channels(SwrContext *s, void (*func)(void *arg, int ch), void *arg, int nb_channels)
+{
+    int ch;
+
+    if (!s->slicethread || nb_channels < 2) {
+        for (ch = 0; ch < nb_channels; ch++)
+            func(arg, ch);
+        return;
+    }
+
+    s->channel_func = func;
+    s->channel_arg  = arg;
+    avpriv_slicethread_execute(s->slicethread, nb_channels, 0);
+}
+
 av_cold void swr_free(SwrContext **ss){
     SwrContext *s= *ss;
     if(s){
@@ -398,6 +421,19 @@ av_assert0(s->out.ch_count);
             goto fail;
     }
 
+    if (s->nb_threads != 1 && (s->resample || s->rematrix) &&
+        FFMAX(s->used_ch_layout.nb_channels, s->out.ch_count) > 1) {
+        ret = avpriv_slicethread_create(&s->slicethread, s, channel_worker, NULL, s->nb_threads);
+        if (ret == AVERROR(ENOSYS)) {
+            av_log(s, AV_LOG_WARNING, "Threading is not supported, using a single thread\n");
+        } else if (ret < 0) {
+            goto fail;
+        } else if (ret == 1) {
+            avpriv_slicethread_free(&s->slicethread);
+        } else
+            av_log(s, AV_LOG_DEBUG, "Using %d threads\n", ret);
+    }
+
     return 0;
 fail:
     swr_close(s);
@@ -523,7 +559,7 @@ static int resample(SwrContext *s, AudioData *out_param, int out_count,
         int ret, size, consumed;
         if(!s->resample_in_constraint && s->in_buffer_count){
             buf_set(&tmp, &s->in_buffer, s->in_buffer_index);
-            ret= s->resampler->multiple_resample(s->resample, &out, out_count, &tmp, s->in_buffer_count, &consumed);
+            ret= s->resampler->multiple_resample(s, s->resample, &out, out_count, &tmp, s->in_buffer_count, &consumed);
             out_count -= ret;
             ret_sum += ret;
             buf_set(&out, &out, ret);
@@ -543,7 +579,7 @@ static int resample(SwrContext *s, AudioData *out_param, int out_count,
 
         if((s->flushed || in_count > padless) && !s->in_buffer_count){
             s->in_buffer_index=0;
-            ret= s->resampler->multiple_resample(s->resample, &out, out_count, &in, FFMAX(in_count-padless, 0), &consumed);
+            ret= s->resampler->multiple_resample(s, s->resample, &out, out_count, &in, FFMAX(in_count-padless, 0), &consumed);
             out_count -= ret;
             ret_sum += ret;
             buf_set(&out, &out, ret);
@@ -0,0 +1,176 @@
+/*
+ * Check that multi-threaded resampling and rematrixing produce output
+ * identical to the single threaded path, for 2 to 64 channels.
+ * With -bench, also print the conversion time for each thread count.
+ *
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "libavutil/channel_layout.h"
+#include "libavutil/mem.h"
+#include "libavutil/opt.h"
+#include "libavutil/samplefmt.h"
+#include "libavutil/time.h"
+#include "libswresample/swresample.h"
+
+#define IN_RATE   44100
+#define OUT_RATE  48000
+#define IN_COUNT  (IN_RATE / 4)
+#define OUT_COUNT (IN_COUNT * 2)
+
+static int convert(int in_ch, int out_ch, int linear, int threads,
+                   float **in, float **out, int64_t *elapsed)
+{
+    SwrContext *swr = swr_alloc();
+    AVChannelLayout in_layout, out_layout;
+    int n, total = 0, ret;
+    int64_t t;
+
+    if (!swr)
+        return AVERROR(ENOMEM);
+
+    av_channel_layout_default(&in_layout,  in_ch);
+    av_channel_layout_default(&out_layout, out_ch);
+    av_opt_set_chlayout  (swr, "in_chlayout",     &in_layout,       0);
+    av_opt_set_chlayout  (swr, "out_chlayout",    &out_layout,      0);
+    av_opt_set_int       (swr, "in_sample_rate",  IN_RATE,          0);
+    av_opt_set_int       (swr, "out_sample_rate", OUT_RATE,         0);
+    av_opt_set_sample_fmt(swr, "in_sample_fmt",   AV_SAMPLE_FMT_FLTP, 0);
+    av_opt_set_sample_fmt(swr, "out_sample_fmt",  AV_SAMPLE_FMT_FLTP, 0);
+    av_opt_set_int       (swr, "filter_size",     128,              0);
+    av_opt_set_int       (swr, "linear_interp",   linear,           0);
+    av_opt_set_int       (swr, "threads",         threads,          0);
+
+    if (in_ch != out_ch) {
+        /* downmix pairs of channels, large unspecified layouts need an explicit matrix */
+        double matrix[64 * 64] = { 0 };
+        for (int ch = 0; ch < out_ch; ch++)
+            matrix[ch * in_ch + 2 * ch] = matrix[ch * in_ch + 2 * ch + 1] = 0.5;
+        if ((ret = swr_set_matrix(swr, matrix, in_ch)) < 0)
+            goto end;
+    }
+
+    if ((ret = swr_init(swr)) < 0)
+        goto end;
+
+    t = av_gettime_relative();
+    ret = swr_convert(swr, (uint8_t **)out, OUT_COUNT, (const uint8_t **)in, IN_COUNT);
+    if (ret < 0)
+        goto end;
+    total = ret;
+    for (;;) {
+        uint8_t *tail[64];
+        int ch;
+        for (ch = 0; ch < out_ch; ch++)
+            tail[ch] = (uint8_t *)(out[ch] + total);
+        n = swr_convert(swr, tail, OUT_COUNT - total, NULL, 0);
+        if (n <= 0)
+            break;
+        total += n;
+    }
+    *elapsed = av_gettime_relative() - t;
+    ret = n < 0 ? n : total;
+end:
+    swr_free(&swr);
+    return ret;
+}
+
+static void free_planes(float **p, int nb)
+{
+    for (int i = 0; i < nb; i++)
+        av_freep(&p[i]);
+}
+
+int main(int argc, char **argv)
+{
+    static const int channels[] = { 2, 8, 32, 64 };
+    static const int thread_counts[] = { 2, 4, 8 };
+    int bench = argc > 1 && !strcmp(argv[1], "-bench");
+    int ret = 0;
+
+    for (int c = 0; c < FF_ARRAY_ELEMS(channels); c++) {
+        for (int remix = 0; remix < 2; remix++) {
+            for (int linear = 0; linear < 2; linear++) {
+                int in_ch  = channels[c];
+                int out_ch = remix ? in_ch / 2 : in_ch;
+                float *in[64] = { NULL }, *ref[64] = { NULL }, *out[64] = { NULL };
+                int64_t elapsed;
+                int ref_count;
+
+                for (int ch = 0; ch < in_ch; ch++) {
+                    in[ch] = av_malloc_array(IN_COUNT, sizeof(**in));
+                    if (!in[ch])
+                        goto fail;
+                    for (int i = 0; i < IN_COUNT; i++)
+                        in[ch][i] = ((i * (ch + 3) * 2654435761U) >> 16 & 0xffff) / 32768.0f - 1.0f;
+                }
+                for (int ch = 0; ch < out_ch; ch++) {
+                    ref[ch] = av_calloc(OUT_COUNT, sizeof(**ref));
+                    out[ch] = av_calloc(OUT_COUNT, sizeof(**out));
+                    if (!ref[ch] || !out[ch])
+                        goto fail;
+                }
+
+                ref_count = convert(in_ch, out_ch, linear, 1, in, ref, &elapsed);
+                if (ref_count < 0)
+                    goto fail;
+                if (bench)
+                    printf("%2d->%2d ch linear=%d threads=1: %8"PRId64" us\n",
+                           in_ch, out_ch, linear, elapsed);
+
+                for (int t = 0; t < FF_ARRAY_ELEMS(thread_counts); t++) {
+                    int count = convert(in_ch, out_ch, linear, thread_counts[t], in, out, &elapsed);
+                    if (count < 0)
+                        goto fail;
+                    if (bench)
+                        printf("%2d->%2d ch linear=%d threads=%d: %8"PRId64" us\n",
+                               in_ch, out_ch, linear, thread_counts[t], elapsed);
+                    if (count != ref_count) {
+                        fprintf(stderr, "%d->%d channels, %d threads: %d samples instead of %d\n",
+                                in_ch, out_ch, thread_counts[t], count, ref_count);
+                        ret = 1;
+                    }
+                    for (int ch = 0; ch < out_ch; ch++) {
+                        if (memcmp(ref[ch], out[ch], ref_count * sizeof(**out))) {
+                            fprintf(stderr, "%d->%d channels, %d threads: channel %d differs\n",
+                                    in_ch, out_ch, thread_counts[t], ch);
+                            ret = 1;
+                        }
+                    }
+                }
+
+                free_planes(in,  in_ch);
+                free_planes(ref, out_ch);
+                free_planes(out, out_ch);
+                continue;
+fail:
+                fprintf(stderr, "conversion failed for %d->%d channels\n", in_ch, out_ch);
+                free_planes(in,  in_ch);
+                free_planes(ref, out_ch);
+                free_planes(out, out_ch);
+                return 1;
+            }
+        }
+    }
+
+    return ret;
+}
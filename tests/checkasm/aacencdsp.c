@@ -97,6 +97,43 @@ static void test_quant_bands(AACEncDSPContext *s)
     report("quant_bands");
 }
 
+static void test_cb_index(AACEncDSPContext *s)
+{
+    LOCAL_ALIGNED_32(int, quants, [96]);
+    LOCAL_ALIGNED_32(int, idx, [48]);
+    LOCAL_ALIGNED_32(int, idx2, [48]);
+
+    declare_func(void, int *, const int *, int, int, int, int);
+
+    for (int cb = 1; cb < 12; cb++) {
+        int dim     = cb < 5 ? 4 : 2;
+        int sign    = cb < 3 || cb == 5 || cb == 6;
+        int maxval  = aac_cb_maxval[cb];
+        int off     = sign ? maxval : 0;
+        int size    = 4 * (1 + rnd() % 24);
+
+        for (int i = 0; i < 96; i++) {
+            int q = rnd() % (maxval + 1);
+            quants[i] = sign && (rnd() & 1) ? -q : q;
+        }
+
+        if (check_func(s->cb_index, "cb_index_%d", cb)) {
+            memset(idx,  0, 48 * sizeof(*idx));
+            memset(idx2, 0, 48 * sizeof(*idx2));
+
+            call_ref(idx,  quants, size, dim, aac_cb_range[cb], off);
+            call_new(idx2, quants, size, dim, aac_cb_range[cb], off);
+
+            if (memcmp(idx, idx2, 48 * sizeof(*idx)))
+                fail();
+
+            bench_new(idx, quants, 96, dim, aac_cb_range[cb], off);
+        }
+    }
+
+    report("cb_index");
+}
+
 void checkasm_check_aacencdsp(void)
 {
     AACEncDSPContext s = { 0 };
@@ -104,4 +141,5 @@ void checkasm_check_aacencdsp(void)
 
     test_abs_pow34(&s);
     test_quant_bands(&s);
+    test_cb_index(&s);
 }
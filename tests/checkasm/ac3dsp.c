@@ -26,6 +26,7 @@
 #include "libavutil/mem_internal.h"
 
 #include "libavcodec/ac3dsp.h"
+#include "libavcodec/ac3tab.h"
 
 #include "checkasm.h"
 
@@ -190,6 +191,52 @@ static void check_ac3_sum_square_butterfly_float(AC3DSPContext *c) {
     report("ac3_sum_square_butterfly_float");
 }
 
+static void check_ac3_bit_alloc_calc_bap(AC3DSPContext *c) {
+    /* full bandwidth, coupling channel, LFE and a few odd ranges */
+    static const int ranges[][2] = {
+        { 0, 253 }, { 37, 229 }, { 0, 7 }, { 13, 181 }, { 1, 2 }, { 70, 86 },
+    };
+    LOCAL_ALIGNED_16(int16_t, mask, [64]);
+    LOCAL_ALIGNED_16(int16_t, psd, [MAX_COEFS]);
+    LOCAL_ALIGNED_16(uint8_t, bap0, [MAX_COEFS]);
+    LOCAL_ALIGNED_16(uint8_t, bap1, [MAX_COEFS]);
+
+    declare_func(void, int16_t *, int16_t *, int, int, int, int,
+                 const uint8_t *, uint8_t *);
+
+    for (int i = 0; i < FF_ARRAY_ELEMS(ranges); i++) {
+        int start = ranges[i][0], end = ranges[i][1];
+
+        if (check_func(c->bit_alloc_calc_bap, "ac3_bit_alloc_calc_bap_%d_%d",
+                       start, end)) {
+            for (int n = 0; n < 16; n++) {
+                /* -960 clears the whole array */
+                int snr_offset = n ? ((int)(rnd() % 1024) - 240) * 4 : -960;
+                int floor      = ff_ac3_floor_tab[rnd() & 7];
+
+                for (int j = 0; j < 64; j++)
+                    mask[j] = rnd() % 4096;
+                for (int j = 0; j < MAX_COEFS; j++)
+                    psd[j] = 3072 - (rnd() % 25) * 128;
+                memset(bap0, 0xAA, MAX_COEFS);
+                memset(bap1, 0xAA, MAX_COEFS);
+
+                call_ref(mask, psd, start, end, snr_offset, floor,
+                         ff_ac3_bap_tab, bap0);
+                call_new(mask, psd, start, end, snr_offset, floor,
+                         ff_ac3_bap_tab, bap1);
+
+                if (memcmp(bap0, bap1, MAX_COEFS))
+                    fail();
+            }
+            bench_new(mask, psd, start, end, 0, ff_ac3_floor_tab[4],
+                      ff_ac3_bap_tab, bap1);
+        }
+    }
+
+    report("ac3_bit_alloc_calc_bap");
+}
+
 void checkasm_check_ac3dsp(void)
 {
     AC3DSPContext c;
@@ -200,4 +247,5 @@ void checkasm_check_ac3dsp(void)
     check_float_to_fixed24(&c);
     check_ac3_sum_square_butterfly_int32(&c);
     check_ac3_sum_square_butterfly_float(&c);
+    check_ac3_bit_alloc_calc_bap(&c);
 }
@@ -0,0 +1,62 @@
+/*
+ * This file is part of Librempeg
+ *
+ * Librempeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Librempeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Librempeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+
+#include "libavutil/mem_internal.h"
+#include "libavcodec/adpcmdsp.h"
+
+#include "checkasm.h"
+
+#define BUF_SIZE 256
+
+static void check_unpack_nibbles(void (*unpack)(uint8_t *, const uint8_t *, int),
+                                 const char *name)
+{
+    LOCAL_ALIGNED_16(uint8_t, src, [BUF_SIZE]);
+    LOCAL_ALIGNED_16(uint8_t, dst0, [2 * BUF_SIZE]);
+    LOCAL_ALIGNED_16(uint8_t, dst1, [2 * BUF_SIZE]);
+
+    declare_func(void, uint8_t *dst, const uint8_t *src, int len);
+
+    for (int i = 0; i < BUF_SIZE; i++)
+        src[i] = rnd();
+
+    if (check_func(unpack, "adpcm_unpack_nibbles_%s", name)) {
+        for (int len = 1; len <= BUF_SIZE; len += 1 + rnd() % 37) {
+            memset(dst0, 0xAA, 2 * BUF_SIZE);
+            memset(dst1, 0xAA, 2 * BUF_SIZE);
+            call_ref(dst0, src, len);
+            call_new(dst1, src, len);
+            if (memcmp(dst0, dst1, 2 * len))
+                fail();
+        }
+        bench_new(dst1, src, BUF_SIZE);
+    }
+}
+
+void checkasm_check_adpcmdsp(void)
+{
+    ADPCMDSPContext c;
+
+    ff_adpcmdsp_init(&c);
+
+    check_unpack_nibbles(c.unpack_nibbles_lo, "lo");
+    check_unpack_nibbles(c.unpack_nibbles_hi, "hi");
+    report("unpack_nibbles");
+}
@@ -0,0 +1,93 @@
+/*
+ * This file is part of Librempeg
+ *
+ * Librempeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Librempeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Librempeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <math.h>
+
+#include "libavutil/mem_internal.h"
+
+#include "libavcodec/opus/pvq.h"
+
+#include "checkasm.h"
+
+#define MAX_N 176
+
+/* The searches are heuristics and the SIMD versions may pick other positions
+ * than the C one, so check that the result is a valid pulse vector of about
+ * the same quality instead of comparing the vectors. */
+static int check_pulses(const float *X, const int *y, int K, int N, float norm,
+                        double *corr)
+{
+    double xy = 0.0;
+    int sum = 0, yy = 0;
+
+    for (int i = 0; i < N; i++) {
+        if (y[i] && (y[i] < 0) != (X[i] < 0.0f))
+            return 0;
+        sum += abs(y[i]);
+        yy  += y[i] * y[i];
+        xy  += X[i] * y[i];
+    }
+
+    *corr = xy / sqrt(yy);
+    return sum == K && norm == yy;
+}
+
+static void test_pvq_search(CeltPVQ *pvq, int N, int K)
+{
+    LOCAL_ALIGNED_32(float, X, [256]);
+    LOCAL_ALIGNED_32(int, y0, [256]);
+    LOCAL_ALIGNED_32(int, y1, [256]);
+    double energy = 0.0, corr0, corr1;
+    float norm0, norm1;
+
+    declare_func_float(float, float *X, int *y, int K, int N);
+
+    for (int i = 0; i < 256; i++)
+        X[i] = i < N ? (float)rnd() / UINT_MAX - 0.5f : 0.0f;
+    for (int i = 0; i < N; i++)
+        energy += X[i] * X[i];
+    for (int i = 0; i < N; i++)
+        X[i] /= sqrt(energy);
+
+    if (check_func(pvq->pvq_search, "pvq_search_%d", N)) {
+        norm0 = call_ref(X, y0, K, N);
+        norm1 = call_new(X, y1, K, N);
+
+        if (!check_pulses(X, y0, K, N, norm0, &corr0) ||
+            !check_pulses(X, y1, K, N, norm1, &corr1) ||
+            corr1 < corr0 - 0.02)
+            fail();
+
+        bench_new(X, y1, K, N);
+    }
+}
+
+void checkasm_check_celt_pvq(void)
+{
+    static const int sizes[] = { 2, 3, 4, 6, 8, 12, 16, 22, 24, 32, 36, 44, 64, 88, 176 };
+    CeltPVQ *pvq;
+
+    if (ff_celt_pvq_init(&pvq, 1) < 0)
+        return;
+
+    for (int i = 0; i < FF_ARRAY_ELEMS(sizes); i++)
+        test_pvq_search(pvq, sizes[i], 1 + rnd() % 128);
+    report("pvq_search");
+
+    ff_celt_pvq_uninit(&pvq);
+}
@@ -129,6 +129,9 @@ static const struct {
     #if CONFIG_AC3DSP
         { "ac3dsp", checkasm_check_ac3dsp },
     #endif
+    #if CONFIG_ADPCMDSP
+        { "adpcmdsp", checkasm_check_adpcmdsp },
+    #endif
     #if CONFIG_ALAC_DECODER
         { "alacdsp", checkasm_check_alacdsp },
     #endif
@@ -147,6 +150,9 @@ static const struct {
     #if CONFIG_CAVS_DECODER
         { "cavsdsp", checkasm_check_cavsdsp },
     #endif
+    #if CONFIG_OPUS_ENCODER
+        { "celt_pvq", checkasm_check_celt_pvq },
+    #endif
     #if CONFIG_DCA_DECODER
         { "dcadsp", checkasm_check_dcadsp },
         { "synth_filter", checkasm_check_synth_filter },
@@ -220,6 +226,9 @@ static const struct {
     #if CONFIG_LPC
         { "lpc", checkasm_check_lpc },
     #endif
+    #if CONFIG_TRUEHD_ENCODER
+        { "mlpencdsp", checkasm_check_mlpencdsp },
+    #endif
     #if CONFIG_ME_CMP
         { "motion", checkasm_check_motion },
     #endif
@@ -296,11 +305,17 @@ static const struct {
     #if CONFIG_VORBIS_DECODER
         { "vorbisdsp", checkasm_check_vorbisdsp },
     #endif
+    #if CONFIG_VORBIS_ENCODER
+        { "vorbisencdsp", checkasm_check_vorbisencdsp },
+    #endif
     #if CONFIG_VVC_DECODER
         { "vvc_alf", checkasm_check_vvc_alf },
         { "vvc_mc",  checkasm_check_vvc_mc  },
         { "vvc_sao", checkasm_check_vvc_sao },
     #endif
+    #if CONFIG_WAVPACK_ENCODER
+        { "wavpackencdsp", checkasm_check_wavpackencdsp },
+    #endif
 #endif
 #if CONFIG_AVFILTER
     #if CONFIG_SCENE_SAD
@@ -362,12 +377,16 @@ static const struct {
     { "sw_yuv2yuv", checkasm_check_sw_yuv2yuv },
     { "sw_ops", checkasm_check_sw_ops },
 #endif
+#if CONFIG_SWRESAMPLE
+    { "swr_resample", checkasm_check_swr_resample },
+#endif
 #if CONFIG_AVUTIL
         { "aes",       checkasm_check_aes },
         { "crc",       checkasm_check_crc },
         { "fixed_dsp", checkasm_check_fixed_dsp },
         { "float_dsp", checkasm_check_float_dsp },
         { "lls",       checkasm_check_lls },
+        { "syncscan",  checkasm_check_syncscan },
 #if CONFIG_PIXELUTILS
         { "pixelutils",checkasm_check_pixelutils },
 #endif
@@ -80,6 +80,7 @@ typedef sigjmp_buf checkasm_context;
 void checkasm_check_aacencdsp(void);
 void checkasm_check_aacpsdsp(void);
 void checkasm_check_ac3dsp(void);
+void checkasm_check_adpcmdsp(void);
 void checkasm_check_aes(void);
 void checkasm_check_afir(void);
 void checkasm_check_alacdsp(void);
@@ -91,6 +92,7 @@ void checkasm_check_blend(void);
 void checkasm_check_blockdsp(void);
 void checkasm_check_bswapdsp(void);
 void checkasm_check_cavsdsp(void);
+void checkasm_check_celt_pvq(void);
 void checkasm_check_colordetect(void);
 void checkasm_check_colorspace(void);
 void checkasm_check_crc(void);
@@ -126,6 +128,7 @@ void checkasm_check_lls(void);
 void checkasm_check_llviddsp(void);
 void checkasm_check_llvidencdsp(void);
 void checkasm_check_lpc(void);
+void checkasm_check_mlpencdsp(void);
 void checkasm_check_motion(void);
 void checkasm_check_mpeg4videodsp(void);
 void checkasm_check_mpegvideo_unquantize(void);
@@ -144,6 +147,7 @@ void checkasm_check_scene_sad(void);
 void checkasm_check_snowdsp(void);
 void checkasm_check_svq1enc(void);
 void checkasm_check_synth_filter(void);
+void checkasm_check_syncscan(void);
 void checkasm_check_sw_gbrp(void);
 void checkasm_check_sw_range_convert(void);
 void checkasm_check_sw_rgb(void);
@@ -152,6 +156,7 @@ void checkasm_check_sw_xyz2rgb(void);
 void checkasm_check_sw_yuv2rgb(void);
 void checkasm_check_sw_yuv2yuv(void);
 void checkasm_check_sw_ops(void);
+void checkasm_check_swr_resample(void);
 void checkasm_check_takdsp(void);
 void checkasm_check_utvideodsp(void);
 void checkasm_check_v210dec(void);
@@ -175,9 +180,11 @@ void checkasm_check_vp9_loopfilter(void);
 void checkasm_check_vp9_mc(void);
 void checkasm_check_videodsp(void);
 void checkasm_check_vorbisdsp(void);
+void checkasm_check_vorbisencdsp(void);
 void checkasm_check_vvc_alf(void);
 void checkasm_check_vvc_mc(void);
 void checkasm_check_vvc_sao(void);
+void checkasm_check_wavpackencdsp(void);
 
 struct CheckasmPerf;
 
@@ -0,0 +1,73 @@
+/*
+ * This file is part of Librempeg
+ *
+ * Librempeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Librempeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Librempeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+
+#include "libavutil/mem_internal.h"
+#include "libavcodec/mathops.h"
+#include "libavcodec/mlpencdsp.h"
+
+#include "checkasm.h"
+
+#define BUF_SIZE 256
+#define HISTORY  8
+
+static void check_fir_residual(MLPEncDSPContext *c)
+{
+    LOCAL_ALIGNED_16(int32_t, samples,   [HISTORY + BUF_SIZE]);
+    LOCAL_ALIGNED_16(int32_t, residual0, [BUF_SIZE]);
+    LOCAL_ALIGNED_16(int32_t, residual1, [BUF_SIZE]);
+    int32_t coeff[8];
+
+    declare_func(void, int32_t *residual, const int32_t *samples,
+                 const int32_t *coeff, int order, int shift,
+                 int32_t mask, int len);
+
+    /* 24-bit samples and up to 16-bit coefficients, like the encoder */
+    for (int i = 0; i < HISTORY + BUF_SIZE; i++)
+        samples[i] = sign_extend(rnd(), 24);
+
+    if (check_func(c->fir_residual, "mlp_fir_residual")) {
+        for (int order = 1; order <= 8; order++) {
+            int shift = rnd() % 16;
+            int32_t mask = -(1 << (rnd() % 8));
+            int len = 8 * (1 + rnd() % (BUF_SIZE / 8));
+
+            for (int i = 0; i < 8; i++)
+                coeff[i] = sign_extend(rnd(), 16);
+
+            memset(residual0, 0, BUF_SIZE * sizeof(*residual0));
+            memset(residual1, 0, BUF_SIZE * sizeof(*residual1));
+            call_ref(residual0, samples + HISTORY, coeff, order, shift, mask, len);
+            call_new(residual1, samples + HISTORY, coeff, order, shift, mask, len);
+            if (memcmp(residual0, residual1, BUF_SIZE * sizeof(*residual0)))
+                fail();
+        }
+        bench_new(residual1, samples + HISTORY, coeff, 8, 14, -1, BUF_SIZE);
+    }
+}
+
+void checkasm_check_mlpencdsp(void)
+{
+    MLPEncDSPContext c;
+
+    ff_mlpencdsp_init(&c);
+
+    check_fir_residual(&c);
+    report("fir_residual");
+}
@@ -0,0 +1,122 @@
+/*
+ * This file is part of Librempeg.
+ *
+ * Librempeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Librempeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <float.h>
+#include <string.h>
+
+#include "libavutil/internal.h"
+#include "libavutil/mem_internal.h"
+#include "libavutil/samplefmt.h"
+#include "libswresample/resample.h"
+
+#include "checkasm.h"
+
+#define LEN     256
+#define SRC_LEN (LEN * 2 + 512)
+
+static int compare(const void *a, const void *b, enum AVSampleFormat fmt, int len)
+{
+    switch (fmt) {
+    case AV_SAMPLE_FMT_FLTP:
+        return float_near_abs_eps_array(a, b, 2e-5f, len);
+    case AV_SAMPLE_FMT_DBLP:
+        return double_near_abs_eps_array(a, b, 1e-12, len);
+    default:
+        return !memcmp(a, b, len * sizeof(int16_t));
+    }
+}
+
+static void fill_src(void *buf, enum AVSampleFormat fmt, int len)
+{
+    for (int i = 0; i < len; i++) {
+        int v = (int)(rnd() & 0xffff) - 0x8000;
+        switch (fmt) {
+        case AV_SAMPLE_FMT_FLTP: ((float   *)buf)[i] = v / 32768.0f; break;
+        case AV_SAMPLE_FMT_DBLP: ((double  *)buf)[i] = v / 32768.0;  break;
+        default:                 ((int16_t *)buf)[i] = v / 2;        break;
+        }
+    }
+}
+
+static void check_resample(enum AVSampleFormat fmt, int linear)
+{
+    LOCAL_ALIGNED_32(uint8_t, src,  [SRC_LEN * sizeof(double)]);
+    LOCAL_ALIGNED_32(uint8_t, dst0, [LEN * sizeof(double)]);
+    LOCAL_ALIGNED_32(uint8_t, dst1, [LEN * sizeof(double)]);
+    const char *name = linear ? "resample_linear" : "resample_common";
+    ResampleContext *c;
+    void *func;
+
+    declare_func(int, ResampleContext *c, void *dst, const void *src,
+                 int n, int update_ctx);
+
+    /* large filter and no exact rational ratio, so that frac is non-zero
+     * and the linear interpolation kernel is actually used */
+    c = swri_resampler.init(NULL, 48000, 44100, 64, 10, linear, 0.97, fmt,
+                            SWR_FILTER_TYPE_KAISER, 9.0, 0.0, 0, 0);
+    if (!c) {
+        fail();
+        return;
+    }
+    func = linear ? (void *)c->dsp.resample_linear : (void *)c->dsp.resample_common;
+
+    if (check_func(func, "%s_%s", name, av_get_sample_fmt_name(fmt))) {
+        int index = rnd() % c->phase_count;
+        int frac  = rnd() % c->src_incr;
+        int ret0, ret1, index0, frac0;
+
+        fill_src(src, fmt, SRC_LEN);
+        memset(dst0, 0, LEN * c->felem_size);
+        memset(dst1, 0, LEN * c->felem_size);
+
+        c->index = index;
+        c->frac  = frac;
+        ret0   = call_ref(c, dst0, src, LEN, 1);
+        index0 = c->index;
+        frac0  = c->frac;
+
+        c->index = index;
+        c->frac  = frac;
+        ret1 = call_new(c, dst1, src, LEN, 1);
+
+        if (ret0 != ret1 || index0 != c->index || frac0 != c->frac ||
+            !compare(dst0, dst1, fmt, LEN))
+            fail();
+
+        c->index = index;
+        c->frac  = frac;
+        bench_new(c, dst1, src, LEN, 0);
+    }
+
+    swri_resampler.free(&c);
+}
+
+void checkasm_check_swr_resample(void)
+{
+    static const enum AVSampleFormat fmts[] = {
+        AV_SAMPLE_FMT_S16P, AV_SAMPLE_FMT_FLTP, AV_SAMPLE_FMT_DBLP,
+    };
+
+    for (int i = 0; i < FF_ARRAY_ELEMS(fmts); i++)
+        check_resample(fmts[i], 0);
+    report("resample_common");
+
+    for (int i = 0; i < FF_ARRAY_ELEMS(fmts); i++)
+        check_resample(fmts[i], 1);
+    report("resample_linear");
+}
@@ -0,0 +1,117 @@
+/*
+ * This file is part of Librempeg
+ *
+ * Librempeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Librempeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Librempeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "checkasm.h"
+#include "libavutil/syncscan.h"
+
+#define BUF_SIZE 4096
+
+/* mostly 0x00, 0x01 and 0xff bytes, so that partial matches are common */
+static void fill_buf(uint8_t *buf, int size)
+{
+    for (int i = 0; i < size; i++) {
+        unsigned r = rnd();
+        switch (r & 7) {
+        case 0: case 1: case 2: buf[i] = 0;      break;
+        case 3: case 4:         buf[i] = 1;      break;
+        case 5:                 buf[i] = 0xff;   break;
+        default:                buf[i] = r >> 8; break;
+        }
+    }
+}
+
+static void check_find_start_code(const SyncScanContext *c, uint8_t *buf)
+{
+    declare_func(int, const uint8_t *buf, int size);
+
+    if (check_func(c->find_start_code, "find_start_code")) {
+        for (int size = 0; size < 80; size++) {
+            for (int off = 0; off < 4; off++) {
+                int ref, new;
+                fill_buf(buf, BUF_SIZE);
+                ref = call_ref(buf + off, size);
+                new = call_new(buf + off, size);
+                if (ref != new)
+                    fail();
+            }
+        }
+
+        /* start code after a long run of other bytes */
+        memset(buf, 0x47, BUF_SIZE);
+        for (int pos = BUF_SIZE - 64; pos < BUF_SIZE - 2; pos++) {
+            int ref, new;
+            buf[pos] = buf[pos + 1] = 0;
+            buf[pos + 2] = 1;
+            ref = call_ref(buf, BUF_SIZE);
+            new = call_new(buf, BUF_SIZE);
+            if (ref != new)
+                fail();
+            buf[pos] = buf[pos + 1] = buf[pos + 2] = 0x47;
+        }
+
+        bench_new(buf, BUF_SIZE);
+    }
+}
+
+static void check_find_sync_word(const SyncScanContext *c, uint8_t *buf)
+{
+    static const struct {
+        unsigned sync, mask;
+    } words[] = {
+        { 0x0B77, 0xFFFF }, // AC-3
+        { 0xFFF0, 0xFFF6 }, // ADTS
+        { 0x0001, 0xFFFF },
+    };
+    declare_func(int, const uint8_t *buf, int size,
+                 unsigned sync, unsigned mask);
+
+    if (check_func(c->find_sync_word, "find_sync_word")) {
+        for (int w = 0; w < FF_ARRAY_ELEMS(words); w++) {
+            const unsigned sync = words[w].sync, mask = words[w].mask;
+
+            for (int size = 0; size < 80; size++) {
+                int ref, new;
+                fill_buf(buf, BUF_SIZE);
+                ref = call_ref(buf, size, sync, mask);
+                new = call_new(buf, size, sync, mask);
+                if (ref != new)
+                    fail();
+            }
+        }
+
+        memset(buf, 0x47, BUF_SIZE);
+        bench_new(buf, BUF_SIZE, 0x0B77, 0xFFFF);
+    }
+}
+
+void checkasm_check_syncscan(void)
+{
+    static uint8_t buf[BUF_SIZE];
+    SyncScanContext c;
+
+    avpriv_syncscan_init(&c);
+
+    check_find_start_code(&c, buf);
+    report("find_start_code");
+
+    check_find_sync_word(&c, buf);
+    report("find_sync_word");
+}
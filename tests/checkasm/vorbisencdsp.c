@@ -0,0 +1,77 @@
+/*
+ * This file is part of Librempeg
+ *
+ * Librempeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Librempeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Librempeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <math.h>
+
+#include "libavutil/mem_internal.h"
+#include "libavcodec/vorbisencdsp.h"
+
+#include "checkasm.h"
+
+#define MAX_ENTRIES 96
+#define MAX_DIM     8
+
+static void check_find_entry(VorbisEncDSPContext *c)
+{
+    LOCAL_ALIGNED_32(float, dims, [MAX_DIM * MAX_ENTRIES]);
+    LOCAL_ALIGNED_32(float, pow2, [MAX_ENTRIES]);
+    float num[MAX_DIM];
+
+    declare_func(int, const float *dims, const float *pow2,
+                 const float *num, int ndim, int stride);
+
+    if (check_func(c->find_entry, "vorbis_find_entry")) {
+        for (int ndim = 1; ndim <= MAX_DIM; ndim++) {
+            int stride = 16 * (1 + rnd() % (MAX_ENTRIES / 16));
+            /* small integer values give ties, which must resolve to the
+             * first entry */
+            int ints = rnd() & 1;
+            int ref, new;
+
+            for (int i = 0; i < stride; i++) {
+                float p = 0;
+                for (int j = 0; j < ndim; j++) {
+                    float v = ints ? (int)(rnd() % 9) - 4 :
+                                     ((int)(rnd() % 2001) - 1000) / 100.0f;
+                    dims[j * stride + i] = v;
+                    p += v * v;
+                }
+                pow2[i] = rnd() % 5 ? p / 2 : INFINITY;
+            }
+            for (int j = 0; j < ndim; j++)
+                num[j] = ints ? (int)(rnd() % 9) - 4 :
+                                ((int)(rnd() % 2001) - 1000) / 100.0f;
+
+            ref = call_ref(dims, pow2, num, ndim, stride);
+            new = call_new(dims, pow2, num, ndim, stride);
+            if (ref != new)
+                fail();
+        }
+        bench_new(dims, pow2, num, 2, MAX_ENTRIES);
+    }
+}
+
+void checkasm_check_vorbisencdsp(void)
+{
+    VorbisEncDSPContext c;
+
+    ff_vorbisencdsp_init(&c);
+
+    check_find_entry(&c);
+    report("find_entry");
+}
@@ -0,0 +1,83 @@
+/*
+ * This file is part of Librempeg
+ *
+ * Librempeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Librempeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Librempeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+
+#include "libavutil/mem_internal.h"
+#include "libavcodec/wavpackencdsp.h"
+
+#include "checkasm.h"
+
+#define BUF_SIZE 256
+
+/* mostly small values with some zeros, like real predictions */
+static int32_t rnd_sample(void)
+{
+    return rnd() % 5 ? (int32_t)(rnd() % (1 << 18)) - (1 << 17) : 0;
+}
+
+static void check_decorr_stereo_quick4(WavPackEncDSPContext *c)
+{
+    LOCAL_ALIGNED_16(int32_t, in_left,  [BUF_SIZE]);
+    LOCAL_ALIGNED_16(int32_t, in_right, [BUF_SIZE]);
+    LOCAL_ALIGNED_16(int32_t, src,      [8 * BUF_SIZE]);
+    LOCAL_ALIGNED_16(int32_t, samples0, [8 * BUF_SIZE]);
+    LOCAL_ALIGNED_16(int32_t, samples1, [8 * BUF_SIZE]);
+    int32_t weight[8], weight0[8], weight1[8];
+
+    declare_func(void, int32_t *samples, const int32_t *in_left,
+                 const int32_t *in_right, int32_t *weight,
+                 int delta, int nb_samples);
+
+    for (int i = 0; i < BUF_SIZE; i++) {
+        in_left[i]  = rnd_sample();
+        in_right[i] = rnd_sample();
+    }
+    for (int i = 0; i < 8 * BUF_SIZE; i++)
+        src[i] = rnd_sample();
+    for (int i = 0; i < 8; i++)
+        weight[i] = (int32_t)(rnd() % 2049) - 1024;
+
+    if (check_func(c->decorr_stereo_quick4, "wavpack_decorr_stereo_quick4")) {
+        for (int len = 1; len <= BUF_SIZE; len += 1 + rnd() % 37) {
+            int delta = rnd() % 8;
+
+            memcpy(samples0, src, 8 * BUF_SIZE * sizeof(*src));
+            memcpy(samples1, src, 8 * BUF_SIZE * sizeof(*src));
+            memcpy(weight0, weight, sizeof(weight));
+            memcpy(weight1, weight, sizeof(weight));
+            call_ref(samples0, in_left, in_right, weight0, delta, len);
+            call_new(samples1, in_left, in_right, weight1, delta, len);
+            if (memcmp(samples0, samples1, 8 * BUF_SIZE * sizeof(*src)) ||
+                memcmp(weight0, weight1, sizeof(weight)))
+                fail();
+        }
+        memcpy(weight1, weight, sizeof(weight));
+        bench_new(samples1, in_left, in_right, weight1, 2, BUF_SIZE);
+    }
+}
+
+void checkasm_check_wavpackencdsp(void)
+{
+    WavPackEncDSPContext c;
+
+    ff_wavpackencdsp_init(&c);
+
+    check_decorr_stereo_quick4(&c);
+    report("decorr_stereo_quick4");
+}
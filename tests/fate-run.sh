@@ -209,6 +209,40 @@ framecrc(){
     ffmpeg "$@" -bitexact -f framecrc -
 }
 
+# Demux with the segment cache of the HLS and DASH demuxers, and count the
+# segments downloaded into the cache and the segments read from it.
+segment_cache(){
+    logfile=${outdir}/$test.log
+    cleanfiles="$cleanfiles $logfile"
+    framecrc -loglevel debug "$@" 2>$logfile || return 1
+    echo "downloaded=$(grep -c "Downloaded '" $logfile) read=$(grep -c "Reading '" $logfile)"
+}
+
+# Open a copy of the input with the index_cache option of the mov and
+# matroska demuxers three times: without a cache, with the cache written by
+# the first open, and after the modification time of the input changed.
+# Print the output of the first open, and for the other two whether the
+# cache was used and whether the output is the same.
+index_cache(){
+    input=${outdir}/$test.input
+    cache=${outdir}/$test.cache
+    logfile=${outdir}/$test.log
+    first=${outdir}/$test.first
+    next=${outdir}/$test.next
+    cleanfiles="$cleanfiles $input $cache $logfile $first $next"
+    cp "$1" $input || return 1
+    shift
+    rm -f $cache
+    framecrc -index_cache $cache "$@" -i $input -c copy >$first || return 1
+    cat $first
+    for open in cached stale; do
+        test $open = stale && touch -t 200001010000 $input
+        framecrc -loglevel verbose -index_cache $cache "$@" -i $input -c copy >$next 2>$logfile || return 1
+        cmp -s $first $next && output=same || output=different
+        echo "$open: cache used=$(grep -c "Using index cache" $logfile) output=$output"
+    done
+}
+
 ffmetadata(){
     ffmpeg "$@" -bitexact -f ffmetadata -
 }
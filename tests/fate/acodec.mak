@@ -100,6 +100,21 @@ fate-acodec-adpcm-ms-trellis:      FMT = wav
 fate-acodec-adpcm-swf-trellis:     FMT = flv
 fate-acodec-adpcm-yamaha-trellis:  FMT = wav
 
+FATE_ACODEC-$(call ENCDEC, ADPCM_IMA_WAV, WAV, ARESAMPLE_FILTER) += fate-acodec-adpcm-ima_wav-threads
+fate-acodec-adpcm-ima_wav-threads: FMT = wav
+fate-acodec-adpcm-ima_wav-threads: CODEC = adpcm_ima_wav
+fate-acodec-adpcm-ima_wav-threads: THREADS = 2
+fate-acodec-adpcm-ima_wav-threads: THREAD_TYPE = slice
+
+FATE_ACODEC_ADPCM_BPF-$(call ENCDEC, ADPCM_IMA_WAV, WAV, ARESAMPLE_FILTER) += ima_wav
+FATE_ACODEC_ADPCM_BPF-$(call ENCDEC, ADPCM_MS,      WAV)                   += ms
+FATE_ACODEC_ADPCM_BPF := $(if $(call ENCDEC, PCM_S16LE, WAV), $(FATE_ACODEC_ADPCM_BPF-yes))
+FATE_ACODEC_ADPCM_BPF := $(FATE_ACODEC_ADPCM_BPF:%=fate-acodec-adpcm-%-bpf)
+FATE_ACODEC += $(FATE_ACODEC_ADPCM_BPF)
+
+fate-acodec-adpcm-%-bpf: CODEC = adpcm_$(@:fate-acodec-adpcm-%-bpf=%)
+fate-acodec-adpcm-%-bpf: CMD = enc_dec wav $(SRC) wav "-b:a 128k -c $(CODEC)" wav "-c pcm_s16le" "-blocks_per_frame 16"
+
 FATE_ACODEC-$(call ENCDEC, MP2, MP2 MP3, ARESAMPLE_FILTER) += fate-acodec-mp2
 fate-acodec-mp2: FMT = mp2
 fate-acodec-mp2: CMP_SHIFT = -1924
@@ -129,13 +144,16 @@ fate-acodec-dca2: CMP_SHIFT = -2048
 fate-acodec-dca2: CMP_TARGET = 534
 fate-acodec-dca2: SIZE_TOLERANCE = 1632
 
-FATE_ACODEC-$(call ENCDEC, FLAC, FLAC) += fate-acodec-flac fate-acodec-flac-exact-rice
+FATE_ACODEC-$(call ENCDEC, FLAC, FLAC) += fate-acodec-flac fate-acodec-flac-exact-rice fate-acodec-flac-threads
 fate-acodec-flac: FMT = flac
 fate-acodec-flac: CODEC = flac -compression_level 2
 
 fate-acodec-flac-exact-rice: FMT = flac
 fate-acodec-flac-exact-rice: CODEC = flac -compression_level 2 -exact_rice_parameters 1
 
+fate-acodec-flac-threads: FMT = flac
+fate-acodec-flac-threads: CODEC = flac -compression_level 2 -threads 3
+
 FATE_ACODEC-$(call ENCDEC, G723_1, G723_1, ARESAMPLE_FILTER) += fate-acodec-g723_1
 fate-acodec-g723_1: tests/data/asynth-8000-1.wav
 fate-acodec-g723_1: SRC = tests/data/asynth-8000-1.wav
@@ -165,12 +183,34 @@ fate-acodec-s302m: CODEC = s302m
 fate-acodec-s302m: ENCOPTS = -af aresample=48000:tsf=s16p -strict -2
 fate-acodec-s302m: DECOPTS = -af aresample=44100:tsf=s16p
 
-FATE_ACODEC-$(call ENCDEC, WAVPACK, WV, ARESAMPLE_FILTER) += fate-acodec-wavpack
+FATE_ACODEC-$(call ENCDEC, WAVPACK, WV, ARESAMPLE_FILTER) += fate-acodec-wavpack fate-acodec-wavpack-threads
 fate-acodec-wavpack: FMT = wv
 fate-acodec-wavpack: CODEC = wavpack -compression_level 1
+fate-acodec-wavpack-threads: FMT = wv
+fate-acodec-wavpack-threads: CODEC = wavpack -compression_level 6 -threads 3
 
-FATE_ACODEC-$(call ENCDEC, TTA, TTA) += fate-acodec-tta
+FATE_ACODEC-$(call ENCDEC, TTA, TTA) += fate-acodec-tta fate-acodec-tta-threads
 fate-acodec-tta: FMT = tta
+fate-acodec-tta-threads: FMT = tta
+fate-acodec-tta-threads: CODEC = tta -threads 3
+
+FATE_ACODEC-$(call ENCDEC, VORBIS, OGG, ARESAMPLE_FILTER) += fate-acodec-vorbis fate-acodec-vorbis-threads
+fate-acodec-vorbis: FMT = ogg
+fate-acodec-vorbis: ENCOPTS = -strict experimental
+fate-acodec-vorbis-threads: FMT = ogg
+fate-acodec-vorbis-threads: CODEC = vorbis -threads 3
+fate-acodec-vorbis-threads: ENCOPTS = -strict experimental
+
+FATE_ACODEC-$(call ENCMUX, TRUEHD, TRUEHD, WAV_DEMUXER) += fate-acodec-truehd fate-acodec-truehd-threads
+fate-acodec-truehd: tests/data/asynth-44100-2.wav
+fate-acodec-truehd: CMD = md5 -i $(TARGET_PATH)/$(SRC) -c:a truehd -strict -2 -f truehd -flags +bitexact
+fate-acodec-truehd: CMP = oneline
+fate-acodec-truehd: REF = c795e66edc5c89afd1b648fa00082303
+
+fate-acodec-truehd-threads: tests/data/asynth-44100-2.wav
+fate-acodec-truehd-threads: CMD = md5 -i $(TARGET_PATH)/$(SRC) -c:a truehd -strict -2 -threads 2 -f truehd -flags +bitexact
+fate-acodec-truehd-threads: CMP = oneline
+fate-acodec-truehd-threads: REF = c795e66edc5c89afd1b648fa00082303
 
 FATE_ACODEC-yes := $(if $(call ENCDEC, PCM_S16LE, WAV), $(FATE_ACODEC-yes))
 FATE_ACODEC += $(FATE_ACODEC-yes)
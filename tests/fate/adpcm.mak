@@ -70,6 +70,16 @@ fate-adpcm-ima-smjpeg: CMD = framecrc -i $(TARGET_SAMPLES)/smjpeg/scenwin.mjpg -
 FATE_ADPCM-$(call DEMDEC, MOV, ADPCM_IMA_WAV, ASF2SF_FILTER) += fate-adpcm-ima_wav-stereo
 fate-adpcm-ima_wav-stereo: CMD = md5 -i $(TARGET_SAMPLES)/qt-surge-suite/surge-2-16-L-ms11.mov -f s16le -af asf2sf
 
+FATE_ADPCM-$(call DEMDEC, MOV, ADPCM_IMA_WAV, ASF2SF_FILTER) += fate-adpcm-ima_wav-stereo-threads
+fate-adpcm-ima_wav-stereo-threads: CMD = md5 -i $(TARGET_SAMPLES)/qt-surge-suite/surge-2-16-L-ms11.mov -f s16le -af asf2sf
+fate-adpcm-ima_wav-stereo-threads: THREADS = 2
+fate-adpcm-ima_wav-stereo-threads: THREAD_TYPE = slice
+fate-adpcm-ima_wav-stereo-threads: REF = $(SRC_PATH)/tests/ref/fate/adpcm-ima_wav-stereo
+
+FATE_ADPCM-$(call DEMDEC, MOV, ADPCM_IMA_WAV, ASF2SF_FILTER) += fate-adpcm-ima_wav-stereo-bpf
+fate-adpcm-ima_wav-stereo-bpf: CMD = md5 -blocks_per_frame 16 -i $(TARGET_SAMPLES)/qt-surge-suite/surge-2-16-L-ms11.mov -f s16le -af asf2sf
+fate-adpcm-ima_wav-stereo-bpf: REF = $(SRC_PATH)/tests/ref/fate/adpcm-ima_wav-stereo
+
 FATE_ADPCM-$(call FRAMECRC, WSVQA, ADPCM_IMA_WS) += fate-adpcm-ima-ws
 fate-adpcm-ima-ws: CMD = framecrc -i $(TARGET_SAMPLES)/vqa/cc-demo1-partial.vqa -vn
 
@@ -82,6 +92,10 @@ fate-adpcm-ms-mono: CMD = framecrc -i $(TARGET_SAMPLES)/dxa/meetsquid.dxa -t 2 -
 FATE_ADPCM-$(call DEMDEC, MOV, ADPCM_MS) += fate-adpcm_ms-stereo
 fate-adpcm_ms-stereo: CMD = md5 -i $(TARGET_SAMPLES)/qt-surge-suite/surge-2-16-L-ms02.mov -f s16le
 
+FATE_ADPCM-$(call DEMDEC, MOV, ADPCM_MS) += fate-adpcm_ms-stereo-bpf
+fate-adpcm_ms-stereo-bpf: CMD = md5 -blocks_per_frame 16 -i $(TARGET_SAMPLES)/qt-surge-suite/surge-2-16-L-ms02.mov -f s16le
+fate-adpcm_ms-stereo-bpf: REF = $(SRC_PATH)/tests/ref/fate/adpcm_ms-stereo
+
 FATE_ADPCM-$(call FRAMECRC, WAV, ADPCM_SANYO, ASF2SF_FILTER) += fate-adpcm-sanyo-3bit
 fate-adpcm-sanyo-3bit: CMD = framecrc -i $(TARGET_SAMPLES)/sanyo/sanyo-mono-3bit-8000.wav -af asf2sf
 
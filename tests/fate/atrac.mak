@@ -31,6 +31,18 @@ FATE_ATRAC3P += fate-atrac3p-2
 fate-atrac3p-2: CMD = pcm -i $(TARGET_SAMPLES)/atrac3p/sonateno14op27-2-cut.aa3
 fate-atrac3p-2: REF = $(SAMPLES)/atrac3p/sonateno14op27-2-cut.pcm
 
+FATE_ATRAC3P += fate-atrac3p-1-frame-threads
+fate-atrac3p-1-frame-threads: CMD = pcm -i $(TARGET_SAMPLES)/atrac3p/at3p_sample1.oma
+fate-atrac3p-1-frame-threads: REF = $(SAMPLES)/atrac3p/at3p_sample1.pcm
+fate-atrac3p-1-frame-threads: THREADS = 2
+fate-atrac3p-1-frame-threads: THREAD_TYPE = frame
+
+FATE_ATRAC3P += fate-atrac3p-2-frame-threads
+fate-atrac3p-2-frame-threads: CMD = pcm -i $(TARGET_SAMPLES)/atrac3p/sonateno14op27-2-cut.aa3
+fate-atrac3p-2-frame-threads: REF = $(SAMPLES)/atrac3p/sonateno14op27-2-cut.pcm
+fate-atrac3p-2-frame-threads: THREADS = 2
+fate-atrac3p-2-frame-threads: THREAD_TYPE = frame
+
 FATE_ATRAC3P-$(call PCM, OMA, ATRAC3P, ARESAMPLE_FILTER) += $(FATE_ATRAC3P)
 
 FATE_ATRAC_ALL = $(FATE_ATRAC1-yes) $(FATE_ATRAC3-yes) $(FATE_ATRAC3P-yes)
@@ -1,6 +1,7 @@
 FATE_CHECKASM = fate-checkasm-aacencdsp                                 \
                 fate-checkasm-aacpsdsp                                  \
                 fate-checkasm-ac3dsp                                    \
+                fate-checkasm-adpcmdsp                                  \
                 fate-checkasm-aes                                       \
                 fate-checkasm-af_afir                                   \
                 fate-checkasm-alacdsp                                   \
@@ -10,6 +11,7 @@ FATE_CHECKASM = fate-checkasm-aacencdsp                                 \
                 fate-checkasm-blockdsp                                  \
                 fate-checkasm-bswapdsp                                  \
                 fate-checkasm-cavsdsp                                   \
+                fate-checkasm-celt_pvq                                  \
                 fate-checkasm-crc                                       \
                 fate-checkasm-dcadsp                                    \
                 fate-checkasm-diracdsp                                  \
@@ -42,6 +44,7 @@ FATE_CHECKASM = fate-checkasm-aacencdsp                                 \
                 fate-checkasm-llviddsp                                  \
                 fate-checkasm-llvidencdsp                               \
                 fate-checkasm-lpc                                       \
+                fate-checkasm-mlpencdsp                                 \
                 fate-checkasm-motion                                    \
                 fate-checkasm-mpeg4videodsp                             \
                 fate-checkasm-mpegvideo_unquantize                      \
@@ -59,6 +62,7 @@ FATE_CHECKASM = fate-checkasm-aacencdsp                                 \
                 fate-checkasm-snowdsp                                   \
                 fate-checkasm-svq1enc                                   \
                 fate-checkasm-synth_filter                              \
+                fate-checkasm-syncscan                                  \
                 fate-checkasm-sw_gbrp                                   \
                 fate-checkasm-sw_ops                                    \
                 fate-checkasm-sw_range_convert                          \
@@ -67,6 +71,7 @@ FATE_CHECKASM = fate-checkasm-aacencdsp                                 \
                 fate-checkasm-sw_xyz2rgb                                \
                 fate-checkasm-sw_yuv2rgb                                \
                 fate-checkasm-sw_yuv2yuv                                \
+                fate-checkasm-swr_resample                              \
                 fate-checkasm-takdsp                                    \
                 fate-checkasm-utvideodsp                                \
                 fate-checkasm-v210dec                                   \
@@ -88,6 +93,7 @@ FATE_CHECKASM = fate-checkasm-aacencdsp                                 \
                 fate-checkasm-vf_sobel                                  \
                 fate-checkasm-videodsp                                  \
                 fate-checkasm-vorbisdsp                                 \
+                fate-checkasm-vorbisencdsp                              \
                 fate-checkasm-vp3dsp                                    \
                 fate-checkasm-vp6dsp                                    \
                 fate-checkasm-vp8dsp                                    \
@@ -95,6 +101,7 @@ FATE_CHECKASM = fate-checkasm-aacencdsp                                 \
                 fate-checkasm-vvc_alf                                   \
                 fate-checkasm-vvc_mc                                    \
                 fate-checkasm-vvc_sao                                   \
+                fate-checkasm-wavpackencdsp                             \
 
 $(FATE_CHECKASM): tests/checkasm/checkasm$(EXESUF)
 $(FATE_CHECKASM): CMD = run tests/checkasm/checkasm$(EXESUF) --test=$(@:fate-checkasm-%=%)
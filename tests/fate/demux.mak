@@ -180,6 +180,40 @@ FATE_FFPROBE_DEMUX-$(call DEMDEC, MPEGTS HLS) += fate-ts-timed-id3-hls-demux
 fate-ts-timed-id3-hls-demux: tests/data/id3.m3u8
 fate-ts-timed-id3-hls-demux: CMD = ffprobe_demux $(TARGET_PATH)/tests/data/id3.m3u8
 
+# With -mmap 1 the file protocol maps packets of 64 KiB and more, which
+# the frm and mov demuxers then edit in place (alpha inversion, CENC
+# decryption). The output must match the one of the read path. The frm
+# input is not probed, as probing would buffer the whole file.
+tests/data/mmap-bgra.frm: TAG = GEN
+tests/data/mmap-bgra.frm: ffmpeg$(PROGSSUF)$(EXESUF) | tests/data
+	$(M)printf 'FRM\005\000\001\000\001' > $(TARGET_PATH)/$@ && \
+	$(TARGET_EXEC) $(TARGET_PATH)/$< -nostdin \
+        -f lavfi -i testsrc=s=256x256:d=0.08 -pix_fmt bgra -f rawvideo - \
+        >> $(TARGET_PATH)/$@ 2>/dev/null
+
+tests/data/mmap-cenc.mov: TAG = GEN
+tests/data/mmap-cenc.mov: ffmpeg$(PROGSSUF)$(EXESUF) | tests/data
+	$(M)$(TARGET_EXEC) $(TARGET_PATH)/$< -nostdin \
+        -f lavfi -i testsrc=s=320x240:d=0.2 -flags +bitexact -fflags +bitexact \
+        -c:v rawvideo -pix_fmt rgb24 -encryption_scheme cenc-aes-ctr \
+        -encryption_key 12345678901234567890123456789012 \
+        -encryption_kid abba271e8bcf552bbd2e86a434a9a5d9 \
+        -y $(TARGET_PATH)/$@ 2>/dev/null
+
+FATE_MMAP_DEMUX-$(call FRAMECRC, FRM, , LAVFI_INDEV TESTSRC_FILTER SCALE_FILTER RAWVIDEO_MUXER) += fate-frm-bgra-demux fate-frm-bgra-mmap-demux
+fate-frm-bgra-demux fate-frm-bgra-mmap-demux: tests/data/mmap-bgra.frm
+fate-frm-bgra-demux: CMD = framecrc -f frm -i $(TARGET_PATH)/tests/data/mmap-bgra.frm -c:v copy
+fate-frm-bgra-mmap-demux: CMD = framecrc -mmap 1 -f frm -i $(TARGET_PATH)/tests/data/mmap-bgra.frm -c:v copy
+fate-frm-bgra-mmap-demux: REF = $(SRC_PATH)/tests/ref/fate/frm-bgra-demux
+
+FATE_MMAP_DEMUX-$(call FRAMECRC, MOV, , LAVFI_INDEV TESTSRC_FILTER SCALE_FILTER MOV_MUXER) += fate-mov-cenc-demux fate-mov-cenc-mmap-demux
+fate-mov-cenc-demux fate-mov-cenc-mmap-demux: tests/data/mmap-cenc.mov
+fate-mov-cenc-demux: CMD = framecrc -decryption_key 12345678901234567890123456789012 -i $(TARGET_PATH)/tests/data/mmap-cenc.mov -c:v copy
+fate-mov-cenc-mmap-demux: CMD = framecrc -mmap 1 -decryption_key 12345678901234567890123456789012 -i $(TARGET_PATH)/tests/data/mmap-cenc.mov -c:v copy
+fate-mov-cenc-mmap-demux: REF = $(SRC_PATH)/tests/ref/fate/mov-cenc-demux
+
+FATE_FFMPEG += $(FATE_MMAP_DEMUX-yes)
+
 #FATE_SAMPLES_DEMUX-$(call PARSERDEM, JPEGXS, IMAGE_JPEGXS_PIPE, CONCAT_PROTOCOL) += fate-jxs-concat-demux
 #fate-jxs-concat-demux: CMD = framecrc "-i concat:$(TARGET_SAMPLES)/jxs/lena.jxs|$(TARGET_SAMPLES)/jxs/lena.jxs -c:v copy"
 
@@ -187,4 +221,4 @@ FATE_SAMPLES_DEMUX += $(FATE_SAMPLES_DEMUX-yes)
 FATE_SAMPLES_FFMPEG += $(FATE_SAMPLES_DEMUX)
 FATE_FFPROBE_DEMUX   += $(FATE_FFPROBE_DEMUX-yes)
 FATE_SAMPLES_FFPROBE += $(FATE_FFPROBE_DEMUX)
-fate-demux: $(FATE_SAMPLES_DEMUX) $(FATE_FFPROBE_DEMUX)
+fate-demux: $(FATE_SAMPLES_DEMUX) $(FATE_FFPROBE_DEMUX) $(FATE_MMAP_DEMUX-yes)
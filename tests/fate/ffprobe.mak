@@ -24,4 +24,25 @@ FATE_FFPROBE-$(call FILTERDEMDECENCMUX, AEVALSRC TESTSRC ARESAMPLE, FFMETADATA,
                                         FFMPEG LAVFI_INDEV PCM_F64BE_DECODER PCM_F64LE_DECODER PCM_S16LE_ENCODER) \
                                         += $(FFPROBE_TEST_FILE_TESTS-yes)
 
+tests/data/ffprobe-analyze.ts: ffmpeg$(PROGSSUF)$(EXESUF) | tests/data
+	$(M)$(TARGET_EXEC) $(TARGET_PATH)/$< -nostdin \
+        -f lavfi -i "aevalsrc=sin(400*PI*2*t):d=0.5[out0]; testsrc=d=0.5[out1]; aevalsrc=sin(880*PI*2*t)|sin(660*PI*2*t):d=0.5[out2]; testsrc=s=176x144:d=0.5[out3]" \
+        -flags +bitexact -fflags +bitexact -map 0 -vcodec mpeg4 -acodec mp2 \
+        -y $(TARGET_PATH)/$@ 2>/dev/null
+
+# the streams of an mpegts input are probed by decoding them, which the
+# analysis threads must do with the same result as the calling thread
+FFPROBE_ANALYZE_FILE=tests/data/ffprobe-analyze.ts
+FFPROBE_ANALYZE_COMMAND=ffprobe$(PROGSSUF)$(EXESUF) -show_streams -show_format -of compact -bitexact $(TARGET_PATH)/$(FFPROBE_ANALYZE_FILE) -print_filename $(FFPROBE_ANALYZE_FILE)
+
+FFPROBE_ANALYZE_TESTS = fate-ffprobe_analyze_serial fate-ffprobe_analyze_threads
+$(FFPROBE_ANALYZE_TESTS): $(FFPROBE_ANALYZE_FILE)
+fate-ffprobe_analyze_serial:  CMD = run $(FFPROBE_ANALYZE_COMMAND) -analyze_threads 1
+fate-ffprobe_analyze_threads: CMD = run $(FFPROBE_ANALYZE_COMMAND) -analyze_threads 3
+fate-ffprobe_analyze_threads: REF = $(SRC_PATH)/tests/ref/fate/ffprobe_analyze_serial
+
+FATE_FFPROBE-$(call FILTERDEMDECENCMUX, AEVALSRC TESTSRC ARESAMPLE, MPEGTS, MPEG4 MP2, MPEG4 MP2, MPEGTS, \
+                                        FFMPEG LAVFI_INDEV WRAPPED_AVFRAME_DECODER) \
+                                        += $(FFPROBE_ANALYZE_TESTS)
+
 fate-ffprobe: $(FATE_FFPROBE-yes)
@@ -224,6 +224,28 @@ fate-hls-start-number: tests/data/hls_start_number.m3u8
 fate-hls-start-number: CMD = sed -n -e /^\#EXT-X-MEDIA-SEQUENCE:/p -e /^[^\#]/p $(TARGET_PATH)/tests/data/hls_start_number.m3u8
 fate-hls-start-number: CMP = diff
 
+tests/data/hls_segment_cache.m3u8: TAG = GEN
+tests/data/hls_segment_cache.m3u8: ffmpeg$(PROGSSUF)$(EXESUF) | tests/data
+	$(M)$(TARGET_EXEC) $(TARGET_PATH)/$< -nostdin \
+	-f lavfi -i "testsrc2=size=128x72:rate=5:d=6" -f hls -hls_time 1 -map 0:v \
+	-hls_list_size 0 -c:v mpeg2video -g 5 \
+	-hls_segment_filename $(TARGET_PATH)/tests/data/hls_segment_cache_%d.ts \
+	$(TARGET_PATH)/tests/data/hls_segment_cache.m3u8 2>/dev/null
+
+FATE_HLSENC_LAVFI-$(call ALLYES, TESTSRC2_FILTER LAVFI_INDEV MPEG2VIDEO_ENCODER MPEG2VIDEO_DECODER HLS_MUXER HLS_DEMUXER MPEGTS_MUXER MPEGTS_DEMUXER FILE_PROTOCOL) += fate-hls-segment-cache
+fate-hls-segment-cache: tests/data/hls_segment_cache.m3u8
+fate-hls-segment-cache: CMD = rm -rf $(TARGET_PATH)/tests/data/hls_segment_cache; segment_cache -segment_prefetch 2 -segment_cache_dir $(TARGET_PATH)/tests/data/hls_segment_cache -i $(TARGET_PATH)/tests/data/hls_segment_cache.m3u8
+
+# reads all segments from the cache filled by fate-hls-segment-cache
+FATE_HLSENC_LAVFI-$(call ALLYES, TESTSRC2_FILTER LAVFI_INDEV MPEG2VIDEO_ENCODER MPEG2VIDEO_DECODER HLS_MUXER HLS_DEMUXER MPEGTS_MUXER MPEGTS_DEMUXER FILE_PROTOCOL) += fate-hls-segment-cache-hit
+fate-hls-segment-cache-hit: fate-hls-segment-cache
+fate-hls-segment-cache-hit: CMD = segment_cache -segment_cache_dir $(TARGET_PATH)/tests/data/hls_segment_cache -i $(TARGET_PATH)/tests/data/hls_segment_cache.m3u8
+
+# the cache is smaller than a segment, so the segments are evicted and downloaded again
+FATE_HLSENC_LAVFI-$(call ALLYES, TESTSRC2_FILTER LAVFI_INDEV MPEG2VIDEO_ENCODER MPEG2VIDEO_DECODER HLS_MUXER HLS_DEMUXER MPEGTS_MUXER MPEGTS_DEMUXER FILE_PROTOCOL) += fate-hls-segment-cache-evict
+fate-hls-segment-cache-evict: fate-hls-segment-cache-hit
+fate-hls-segment-cache-evict: CMD = segment_cache -segment_cache_dir $(TARGET_PATH)/tests/data/hls_segment_cache -segment_cache_size 10000 -i $(TARGET_PATH)/tests/data/hls_segment_cache.m3u8
+
 FATE_HLSENC_LAVFI-yes := $(if $(call FRAMECRC), $(FATE_HLSENC_LAVFI-yes))
 
 FATE_FFMPEG += $(FATE_HLSENC_LAVFI-yes)
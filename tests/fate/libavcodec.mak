@@ -8,6 +8,10 @@ fate-apv-entropy: libavcodec/tests/apv$(EXESUF)
 fate-apv-entropy: CMD = run libavcodec/tests/apv$(EXESUF)
 fate-apv-entropy: REF = /dev/null
 
+FATE_LIBAVCODEC-$(call ALLYES, HCA_DECODER ATRAC9_DECODER ATRAC3P_DECODER) += fate-audio-frame-threads
+fate-audio-frame-threads: libavcodec/tests/audio_frame_threads$(EXESUF)
+fate-audio-frame-threads: CMD = run libavcodec/tests/audio_frame_threads$(EXESUF)
+
 FATE_LIBAVCODEC-yes += fate-avpacket
 fate-avpacket: libavcodec/tests/avpacket$(EXESUF)
 fate-avpacket: CMD = run libavcodec/tests/avpacket$(EXESUF)
@@ -31,6 +31,10 @@ fate-seek_utils: libavformat/tests/seek_utils$(EXESUF)
 fate-seek_utils: CMD = run libavformat/tests/seek_utils$(EXESUF)
 fate-seek_utils: CMP = null
 
+FATE_LIBAVFORMAT-$(call ALLYES, XWB_DEMUXER FSB_DEMUXER AWC_DEMUXER SAB_DEMUXER NUS3BANK_DEMUXER WAV_DEMUXER) += fate-subsong
+fate-subsong: libavformat/tests/subsong$(EXESUF)
+fate-subsong: CMD = run libavformat/tests/subsong$(EXESUF)
+
 FATE_LIBAVFORMAT += $(FATE_LIBAVFORMAT-yes)
 FATE-$(CONFIG_AVFORMAT) += $(FATE_LIBAVFORMAT)
 fate-libavformat: $(FATE_LIBAVFORMAT)
@@ -1112,5 +1112,11 @@ fate-swr-resample-realloc: CMD = run libswresample/tests/swresample_resample_rea
 
 FATE_SWR += $(FATE_SWR_REALLOC-yes)
 
+FATE_SWR_THREADS-$(CONFIG_SWRESAMPLE) += fate-swr-threads
+fate-swr-threads: libswresample/tests/swresample_threads$(EXESUF)
+fate-swr-threads: CMD = run libswresample/tests/swresample_threads$(EXESUF)
+
+FATE_SWR += $(FATE_SWR_THREADS-yes)
+
 FATE_FFMPEG += $(FATE_SWR)
 fate-swr: $(FATE_SWR)
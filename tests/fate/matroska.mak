@@ -297,8 +297,22 @@ fate-matroska-side-data-pref-packet: CMD = run ffprobe$(PROGSSUF)$(EXESUF) $(TAR
     -select_streams v:0 -show_streams -show_frames -show_entries stream=stream_side_data:frame=frame_side_data_list -side_data_prefer_packet mastering_display_metadata,content_light_level
 FATE_MATROSKA_FFPROBE-$(call ALLYES, MATROSKA_DEMUXER HEVC_DECODER) += fate-matroska-side-data-pref-codec fate-matroska-side-data-pref-packet
 
+# Muxed to a pipe, so that there are no cues and seeking has to scan the
+# clusters, adding the keyframes found to the index saved in the cache.
+tests/data/matroska-index-cache.mkv: TAG = GEN
+tests/data/matroska-index-cache.mkv: ffmpeg$(PROGSSUF)$(EXESUF) | tests/data
+	$(M)$(TARGET_EXEC) $(TARGET_PATH)/$< -nostdin \
+        -f lavfi -i testsrc=s=176x144:d=4 -c:v mpeg4 -g 10 \
+        -flags +bitexact -fflags +bitexact -f matroska - \
+        > $(TARGET_PATH)/$@ 2>/dev/null
+
+FATE_MATROSKA_FFMPEG-$(call FRAMECRC, MATROSKA, MPEG4, LAVFI_INDEV TESTSRC_FILTER MPEG4_ENCODER MATROSKA_MUXER PIPE_PROTOCOL) += fate-matroska-index-cache
+fate-matroska-index-cache: tests/data/matroska-index-cache.mkv
+fate-matroska-index-cache: CMD = index_cache $(TARGET_PATH)/tests/data/matroska-index-cache.mkv -ss 2.5
+
 FATE_SAMPLES_AVCONV += $(FATE_MATROSKA-yes)
 FATE_SAMPLES_FFPROBE += $(FATE_MATROSKA_FFPROBE-yes)
 FATE_SAMPLES_FFMPEG_FFPROBE += $(FATE_MATROSKA_FFMPEG_FFPROBE-yes)
+FATE_FFMPEG += $(FATE_MATROSKA_FFMPEG-yes)
 
-fate-matroska: $(FATE_MATROSKA-yes) $(FATE_MATROSKA_FFPROBE-yes) $(FATE_MATROSKA_FFMPEG_FFPROBE-yes)
+fate-matroska: $(FATE_MATROSKA-yes) $(FATE_MATROSKA_FFPROBE-yes) $(FATE_MATROSKA_FFMPEG_FFPROBE-yes) $(FATE_MATROSKA_FFMPEG-yes)
@@ -299,6 +299,20 @@ fate-mov-vfr: CMD = md5 -filter_complex testsrc=size=2x2:duration=1,setpts=N*N:s
 fate-mov-vfr: CMP = oneline
 fate-mov-vfr: REF = 1558b4a9398d8635783c93f84eb5a60d
 
+# Fragmented without sidx and mfra, so the demuxer reads every moof to build
+# the fragment index, which the index cache saves.
+tests/data/mov-index-cache.mp4: TAG = GEN
+tests/data/mov-index-cache.mp4: ffmpeg$(PROGSSUF)$(EXESUF) | tests/data
+	$(M)$(TARGET_EXEC) $(TARGET_PATH)/$< -nostdin \
+        -f lavfi -i testsrc=s=176x144:d=4 -c:v mpeg4 -g 10 \
+        -flags +bitexact -fflags +bitexact \
+        -movflags frag_keyframe+empty_moov+skip_trailer \
+        -y $(TARGET_PATH)/$@ 2>/dev/null
+
+FATE_MOV_FFMPEG-$(call FRAMECRC, MOV, MPEG4, LAVFI_INDEV TESTSRC_FILTER MPEG4_ENCODER MP4_MUXER) += fate-mov-index-cache
+fate-mov-index-cache: tests/data/mov-index-cache.mp4
+fate-mov-index-cache: CMD = index_cache $(TARGET_PATH)/tests/data/mov-index-cache.mp4 -ss 2.5
+
 FATE_MOV_FFMPEG_FFPROBE-$(call TRANSCODE, FLAC, MP4 MOV, WAV_DEMUXER PCM_S16LE_DECODER) += fate-mov-mp4-iamf-stereo
 fate-mov-mp4-iamf-stereo: tests/data/asynth-44100-2.wav tests/data/streamgroups/audio_element-stereo tests/data/streamgroups/mix_presentation-stereo
 fate-mov-mp4-iamf-stereo: SRC = $(TARGET_PATH)/tests/data/asynth-44100-2.wav
@@ -0,0 +1,157 @@
+/*
+ * Benchmark the audio decoder of a set of files, e.g.:
+ * tools/audiodecbench -threads 4 -loop 10 music.hca voice.at9
+ *
+ * The packets of the first audio stream of each file are read into
+ * memory before the clock starts, then decoded -loop times. The speed is
+ * reported as a multiple of real time.
+ *
+ * This file is part of Librempeg
+ *
+ * Librempeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Librempeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Librempeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libavcodec/avcodec.h"
+#include "libavformat/avformat.h"
+#include "libavutil/error.h"
+#include "libavutil/frame.h"
+#include "libavutil/log.h"
+#include "libavutil/mem.h"
+#include "libavutil/time.h"
+
+static int run(const char *filename, int threads, int loops)
+{
+    AVFormatContext *fmt = NULL;
+    AVCodecContext *avctx = NULL;
+    const AVCodec *codec = NULL;
+    AVPacket **pkts = NULL;
+    AVFrame *frame = NULL;
+    int64_t samples = 0, t;
+    int nb_pkts = 0, idx, ret;
+
+    ret = avformat_open_input(&fmt, filename, NULL, NULL);
+    if (ret < 0)
+        goto end;
+    ret = avformat_find_stream_info(fmt, NULL);
+    if (ret < 0)
+        goto end;
+    ret = idx = av_find_best_stream(fmt, AVMEDIA_TYPE_AUDIO, -1, -1, &codec, 0);
+    if (ret < 0)
+        goto end;
+
+    avctx = avcodec_alloc_context3(codec);
+    frame = av_frame_alloc();
+    if (!avctx || !frame) {
+        ret = AVERROR(ENOMEM);
+        goto end;
+    }
+    ret = avcodec_parameters_to_context(avctx, fmt->streams[idx]->codecpar);
+    if (ret < 0)
+        goto end;
+    avctx->thread_count = threads;
+    ret = avcodec_open2(avctx, codec, NULL);
+    if (ret < 0)
+        goto end;
+
+    /* read the whole stream up front so that only the decoder is timed */
+    for (;;) {
+        void *tmp;
+        AVPacket *pkt = av_packet_alloc();
+        if (!pkt) {
+            ret = AVERROR(ENOMEM);
+            goto end;
+        }
+        ret = av_read_frame(fmt, pkt);
+        if (ret < 0 || pkt->stream_index != idx) {
+            av_packet_free(&pkt);
+            if (ret == AVERROR_EOF)
+                break;
+            if (ret < 0)
+                goto end;
+            continue;
+        }
+        tmp = av_realloc_array(pkts, nb_pkts + 1, sizeof(*pkts));
+        if (!tmp) {
+            av_packet_free(&pkt);
+            ret = AVERROR(ENOMEM);
+            goto end;
+        }
+        pkts = tmp;
+        pkts[nb_pkts++] = pkt;
+    }
+
+    t = av_gettime_relative();
+    for (int l = 0; l < loops; l++) {
+        for (int i = 0; i <= nb_pkts; i++) {
+            ret = avcodec_send_packet(avctx, i < nb_pkts ? pkts[i] : NULL);
+            if (ret < 0)
+                goto end;
+            while ((ret = avcodec_receive_frame(avctx, frame)) >= 0) {
+                samples += frame->nb_samples;
+                av_frame_unref(frame);
+            }
+            if (ret != AVERROR(EAGAIN) && ret != AVERROR_EOF)
+                goto end;
+        }
+        avcodec_flush_buffers(avctx);
+    }
+    t = av_gettime_relative() - t;
+    ret = 0;
+
+    printf("%s: %s %d ch, %d threads: %"PRId64" samples, %.3f s, %.1fx realtime\n",
+           filename, codec->name, avctx->ch_layout.nb_channels, threads, samples,
+           t / 1000000.0, t ? samples * 1000000.0 / avctx->sample_rate / t : 0.0);
+
+end:
+    if (ret < 0)
+        fprintf(stderr, "%s: %s\n", filename, av_err2str(ret));
+    for (int i = 0; i < nb_pkts; i++)
+        av_packet_free(&pkts[i]);
+    av_free(pkts);
+    av_frame_free(&frame);
+    avcodec_free_context(&avctx);
+    avformat_close_input(&fmt);
+    return ret;
+}
+
+int main(int argc, char **argv)
+{
+    int threads = 1, loops = 1, nb_files = 0, err = 0;
+
+    av_log_set_level(AV_LOG_ERROR);
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-threads") && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-loop") && i + 1 < argc) {
+            loops = atoi(argv[++i]);
+        } else {
+            err |= run(argv[i], threads, loops) < 0;
+            nb_files++;
+        }
+    }
+
+    if (!nb_files) {
+        fprintf(stderr, "audiodecbench [-threads n] [-loop n] <file>...\n");
+        return 1;
+    }
+
+    return err;
+}
@@ -0,0 +1,254 @@
+/*
+ * Benchmark an audio encoder over several channel counts, e.g.:
+ * tools/audioencbench aac
+ * tools/audioencbench -threads 4 -t 60 -o b=512k aac 2 6 8
+ *
+ * The input is a synthetic mix of tones and noise, different for every
+ * channel, generated before the clock starts. The speed is reported as
+ * a multiple of real time.
+ *
+ * This file is part of Librempeg
+ *
+ * Librempeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Librempeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Librempeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libavcodec/avcodec.h"
+#include "libavutil/channel_layout.h"
+#include "libavutil/dict.h"
+#include "libavutil/error.h"
+#include "libavutil/frame.h"
+#include "libavutil/log.h"
+#include "libavutil/mathematics.h"
+#include "libavutil/samplefmt.h"
+#include "libavutil/time.h"
+
+static enum AVSampleFormat pick_format(const enum AVSampleFormat *fmts)
+{
+    static const enum AVSampleFormat preferred[] = {
+        AV_SAMPLE_FMT_FLTP, AV_SAMPLE_FMT_FLT, AV_SAMPLE_FMT_S16P,
+        AV_SAMPLE_FMT_S16,  AV_SAMPLE_FMT_S32P, AV_SAMPLE_FMT_S32,
+        AV_SAMPLE_FMT_DBLP, AV_SAMPLE_FMT_DBL,
+    };
+
+    if (!fmts)
+        return AV_SAMPLE_FMT_FLTP;
+    for (int i = 0; i < FF_ARRAY_ELEMS(preferred); i++)
+        for (int j = 0; fmts[j] != AV_SAMPLE_FMT_NONE; j++)
+            if (fmts[j] == preferred[i])
+                return fmts[j];
+    return AV_SAMPLE_FMT_NONE;
+}
+
+static void fill_frame(AVFrame *frame, int64_t pos, int sample_rate,
+                       uint32_t *seed)
+{
+    int channels = frame->ch_layout.nb_channels;
+    int planar   = av_sample_fmt_is_planar(frame->format);
+
+    for (int i = 0; i < frame->nb_samples; i++) {
+        for (int ch = 0; ch < channels; ch++) {
+            double t = (pos + i) / (double)sample_rate;
+            double v = 0.3 * sin(2 * M_PI * (220.0 + 110.0 * ch) * t) +
+                       0.1 * sin(2 * M_PI * (3000.0 + 500.0 * ch) * t);
+            int idx  = planar ? i : i * channels + ch;
+            uint8_t *dst = frame->extended_data[planar ? ch : 0];
+
+            *seed = *seed * 1664525 + 1013904223;
+            v += 0.05 * ((int32_t)*seed / 2147483648.0);
+
+            switch (av_get_packed_sample_fmt(frame->format)) {
+            case AV_SAMPLE_FMT_FLT: ((float   *)dst)[idx] = v;                break;
+            case AV_SAMPLE_FMT_DBL: ((double  *)dst)[idx] = v;                break;
+            case AV_SAMPLE_FMT_S16: ((int16_t *)dst)[idx] = lrint(v * 32767); break;
+            case AV_SAMPLE_FMT_S32: ((int32_t *)dst)[idx] = lrint(v * 2147483647.0); break;
+            default: break;
+            }
+        }
+    }
+}
+
+static int run(const AVCodec *codec, int channels, int threads, double duration,
+               const AVDictionary *opts)
+{
+    const enum AVSampleFormat *fmts = NULL;
+    const int *rates = NULL;
+    AVCodecContext *avctx = NULL;
+    AVDictionary *dict = NULL;
+    AVFrame **frames = NULL;
+    AVPacket *pkt = NULL;
+    int64_t total, pos = 0, bytes = 0, t;
+    uint32_t seed = 1;
+    int nb_frames = 0, ret;
+
+    avctx = avcodec_alloc_context3(codec);
+    pkt   = av_packet_alloc();
+    if (!avctx || !pkt) {
+        ret = AVERROR(ENOMEM);
+        goto end;
+    }
+
+    avcodec_get_supported_config(avctx, NULL, AV_CODEC_CONFIG_SAMPLE_FORMAT,
+                                 0, (const void **)&fmts, NULL);
+    avcodec_get_supported_config(avctx, NULL, AV_CODEC_CONFIG_SAMPLE_RATE,
+                                 0, (const void **)&rates, NULL);
+
+    avctx->sample_fmt  = pick_format(fmts);
+    avctx->sample_rate = 48000;
+    if (rates) {
+        avctx->sample_rate = rates[0];
+        for (int i = 0; rates[i]; i++)
+            if (rates[i] == 48000)
+                avctx->sample_rate = 48000;
+    }
+    avctx->time_base     = (AVRational){ 1, avctx->sample_rate };
+    avctx->thread_count  = threads;
+    avctx->strict_std_compliance = FF_COMPLIANCE_EXPERIMENTAL;
+    av_channel_layout_default(&avctx->ch_layout, channels);
+
+    if (avctx->sample_fmt == AV_SAMPLE_FMT_NONE) {
+        ret = AVERROR(ENOSYS);
+        goto end;
+    }
+
+    av_dict_copy(&dict, opts, 0);
+    ret = avcodec_open2(avctx, codec, &dict);
+    av_dict_free(&dict);
+    if (ret < 0)
+        goto end;
+
+    /* generate the whole input up front so that only the encoder is timed */
+    total = llrint(duration * avctx->sample_rate);
+    if (avctx->frame_size && !(codec->capabilities & (AV_CODEC_CAP_SMALL_LAST_FRAME |
+                                                      AV_CODEC_CAP_VARIABLE_FRAME_SIZE)))
+        total -= total % avctx->frame_size;
+    while (pos < total) {
+        AVFrame *frame;
+        void *tmp = av_realloc_array(frames, nb_frames + 1, sizeof(*frames));
+        if (!tmp) {
+            ret = AVERROR(ENOMEM);
+            goto end;
+        }
+        frames = tmp;
+        frame  = frames[nb_frames] = av_frame_alloc();
+        if (!frame) {
+            ret = AVERROR(ENOMEM);
+            goto end;
+        }
+        nb_frames++;
+
+        frame->format      = avctx->sample_fmt;
+        frame->sample_rate = avctx->sample_rate;
+        frame->nb_samples  = avctx->frame_size ? avctx->frame_size : 1024;
+        frame->nb_samples  = FFMIN(frame->nb_samples, total - pos);
+        frame->pts         = pos;
+        ret = av_channel_layout_copy(&frame->ch_layout, &avctx->ch_layout);
+        if (ret < 0 || (ret = av_frame_get_buffer(frame, 0)) < 0)
+            goto end;
+        fill_frame(frame, pos, avctx->sample_rate, &seed);
+        pos += frame->nb_samples;
+    }
+
+    t = av_gettime_relative();
+    for (int i = 0; i <= nb_frames; i++) {
+        ret = avcodec_send_frame(avctx, i < nb_frames ? frames[i] : NULL);
+        if (ret < 0)
+            goto end;
+        while ((ret = avcodec_receive_packet(avctx, pkt)) >= 0) {
+            bytes += pkt->size;
+            av_packet_unref(pkt);
+        }
+        if (ret != AVERROR(EAGAIN) && ret != AVERROR_EOF)
+            goto end;
+    }
+    t = av_gettime_relative() - t;
+    ret = 0;
+
+    printf("%s %d ch, %d threads: %"PRId64" bytes, %.3f s, %.1fx realtime\n",
+           codec->name, channels, threads, bytes, t / 1000000.0,
+           t ? total * 1000000.0 / avctx->sample_rate / t : 0.0);
+
+end:
+    if (ret < 0)
+        fprintf(stderr, "%s %d ch: %s\n", codec->name, channels, av_err2str(ret));
+    for (int i = 0; i < nb_frames; i++)
+        av_frame_free(&frames[i]);
+    av_free(frames);
+    av_packet_free(&pkt);
+    avcodec_free_context(&avctx);
+    return ret;
+}
+
+int main(int argc, char **argv)
+{
+    static const int default_channels[] = { 1, 2, 6, 8 };
+    AVDictionary *opts = NULL;
+    const AVCodec *codec = NULL;
+    const char *name = NULL;
+    double duration = 30;
+    int channels[32], nb_channels = 0;
+    int threads = 1, err = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-o") && i + 1 < argc) {
+            char *val, *key = argv[++i];
+            if (!(val = strchr(key, '='))) {
+                fprintf(stderr, "Invalid option %s\n", key);
+                return 1;
+            }
+            *val++ = 0;
+            av_dict_set(&opts, key, val, 0);
+        } else if (!strcmp(argv[i], "-threads") && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-t") && i + 1 < argc) {
+            duration = atof(argv[++i]);
+        } else if (!name) {
+            name = argv[i];
+        } else if (nb_channels < FF_ARRAY_ELEMS(channels)) {
+            channels[nb_channels++] = atoi(argv[i]);
+        }
+    }
+
+    if (!name) {
+        fprintf(stderr, "audioencbench [-o key=value]... [-threads n] [-t seconds] "
+                        "<encoder> [channels]...\n");
+        return 1;
+    }
+
+    codec = avcodec_find_encoder_by_name(name);
+    if (!codec || codec->type != AVMEDIA_TYPE_AUDIO) {
+        fprintf(stderr, "Unknown audio encoder %s\n", name);
+        av_dict_free(&opts);
+        return 1;
+    }
+
+    av_log_set_level(AV_LOG_WARNING);
+
+    if (!nb_channels) {
+        memcpy(channels, default_channels, sizeof(default_channels));
+        nb_channels = FF_ARRAY_ELEMS(default_channels);
+    }
+
+    for (int i = 0; i < nb_channels; i++)
+        err |= run(codec, channels[i], threads, duration, opts) < 0;
+
+    av_dict_free(&opts);
+    return err;
+}
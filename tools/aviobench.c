@@ -0,0 +1,92 @@
+/*
+ * Benchmark reading a file through AVIOContext, e.g. to compare protocols:
+ * tools/aviobench file:in.mp4
+ * tools/aviobench async:file:in.mp4
+ * tools/aviobench -o readahead=8388608 file:in.mp4
+ *
+ * With -skip, every read of 64 KiB is followed by a forward seek of the
+ * given size, which approximates demuxing one stream of an interleaved file.
+ * Drop the page cache before each run to measure the storage.
+ *
+ * This file is part of Librempeg
+ *
+ * Librempeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Librempeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Librempeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libavformat/avio.h"
+#include "libavutil/dict.h"
+#include "libavutil/error.h"
+#include "libavutil/time.h"
+
+#define READ_SIZE (64 * 1024)
+
+int main(int argc, char **argv)
+{
+    static unsigned char buf[READ_SIZE];
+    AVDictionary *opts = NULL;
+    AVIOContext *pb = NULL;
+    const char *url = NULL;
+    int64_t total = 0, t;
+    int skip = 0, ret;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-o") && i + 1 < argc) {
+            char *val, *key = argv[++i];
+            if (!(val = strchr(key, '='))) {
+                fprintf(stderr, "Invalid option %s\n", key);
+                return 1;
+            }
+            *val++ = 0;
+            av_dict_set(&opts, key, val, 0);
+        } else if (!strcmp(argv[i], "-skip") && i + 1 < argc) {
+            skip = atoi(argv[++i]);
+        } else {
+            url = argv[i];
+        }
+    }
+
+    if (!url) {
+        fprintf(stderr, "aviobench [-o key=value]... [-skip bytes] <url>\n");
+        return 1;
+    }
+
+    t = av_gettime_relative();
+
+    ret = avio_open2(&pb, url, AVIO_FLAG_READ, NULL, &opts);
+    av_dict_free(&opts);
+    if (ret < 0) {
+        fprintf(stderr, "Could not open %s: %s\n", url, av_err2str(ret));
+        return 1;
+    }
+
+    while ((ret = avio_read(pb, buf, READ_SIZE)) > 0) {
+        total += ret;
+        if (skip && avio_skip(pb, skip) < 0)
+            break;
+    }
+
+    avio_closep(&pb);
+    t = av_gettime_relative() - t;
+
+    printf("%s: read %"PRId64" bytes in %"PRId64" us, %.1f MB/s\n",
+           url, total, t, t ? total / (double)t : 0.0);
+
+    return ret < 0 && ret != AVERROR_EOF;
+}
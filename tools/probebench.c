@@ -0,0 +1,133 @@
+/*
+ * Benchmark input format probing over a set of files, e.g. the FATE samples:
+ * find $FATE_SAMPLES -type f | xargs tools/probebench
+ *
+ * For each file, the probe buffer sizes used by av_probe_input_buffer2()
+ * are probed with av_probe_input_format3() and with a plain scan calling
+ * every read_probe(). Demuxers whose read_probe() accepts a buffer that
+ * none of their signatures match are reported, as that would make the
+ * signature index change probing results.
+ *
+ * This file is part of Librempeg
+ *
+ * Librempeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Librempeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Librempeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "libavformat/avformat.h"
+#include "libavformat/demux.h"
+#include "libavformat/internal.h"
+#include "libavutil/mem.h"
+#include "libavutil/time.h"
+
+static int failures;
+
+static int signatures_match(const FFProbeSignature *sig, const AVProbeData *pd)
+{
+    for (; sig->size; sig++) {
+        int masked = 0, j;
+
+        for (j = 0; j < sig->size; j++)
+            masked |= sig->mask[j];
+        for (j = 0; j < sig->size; j++)
+            if ((pd->buf[sig->offset + j] ^ sig->magic[j]) & (masked ? sig->mask[j] : 0xFF))
+                break;
+        if (j == sig->size)
+            return 1;
+    }
+    return 0;
+}
+
+static void full_scan(const AVProbeData *pd, const char *filename)
+{
+    const AVInputFormat *fmt;
+    void *i = NULL;
+
+    while ((fmt = av_demuxer_iterate(&i))) {
+        const FFInputFormat *ffmt = ffifmt(fmt);
+        int score;
+
+        if (!ffmt->read_probe || (fmt->flags & (AVFMT_NOFILE | AVFMT_EXPERIMENTAL)))
+            continue;
+        score = ffmt->read_probe(pd);
+        if (score > 0 && ffmt->signatures && !signatures_match(ffmt->signatures, pd)) {
+            fprintf(stderr, "%s: %s probe scored %d without a matching signature\n",
+                    filename, fmt->name, score);
+            failures++;
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int64_t t_index = 0, t_full = 0;
+    uint8_t *data, *buf;
+    int nb_files = 0;
+
+    if (argc < 2) {
+        fprintf(stderr, "probebench <file>...\n");
+        return 1;
+    }
+
+    data = av_malloc(PROBE_BUF_MAX);
+    buf  = av_malloc(PROBE_BUF_MAX + AVPROBE_PADDING_SIZE);
+    if (!data || !buf)
+        return 1;
+
+    for (int f = 1; f < argc; f++) {
+        FILE *in = fopen(argv[f], "rb");
+        size_t size;
+
+        if (!in)
+            continue;
+        size = fread(data, 1, PROBE_BUF_MAX, in);
+        fclose(in);
+        nb_files++;
+
+        for (int probe_size = PROBE_BUF_MIN; probe_size <= PROBE_BUF_MAX; probe_size <<= 1) {
+            AVProbeData pd = {
+                .filename = "",
+                .buf      = buf,
+                .buf_size = FFMIN(probe_size, size),
+            };
+            int64_t t;
+            int score;
+
+            memcpy(buf, data, pd.buf_size);
+            memset(buf + pd.buf_size, 0, AVPROBE_PADDING_SIZE);
+
+            t = av_gettime_relative();
+            av_probe_input_format3(&pd, 1, &score);
+            t_index += av_gettime_relative() - t;
+
+            t = av_gettime_relative();
+            full_scan(&pd, argv[f]);
+            t_full += av_gettime_relative() - t;
+
+            if (probe_size >= size)
+                break;
+        }
+    }
+
+    printf("%d files: av_probe_input_format3 %"PRId64" us, full read_probe scan %"PRId64" us\n",
+           nb_files, t_index, t_full);
+
+    av_free(data);
+    av_free(buf);
+    return !!failures;
+}